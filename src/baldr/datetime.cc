@@ -689,6 +689,22 @@ get_duration(const std::string& date_time, const uint32_t seconds, const date::t
   return iso_date;
 }
 
+// get the local date_times from begin to end every step minutes
+std::vector<std::string>
+date_time_range(const std::string& begin, const std::string& end, const uint32_t step) {
+  std::vector<std::string> date_times;
+  if (step == 0) {
+    return date_times;
+  }
+  const auto last = get_formatted_date(end);
+  for (auto date = get_formatted_date(begin); date <= last; date += std::chrono::minutes(step)) {
+    std::ostringstream iso_date_time;
+    iso_date_time << date::format("%FT%R", date);
+    date_times.emplace_back(iso_date_time.str());
+  }
+  return date_times;
+}
+
 // does this date fall in the begin and end date range?
 bool is_conditional_active(const bool type,
                            const uint8_t begin_hrs,
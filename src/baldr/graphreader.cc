@@ -5,9 +5,14 @@
 #include "midgard/logging.h"
 #include "midgard/util.h"
 #include "shortcut_recovery.h"
+#include "tile_warmer.h"
+
+#include <boost/property_tree/ptree.hpp>
 
 #include <sys/stat.h>
 
+#include <algorithm>
+#include <atomic>
 #include <filesystem>
 #include <span>
 #include <string>
@@ -21,6 +26,27 @@ constexpr size_t DEFAULT_MAX_CACHE_SIZE = 1073741824; // 1 gig
 constexpr size_t AVERAGE_TILE_SIZE = 2097152;         // 2 megs
 constexpr size_t AVERAGE_MM_TILE_SIZE = 1024;         // 1k
 
+// bumped every time a reload of the extracts is requested, readers compare it to their own
+std::atomic<uint64_t> reload_generation{0};
+
+// the parts of the config which are needed to load and warm up the extracts and cache their tiles
+std::shared_ptr<const boost::property_tree::ptree>
+make_extract_config(const boost::property_tree::ptree& pt) {
+  auto config = std::make_shared<boost::property_tree::ptree>();
+  for (const auto* key :
+       {"tile_extract", "traffic_extract", "data_processing.scan_tar", "max_cache_size",
+        "use_lru_mem_cache", "lru_mem_cache_hard_control", "use_simple_mem_cache",
+        "global_synchronized_cache"}) {
+    if (auto value = pt.get_optional<std::string>(key)) {
+      config->put(key, *value);
+    }
+  }
+  if (auto warm_up = pt.get_child_optional("warm_up")) {
+    config->put_child("warm_up", *warm_up);
+  }
+  return config;
+}
+
 struct tile_index_entry {
   uint64_t offset;  // byte offset from the beginning of the tar
   uint32_t tile_id; // just level and tileindex hence fitting in 32bits
@@ -386,53 +412,54 @@ graph_tile_ptr TileCacheLRU::Put(const GraphId& graphid, graph_tile_ptr tile, si
 // ----------------------------------------------------------------------------
 
 // Constructor.
-SynchronizedTileCache::SynchronizedTileCache(TileCache& cache, std::mutex& mutex)
-    : cache_(cache), mutex_ref_(mutex) {
+SynchronizedTileCache::SynchronizedTileCache(std::shared_ptr<TileCache> cache, std::mutex& mutex)
+    : cache_(std::move(cache)), mutex_ref_(mutex) {
 }
 
 // Reserves enough cache to hold (max_cache_size / tile_size) items.
 void SynchronizedTileCache::Reserve(size_t tile_size) {
   std::lock_guard<std::mutex> lock(mutex_ref_);
-  cache_.Reserve(tile_size);
+  cache_->Reserve(tile_size);
 }
 
 // Checks if tile exists in the cache.
 bool SynchronizedTileCache::Contains(const GraphId& graphid) const {
   std::lock_guard<std::mutex> lock(mutex_ref_);
-  return cache_.Contains(graphid);
+  return cache_->Contains(graphid);
 }
 
 // Lets you know if the cache is too large.
 bool SynchronizedTileCache::OverCommitted() const {
   std::lock_guard<std::mutex> lock(mutex_ref_);
-  return cache_.OverCommitted();
+  return cache_->OverCommitted();
 }
 
 // Clears the cache.
 void SynchronizedTileCache::Clear() {
   std::lock_guard<std::mutex> lock(mutex_ref_);
-  cache_.Clear();
+  cache_->Clear();
 }
 
 void SynchronizedTileCache::Trim() {
   std::lock_guard<std::mutex> lock(mutex_ref_);
-  cache_.Trim();
+  cache_->Trim();
 }
 
 // Get a pointer to a graph tile object given a GraphId.
 graph_tile_ptr SynchronizedTileCache::Get(const GraphId& graphid) const {
   std::lock_guard<std::mutex> lock(mutex_ref_);
-  return cache_.Get(graphid);
+  return cache_->Get(graphid);
 }
 
 // Puts a copy of a tile of into the cache.
 graph_tile_ptr SynchronizedTileCache::Put(const GraphId& graphid, graph_tile_ptr tile, size_t size) {
   std::lock_guard<std::mutex> lock(mutex_ref_);
-  return cache_.Put(graphid, std::move(tile), size);
+  return cache_->Put(graphid, std::move(tile), size);
 }
 
 // Constructs tile cache.
-TileCache* TileCacheFactory::createTileCache(const boost::property_tree::ptree& pt) {
+TileCache* TileCacheFactory::createTileCache(const boost::property_tree::ptree& pt,
+                                             uint64_t generation) {
   size_t max_cache_size = pt.get<size_t>("max_cache_size", DEFAULT_MAX_CACHE_SIZE);
 
   bool use_lru_cache = pt.get<bool>("use_lru_mem_cache", false);
@@ -446,10 +473,16 @@ TileCache* TileCacheFactory::createTileCache(const boost::property_tree::ptree&
   if (pt.get<bool>("global_synchronized_cache", false)) {
     // Handle synchronization of cache
     static std::mutex globalCacheMutex_;
-    static std::shared_ptr<TileCache> globalTileCache_;
+    // One cache per tileset generation so readers which haven't reloaded yet never see the tiles
+    // of another extract. A cache goes away with the last reader of its generation
+    static std::unordered_map<uint64_t, std::weak_ptr<TileCache>> globalTileCaches_;
     // We need to lock the factory method itself to prevent races
     static std::mutex factoryMutex;
     std::lock_guard<std::mutex> lock(factoryMutex);
+    for (auto itr = globalTileCaches_.begin(); itr != globalTileCaches_.end();) {
+      itr = itr->second.expired() ? globalTileCaches_.erase(itr) : std::next(itr);
+    }
+    auto globalTileCache_ = globalTileCaches_[generation].lock();
     if (!globalTileCache_) {
       if (use_lru_cache) {
         globalTileCache_ = std::make_shared<TileCacheLRU>(max_cache_size, lru_mem_control);
@@ -457,8 +490,9 @@ TileCache* TileCacheFactory::createTileCache(const boost::property_tree::ptree&
         // globalTileCache_.reset(new SimpleTileCache(max_cache_size));
         globalTileCache_ = std::make_shared<FlatTileCache>(max_cache_size);
       }
+      globalTileCaches_[generation] = globalTileCache_;
     }
-    return new SynchronizedTileCache(*globalTileCache_, globalCacheMutex_);
+    return new SynchronizedTileCache(std::move(globalTileCache_), globalCacheMutex_);
   }
 
   // or do you want to use an LRU cache
@@ -488,7 +522,10 @@ GraphReader::GraphReader(const boost::property_tree::ptree& pt,
       is_tar_url_(!tile_url_.empty() &&
                   tile_url_.find(GraphTile::kTilePathPattern) == std::string::npos),
       url_id_txt_checksum_(load_id_txt_checksum(url_id_txt_path_, tile_url_)),
-      cache_(TileCacheFactory::createTileCache(pt)) {
+      cache_(TileCacheFactory::createTileCache(pt, reload_generation.load())),
+      shortcut_caching_(pt.get<bool>("shortcut_caching", false)),
+      extract_config_(make_extract_config(pt)), traffic_readonly_(traffic_readonly),
+      tileset_generation_(reload_generation.load()), reload_checked_(tileset_generation_) {
 
   if (!tile_url_.empty()) {
     // Make a tile fetcher if we havent passed one in from somewhere else
@@ -523,6 +560,10 @@ GraphReader::GraphReader(const boost::property_tree::ptree& pt,
   // mmap'd file
   cache_->Reserve(tile_extract_->tiles.empty() ? AVERAGE_TILE_SIZE : AVERAGE_MM_TILE_SIZE);
 
+  // Start bringing the extract into memory in the background if configured to
+  tile_warmer_t::warm(*extract_config_, tile_extract_->archive, tile_extract_->tiles,
+                      tileset_generation_);
+
   // Initialize the incident cache singleton if we have any kind of configuration to do so. if the
   // configuration is wrong or any kind of problem occurs this throws. the call below will spawn a
   // single background thread which is responsible for loading incidents continually
@@ -535,9 +576,81 @@ GraphReader::GraphReader(const boost::property_tree::ptree& pt,
   }
 
   // Fill shortcut recovery cache if requested or by default in memmap mode
-  if (pt.get<bool>("shortcut_caching", false)) {
-    shortcut_recovery_t::get_instance(this);
+  if (shortcut_caching_) {
+    shortcut_recovery_t::get_instance(this, tileset_generation_);
+  }
+}
+
+void GraphReader::RequestReload() {
+  reload_generation.fetch_add(1);
+}
+
+bool GraphReader::ReloadIfRequested() {
+  if (reload_generation.load() == reload_checked_) {
+    return false;
+  }
+  Reload();
+  return true;
+}
+
+bool GraphReader::Reload() {
+  // readers share what they derive from the tiles by generation, so a reload nobody requested
+  // needs a generation of its own. that also has the other readers pick up the new extracts
+  auto generation = reload_generation.load();
+  if (generation == tileset_generation_) {
+    generation = reload_generation.fetch_add(1) + 1;
+  }
+  // whether or not it works we wont try again until the next request
+  reload_checked_ = generation;
+
+  std::shared_ptr<const tile_extract_t> extract(
+      new tile_extract_t(*extract_config_, traffic_readonly_));
+  // a half written or missing extract shouldn't take down a reader that is working fine
+  if ((extract->tiles.empty() && !tile_extract_->tiles.empty()) ||
+      (extract->traffic_tiles.empty() && !tile_extract_->traffic_tiles.empty())) {
+    LOG_ERROR("Failed to reload the tile extracts, keeping the ones already loaded");
+    return false;
+  }
+
+  // tiles still in use hold on to the previous archive until they are released, the same goes for
+  // a cache shared with readers which haven't reloaded yet
+  tile_extract_ = std::move(extract);
+  tileset_generation_ = generation;
+  cache_.reset(TileCacheFactory::createTileCache(*extract_config_, tileset_generation_));
+  cache_->Reserve(tile_extract_->tiles.empty() ? AVERAGE_TILE_SIZE : AVERAGE_MM_TILE_SIZE);
+  LOG_INFO("Reloaded the tile extracts");
+  tile_warmer_t::warm(*extract_config_, tile_extract_->archive, tile_extract_->tiles,
+                      tileset_generation_);
+
+  // the incidents and recovered shortcuts of the previous tiles don't apply to the new ones
+  if (enable_incidents_) {
+    incident_singleton_t::retile(tileset_generation_, tile_extract_->tiles.empty()
+                                                          ? std::unordered_set<GraphId>{}
+                                                          : GetTileSet());
+  }
+  if (shortcut_caching_) {
+    shortcut_recovery_t::get_instance(this, tileset_generation_);
   }
+  return true;
+}
+
+float GraphReader::WarmUpProgress() {
+  return tile_warmer_t::progress();
+}
+
+bool GraphReader::WarmedUp() {
+  return tile_warmer_t::ready();
+}
+
+uint64_t GraphReader::TrafficVersion() const {
+  uint64_t version = 0;
+  for (const auto& tile : tile_extract_->traffic_tiles) {
+    // the traffic updater writes the headers in place while we read them
+    const auto* header = reinterpret_cast<const volatile TrafficTileHeader*>(tile.second.first);
+    const uint64_t last_update = header->last_update;
+    version = std::max(version, last_update);
+  }
+  return version;
 }
 
 // Method to test if tile exists
@@ -872,7 +985,8 @@ GraphId GraphReader::GetShortcut(const GraphId& id) {
 
 // Unpack edges for a given shortcut edge
 std::vector<GraphId> GraphReader::RecoverShortcut(const GraphId& shortcut_id) {
-  return shortcut_recovery_t::get_instance().get(shortcut_id, *this);
+  return shortcut_recovery_t::get_instance(shortcut_caching_ ? this : nullptr, tileset_generation_)
+      .get(shortcut_id, *this);
 }
 
 // Convenience method to get the relative edge density (from the
@@ -1101,5 +1215,42 @@ graph_tile_ptr LimitedGraphReader::GetGraphTile(const GraphId& graphid) {
   return reader_.GetGraphTile(graphid);
 }
 
+namespace {
+// the tiles come from the shared reader, all we need locally is a small cache of our own
+const boost::property_tree::ptree& concurrent_reader_config() {
+  static const boost::property_tree::ptree config = [] {
+    boost::property_tree::ptree pt;
+    pt.put("use_simple_mem_cache", true);
+    return pt;
+  }();
+  return config;
+}
+} // namespace
+
+ConcurrentGraphReader::ConcurrentGraphReader(GraphReader& reader, std::mutex& mutex)
+    : GraphReader(concurrent_reader_config()), reader_(reader), mutex_(mutex) {
+}
+
+bool ConcurrentGraphReader::DoesTileExist(const GraphId& graphid) const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return reader_.DoesTileExist(graphid);
+}
+
+graph_tile_ptr ConcurrentGraphReader::GetGraphTile(const GraphId& graphid) {
+  if (!graphid.is_valid()) {
+    return nullptr;
+  }
+  auto base = graphid.tile_base();
+  if (auto cached = cache_->Get(base)) {
+    return cached;
+  }
+  graph_tile_ptr tile;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    tile = reader_.GetGraphTile(base);
+  }
+  return tile ? cache_->Put(base, std::move(tile), AVERAGE_MM_TILE_SIZE) : nullptr;
+}
+
 } // namespace baldr
 } // namespace valhalla
@@ -30,6 +30,8 @@ protected:
     std::atomic<bool> lock_free;    // whether or not we can skip locking around cache operations
     std::condition_variable signal; // how the watcher tells the main thread its done its first load
     std::mutex mutex;               // for locking on cache operations
+    // whether the watcher was replaced by one for another tileset and should stop
+    std::atomic<bool> stopped{false};
     // the actual cache where tiles are stored
     std::unordered_map<uint64_t, std::shared_ptr<const valhalla::IncidentsTile>> cache;
   };
@@ -39,10 +41,9 @@ protected:
   // destructed, then the watcher would be making use of a deallocated state object. this way, if the
   // watcher is last to die it own the lifetime of the state and if the singleton is the last to die
   // it owns the lifetime of the state. note that we still need to use atomics inside the state as
-  // only the shared_ptr itself is thread safe, not the thing it points to
+  // only the shared_ptr itself is thread safe, not the thing it points to. the shared_ptr is only
+  // ever accessed atomically because it is replaced when the tileset is reloaded
   std::shared_ptr<state_t> state;
-  // daemon thread to watch for new incident data
-  std::thread watcher;
 
   // prototype for the watch function. we need this so unit tests can safely test all functionality
   using watch_function_t = std::function<void(boost::property_tree::ptree,
@@ -50,6 +51,12 @@ protected:
                                               std::shared_ptr<state_t>,
                                               std::function<bool(size_t)>)>;
 
+  // what we need to start another watcher when the tileset is reloaded
+  boost::property_tree::ptree config;
+  watch_function_t watch_func;
+  uint64_t generation = 0;
+  std::mutex retile_mutex;
+
   /**
    * Singleton private constructor that static function uses to instantiate the singleton
    * @param config      lets the daemon thread know where/how to look for incidents
@@ -59,19 +66,42 @@ protected:
   incident_singleton_t(const boost::property_tree::ptree& config,
                        const std::unordered_set<valhalla::baldr::GraphId>& tileset,
                        const watch_function_t& watch_func = incident_singleton_t::watch)
-      : state{new state_t{}}, watcher(watch_func, config, tileset, state, interrupt()) {
-    // let the thread control its own lifetime
-    watcher.detach();
+      : config(config), watch_func(watch_func) {
+    std::atomic_store(&state, start(tileset));
+  }
+
+  /**
+   * Spawns a daemon thread to watch for the incidents of a tileset and waits for its first load
+   * @param tileset  the tiles to watch, see the constructor
+   * @return the state the new thread keeps up to date
+   */
+  std::shared_ptr<state_t> start(const std::unordered_set<valhalla::baldr::GraphId>& tileset) {
+    // the thread controls its own lifetime
+    std::shared_ptr<state_t> fresh{new state_t{}};
+    std::thread(watch_func, config, tileset, fresh, interrupt()).detach();
     // check how long we should wait to find out if its initialized
     auto max_loading_latency =
         config.get<time_t>("incident_max_loading_latency", DEFAULT_MAX_LOADING_LATENCY);
 
     // see if the thread can start up and do a pass to load all the incidents
-    std::unique_lock<std::mutex> lock(state->mutex);
+    std::unique_lock<std::mutex> lock(fresh->mutex);
     auto when = std::chrono::system_clock::now() + std::chrono::seconds(max_loading_latency);
-    if (!state->signal.wait_until(lock, when, [&]() -> bool { return state->initialized.load(); })) {
+    if (!fresh->signal.wait_until(lock, when, [&]() -> bool { return fresh->initialized.load(); })) {
+      fresh->stopped.store(true);
       throw std::runtime_error("Unable to initialize incident watcher in the configured time period");
     }
+    return fresh;
+  }
+
+  /**
+   * @return the one singleton, constructed with the arguments of the first call
+   */
+  static incident_singleton_t&
+  instance(const boost::property_tree::ptree& config = {},
+           const std::unordered_set<valhalla::baldr::GraphId>& tileset = {}) {
+    // spawn a daemon to watch for incidents
+    static incident_singleton_t singleton{config, tileset};
+    return singleton;
   }
 
   /**
@@ -329,7 +359,7 @@ protected:
 
       // wait just a little before we check again
       std::this_thread::sleep_for(std::chrono::seconds(wait));
-    } while (!interrupt || !interrupt(run_count));
+    } while (!state->stopped.load() && (!interrupt || !interrupt(run_count)));
 
     LOG_INFO("Incident watcher has stopped");
   }
@@ -346,19 +376,41 @@ public:
   get(const valhalla::baldr::GraphId& tile_id,
       const boost::property_tree::ptree& config = {},
       const std::unordered_set<valhalla::baldr::GraphId>& tileset = {}) {
-    // spawn a daemon to watch for incidents
-    static incident_singleton_t singleton{config, tileset};
+    auto state = std::atomic_load(&instance(config, tileset).state);
 
     // return the tile from the cache or an empty one if its not there
-    auto scoped_lock = singleton.state->lock_free.load()
-                           ? std::unique_lock<std::mutex>()
-                           : std::unique_lock<std::mutex>(singleton.state->mutex);
-    auto found = singleton.state->cache.find(tile_id);
-    if (found == singleton.state->cache.cend()) {
+    auto scoped_lock = state->lock_free.load() ? std::unique_lock<std::mutex>()
+                                               : std::unique_lock<std::mutex>(state->mutex);
+    auto found = state->cache.find(tile_id);
+    if (found == state->cache.cend()) {
       return {};
     }
     auto tile = std::atomic_load_explicit(&found->second, std::memory_order_acquire);
     return tile;
   }
+
+  /**
+   * Switches to watching the incidents of a reloaded tileset, once per reload. Until the watcher of
+   * the new tileset has done its first load the incidents keep coming from the current one, which
+   * is stopped afterwards. If the new one can't be started the current one is kept
+   * @param generation  the tileset generation the tiles belong to
+   * @param tileset     the tiles to watch, see the constructor
+   */
+  static void retile(uint64_t generation,
+                     const std::unordered_set<valhalla::baldr::GraphId>& tileset) {
+    auto& singleton = instance();
+    std::lock_guard<std::mutex> lock(singleton.retile_mutex);
+    if (generation <= singleton.generation) {
+      return;
+    }
+    singleton.generation = generation;
+    try {
+      auto previous = std::atomic_exchange(&singleton.state, singleton.start(tileset));
+      previous->stopped.store(true);
+      LOG_INFO("Incident watcher switched to the reloaded tileset");
+    } catch (const std::exception& e) {
+      LOG_ERROR("Incident watcher kept the previous tileset: " + std::string(e.what()));
+    }
+  }
 };
 } // namespace
@@ -5,8 +5,11 @@
 #include "midgard/logging.h"
 
 #include <cstdint>
+#include <memory>
+#include <mutex>
 #include <string>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 
 namespace {
@@ -204,20 +207,39 @@ protected:
   // a place to cache the recovered shortcuts
   std::unordered_map<uint64_t, std::vector<valhalla::baldr::GraphId>> shortcuts;
   // a place to keep some stats about the recovery
-  size_t unrecovered;
-  size_t superseded;
+  size_t unrecovered = 0;
+  size_t superseded = 0;
 
 public:
   /**
-   * returns a static instance of the cache after prefilling it. if on the first call,
-   * the reader is nullptr then the cache will not be filled and recovery will be on the fly
+   * returns the cache of a tileset generation after prefilling it. if on the first call for the
+   * generation the reader is nullptr then the cache will not be filled and recovery will be on the
+   * fly. each thread holds on to the cache it last used, the cache of a previous generation goes
+   * away once no thread uses it anymore
    *
    * @param reader       the reader used to initialize the cache the first time
+   * @param generation   the tileset generation of the reader
    * @return a filled cache mapping shortcuts to superseded edges
    */
-  static shortcut_recovery_t& get_instance(valhalla::baldr::GraphReader* reader = nullptr) {
-    static shortcut_recovery_t cache{reader};
-    return cache;
+  static const shortcut_recovery_t& get_instance(valhalla::baldr::GraphReader* reader,
+                                                 uint64_t generation) {
+    // the common case, no reload since this thread last asked
+    thread_local std::pair<uint64_t, std::shared_ptr<const shortcut_recovery_t>> last;
+    if (last.second && last.first == generation)
+      return *last.second;
+
+    static std::mutex mutex;
+    static std::unordered_map<uint64_t, std::weak_ptr<const shortcut_recovery_t>> caches;
+    std::lock_guard<std::mutex> lock(mutex);
+    auto cache = caches[generation].lock();
+    if (!cache) {
+      cache.reset(new shortcut_recovery_t(reader));
+      caches[generation] = cache;
+    }
+    for (auto itr = caches.begin(); itr != caches.end();)
+      itr = itr->second.expired() ? caches.erase(itr) : std::next(itr);
+    last = {generation, std::move(cache)};
+    return *last.second;
   }
 
   /**
@@ -0,0 +1,319 @@
+#include "tile_warmer.h"
+#include "baldr/graphid.h"
+#include "baldr/graphtile.h"
+#include "midgard/logging.h"
+#include "midgard/sequence.h"
+
+#include <boost/property_tree/ptree.hpp>
+
+#ifndef _WIN32
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+
+namespace {
+
+using ranges_t = std::vector<std::pair<char*, size_t>>;
+
+// how much of the extract we advise, touch or lock at a time so we can stop early
+constexpr size_t WARM_UP_CHUNK_SIZE = 16 * 1024 * 1024;
+// how long we keep checking for pages to become resident without any progress
+constexpr size_t WARM_UP_MAX_STALLED_POLLS = 5;
+
+// shared between the warming thread and anyone asking how far along it is
+struct state_t {
+  std::shared_ptr<valhalla::midgard::tar> archive; // keeps the mapping and its locks alive
+  uint64_t generation;                             // the reload this extract was loaded for
+  float ready_fraction;
+  std::atomic<uint64_t> target_pages{0};
+  std::atomic<uint64_t> resident_pages{0};
+  std::atomic<bool> done{false};
+  std::atomic<bool> cancelled{false};
+  // wakes the thread up from polling so cancelling doesn't have to wait out the poll interval
+  std::mutex mutex;
+  std::condition_variable wake;
+
+  void cancel() {
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      cancelled = true;
+    }
+    wake.notify_all();
+  }
+
+  // waits for a while, returns false if cancelled in the meantime
+  bool wait(std::chrono::milliseconds duration) {
+    std::unique_lock<std::mutex> lock(mutex);
+    return !wake.wait_for(lock, duration, [this] { return cancelled.load(); });
+  }
+};
+
+// the one warm up of the process and the thread doing it
+struct warm_up_t {
+  std::mutex mutex;
+  std::shared_ptr<state_t> state;
+  std::thread thread;
+
+  // cancels the current warm up, if any, and waits for its thread to finish
+  void stop() {
+    if (state) {
+      state->cancel();
+    }
+    if (thread.joinable()) {
+      thread.join();
+    }
+  }
+
+  ~warm_up_t() {
+    stop();
+  }
+};
+
+warm_up_t& warm_up() {
+  static warm_up_t warm_up;
+  return warm_up;
+}
+
+// reads the tile ids out of a file of graph ids or tile paths
+std::vector<uint64_t> read_hot_tiles(const std::string& path) {
+  std::vector<uint64_t> tile_ids;
+  std::ifstream file(path);
+  if (!file.is_open()) {
+    LOG_WARN("Could not open the hot tiles file " + path);
+    return tile_ids;
+  }
+  std::string line;
+  while (std::getline(file, line)) {
+    line.erase(line.find_last_not_of(" \t\r") + 1);
+    if (line.empty()) {
+      continue;
+    }
+    try {
+      if (line.find('/') != std::string::npos) {
+        tile_ids.push_back(valhalla::baldr::GraphTile::GetTileId(line).value);
+      } else {
+        tile_ids.push_back(valhalla::baldr::GraphId(std::stoull(line)).tile_base().value);
+      }
+    } catch (...) {
+      LOG_WARN("Skipping unparseable hot tile " + line);
+    }
+  }
+  return tile_ids;
+}
+
+#ifndef _WIN32
+// rounds the ranges out to whole pages and merges the ones which overlap
+ranges_t to_pages(ranges_t ranges, size_t page_size) {
+  for (auto& range : ranges) {
+    auto begin = reinterpret_cast<uintptr_t>(range.first) / page_size * page_size;
+    auto end = (reinterpret_cast<uintptr_t>(range.first) + range.second + page_size - 1) /
+               page_size * page_size;
+    range = {reinterpret_cast<char*>(begin), end - begin};
+  }
+  std::sort(ranges.begin(), ranges.end());
+  ranges_t merged;
+  for (const auto& range : ranges) {
+    if (!merged.empty() && range.first <= merged.back().first + merged.back().second) {
+      auto end = std::max(merged.back().first + merged.back().second, range.first + range.second);
+      merged.back().second = end - merged.back().first;
+    } else {
+      merged.push_back(range);
+    }
+  }
+  return merged;
+}
+
+// counts how many pages of the ranges are in memory
+uint64_t resident(const ranges_t& ranges, size_t page_size) {
+#if defined(__APPLE__)
+  std::vector<char> pages;
+#else
+  std::vector<unsigned char> pages;
+#endif
+  uint64_t count = 0;
+  for (const auto& range : ranges) {
+    pages.resize(range.second / page_size);
+    if (mincore(range.first, range.second, pages.data()) == 0) {
+      count += std::count_if(pages.begin(), pages.end(), [](auto page) { return page & 1; });
+    }
+  }
+  return count;
+}
+
+void run(std::shared_ptr<state_t> state,
+         std::string policy,
+         ranges_t ranges,
+         ranges_t locked,
+         size_t page_size) {
+  try {
+    // ask for or fault in the pages a chunk at a time
+    for (const auto& range : ranges) {
+      for (size_t offset = 0; offset < range.second && !state->cancelled;
+           offset += WARM_UP_CHUNK_SIZE) {
+        auto* chunk = range.first + offset;
+        auto size = std::min(WARM_UP_CHUNK_SIZE, range.second - offset);
+        if (policy == "willneed") {
+          posix_madvise(chunk, size, POSIX_MADV_WILLNEED);
+          continue;
+        }
+        volatile char sink = 0;
+        for (size_t page = 0; page < size; page += page_size) {
+          sink = sink + chunk[page];
+        }
+        state->resident_pages += size / page_size;
+      }
+    }
+
+    // pin the ones we were asked to, they are unlocked when the mapping goes away
+    for (const auto& range : locked) {
+      if (state->cancelled) {
+        break;
+      }
+      if (mlock(range.first, range.second) != 0) {
+        LOG_WARN("Could not lock the tile extract in memory, check RLIMIT_MEMLOCK: " +
+                 std::string(strerror(errno)));
+        break;
+      }
+    }
+
+    // the kernel may still be reading ahead or may have already dropped some of it again
+    uint64_t last = 0;
+    for (size_t stalled = 0; !state->cancelled && stalled < WARM_UP_MAX_STALLED_POLLS;) {
+      state->resident_pages = resident(ranges, page_size);
+      if (state->resident_pages == state->target_pages) {
+        break;
+      }
+      stalled = state->resident_pages > last ? 0 : stalled + 1;
+      last = state->resident_pages;
+      state->wait(std::chrono::seconds(1));
+    }
+  } catch (const std::exception& e) {
+    LOG_ERROR("Tile extract warm up failed: " + std::string(e.what()));
+  }
+
+  if (!state->cancelled) {
+    LOG_INFO("Tile extract warm up finished with " + std::to_string(state->resident_pages.load()) +
+             " of " + std::to_string(state->target_pages.load()) + " pages resident");
+  }
+  state->done = true;
+}
+#endif
+
+} // namespace
+
+namespace valhalla {
+namespace baldr {
+
+void tile_warmer_t::warm(const boost::property_tree::ptree& config,
+                         const std::shared_ptr<midgard::tar>& archive,
+                         const tiles_t& tiles,
+                         uint64_t generation) {
+  auto policy = config.get<std::string>("warm_up.policy", "none");
+  auto mlock_level = config.get<int>("warm_up.mlock_level", -1);
+  if (!archive || (policy == "none" && mlock_level < 0)) {
+    return;
+  }
+
+  auto& current = warm_up();
+  std::lock_guard<std::mutex> lock(current.mutex);
+  if (current.state && current.state->archive->tar_file == archive->tar_file &&
+      current.state->generation == generation) {
+    return;
+  }
+  // the previous extract is done for, stop warming it and release its locks. the thread checks
+  // for this between chunks, so this doesn't hold up the other readers for long
+  current.stop();
+
+#ifdef _WIN32
+  LOG_WARN("Tile extract warm up is not supported on this platform");
+  current.state.reset();
+#else
+  // what to bring into memory
+  ranges_t ranges, locked;
+  auto page_size = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+  if (policy == "willneed") {
+    ranges.emplace_back(archive->mm.get(), archive->mm.size());
+  } else if (policy == "levels") {
+    std::unordered_set<uint32_t> levels;
+    if (auto configured = config.get_child_optional("warm_up.levels")) {
+      for (const auto& level : *configured) {
+        levels.insert(level.second.get_value<uint32_t>());
+      }
+    } else {
+      levels = {0, 1};
+    }
+    for (const auto& tile : tiles) {
+      if (levels.count(GraphId(tile.first).level())) {
+        ranges.push_back(tile.second);
+      }
+    }
+  } else if (policy == "hot_tiles") {
+    for (const auto& tile_id : read_hot_tiles(config.get<std::string>("warm_up.hot_tiles", ""))) {
+      auto found = tiles.find(tile_id);
+      if (found != tiles.cend()) {
+        ranges.push_back(found->second);
+      }
+    }
+  } else if (policy != "none") {
+    LOG_WARN("Unknown tile extract warm up policy " + policy);
+  }
+  if (mlock_level >= 0) {
+    for (const auto& tile : tiles) {
+      if (GraphId(tile.first).level() == static_cast<uint32_t>(mlock_level)) {
+        locked.push_back(tile.second);
+      }
+    }
+  }
+  locked = to_pages(std::move(locked), page_size);
+  ranges.insert(ranges.end(), locked.begin(), locked.end());
+  ranges = to_pages(std::move(ranges), page_size);
+
+  // kick it off in the background
+  auto state = std::make_shared<state_t>();
+  state->archive = archive;
+  state->generation = generation;
+  state->ready_fraction = config.get<float>("warm_up.ready_fraction", 0.f);
+  for (const auto& range : ranges) {
+    state->target_pages += range.second / page_size;
+  }
+  LOG_INFO("Warming up " + std::to_string(state->target_pages.load()) + " pages of " +
+           archive->tar_file);
+  current.state = state;
+  current.thread = std::thread(run, std::move(state), policy, std::move(ranges), std::move(locked),
+                               page_size);
+#endif
+}
+
+float tile_warmer_t::progress() {
+  auto& current = warm_up();
+  std::lock_guard<std::mutex> lock(current.mutex);
+  const auto& state = current.state;
+  if (!state || state->target_pages == 0) {
+    return 1.f;
+  }
+  return static_cast<float>(state->resident_pages) / state->target_pages;
+}
+
+bool tile_warmer_t::ready() {
+  auto& current = warm_up();
+  std::lock_guard<std::mutex> lock(current.mutex);
+  const auto& state = current.state;
+  return !state || state->done || state->target_pages == 0 ||
+         static_cast<float>(state->resident_pages) / state->target_pages >= state->ready_fraction;
+}
+
+} // namespace baldr
+} // namespace valhalla
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <boost/property_tree/ptree_fwd.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <utility>
+
+namespace valhalla {
+namespace midgard {
+struct tar;
+} // namespace midgard
+
+namespace baldr {
+
+/**
+ * Brings the tiles of a memory mapped extract into the page cache in a background thread, so that
+ * the first requests after startup or a reload don't each have to fault in the pages they touch.
+ * There is one warm up per process, since the page cache is shared by every mapping of the file.
+ * The thread is owned by the process wide warm up and joined when it is superseded by a reload or
+ * when the process exits.
+ *
+ * The mjolnir.warm_up config selects what to warm:
+ *  policy          none, willneed (advise the kernel to read the whole extract), levels
+ *                  (touch the pages of the tiles on the given levels) or hot_tiles (touch the
+ *                  pages of the tiles listed in the hot_tiles file)
+ *  levels          a json array of the hierarchy levels to touch for the levels policy, 0 and 1 by
+ *                  default
+ *  hot_tiles       a file with a tile per line, either as a graph id or as a tile path like
+ *                  2/000/818/660.gph
+ *  mlock_level     lock the tiles of this level in memory, regardless of policy
+ *  ready_fraction  the fraction of the warmed pages which need to be resident to be ready
+ */
+struct tile_warmer_t {
+  using tiles_t = std::unordered_map<uint64_t, std::pair<char*, size_t>>;
+
+  /**
+   * Starts warming the extract unless it's already being warmed for this reload. A warm up of a
+   * previous extract is cancelled and its thread joined first.
+   * @param config      the mjolnir config, only the warm_up part is used
+   * @param archive     the mapped extract
+   * @param tiles       where in the mapping each tile is
+   * @param generation  which reload of the extract this is
+   */
+  static void warm(const boost::property_tree::ptree& config,
+                   const std::shared_ptr<midgard::tar>& archive,
+                   const tiles_t& tiles,
+                   uint64_t generation);
+
+  /**
+   * @return the fraction of the pages being warmed that are resident, 1 if nothing is warmed
+   */
+  static float progress();
+
+  /**
+   * @return whether enough of the extract is resident or the warm up has done all it can
+   */
+  static bool ready();
+};
+
+} // namespace baldr
+} // namespace valhalla
@@ -0,0 +1,124 @@
+#pragma once
+
+#include "argparse_utils.h"
+
+#include <boost/property_tree/ptree.hpp>
+#include <cxxopts.hpp>
+
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+/**
+ * @param start  when the timing started
+ * @return the seconds which passed since start
+ */
+inline double seconds_since(const std::chrono::steady_clock::time_point& start) {
+  return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+/**
+ * Adds the options every benchmark has: help, version and, for the benchmarks which need tiles or
+ * a service configuration, config and inline-config.
+ *
+ * @param options      The command line options
+ * @param with_config  Whether the benchmark reads a config
+ */
+inline void add_benchmark_options(cxxopts::Options& options, const bool with_config) {
+  // clang-format off
+  options.add_options()
+    ("h,help", "Print this help message.")
+    ("v,version", "Print the version of this software.");
+  if (with_config) {
+    options.add_options()
+      ("c,config", "Path to the json configuration file.", cxxopts::value<std::string>())
+      ("i,inline-config", "Inline json config.", cxxopts::value<std::string>());
+  }
+  // clang-format on
+}
+
+/**
+ * Parses the command line of a benchmark, reporting any problem with it on stderr.
+ *
+ * @param program  The executable's name
+ * @param options  The command line options
+ * @param argc     The number of arguments
+ * @param argv     The arguments
+ * @param config   The config which will be populated here, if the benchmark reads one
+ * @param bbox     The bounding box option, if the benchmark has one it has to be valid
+ *
+ * @returns the exit code if the benchmark should not run, e.g. after printing the help
+ */
+inline std::optional<int> parse_benchmark_args(const std::string& program,
+                                               cxxopts::Options& options,
+                                               int argc,
+                                               char** argv,
+                                               boost::property_tree::ptree* config,
+                                               const std::vector<double>* bbox = nullptr) {
+  try {
+    auto result = options.parse(argc, argv);
+    if (!parse_common_args(program, options, result, config))
+      return EXIT_SUCCESS;
+    if (bbox && (bbox->size() != 4 || (*bbox)[0] >= (*bbox)[2] || (*bbox)[1] >= (*bbox)[3])) {
+      throw cxxopts::exceptions::exception("A valid bounding box is required\n\n" +
+                                           options.help() + "\n\n");
+    }
+  } catch (cxxopts::exceptions::exception& e) {
+    std::cerr << e.what() << std::endl;
+    return EXIT_FAILURE;
+  } catch (std::exception& e) {
+    std::cerr << "Unable to parse command line options because: " << e.what() << "\n"
+              << "This is a bug, please report it at " PACKAGE_BUGREPORT << "\n";
+    return EXIT_FAILURE;
+  }
+  return std::nullopt;
+}
+
+/**
+ * Prints the results of a benchmark as a table. The first column is left aligned, the others are
+ * right aligned and floating point values are printed with a fixed number of decimals.
+ */
+class table_t {
+public:
+  /**
+   * @param columns    the title and width of each column
+   * @param precision  the decimals of floating point values
+   */
+  table_t(std::vector<std::pair<std::string, int>> columns, const int precision = 3)
+      : columns_(std::move(columns)), precision_(precision) {
+  }
+
+  /**
+   * Prints the titles of the columns
+   */
+  void header() const {
+    for (size_t column = 0; column < columns_.size(); ++column) {
+      cell(column, columns_[column].first);
+    }
+    std::cout << std::endl;
+  }
+
+  /**
+   * Prints a row, one value per column
+   */
+  template <typename... Values> void row(const Values&... values) const {
+    size_t column = 0;
+    std::cout << std::fixed << std::setprecision(precision_);
+    (cell(column++, values), ...);
+    std::cout << std::endl;
+  }
+
+protected:
+  template <typename Value> void cell(const size_t column, const Value& value) const {
+    std::cout << (column == 0 ? std::left : std::right) << std::setw(columns_[column].second)
+              << value;
+  }
+
+  std::vector<std::pair<std::string, int>> columns_;
+  int precision_;
+};
@@ -50,6 +50,9 @@ export class Actor {
   status(query: Query): Promise<Response>;
   status(query: string): Promise<string>;
 
+  accessibility(query: Query): Promise<Response>;
+  accessibility(query: string): Promise<string>;
+
   tile(query: Query | string): Promise<Buffer>;
 }
 
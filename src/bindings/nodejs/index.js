@@ -100,6 +100,10 @@ class Actor {
         return this._callActor('status', query);
     }
 
+    async accessibility(query) {
+        return this._callActor('accessibility', query);
+    }
+
     async tile(query) {
         // Tile always returns binary (MVT)
         if (typeof query === 'string') {
@@ -146,7 +146,9 @@ public:
                      InstanceMethod("transitAvailable", &Actor::TransitAvailable),
                      InstanceMethod("expansion", &Actor::Expansion),
                      InstanceMethod("centroid", &Actor::Centroid),
-                     InstanceMethod("status", &Actor::Status), InstanceMethod("tile", &Actor::Tile)});
+                     InstanceMethod("status", &Actor::Status),
+                     InstanceMethod("accessibility", &Actor::Accessibility),
+                     InstanceMethod("tile", &Actor::Tile)});
 
     // we don't need to delete it, it will be handled by Node
     Napi::FunctionReference* constructor = new Napi::FunctionReference();
@@ -289,6 +291,15 @@ private:
         "Status");
   }
 
+  Napi::Value Accessibility(const Napi::CallbackInfo& info) {
+    return CreateAsyncRequest(
+        info,
+        [](vt::actor_t* actor, const std::string& request) {
+          return actor->accessibility(request);
+        },
+        "Accessibility");
+  }
+
   Napi::Value Tile(const Napi::CallbackInfo& info) {
     Napi::Env env = info.Env();
     if (info.Length() < 1 || !info[0].IsString()) {
@@ -128,6 +128,11 @@ NB_MODULE(_valhalla, m) {
           "status", [](vt::actor_t& self, std::string& req) { return self.status(req); },
           "Returns nothing or optionally details about Valhalla's configuration.",
           nb::call_guard<nb::gil_scoped_release>())
+      .def(
+          "accessibility",
+          [](vt::actor_t& self, std::string& req) { return self.accessibility(req); },
+          "Scores how much of the road network and how many targets are reachable from each input location within each contour.",
+          nb::call_guard<nb::gil_scoped_release>())
       .def(
           "tile",
           [](vt::actor_t& self, std::string& req) -> nb::bytes {
@@ -93,6 +93,10 @@ class Actor(_Actor):
     def status(self, req: Union[str, dict] = "") -> Union[str, dict]:
         return super().status(req)
 
+    @dict_or_str
+    def accessibility(self, req: Union[str, dict]) -> Union[str, dict]:
+        return super().accessibility(req)
+
     def tile(self, req: Union[str, dict]) -> bytes:
         if isinstance(req, dict):
             return super().tile(json.dumps(req))
@@ -62,13 +62,20 @@ void loki_worker_t::isochrones(Api& request) {
 
   init_isochrones(request);
   auto& options = *request.mutable_options();
-  // check that location size does not exceed max
-  if (options.locations_size() > static_cast<int>(max_locations.find("isochrone")->second)) {
-    throw valhalla_exception_t{150, std::to_string(max_locations.find("isochrone")->second)};
-  };
+  // a batch has an isochrone per location so they can be as far apart as they like
+  if (options.batch()) {
+    if (options.locations_size() > static_cast<int>(max_batch_isochrone_locations)) {
+      throw valhalla_exception_t{150, std::to_string(max_batch_isochrone_locations)};
+    }
+  } else {
+    // check that location size does not exceed max
+    if (options.locations_size() > static_cast<int>(max_locations.find("isochrone")->second)) {
+      throw valhalla_exception_t{150, std::to_string(max_locations.find("isochrone")->second)};
+    };
 
-  // check the distances
-  check_distance(options.locations(), max_distance.find("isochrone")->second);
+    // check the distances
+    check_distance(options.locations(), max_distance.find("isochrone")->second);
+  }
 
   try {
     // correlate the various locations to the underlying graph
@@ -76,5 +83,38 @@ void loki_worker_t::isochrones(Api& request) {
   } catch (const std::exception&) { throw valhalla_exception_t{171}; }
 }
 
+void loki_worker_t::accessibility(Api& request) {
+  // time this whole method and save that statistic
+  auto _ = measure_scope_time(request);
+
+  init_isochrones(request);
+  auto& options = *request.mutable_options();
+  // every location is scored on its own like in a batch of isochrones
+  if (options.locations_size() > static_cast<int>(max_batch_isochrone_locations)) {
+    throw valhalla_exception_t{150, std::to_string(max_batch_isochrone_locations)};
+  }
+
+  // the targets are optional, they are the points to count within each contour
+  parse_locations(options.mutable_targets(), request, std::nullopt);
+  if (options.targets_size() > static_cast<int>(max_accessibility_targets)) {
+    throw valhalla_exception_t{176, std::to_string(max_accessibility_targets)};
+  }
+
+  // correlate the locations and the targets to the underlying graph
+  google::protobuf::RepeatedPtrField<Location> locations_targets;
+  locations_targets.MergeFrom(options.locations());
+  locations_targets.MergeFrom(options.targets());
+  try {
+    search_.search(locations_targets, mode_costing[static_cast<size_t>(mode)]);
+  } catch (const std::exception&) { throw valhalla_exception_t{171}; }
+  for (int i = 0; i < locations_targets.size(); ++i) {
+    if (i < options.locations_size()) {
+      options.mutable_locations(i)->CopyFrom(locations_targets[i]);
+    } else {
+      options.mutable_targets(i - options.locations_size())->CopyFrom(locations_targets[i]);
+    }
+  }
+}
+
 } // namespace loki
 } // namespace valhalla
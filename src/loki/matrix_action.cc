@@ -1,3 +1,4 @@
+#include "baldr/datetime.h"
 #include "loki/search.h"
 #include "loki/worker.h"
 
@@ -94,9 +95,36 @@ void loki_worker_t::matrix(Api& request) {
     throw valhalla_exception_t{140, Options_Action_Enum_Name(options.action())};
   };
 
-  // check that location size does not exceed max.
+  // a date_time range computes the matrix for every date_time in it. json requests are checked
+  // when parsed already but protobuf ones come straight here
+  size_t date_times = 1;
+  if (options.has_date_time_end_case()) {
+    if (options.date_time_type() != Options::depart_at &&
+        options.date_time_type() != Options::arrive_by)
+      throw valhalla_exception_t{169, "only sources_to_targets with a date_time type of 1 or 2"};
+    if (options.format() == Options::osrm || options.format() == Options::binary)
+      throw valhalla_exception_t{169, "not available in the osrm or binary format"};
+    if (!DateTime::is_iso_valid(options.date_time()) ||
+        !DateTime::is_iso_valid(options.date_time_end()))
+      throw valhalla_exception_t{162};
+    if (options.date_time_step() == 0)
+      throw valhalla_exception_t{169, "step must be positive"};
+    const auto begin = DateTime::get_formatted_date(options.date_time());
+    const auto end = DateTime::get_formatted_date(options.date_time_end());
+    if (end < begin)
+      throw valhalla_exception_t{169, "end is before value"};
+
+    // check that the range does not have too many date_times
+    date_times = (end - begin) / std::chrono::minutes(options.date_time_step()) + 1;
+    if (date_times > max_matrix_date_times) {
+      throw valhalla_exception_t{169, "exceeded the max of " +
+                                          std::to_string(max_matrix_date_times) + " date_times"};
+    }
+  }
+
+  // check that location size does not exceed max, every date_time of a range is a matrix
   auto max = max_matrix_locations.find(costing_name)->second;
-  if (options.sources_size() * options.targets_size() > max) {
+  if (options.sources_size() * options.targets_size() * date_times > max) {
     throw valhalla_exception_t{150, std::to_string(max)};
   };
 
@@ -42,6 +42,18 @@ void loki_worker_t::status(Api& request) const {
   }
 #endif
 
+  // pick up new tile extracts in all of this process's workers, if we are allowed to. this comes
+  // before the readiness check so that a reload can still be asked for while warming up
+  if (request.options().reload_tiles() && allow_reload) {
+    GraphReader::RequestReload();
+    reader->ReloadIfRequested();
+  }
+
+  // readiness probes can hold off until enough of the tiles are in memory
+  if (!GraphReader::WarmedUp()) {
+    throw valhalla_exception_t{177};
+  }
+
   // info that's always returned
   auto* status = request.mutable_status();
   status->set_version(VALHALLA_PRINT_VERSION);
@@ -50,6 +62,12 @@ void loki_worker_t::status(Api& request) const {
     auto* action_pbf = status->mutable_available_actions()->Add();
     *action_pbf = Options_Action_Enum_Name(action);
   }
+  if (reader->TileSetGeneration()) {
+    status->set_tileset_generation(reader->TileSetGeneration());
+  }
+  if (auto warm_up = GraphReader::WarmUpProgress(); warm_up < 1.f) {
+    status->set_tileset_warm_up(warm_up);
+  }
 
   // only return more info if explicitly asked for (can be very expensive)
   if (!request.options().verbose() || !allow_verbose)
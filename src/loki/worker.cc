@@ -286,6 +286,7 @@ loki_worker_t::loki_worker_t(const boost::property_tree::ptree& config,
     if (kv.first == "max_exclude_locations" || kv.first == "max_reachability" ||
         kv.first == "max_radius" || kv.first == "max_timedep_distance" ||
         kv.first == "max_timedep_distance_matrix" || kv.first == "max_alternates" ||
+        kv.first == "max_matrix_date_times" ||
         kv.first == "max_exclude_polygons_length" ||
         kv.first == "max_distance_disable_hierarchy_culling" || kv.first == "skadi" ||
         kv.first == "status" || kv.first == "allow_hard_exclusions" ||
@@ -359,7 +360,14 @@ loki_worker_t::loki_worker_t(const boost::property_tree::ptree& config,
   max_trace_alternates_shape = config.get<size_t>("service_limits.trace.max_alternates_shape");
   max_alternates = config.get<unsigned int>("service_limits.max_alternates");
   allow_verbose = config.get<bool>("service_limits.status.allow_verbose", false);
+  allow_reload = config.get<bool>("service_limits.status.allow_reload", false);
+  tileset_generation_ = reader->TileSetGeneration();
   max_timedep_dist_matrix = config.get<size_t>("service_limits.max_timedep_distance_matrix", 0);
+  max_matrix_date_times = config.get<size_t>("service_limits.max_matrix_date_times", 96);
+  max_batch_isochrone_locations =
+      config.get<size_t>("service_limits.isochrone.max_batch_locations", 1000);
+  max_accessibility_targets =
+      config.get<size_t>("service_limits.isochrone.max_accessibility_targets", 10000);
   // assign max_distance_disable_hierarchy_culling
   max_distance_disable_hierarchy_culling =
       config.get<float>("service_limits.max_distance_disable_hierarchy_culling", 0.f);
@@ -389,6 +397,15 @@ void loki_worker_t::set_interrupt(const std::function<void()>* interrupt_functio
   reader->SetInterrupt(interrupt);
 }
 
+void loki_worker_t::refresh_tileset() {
+  reader->ReloadIfRequested();
+  // the reader may be shared with another worker which already reloaded it
+  if (tileset_generation_ != reader->TileSetGeneration()) {
+    tileset_generation_ = reader->TileSetGeneration();
+    candidate_query_.Clear();
+  }
+}
+
 // Check if total arc distance exceeds the max distance limit for disable_hierarchy_pruning.
 // If true, add a warning and set the disable_hierarchy_pruning costing option to false.
 void loki_worker_t::check_hierarchy_distance(Api& request) {
@@ -463,6 +480,7 @@ loki_worker_t::work(const std::list<zmq::message_t>& job,
 
     // Set the interrupt function
     service_worker_t::set_interrupt(&interrupt_function);
+    refresh_tileset();
     // do request specific processing
     switch (options.action()) {
       case Options::route:
@@ -482,6 +500,10 @@ loki_worker_t::work(const std::list<zmq::message_t>& job,
         isochrones(request);
         result.messages.emplace_back(request.SerializeAsString());
         break;
+      case Options::accessibility:
+        accessibility(request);
+        result.messages.emplace_back(request.SerializeAsString());
+        break;
       case Options::trace_attributes:
       case Options::trace_route:
         trace(request);
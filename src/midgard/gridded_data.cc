@@ -0,0 +1,443 @@
+#include "midgard/gridded_data.h"
+
+#include <ankerl/unordered_dense.h>
+
+#include <atomic>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <thread>
+#include <unordered_map>
+
+namespace {
+
+using valhalla::midgard::PointLL;
+
+// A piece of an iso line crossing one triangle of a cell, oriented by the right-hand rule
+using segment_t = std::pair<PointLL, PointLL>;
+
+// In the tight loop below, we need to decide where a contour intersects the triangles that make
+// up the given tile. this works out to a number of discrete cases which we lookup using the table
+// below. based on the case we perform the appropriate intersection.
+constexpr int kCaseTable[3][3][3] = {
+    {{0, 0, 8}, {0, 2, 5}, {7, 6, 9}},
+    {{0, 3, 4}, {1, 0, 1}, {4, 3, 0}},
+    {{9, 6, 7}, {5, 2, 0}, {8, 0, 0}},
+};
+
+// swap_table indicates whether the (from_pt, to_pt) segment orientation should be changed or not
+// Lets take case_index=3: case[1][0][1] and case[1][2][1]. They correspond to the (0, -1, 0) and
+// (0, 1, 0) sh[] values respectively. Though both cases correspond to the case_value=3 but they
+// have different m1--m3 segment orientation.
+/*
+ *          sh[m2]=-1        |          sh[m2]=1
+ *           /\              |              /\
+ *          /  \             |             /  \
+ *         /    \            |            /    \
+ * sh[m1]=0 ----> sh[m3]=0   |    sh[m1]=0 <---- sh[m3]=0
+ */
+// This is needed to keep contours oriented correctly, according to the
+// right-hand rule:
+// "A linear ring MUST follow the right-hand rule with respect to the area it
+// bounds, i.e., exterior rings are counterclockwise, and holes are clockwise."  (c)
+// (c) https://tools.ietf.org/html/rfc7946#section-3.1.6
+constexpr bool kSwapTable[3][3][3] = {
+    {{false, false, true}, {false, true, true}, {true, false, false}},
+    {{false, true, false}, {true, false, false}, {true, false, false}},
+    {{true, true, false}, {false, false, false}, {false, false, false}},
+};
+
+// Runs work(i) for every i in [0, count) on up to concurrency threads, the calling thread being
+// one of them. The first exception any of them throws is rethrown once they are all done
+void parallel_for(const size_t count,
+                  const uint32_t concurrency,
+                  const std::function<void(size_t)>& work) {
+  const size_t thread_count = std::min<size_t>(std::max<uint32_t>(concurrency, 1), count);
+  if (thread_count <= 1) {
+    for (size_t i = 0; i < count; ++i) {
+      work(i);
+    }
+    return;
+  }
+
+  std::atomic<size_t> next(0);
+  std::atomic<bool> failed(false);
+  std::vector<std::exception_ptr> errors(thread_count);
+  auto run = [&](std::exception_ptr& error) {
+    try {
+      for (size_t i = next++; i < count && !failed; i = next++) {
+        work(i);
+      }
+    } catch (...) {
+      error = std::current_exception();
+      failed = true;
+    }
+  };
+  std::vector<std::thread> threads;
+  threads.reserve(thread_count - 1);
+  for (size_t i = 1; i < thread_count; ++i) {
+    threads.emplace_back(run, std::ref(errors[i]));
+  }
+  run(errors[0]);
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  for (const auto& error : errors) {
+    if (error) {
+      std::rethrow_exception(error);
+    }
+  }
+}
+
+} // namespace
+
+namespace valhalla {
+namespace midgard {
+
+template <std::size_t dimensions_t>
+typename GriddedData<dimensions_t>::contours_t
+GriddedData<dimensions_t>::GenerateContours(std::vector<contour_interval_t>& intervals,
+                                            const bool rings_only,
+                                            const float denoise,
+                                            const float generalize,
+                                            const uint32_t concurrency) const {
+  // sort the contours first on the metric index then on the values with the bigger contours first
+  std::sort(intervals.begin(), intervals.end(), std::greater<>());
+
+  // which metrics do we need contours for
+  std::vector<size_t> metrics;
+  for (const auto& interval : intervals) {
+    if (metrics.empty() || metrics.back() != std::get<0>(interval)) {
+      metrics.push_back(std::get<0>(interval));
+    }
+  }
+
+  // The cells are traced in bands of rows, skipping the outer rim since its out of bounds. Every
+  // band keeps the segments of each interval in the order its cells were scanned so that stitching
+  // the bands one after the other gives exactly the lines a single scan of the grid would give
+  const int rows = std::max(this->nrows_ - 2, 0);
+  const size_t band_count =
+      concurrency > 1 ? std::max<size_t>(std::min<size_t>(rows, concurrency * 4), 1) : 1;
+  const int band_rows = static_cast<int>((rows + band_count - 1) / band_count);
+  std::vector<std::vector<std::vector<segment_t>>>
+      segments(intervals.size(), std::vector<std::vector<segment_t>>(band_count));
+
+  // Traces the contour value through the 4 triangles of the cell whose bottom left corner is at
+  // tileid, appending the segments it finds
+  auto trace_cell = [this](int tileid, size_t metric_index, float contour_value,
+                           std::vector<segment_t>& out) {
+    // Values at tile corners and center (0 element is center)
+    int sh[5];
+    typename PointLL::first_type s[5]; // Values at the tile corners and center
+    PointLL tile_corners[5];           // PointLL at tile corners and center
+    const int tile_inc[4] = {0, 1, this->ncolumns_ + 1, this->ncolumns_};
+
+    // Find the intersection along a tile edge
+    auto intersect = [&tile_corners, &s](int p1, int p2) {
+      auto ds = s[p2] - s[p1];
+      auto x = (s[p2] * tile_corners[p1].first - s[p1] * tile_corners[p2].first) / ds;
+      auto y = (s[p2] * tile_corners[p1].second - s[p1] * tile_corners[p2].second) / ds;
+      // we round here because connecting the cell line segments requires finding points via
+      // equality on some platforms the intersection arithmetic for adjacent cells results in
+      // floating point noise that differs for the intersection point on either side of the cell
+      // boundary, snapping to centimeter resolution lets us get usable results on those platforms
+      // (eg. aarch64)
+      return PointLL(std::round(x * 1e7) / 1e7, std::round(y * 1e7) / 1e7);
+    };
+
+    for (int m = 4; m > 0; m--) {
+      int newtileid = tileid + tile_inc[m - 1];
+      // Make sure the tile corner value is not set to the max_value
+      // (messes up the intersect method). Set a value slightly above
+      // the contour (e.g. 1 minute higher).
+      // TODO - the value 1 is a bit of a hack.
+      float nd = data_[newtileid][metric_index];
+      s[m] = nd < max_value_[metric_index] ? nd - contour_value : 1.0f;
+      tile_corners[m] = this->Base(newtileid);
+      sh[m] = (s[m] > 0.0f) - (s[m] < 0.0f); // pos = 1, neg = -1, 0 = 0
+    }
+    s[0] = 0.25 * (s[1] + s[2] + s[3] + s[4]);
+    tile_corners[0] = this->Center(tileid);
+    sh[0] = (s[0] > 0.0f) - (s[0] < 0.0f); // pos = 1, neg = -1, 0 = 0
+
+    /*
+     Note: at this stage the relative heights of the corners and the
+     centre are in the h array, and the corresponding coordinates are
+     in the xh and yh arrays. The centre of the box is indexed by 0
+     and the 4 corners by 1 to 4 as shown below.
+     Each triangle is then indexed by the parameter m, and the 3
+     vertices of each triangle are indexed by parameters m1,m2,and m3.
+     It is assumed that the centre of the box is always vertex 2
+     though this is important only when all 3 vertices lie exactly on
+     the same contour level, in which case only the side of the box
+     is drawn.
+        vertex 4 +-------------------+ vertex 3
+                 | \               / |
+                 |   \    m-3    /   |
+                 |     \       /     |
+                 |       \   /       |
+                 |  m=2    X   m=2   |       the centre is vertex 0
+                 |       /   \       |
+                 |     /       \     |
+                 |   /    m=1    \   |
+                 | /               \ |
+        vertex 1 +-------------------+ vertex 2
+    */
+
+    // Scan each triangle in the box
+    for (int m = 1; m <= 4; m++) {
+      // figure out which intersection we need to do
+      const int m1 = m;
+      const int m2 = 0;
+      const int m3 = (m != 4) ? m + 1 : 1;
+      int case_index = kCaseTable[sh[m1] + 1][sh[m2] + 1][sh[m3] + 1];
+      bool swap_points = kSwapTable[sh[m1] + 1][sh[m2] + 1][sh[m3] + 1];
+
+      PointLL from_pt, to_pt;
+      switch (case_index) {
+        // there is no intersection of this triangle
+        case 0:
+          continue;
+        // Line between vertices 1 and 2
+        case 1:
+          from_pt = tile_corners[m1];
+          to_pt = tile_corners[m2];
+          break;
+        // Line between vertices 2 and 3
+        case 2:
+          from_pt = tile_corners[m2];
+          to_pt = tile_corners[m3];
+          break;
+        // Line between vertices 3 and 1
+        case 3:
+          from_pt = tile_corners[m3];
+          to_pt = tile_corners[m1];
+          break;
+        // Line between vertex 1 and side 2-3
+        case 4:
+          from_pt = tile_corners[m1];
+          to_pt = intersect(m2, m3);
+          break;
+        // Line between vertex 2 and side 3-1
+        case 5:
+          from_pt = tile_corners[m2];
+          to_pt = intersect(m3, m1);
+          break;
+        // Line between vertex 3 and side 1-2
+        case 6:
+          from_pt = tile_corners[m3];
+          to_pt = intersect(m1, m2);
+          break;
+        // Line between sides 1-2 and 2-3
+        case 7:
+          from_pt = intersect(m1, m2);
+          to_pt = intersect(m2, m3);
+          break;
+        // Line between sides 2-3 and 3-1
+        case 8:
+          from_pt = intersect(m2, m3);
+          to_pt = intersect(m3, m1);
+          break;
+        // Line between sides 3-1 and 1-2
+        case 9:
+          from_pt = intersect(m3, m1);
+          to_pt = intersect(m1, m2);
+          break;
+      }
+
+      // this isnt a segment..
+      if (from_pt == to_pt) {
+        continue;
+      }
+      if (swap_points) {
+        std::swap(from_pt, to_pt);
+      }
+      out.emplace_back(from_pt, to_pt);
+    }
+  };
+
+  parallel_for(band_count, concurrency, [&](size_t band) {
+    const int ncolumns = this->ncolumns_;
+    // A row of cells is scanned a metric at a time: the values along its bottom and top edges are
+    // copied out of the grid so that finding the extremes of every cell is a simple loop over
+    // contiguous floats, only the cells which the contour value falls into are traced
+    std::vector<float> lower(ncolumns), upper(ncolumns), column_min(ncolumns),
+        column_max(ncolumns), cell_min(ncolumns), cell_max(ncolumns);
+    std::vector<uint8_t> crossed(ncolumns);
+    const int row_begin = 1 + static_cast<int>(band) * band_rows;
+    const int row_end = std::min(row_begin + band_rows, this->nrows_ - 1);
+    for (int row = row_begin; row < row_end; ++row) {
+      const auto* bottom = &data_[this->TileId(0, row)];
+      const auto* top = bottom + ncolumns;
+      for (size_t metric_index : metrics) {
+        for (int col = 0; col < ncolumns; ++col) {
+          lower[col] = bottom[col][metric_index];
+          upper[col] = top[col][metric_index];
+        }
+        for (int col = 0; col < ncolumns; ++col) {
+          column_min[col] = std::min(lower[col], upper[col]);
+          column_max[col] = std::max(lower[col], upper[col]);
+        }
+        for (int col = 1; col < ncolumns - 1; ++col) {
+          cell_min[col] = std::min(column_min[col], column_min[col + 1]);
+          cell_max[col] = std::max(column_max[col], column_max[col + 1]);
+        }
+
+        // For each requested contour value of this metric
+        for (size_t i = 0; i < intervals.size(); ++i) {
+          if (std::get<0>(intervals[i]) != metric_index) {
+            continue;
+          }
+          const float contour_value = std::get<1>(intervals[i]);
+          for (int col = 1; col < ncolumns - 1; ++col) {
+            crossed[col] = (contour_value >= cell_min[col]) & (contour_value <= cell_max[col]);
+          }
+          auto& out = segments[i][band];
+          for (int col = 1; col < ncolumns - 1; ++col) {
+            if (crossed[col]) {
+              trace_cell(this->TileId(col, row), metric_index, contour_value, out);
+            }
+          }
+        }
+      }
+    }
+  });
+
+  // If the generalization value equals kOptimalGeneralization then set
+  // the generalization factor to 1/4 of the grid size
+  float gen_factor = generalize;
+  if (generalize == kOptimalGeneralization) {
+    gen_factor = this->tilesize_ * 0.25f * kMetersPerDegreeLat;
+  }
+
+  // some info about the area the image covers
+  auto h = this->tilesize_ / 2;
+
+  // we need something to hold each iso-line
+  contours_t contours(intervals.size(), std::list<feature_t>{feature_t{}});
+  parallel_for(intervals.size(), concurrency, [&](size_t i) {
+    auto& collection = contours[i];
+    auto& contour = collection.front();
+
+    // the lines in the order they were started, the ones merged into another are left empty
+    std::vector<contour_t> lines;
+    std::vector<bool> merged;
+    // store begins and ends of the segments separately not to loose segment orientation
+    ankerl::unordered_dense::map<PointLL, uint32_t> begin_lookup, end_lookup;
+    for (const auto& band : segments[i]) {
+      for (const auto& segment : band) {
+        const auto& from_pt = segment.first;
+        const auto& to_pt = segment.second;
+
+        // see if we have anything to connect this segment to
+        auto end_lookup_it = end_lookup.find(from_pt);
+        auto begin_lookup_it = begin_lookup.find(to_pt);
+
+        if (end_lookup_it != end_lookup.end() && begin_lookup_it != begin_lookup.end()) {
+          // we want to merge two records
+          //   first_segment                               second_segment
+          // (... ------> from_pt) + (from_pt, to_pt) + (to_pt ------> ...)
+          auto first_segment = end_lookup_it->second;
+          auto second_segment = begin_lookup_it->second;
+          end_lookup.erase(end_lookup_it);
+          begin_lookup.erase(begin_lookup_it);
+
+          // this segment is now a ring
+          if (first_segment == second_segment) {
+            lines[first_segment].push_back(lines[first_segment].front());
+            continue;
+          }
+
+          end_lookup[lines[second_segment].back()] = first_segment;
+          lines[first_segment].splice(lines[first_segment].end(), lines[second_segment]);
+          merged[second_segment] = true;
+        } else if (end_lookup_it != end_lookup.end()) {
+          // (... ------> from_pt) + (from_pt, to_pt)
+          auto line = end_lookup_it->second;
+          lines[line].push_back(to_pt);
+          end_lookup.erase(end_lookup_it);
+          end_lookup.emplace(to_pt, line);
+        } else if (begin_lookup_it != begin_lookup.end()) {
+          // (from_pt, to_pt) + (to_pt ------> ...)
+          auto line = begin_lookup_it->second;
+          lines[line].push_front(from_pt);
+          begin_lookup.erase(begin_lookup_it);
+          begin_lookup.emplace(from_pt, line);
+        } else {
+          // this is an orphan segment for now
+          lines.push_back(contour_t{from_pt, to_pt});
+          merged.push_back(false);
+          begin_lookup.emplace(from_pt, lines.size() - 1);
+          end_lookup.emplace(to_pt, lines.size() - 1);
+        }
+      }
+    }
+    std::vector<std::vector<segment_t>>().swap(segments[i]);
+
+    // the newest lines come first
+    for (size_t line = lines.size(); line > 0; --line) {
+      if (!merged[line - 1]) {
+        contour.push_back(std::move(lines[line - 1]));
+      }
+    }
+
+    // they only wanted rings
+    if (rings_only) {
+      contour.remove_if([](const contour_t& line) { return line.front() != line.back(); });
+    }
+    // sort them by area (maybe length would be sufficient?) biggest first
+    std::unordered_map<const contour_t*, typename PointLL::first_type> cache(contour.size());
+    std::for_each(contour.cbegin(), contour.cend(),
+                  [&cache](const contour_t& c) { cache[&c] = polygon_area(c); });
+    contour.sort([&cache](const contour_t& a, const contour_t& b) {
+      return std::abs(cache[&a]) > std::abs(cache[&b]);
+    });
+
+    // they only want the most significant ones!
+    if (denoise > 0.f) {
+      contour.remove_if([&cache, &contour, denoise](const contour_t& c) {
+        return std::abs(cache[&c] / cache[&contour.front()]) < denoise;
+      });
+    }
+    // clean up the lines
+    for (auto& line : contour) {
+      if (gen_factor > 0.f) {
+        Polyline2<PointLL>::Generalize(line, gen_factor, {}, /* avoid_self_intersections */ true);
+      }
+      // sampling the bottom left corner means everything is skewed, so unskew it
+      for (auto& coord : line) {
+        coord.first += h;
+        coord.second += h;
+      }
+    }
+    // remove points and lines
+    contour.remove_if([](const contour_t& line) { return line.size() < 4; });
+
+    // if they just wanted linestrings we need only one per feature
+    if (!rings_only) {
+      for (auto& linestring : contour) {
+        collection.push_back({std::move(linestring)});
+      }
+      collection.pop_front();
+    }
+  });
+
+  return contours;
+}
+
+// Explicit instantiations
+template GriddedData<1>::contours_t
+GriddedData<1>::GenerateContours(std::vector<contour_interval_t>&,
+                                 const bool,
+                                 const float,
+                                 const float,
+                                 const uint32_t) const;
+template GriddedData<2>::contours_t
+GriddedData<2>::GenerateContours(std::vector<contour_interval_t>&,
+                                 const bool,
+                                 const float,
+                                 const float,
+                                 const uint32_t) const;
+
+} // namespace midgard
+} // namespace valhalla
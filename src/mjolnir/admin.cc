@@ -5,6 +5,7 @@
 #include <geos_c.h>
 #include <sqlite3.h>
 
+#include <algorithm>
 #include <unordered_map>
 
 using namespace valhalla::baldr;
@@ -19,6 +20,70 @@ namespace {
 // geometry is clipped, a small buffer around should be added to handle edge cases.
 constexpr double kTileBboxBuffer = 1e-3;
 
+// How deep the polygon index may split a tile, 6 levels are 64x64 cells of ~400m on a local tile
+constexpr uint32_t kPolygonIndexMaxDepth = 6;
+// How many points have to fall into a cell with crossing polygons before it's split
+constexpr uint32_t kPolygonIndexSplitLookups = 4;
+
+enum class BoxRelation { kDisjoint, kCrossing, kCovered };
+
+// Classifies the polygon against the box. GEOS errors are treated as crossing so that the points in
+// the box still get tested individually.
+BoxRelation relate(const Geometry& poly, const AABB2<PointLL>& box) {
+  auto* context = poly.context.get();
+  auto* coords = GEOSCoordSeq_create_r(context, 5, 2);
+  const double xs[] = {box.minx(), box.maxx(), box.maxx(), box.minx(), box.minx()};
+  const double ys[] = {box.miny(), box.miny(), box.maxy(), box.maxy(), box.miny()};
+  for (unsigned int i = 0; i < 5; ++i) {
+    GEOSCoordSeq_setX_r(context, coords, i, xs[i]);
+    GEOSCoordSeq_setY_r(context, coords, i, ys[i]);
+  }
+  auto* shell = GEOSGeom_createLinearRing_r(context, coords);
+  auto* rect = GEOSGeom_createPolygon_r(context, shell, nullptr, 0);
+
+  auto relation = BoxRelation::kCrossing;
+  if (GEOSPreparedCovers_r(context, poly.prepared, rect) == 1) {
+    relation = BoxRelation::kCovered;
+  } else if (GEOSPreparedIntersects_r(context, poly.prepared, rect) == 0) {
+    relation = BoxRelation::kDisjoint;
+  }
+  GEOSGeom_destroy_r(context, rect);
+  return relation;
+}
+
+// The bounding box of the polygon, everything if GEOS can't tell
+AABB2<PointLL> envelope(const Geometry& poly) {
+  auto* context = poly.context.get();
+  double minx, miny, maxx, maxy;
+  if (GEOSisEmpty_r(context, poly.geometry) != 0 ||
+      GEOSGeom_getXMin_r(context, poly.geometry, &minx) == 0 ||
+      GEOSGeom_getYMin_r(context, poly.geometry, &miny) == 0 ||
+      GEOSGeom_getXMax_r(context, poly.geometry, &maxx) == 0 ||
+      GEOSGeom_getYMax_r(context, poly.geometry, &maxy) == 0) {
+    return {-180., -90., 180., 90.};
+  }
+  return {minx, miny, maxx, maxy};
+}
+
+// Adds the languages of a polygon covering the point to the languages found so far
+void AddLanguages(std::vector<std::pair<std::string, bool>>& languages,
+                  const std::vector<std::string>& langs,
+                  bool is_default) {
+  for (const auto& l : langs) {
+    if (stringLanguage(l) != Language::kNone) {
+      auto needle =
+          std::find_if(languages.begin(), languages.end(),
+                       [&l](const std::pair<std::string, bool>& p) { return p.first == l; });
+
+      if (needle == languages.end()) {
+        languages.emplace_back(l, is_default);
+      } else if (is_default) { // fr - nl or fr;en in default lang column
+        needle->second = false;
+      }
+    }
+  }
+}
+
 } // namespace
 
 Geometry::Geometry(geos_context_type ctx, GEOSGeometry* geom)
@@ -119,20 +184,150 @@ std::vector<std::pair<std::string, bool>> GetMultiPolyIndexes(const language_pol
 
   for (const auto& [poly, langs, is_default] : polys) {
     if (poly.intersects(ll)) {
-      for (const auto& l : langs) {
-        if (stringLanguage(l) != Language::kNone) {
-          auto needle =
-              std::find_if(languages.begin(), languages.end(),
-                           [&l](const std::pair<std::string, bool>& p) { return p.first == l; });
-
-          if (needle == languages.end()) {
-            languages.emplace_back(l, is_default);
-          } else if (is_default) { // fr - nl or fr;en in default lang column
-            needle->second = false;
-          }
+      AddLanguages(languages, langs, is_default);
+    }
+  }
+
+  return languages;
+}
+
+PolygonIndex::PolygonIndex(const std::multimap<uint32_t, Geometry>& polys,
+                           const AABB2<PointLL>& bbox) {
+  for (const auto& [key, poly] : polys) {
+    polys_.emplace_back(key, &poly);
+  }
+  init(bbox);
+}
+
+PolygonIndex::PolygonIndex(const language_poly_index& polys, const AABB2<PointLL>& bbox) {
+  for (const auto& poly : polys) {
+    polys_.emplace_back(static_cast<uint32_t>(polys_.size()), &std::get<0>(poly));
+  }
+  init(bbox);
+}
+
+void PolygonIndex::init(const AABB2<PointLL>& bbox) {
+  envelopes_.reserve(polys_.size());
+  for (const auto& poly : polys_) {
+    envelopes_.push_back(envelope(*poly.second));
+  }
+
+  // the tile itself starts out with every polygon crossing it, classifying them is deferred to
+  // the first split so that tiles with a single node don't pay for it
+  cells_.push_back({bbox, {}, {}, 0, 0, 0});
+  for (uint32_t i = 0; i < polys_.size(); ++i) {
+    cells_.back().crossing.push_back(i);
+  }
+}
+
+void PolygonIndex::split(uint32_t cell) {
+  const auto bbox = cells_[cell].bbox;
+  const double midx = (bbox.minx() + bbox.maxx()) / 2;
+  const double midy = (bbox.miny() + bbox.maxy()) / 2;
+  // sw, se, nw, ne so that the child is at (x >= midx) + 2 * (y >= midy)
+  const AABB2<PointLL> boxes[] = {{bbox.minx(), bbox.miny(), midx, midy},
+                                  {midx, bbox.miny(), bbox.maxx(), midy},
+                                  {bbox.minx(), midy, midx, bbox.maxy()},
+                                  {midx, midy, bbox.maxx(), bbox.maxy()}};
+
+  const auto first = static_cast<uint32_t>(cells_.size());
+  for (const auto& box : boxes) {
+    cell_t child{box, cells_[cell].covering, {}, 0, cells_[cell].depth + 1, 0};
+    for (auto i : cells_[cell].crossing) {
+      if (!envelopes_[i].Intersects(box)) {
+        continue;
+      }
+      switch (relate(*polys_[i].second, box)) {
+        case BoxRelation::kCovered:
+          child.covering.push_back(i);
+          break;
+        case BoxRelation::kCrossing:
+          child.crossing.push_back(i);
+          break;
+        case BoxRelation::kDisjoint:
+          break;
+      }
+    }
+    cells_.push_back(std::move(child));
+  }
+  cells_[cell].children = first;
+}
+
+const std::vector<uint32_t>& PolygonIndex::intersecting(const PointLL& ll) {
+  positions_.clear();
+
+  // points off the tile can't be answered by the cells, check them against everything
+  const auto& root = cells_.front().bbox;
+  if (ll.lng() < root.minx() || ll.lng() > root.maxx() || ll.lat() < root.miny() ||
+      ll.lat() > root.maxy()) {
+    for (uint32_t i = 0; i < polys_.size(); ++i) {
+      if (polys_[i].second->intersects(ll)) {
+        positions_.push_back(i);
+      }
+    }
+  } else {
+    // find the leaf the point is in, splitting it if it gets enough points to be worth it. the
+    // cells are closed so a point on the edge between two of them can go in either
+    uint32_t cell = 0;
+    while (true) {
+      if (!cells_[cell].children) {
+        if (cells_[cell].crossing.empty() || cells_[cell].depth >= kPolygonIndexMaxDepth ||
+            ++cells_[cell].lookups < kPolygonIndexSplitLookups) {
+          break;
         }
+        split(cell);
+      }
+      const auto& bbox = cells_[cell].bbox;
+      cell = cells_[cell].children + (ll.lng() >= (bbox.minx() + bbox.maxx()) / 2) +
+             2 * (ll.lat() >= (bbox.miny() + bbox.maxy()) / 2);
+    }
+
+    // only the polygons crossing the cell need the actual test
+    const auto& leaf = cells_[cell];
+    positions_ = leaf.covering;
+    for (auto i : leaf.crossing) {
+      if (polys_[i].second->intersects(ll)) {
+        positions_.push_back(i);
       }
     }
+    std::sort(positions_.begin(), positions_.end());
+  }
+
+  keys_.clear();
+  for (auto i : positions_) {
+    keys_.push_back(polys_[i].first);
+  }
+  return keys_;
+}
+
+uint32_t GetMultiPolyId(PolygonIndex& index, const PointLL& ll, GraphTileBuilder& graphtile) {
+  uint32_t id = 0;
+  for (auto key : index.intersecting(ll)) {
+    const auto& admin = graphtile.admins_builder(key);
+    if (!admin.state_offset())
+      id = key;
+    else
+      return key;
+  }
+  return id;
+}
+
+uint32_t GetMultiPolyId(PolygonIndex& index, const PointLL& ll) {
+  const auto& keys = index.intersecting(ll);
+  return keys.empty() ? 0 : keys.front();
+}
+
+std::vector<std::pair<std::string, bool>> GetMultiPolyIndexes(const language_poly_index& polys,
+                                                              PolygonIndex& index,
+                                                              const PointLL& ll) {
+  std::vector<std::pair<std::string, bool>> languages;
+
+  // first entry is blank for the default name
+  languages.emplace_back("", false);
+
+  for (auto position : index.intersecting(ll)) {
+    const auto& [poly, langs, is_default] = polys[position];
+    AddLanguages(languages, langs, is_default);
   }
 
   return languages;
@@ -4,6 +4,7 @@
 #include "mjolnir/adminconstants.h"
 #include "mjolnir/pbfadminparser.h"
 #include "mjolnir/sqlite3.h"
+#include "scoped_timer.h"
 
 #include <boost/geometry/algorithms/area.hpp>
 #include <boost/geometry/algorithms/covered_by.hpp>
@@ -12,9 +13,16 @@
 #include <geos_c.h>
 #include <sqlite3.h>
 
+#include <algorithm>
 #include <cstdint>
+#include <deque>
 #include <filesystem>
+#include <future>
+#include <list>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <thread>
 #include <vector>
 
 // For OSM pbf reader
@@ -24,35 +32,42 @@ using namespace valhalla::midgard;
 
 namespace {
 
+// How many admins each thread builds the geometry of per batch
+constexpr size_t kAdminsPerThreadBatch = 16;
+
 /**
- * a simple singleton to wrap geos setup and tear down as well as conversion to and from boost types
+ * a simple per thread singleton to wrap the setup and tear down of a reentrant geos context as well
+ * as conversion to and from boost types. each thread gets its own context so that admin geometries
+ * can be built in parallel
  */
 struct geos_helper_t {
-  static const geos_helper_t& get() {
-    static geos_helper_t singleton;
-    return singleton;
+  static GEOSContextHandle_t get() {
+    thread_local geos_helper_t singleton;
+    return singleton.context;
   }
   template <typename striped_container_t>
-  static GEOSGeometry* from_striped_container(const striped_container_t& coords) {
+  static GEOSGeometry* from_striped_container(GEOSContextHandle_t context,
+                                              const striped_container_t& coords) {
     // sadly we dont layout the memory in parallel arrays so we have to copy to geos
-    GEOSCoordSequence* geos_coords = GEOSCoordSeq_create(coords.size(), 2);
+    GEOSCoordSequence* geos_coords = GEOSCoordSeq_create_r(context, coords.size(), 2);
     for (unsigned int i = 0; i < static_cast<unsigned int>(coords.size()); ++i) {
-      GEOSCoordSeq_setX(geos_coords, i, coords[i].first);
-      GEOSCoordSeq_setY(geos_coords, i, coords[i].second);
+      GEOSCoordSeq_setX_r(context, geos_coords, i, coords[i].first);
+      GEOSCoordSeq_setY_r(context, geos_coords, i, coords[i].second);
     }
-    return GEOSGeom_createLinearRing(geos_coords);
+    return GEOSGeom_createLinearRing_r(context, geos_coords);
   }
   template <typename striped_container_t>
-  static striped_container_t to_striped_container(const GEOSGeometry* geometry) {
+  static striped_container_t to_striped_container(GEOSContextHandle_t context,
+                                                  const GEOSGeometry* geometry) {
     // sadly we dont layout the memory in parallel arrays so we have to copy from geos
-    auto* coords = GEOSGeom_getCoordSeq(geometry);
+    auto* coords = GEOSGeom_getCoordSeq_r(context, geometry);
     unsigned int coords_size;
-    GEOSCoordSeq_getSize(coords, &coords_size);
+    GEOSCoordSeq_getSize_r(context, coords, &coords_size);
     striped_container_t container;
     container.resize(coords_size);
     for (unsigned int i = 0; i < coords_size; ++i) {
-      GEOSCoordSeq_getX(coords, i, &container[i].first);
-      GEOSCoordSeq_getY(coords, i, &container[i].second);
+      GEOSCoordSeq_getX_r(context, coords, i, &container[i].first);
+      GEOSCoordSeq_getY_r(context, coords, i, &container[i].second);
     }
     return container;
   }
@@ -64,12 +79,14 @@ protected:
     vprintf(fmt, ap);
     va_end(ap);
   }
-  geos_helper_t() {
-    initGEOS(message_handler, message_handler);
+  geos_helper_t() : context(GEOS_init_r()) {
+    GEOSContext_setNoticeHandler_r(context, message_handler);
+    GEOSContext_setErrorHandler_r(context, message_handler);
   }
   ~geos_helper_t() {
-    finishGEOS();
+    GEOS_finish_r(context);
   }
+  GEOSContextHandle_t context;
 };
 
 /**
@@ -82,30 +99,31 @@ protected:
 void buffer_ring(const bg::ring_ll_t& ring,
                  std::vector<bg::ring_ll_t>& rings,
                  std::vector<bg::ring_ll_t>& inners) {
+  auto* context = geos_helper_t::get();
   // for collecting polygons
   auto add = [&](auto* geos_poly) {
-    rings.emplace_back(
-        geos_helper_t::to_striped_container<bg::ring_ll_t>(GEOSGetExteriorRing(geos_poly)));
-    for (int i = 0; i < GEOSGetNumInteriorRings(geos_poly); ++i) {
-      auto* inner = GEOSGetInteriorRingN(geos_poly, i);
-      inners.push_back(geos_helper_t::to_striped_container<bg::ring_ll_t>(inner));
+    rings.emplace_back(geos_helper_t::to_striped_container<bg::ring_ll_t>(
+        context, GEOSGetExteriorRing_r(context, geos_poly)));
+    for (int i = 0; i < GEOSGetNumInteriorRings_r(context, geos_poly); ++i) {
+      auto* inner = GEOSGetInteriorRingN_r(context, geos_poly, i);
+      inners.push_back(geos_helper_t::to_striped_container<bg::ring_ll_t>(context, inner));
     }
   };
 
-  auto* outer_ring = geos_helper_t::from_striped_container(ring);
-  auto* geos_poly = GEOSGeom_createPolygon(outer_ring, nullptr, 0);
-  auto* buffered = GEOSBuffer(geos_poly, 0, 8);
-  GEOSNormalize(buffered);
-  auto geom_type = GEOSGeomTypeId(buffered);
+  auto* outer_ring = geos_helper_t::from_striped_container(context, ring);
+  auto* geos_poly = GEOSGeom_createPolygon_r(context, outer_ring, nullptr, 0);
+  auto* buffered = GEOSBuffer_r(context, geos_poly, 0, 8);
+  GEOSNormalize_r(context, buffered);
+  auto geom_type = GEOSGeomTypeId_r(context, buffered);
   switch (geom_type) {
     case GEOS_POLYGON: {
       add(buffered);
       break;
     }
     case GEOS_MULTIPOLYGON: {
-      for (int i = 0; i < GEOSGetNumGeometries(buffered); ++i) {
-        auto* geom = GEOSGetGeometryN(buffered, i);
-        if (GEOSGeomTypeId(geom) != GEOS_POLYGON)
+      for (int i = 0; i < GEOSGetNumGeometries_r(context, buffered); ++i) {
+        auto* geom = GEOSGetGeometryN_r(context, buffered, i);
+        if (GEOSGeomTypeId_r(context, geom) != GEOS_POLYGON)
           throw std::runtime_error("Unusable geometry type after buffering");
         add(geom);
       }
@@ -114,8 +132,8 @@ void buffer_ring(const bg::ring_ll_t& ring,
     default:
       throw std::runtime_error("Unusable geometry type after buffering");
   }
-  GEOSGeom_destroy(geos_poly);
-  GEOSGeom_destroy(buffered);
+  GEOSGeom_destroy_r(context, geos_poly);
+  GEOSGeom_destroy_r(context, buffered);
 }
 
 /**
@@ -123,17 +141,19 @@ void buffer_ring(const bg::ring_ll_t& ring,
  * @param multipolygon  any resulting polygons are output here
  */
 void buffer_polygon(const bg::polygon_ll_t& polygon, bg::multipolygon_ll_t& multipolygon) {
+  auto* context = geos_helper_t::get();
   // for collecting polygons
   auto add = [&](auto* geos_poly) {
     auto& poly = *multipolygon.emplace(multipolygon.end());
-    poly.outer() = geos_helper_t::to_striped_container<bg::ring_ll_t>(GEOSGetExteriorRing(geos_poly));
-    for (int i = 0; i < GEOSGetNumInteriorRings(geos_poly); ++i) {
-      auto* inner = GEOSGetInteriorRingN(geos_poly, i);
-      poly.inners().push_back(geos_helper_t::to_striped_container<bg::ring_ll_t>(inner));
+    poly.outer() = geos_helper_t::to_striped_container<bg::ring_ll_t>(
+        context, GEOSGetExteriorRing_r(context, geos_poly));
+    for (int i = 0; i < GEOSGetNumInteriorRings_r(context, geos_poly); ++i) {
+      auto* inner = GEOSGetInteriorRingN_r(context, geos_poly, i);
+      poly.inners().push_back(geos_helper_t::to_striped_container<bg::ring_ll_t>(context, inner));
     }
   };
 
-  auto* outer_ring = geos_helper_t::from_striped_container(polygon.outer());
+  auto* outer_ring = geos_helper_t::from_striped_container(context, polygon.outer());
   std::vector<GEOSGeometry*> inner_rings;
   inner_rings.reserve(polygon.inners().size());
 
@@ -142,21 +162,22 @@ void buffer_polygon(const bg::polygon_ll_t& polygon, bg::multipolygon_ll_t& mult
   auto unused_size = std::to_string(polygon.inners().size());
 
   for (const auto& inner : polygon.inners()) {
-    inner_rings.push_back(geos_helper_t::from_striped_container(inner));
+    inner_rings.push_back(geos_helper_t::from_striped_container(context, inner));
   }
-  auto* geos_poly = GEOSGeom_createPolygon(outer_ring, &inner_rings.front(), inner_rings.size());
-  auto* buffered = GEOSBuffer(geos_poly, 0, 8);
-  GEOSNormalize(buffered);
-  auto geom_type = GEOSGeomTypeId(buffered);
+  auto* geos_poly =
+      GEOSGeom_createPolygon_r(context, outer_ring, &inner_rings.front(), inner_rings.size());
+  auto* buffered = GEOSBuffer_r(context, geos_poly, 0, 8);
+  GEOSNormalize_r(context, buffered);
+  auto geom_type = GEOSGeomTypeId_r(context, buffered);
   switch (geom_type) {
     case GEOS_POLYGON: {
       add(buffered);
       break;
     }
     case GEOS_MULTIPOLYGON: {
-      for (int i = 0; i < GEOSGetNumGeometries(buffered); ++i) {
-        auto* geom = GEOSGetGeometryN(buffered, i);
-        if (GEOSGeomTypeId(geom) != GEOS_POLYGON)
+      for (int i = 0; i < GEOSGetNumGeometries_r(context, buffered); ++i) {
+        auto* geom = GEOSGetGeometryN_r(context, buffered, i);
+        if (GEOSGeomTypeId_r(context, geom) != GEOS_POLYGON)
           throw std::runtime_error("Unusable geometry type after buffering");
         add(geom);
       }
@@ -166,8 +187,8 @@ void buffer_polygon(const bg::polygon_ll_t& polygon, bg::multipolygon_ll_t& mult
       throw std::runtime_error("Unusable geometry type after buffering with inners size " +
                                unused_size);
   }
-  GEOSGeom_destroy(geos_poly);
-  GEOSGeom_destroy(buffered);
+  GEOSGeom_destroy_r(context, geos_poly);
+  GEOSGeom_destroy_r(context, buffered);
 }
 
 /**
@@ -352,6 +373,235 @@ bg::multipolygon_ll_t to_multipolygon(const std::pair<std::string, uint64_t>& ad
   return multipolygon;
 }
 
+/**
+ * Builds the multipolygon of an admin from its members
+ * @param admin_data  used to look up ways shape (nodes)
+ * @param admin       the admin for which we are building the multipolygon
+ * @return the wkt of the multipolygon or an empty string if the admin is degenerate
+ */
+std::string to_wkt(const OSMAdminData& admin_data, const OSMAdmin& admin) {
+  std::pair<std::string, uint64_t> admin_info(admin_data.name_offset_map.name(admin.name_index),
+                                              admin.id);
+  LOG_DEBUG("Building admin: " + admin_info.first);
+
+  // do inners and outers separately
+  bool complete = true;
+  std::array<std::vector<bg::ring_ll_t>, 2> outers_inners;
+  for (bool outer : {true, false}) {
+    // grab the ring segments and a lookup to find them when connecting them
+    std::vector<bg::ring_ll_t> lines;
+    std::unordered_multimap<valhalla::midgard::PointLL, size_t> line_lookup;
+    if (!to_segments(admin_data, admin, admin_info.first, outer, lines, line_lookup)) {
+      complete = false;
+      break;
+    }
+    // connect them into a series of one or more rings
+    to_rings(admin_info, lines, line_lookup, outers_inners[!outer], outers_inners[1]);
+  }
+
+  // if we didn't have a complete relation (ie some members were missing) we bail
+  if (!complete || outers_inners.front().empty()) {
+    LOG_WARN(admin_info.first + " (" + std::to_string(admin_info.second) +
+             ") is degenerate and will be skipped");
+    return {};
+  }
+
+  // convert the rings into multipolygons
+  auto multipolygon = to_multipolygon(admin_info, outers_inners.front(), outers_inners.back());
+
+  // convert that into wkt format so we can put it into sqlite
+  std::stringstream ss;
+  ss << std::setprecision(7) << boost::geometry::wkt(multipolygon);
+  return ss.str();
+}
+
+/**
+ * Builds the wkt of the queued admins. Each thread has its own geos context and only fills out
+ * the entries of the admins it took off the queue
+ * @param admin_data  the admins and the data to build their geometry from
+ * @param offset      index of the first admin of the batch
+ * @param adminqueue  indices within the batch of the admins left to build
+ * @param lock        guards the queue
+ * @param wkts        the wkt of each admin in the batch
+ * @param result      set once the queue is empty or if something goes wrong
+ */
+void build_wkts(const OSMAdminData& admin_data,
+                size_t offset,
+                std::deque<size_t>& adminqueue,
+                std::mutex& lock,
+                std::vector<std::string>& wkts,
+                std::promise<void>& result) {
+  try {
+    while (true) {
+      // Get the next admin
+      lock.lock();
+      if (adminqueue.empty()) {
+        lock.unlock();
+        break;
+      }
+      size_t index = adminqueue.front();
+      adminqueue.pop_front();
+      lock.unlock();
+
+      wkts[index] = to_wkt(admin_data, admin_data.admins[offset + index]);
+    }
+    result.set_value();
+  } catch (...) {
+    result.set_exception(std::current_exception());
+  }
+}
+
+/**
+ * Builds the geometry of all the admins and inserts them into the admins table. The geometries are
+ * built on multiple threads a batch at a time but they are inserted in the order of the admins so
+ * the resulting rowids do not depend on the number of threads
+ * @param admin_data   the admins parsed from the pbf
+ * @param db           the database containing the admins table
+ * @param concurrency  the number of threads to build geometries with
+ * @return true if the admins were inserted
+ */
+bool AddAdmins(const OSMAdminData& admin_data, sqlite3* db, unsigned int concurrency) {
+  SCOPED_TIMER();
+  sqlite3_stmt* stmt;
+  uint32_t ret;
+  char* err_msg = NULL;
+
+  /*
+   * inserting some MULTIPOLYGONs
+   * this time too we'll use a Prepared Statement
+   */
+  std::string sql =
+      "INSERT INTO admins (admin_level, iso_code, parent_admin, name, name_en, "
+      "drive_on_right, allow_intersection_names, default_language, supported_languages, geom) "
+      "VALUES (?,?,?,?,?,?,?,?,?,ST_MakeValid(CastToMulti(GeomFromText(?, 4326))))";
+
+  ret = sqlite3_prepare_v2(db, sql.c_str(), sql.length(), &stmt, NULL);
+  if (ret != SQLITE_OK) {
+    LOG_ERROR("SQL error: " + sql);
+    LOG_ERROR(std::string(sqlite3_errmsg(db)));
+  }
+  ret = sqlite3_exec(db, "BEGIN", NULL, NULL, &err_msg);
+  if (ret != SQLITE_OK) {
+    LOG_ERROR("Error: " + std::string(err_msg));
+    sqlite3_free(err_msg);
+    return false;
+  }
+
+  // for each admin area (relation)
+  [[maybe_unused]] uint32_t count = 0;
+  const size_t batch_size = concurrency * kAdminsPerThreadBatch;
+  std::vector<std::string> wkts;
+  for (size_t index = 0; index < admin_data.admins.size(); ++index) {
+    // build the geometry of the next batch of admins
+    size_t batch_index = index % batch_size;
+    if (batch_index == 0) {
+      size_t batch_end = std::min(index + batch_size, admin_data.admins.size());
+      wkts.assign(batch_end - index, {});
+      std::deque<size_t> adminqueue;
+      for (size_t i = index; i < batch_end; ++i) {
+        adminqueue.push_back(i - index);
+      }
+      std::mutex lock;
+      std::vector<std::shared_ptr<std::thread>> threads(
+          std::min(static_cast<size_t>(concurrency), wkts.size()));
+      std::list<std::promise<void>> results;
+      for (auto& thread : threads) {
+        results.emplace_back();
+        thread = std::make_shared<std::thread>(build_wkts, std::cref(admin_data), index,
+                                               std::ref(adminqueue), std::ref(lock),
+                                               std::ref(wkts), std::ref(results.back()));
+      }
+      for (auto& thread : threads) {
+        thread->join();
+      }
+      // rethrow anything that went wrong
+      for (auto& result : results) {
+        result.get_future().get();
+      }
+    }
+
+    // skip the degenerate ones
+    const auto& admin = admin_data.admins[index];
+    const auto& wkt = wkts[batch_index];
+    if (wkt.empty())
+      continue;
+    std::pair<std::string, uint64_t> admin_info(admin_data.name_offset_map.name(admin.name_index),
+                                                admin.id);
+
+    // load it into sqlite
+    count++;
+    sqlite3_reset(stmt);
+    sqlite3_clear_bindings(stmt);
+    sqlite3_bind_int(stmt, 1, admin.admin_level);
+
+    std::string iso;
+    if (admin.iso_code_index) {
+      iso = admin_data.name_offset_map.name(admin.iso_code_index);
+      sqlite3_bind_text(stmt, 2, iso.c_str(), iso.length(), SQLITE_STATIC);
+    } else {
+      sqlite3_bind_null(stmt, 2);
+    }
+
+    sqlite3_bind_null(stmt, 3);
+
+    sqlite3_bind_text(stmt, 4, admin_info.first.c_str(), admin_info.first.length(), SQLITE_STATIC);
+
+    std::string name_en, default_language;
+    if (admin.name_en_index) {
+      name_en = admin_data.name_offset_map.name(admin.name_en_index);
+      sqlite3_bind_text(stmt, 5, name_en.c_str(), name_en.length(), SQLITE_STATIC);
+    } else {
+      sqlite3_bind_null(stmt, 5);
+    }
+
+    uint32_t level = admin.admin_level;
+    if (level == 2 || level == 4)
+      sqlite3_bind_int(stmt, 6, admin.drive_on_right);
+    else
+      sqlite3_bind_null(stmt, 6);
+
+    if (level == 2 || level == 4)
+      sqlite3_bind_int(stmt, 7, admin.allow_intersection_names);
+    else
+      sqlite3_bind_null(stmt, 7);
+
+    if (admin.default_language_index) {
+      default_language = admin_data.name_offset_map.name(admin.default_language_index);
+      sqlite3_bind_text(stmt, 8, default_language.c_str(), default_language.length(), SQLITE_STATIC);
+    } else {
+      sqlite3_bind_null(stmt, 8);
+    }
+
+    sqlite3_bind_null(stmt, 9);
+    sqlite3_bind_text(stmt, 10, wkt.c_str(), wkt.length(), SQLITE_STATIC);
+    /* performing INSERT INTO */
+    ret = sqlite3_step(stmt);
+    if (ret == SQLITE_DONE || ret == SQLITE_ROW) {
+      continue;
+    }
+    LOG_ERROR("sqlite3_step() error: " + std::string(sqlite3_errmsg(db)));
+    LOG_ERROR("sqlite3_step() Name: " + admin_data.name_offset_map.name(admin.name_index));
+    LOG_ERROR("sqlite3_step() Name:en: " + admin_data.name_offset_map.name(admin.name_en_index));
+    LOG_ERROR("sqlite3_step() Admin Level: " + std::to_string(admin.admin_level));
+    LOG_ERROR("sqlite3_step() Drive on Right: " + std::to_string(admin.drive_on_right));
+    LOG_ERROR("sqlite3_step() Allow Intersection Names: " +
+              std::to_string(admin.allow_intersection_names));
+    LOG_ERROR("sqlite3_step() Default Language: " +
+              admin_data.name_offset_map.name(admin.default_language_index));
+  }
+
+  sqlite3_finalize(stmt);
+  ret = sqlite3_exec(db, "COMMIT", NULL, NULL, &err_msg);
+  if (ret != SQLITE_OK) {
+    LOG_ERROR("Error: " + std::string(err_msg));
+    sqlite3_free(err_msg);
+    return false;
+  }
+  LOG_INFO("Inserted " + std::to_string(count) + " admin areas");
+
+  return true;
+}
+
 } // anonymous namespace
 
 namespace valhalla {
@@ -362,7 +612,7 @@ namespace mjolnir {
  */
 bool BuildAdminFromPBF(const boost::property_tree::ptree& pt,
                        const std::vector<std::string>& input_files) {
-
+  SCOPED_TIMER();
   // Bail if bad path
   auto database = pt.get_optional<std::string>("admin");
 
@@ -475,139 +725,13 @@ bool BuildAdminFromPBF(const boost::property_tree::ptree& pt,
   LOG_INFO("Created admin access table.");
   LOG_INFO("Start populating admin tables.");
 
-  /*
-   * inserting some MULTIPOLYGONs
-   * this time too we'll use a Prepared Statement
-   */
-  sql = "INSERT INTO admins (admin_level, iso_code, parent_admin, name, name_en, "
-        "drive_on_right, allow_intersection_names, default_language, supported_languages, geom) "
-        "VALUES (?,?,?,?,?,?,?,?,?,ST_MakeValid(CastToMulti(GeomFromText(?, 4326))))";
-
-  ret = sqlite3_prepare_v2(db->get(), sql.c_str(), sql.length(), &stmt, NULL);
-  if (ret != SQLITE_OK) {
-    LOG_ERROR("SQL error: " + sql);
-    LOG_ERROR(std::string(sqlite3_errmsg(db->get())));
-  }
-  ret = sqlite3_exec(db->get(), "BEGIN", NULL, NULL, &err_msg);
-  if (ret != SQLITE_OK) {
-    LOG_ERROR("Error: " + std::string(err_msg));
-    sqlite3_free(err_msg);
+  // insert the admin polygons
+  unsigned int concurrency =
+      std::max(1u, pt.get<unsigned int>("concurrency", std::thread::hardware_concurrency()));
+  if (!AddAdmins(admin_data, db->get(), concurrency)) {
     return false;
   }
 
-  // initialize geos
-  geos_helper_t::get();
-
-  // for each admin area (relation)
-  [[maybe_unused]] uint32_t count = 0;
-  for (const auto& admin : admin_data.admins) {
-    std::pair<std::string, uint64_t> admin_info(admin_data.name_offset_map.name(admin.name_index),
-                                                admin.id);
-    LOG_DEBUG("Building admin: " + admin_info.first);
-
-    // do inners and outers separately
-    bool complete = true;
-    std::array<std::vector<bg::ring_ll_t>, 2> outers_inners;
-    for (bool outer : {true, false}) {
-      // grab the ring segments and a lookup to find them when connecting them
-      std::vector<bg::ring_ll_t> lines;
-      std::unordered_multimap<valhalla::midgard::PointLL, size_t> line_lookup;
-      if (!to_segments(admin_data, admin, admin_info.first, outer, lines, line_lookup)) {
-        complete = false;
-        break;
-      }
-      // connect them into a series of one or more rings
-      to_rings(admin_info, lines, line_lookup, outers_inners[!outer], outers_inners[1]);
-    }
-
-    // if we didn't have a complete relation (ie some members were missing) we bail
-    if (!complete || outers_inners.front().empty()) {
-      LOG_WARN(admin_info.first + " (" + std::to_string(admin_info.second) +
-               ") is degenerate and will be skipped");
-      continue;
-    }
-
-    // convert the rings into multipolygons
-    auto multipolygon = to_multipolygon(admin_info, outers_inners.front(), outers_inners.back());
-
-    // convert that into wkt format so we can put it into sqlite
-    std::stringstream ss;
-    ss << std::setprecision(7) << boost::geometry::wkt(multipolygon);
-    auto wkt = ss.str();
-    if (wkt.empty())
-      continue;
-
-    // load it into sqlite
-    count++;
-    sqlite3_reset(stmt);
-    sqlite3_clear_bindings(stmt);
-    sqlite3_bind_int(stmt, 1, admin.admin_level);
-
-    std::string iso;
-    if (admin.iso_code_index) {
-      iso = admin_data.name_offset_map.name(admin.iso_code_index);
-      sqlite3_bind_text(stmt, 2, iso.c_str(), iso.length(), SQLITE_STATIC);
-    } else {
-      sqlite3_bind_null(stmt, 2);
-    }
-
-    sqlite3_bind_null(stmt, 3);
-
-    sqlite3_bind_text(stmt, 4, admin_info.first.c_str(), admin_info.first.length(), SQLITE_STATIC);
-
-    std::string name_en, default_language;
-    if (admin.name_en_index) {
-      name_en = admin_data.name_offset_map.name(admin.name_en_index);
-      sqlite3_bind_text(stmt, 5, name_en.c_str(), name_en.length(), SQLITE_STATIC);
-    } else {
-      sqlite3_bind_null(stmt, 5);
-    }
-
-    uint32_t level = admin.admin_level;
-    if (level == 2 || level == 4)
-      sqlite3_bind_int(stmt, 6, admin.drive_on_right);
-    else
-      sqlite3_bind_null(stmt, 6);
-
-    if (level == 2 || level == 4)
-      sqlite3_bind_int(stmt, 7, admin.allow_intersection_names);
-    else
-      sqlite3_bind_null(stmt, 7);
-
-    if (admin.default_language_index) {
-      default_language = admin_data.name_offset_map.name(admin.default_language_index);
-      sqlite3_bind_text(stmt, 8, default_language.c_str(), default_language.length(), SQLITE_STATIC);
-    } else {
-      sqlite3_bind_null(stmt, 8);
-    }
-
-    sqlite3_bind_null(stmt, 9);
-    sqlite3_bind_text(stmt, 10, wkt.c_str(), wkt.length(), SQLITE_STATIC);
-    /* performing INSERT INTO */
-    ret = sqlite3_step(stmt);
-    if (ret == SQLITE_DONE || ret == SQLITE_ROW) {
-      continue;
-    }
-    LOG_ERROR("sqlite3_step() error: " + std::string(sqlite3_errmsg(db->get())));
-    LOG_ERROR("sqlite3_step() Name: " + admin_data.name_offset_map.name(admin.name_index));
-    LOG_ERROR("sqlite3_step() Name:en: " + admin_data.name_offset_map.name(admin.name_en_index));
-    LOG_ERROR("sqlite3_step() Admin Level: " + std::to_string(admin.admin_level));
-    LOG_ERROR("sqlite3_step() Drive on Right: " + std::to_string(admin.drive_on_right));
-    LOG_ERROR("sqlite3_step() Allow Intersection Names: " +
-              std::to_string(admin.allow_intersection_names));
-    LOG_ERROR("sqlite3_step() Default Language: " +
-              admin_data.name_offset_map.name(admin.default_language_index));
-  }
-
-  sqlite3_finalize(stmt);
-  ret = sqlite3_exec(db->get(), "COMMIT", NULL, NULL, &err_msg);
-  if (ret != SQLITE_OK) {
-    LOG_ERROR("Error: " + std::string(err_msg));
-    sqlite3_free(err_msg);
-    return false;
-  }
-  LOG_INFO("Inserted " + std::to_string(count) + " admin areas");
-
   sql = "SELECT CreateSpatialIndex('admins', 'geom')";
   ret = sqlite3_exec(db->get(), sql.c_str(), NULL, NULL, &err_msg);
   if (ret != SQLITE_OK) {
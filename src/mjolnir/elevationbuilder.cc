@@ -2,6 +2,7 @@
 #include "baldr/graphconstants.h"
 #include "baldr/graphid.h"
 #include "baldr/graphreader.h"
+#include "baldr/tilehierarchy.h"
 #include "midgard/elevation_encoding.h"
 #include "midgard/logging.h"
 #include "midgard/pointll.h"
@@ -14,8 +15,9 @@
 
 #include <boost/property_tree/ptree.hpp>
 
+#include <algorithm>
+#include <cmath>
 #include <filesystem>
-#include <random>
 #include <thread>
 #include <utility>
 
@@ -37,19 +39,7 @@ using cache_t =
 /**
  * Encode elevation along an edge to store in tiles.
  */
-std::vector<int8_t> encode_edge_elevation(const std::unique_ptr<valhalla::skadi::sample>& sample,
-                                          const std::vector<PointLL>& shape,
-                                          const uint32_t length,
-                                          uint32_t wayid) {
-  // Uniformly resample the polyline to create the desired number of vertices
-  uint32_t n = encoded_elevation_count(length) + 2;
-  std::vector<PointLL> resampled =
-      valhalla::midgard::uniform_resample_spherical_polyline(shape, length, n);
-
-  // Get elevation (height) at each sampled point along the edge.
-  std::vector<double> heights(resampled.size());
-  heights = sample->get_all(resampled);
-
+std::vector<int8_t> encode_edge_elevation(const std::vector<double>& heights, uint32_t wayid) {
   // Encode the elevation.
   bool error = false;
   std::vector<int8_t> encoded = encode_elevation(heights, error);
@@ -70,17 +60,11 @@ std::vector<int8_t> encode_edge_elevation(const std::unique_ptr<valhalla::skadi:
 /**
  * Encode elevation for a bridge, tunnel, ferry.
  */
-std::vector<int8_t> encode_btf_elevation(const std::unique_ptr<valhalla::skadi::sample>& sample,
-                                         const std::vector<PointLL>& shape,
-                                         const uint32_t length,
-                                         uint32_t wayid) {
+std::vector<int8_t>
+encode_btf_elevation(const double h1, const double h2, const uint32_t length, uint32_t wayid) {
   // Compute a uniform sampling interval along the edge based on its length.
   double interval = sampling_interval(length);
 
-  // Sample at the first and last shape point
-  double h1 = sample->get(shape.front());
-  double h2 = sample->get(shape.back());
-
   // Use linear interpolation from h1 to h2 along the length of the edge
   uint32_t n = static_cast<uint32_t>(length / interval) + 1;
   std::vector<double> heights(n);
@@ -108,6 +92,16 @@ std::vector<int8_t> encode_btf_elevation(const std::unique_ptr<valhalla::skadi::
   return e;
 }
 
+// Where the postings of an edge info live in the batch of postings sampled for the whole tile.
+// Bridges, tunnels and ferries only sample their two ends for both the grades and the encoding
+struct edge_postings_t {
+  size_t grade_begin;
+  size_t grade_count; // how many heights the grades are computed over
+  size_t encode_begin;
+  size_t encode_count;
+  bool btf;
+};
+
 void add_elevations_to_single_tile(GraphReader& graphreader,
                                    std::mutex& graphreader_lck,
                                    cache_t& cache,
@@ -120,14 +114,6 @@ void add_elevations_to_single_tile(GraphReader& graphreader,
   // retrieved/used?
   tilebuilder.header_builder().set_has_elevation(true);
 
-  // Iterate through the nodes edges, get the node lat,lng, sample and store elevation.
-  for (uint32_t i = 0; i < tilebuilder.header()->nodecount(); ++i) {
-    // Get a writeable reference to the node edge
-    NodeInfo& nodeinfo = tilebuilder.node_builder(i);
-    PointLL ll = nodeinfo.latlng(tilebuilder.header()->base_ll());
-    nodeinfo.set_elevation(sample->get(ll));
-  }
-
   // Reserve twice the number of directed edges in the tile. We do not directly know
   // how many EdgeInfo records exist but it cannot be more than 2x the directed edge count.
   uint32_t count = tilebuilder.header()->directededgecount();
@@ -142,11 +128,63 @@ void add_elevations_to_single_tile(GraphReader& graphreader,
     edge_info_offsets.insert(std::pair<uint32_t, uint32_t>(edge_info_offset, i));
   }
 
+  // Gather every posting of the tile up front, the nodes first and then the resampled shapes of
+  // each edge info, so that skadi can sample them in one go grouped by the hgt tile they fall in
+  std::vector<PointLL> postings;
+  postings.reserve(tilebuilder.header()->nodecount());
+  for (uint32_t i = 0; i < tilebuilder.header()->nodecount(); ++i) {
+    postings.push_back(tilebuilder.node_builder(i).latlng(tilebuilder.header()->base_ll()));
+  }
+  std::vector<edge_postings_t> edge_postings;
+  for (auto elem = edge_info_offsets.begin(); elem != edge_info_offsets.end();
+       elem = edge_info_offsets.upper_bound(elem->first)) {
+    DirectedEdge& directededge = tilebuilder.directededge_builder(elem->second);
+    auto shape = tilebuilder.edgeinfo(&directededge).shape();
+    auto length = directededge.length();
+    edge_postings_t edge{};
+    edge.btf = directededge.bridge() || directededge.tunnel() || directededge.use() == Use::kFerry;
+
+    // Evenly sample the shape and add the last shape point. TODO - if close to the end do not!
+    std::vector<PointLL> resampled =
+        valhalla::midgard::resample_spherical_polyline(shape, POSTING_INTERVAL);
+    resampled.push_back(shape.back());
+    edge.grade_begin = postings.size();
+    edge.grade_count = resampled.size();
+    if (edge.btf) {
+      // Get height at beginning and end of bridge/tunnel
+      postings.push_back(resampled.front());
+      postings.push_back(resampled.back());
+    } else {
+      postings.insert(postings.end(), resampled.begin(), resampled.end());
+    }
+
+    // Uniformly resample the polyline to create the desired number of vertices for the encoding,
+    // bridges, tunnels and ferries only need the heights at either end of the shape
+    edge.encode_begin = postings.size();
+    if (edge.btf) {
+      postings.push_back(shape.front());
+      postings.push_back(shape.back());
+    } else {
+      uint32_t n = encoded_elevation_count(length) + 2;
+      auto uniform = valhalla::midgard::uniform_resample_spherical_polyline(shape, length, n);
+      postings.insert(postings.end(), uniform.begin(), uniform.end());
+    }
+    edge.encode_count = postings.size() - edge.encode_begin;
+    edge_postings.push_back(edge);
+  }
+  std::vector<double> sampled = sample->get_all(postings);
+
+  // Iterate through the nodes, store the elevation we sampled at their lat,lng
+  for (uint32_t i = 0; i < tilebuilder.header()->nodecount(); ++i) {
+    tilebuilder.node_builder(i).set_elevation(sampled[i]);
+  }
+
   // Map existing edge info offsets to new (after adding encoded elevation)
   std::unordered_map<uint32_t, uint32_t> new_offsets;
 
   // Iterate through the directed edges
   uint32_t ei_offset = 0;
+  auto edge = edge_postings.cbegin();
   for (auto& elem : edge_info_offsets) {
     // Get a writeable reference to the directed edge
     DirectedEdge& directededge = tilebuilder.directededge_builder(elem.second);
@@ -157,34 +195,25 @@ void add_elevations_to_single_tile(GraphReader& graphreader,
     // Check if this edge has been cached (based on edge info offset)
     auto found = cache.find(edge_info_offset);
     if (found == cache.cend()) {
-      // Get the shape and length
-      auto shape = tilebuilder.edgeinfo(&directededge).shape();
+      // The postings were gathered in the same order we see the edge infos for the first time
       auto length = directededge.length();
 
       // Grade estimation and max slopes
       std::tuple<double, double, double, double> forward_grades(0.0, 0.0, 0.0, 0.0);
       std::tuple<double, double, double, double> reverse_grades(0.0, 0.0, 0.0, 0.0);
 
-      // Evenly sample the shape and add the last shape point. TODO - if close to the end do not!
-      std::vector<PointLL> resampled =
-          valhalla::midgard::resample_spherical_polyline(shape, POSTING_INTERVAL);
-      resampled.push_back(shape.back());
-
       // Get the heights at each sampled point.
-      std::vector<double> heights(resampled.size());
-      if (directededge.bridge() || directededge.tunnel() || directededge.use() == Use::kFerry) {
-        // Get height at beginning and end of bridge/tunnel
-        std::vector<PointLL> tmp;
-        tmp.emplace_back(resampled.front());
-        tmp.emplace_back(resampled.back());
-        auto h = sample->get_all(tmp);
-        heights[0] = h[0];
-        float dh = (h[1] - heights[0]) / heights.size();
+      std::vector<double> heights(edge->grade_count);
+      auto grade_heights = sampled.cbegin() + edge->grade_begin;
+      if (edge->btf) {
+        // Interpolate between the heights at beginning and end of bridge/tunnel
+        heights[0] = grade_heights[0];
+        float dh = (grade_heights[1] - heights[0]) / heights.size();
         for (size_t i = 1; i < heights.size(); ++i) {
           heights[i] = heights[i - 1] + dh;
         }
       } else {
-        heights = sample->get_all(resampled);
+        std::copy(grade_heights, grade_heights + edge->grade_count, heights.begin());
       }
 
       // Compute "weighted" grades as well as max grades in both directions. Valid range
@@ -221,12 +250,15 @@ void add_elevations_to_single_tile(GraphReader& graphreader,
       // Bridges, tunnels, ferries are special cases. Increment the new edge info offset.
       std::vector<int8_t> encoded;
       auto wayid = tilebuilder.edgeinfo(&directededge).wayid();
-      if (directededge.bridge() || directededge.tunnel() || directededge.use() == Use::kFerry) {
-        encoded = encode_btf_elevation(sample, shape, length, wayid);
+      auto encode_heights = sampled.cbegin() + edge->encode_begin;
+      if (edge->btf) {
+        encoded = encode_btf_elevation(encode_heights[0], encode_heights[1], length, wayid);
       } else {
-        encoded = encode_edge_elevation(sample, shape, length, wayid);
+        encoded = encode_edge_elevation({encode_heights, encode_heights + edge->encode_count},
+                                        wayid);
       }
       ei_offset += tilebuilder.set_elevation(edge_info_offset, mean_elevation, encoded);
+      ++edge;
     }
 
     // Edge elevation information. If the edge is forward (with respect to the shape)
@@ -307,17 +339,40 @@ void add_elevations_to_multiple_tiles(const boost::property_tree::ptree& pt,
 std::deque<GraphId> get_tile_ids(const boost::property_tree::ptree& pt) {
   std::deque<GraphId> tilequeue;
   GraphReader reader(pt.get_child("mjolnir"));
-  // Create a randomized queue of tiles (at all levels) to work from
+  // Create a queue of tiles (at all levels) to work from
   auto tileset = reader.GetTileSet();
   for (const auto& id : tileset)
     tilequeue.emplace_back(id);
-
-  std::random_device rd;
-  std::shuffle(tilequeue.begin(), tilequeue.end(), std::mt19937(rd()));
-
   return tilequeue;
 }
 
+/**
+ * Orders the tiles along a z-order curve over the 1x1 degree hgt tiles their centers fall in.
+ * The threads pull tiles off the front of the queue so at any point they work on neighbouring
+ * tiles, which need the same few hgt tiles. That keeps the hgt tiles in the shared skadi cache
+ * until they are done with so each of them is decompressed about once for the whole build.
+ */
+void sort_by_hgt_tile(std::deque<GraphId>& tilequeue) {
+  auto spread = [](uint32_t v) {
+    v = (v | (v << 8)) & 0x00FF00FF;
+    v = (v | (v << 4)) & 0x0F0F0F0F;
+    v = (v | (v << 2)) & 0x33333333;
+    v = (v | (v << 1)) & 0x55555555;
+    return v;
+  };
+  std::vector<std::pair<uint32_t, GraphId>> keyed;
+  keyed.reserve(tilequeue.size());
+  for (const auto& id : tilequeue) {
+    auto center = TileHierarchy::get_tiling(id.level()).TileBounds(id.tileid()).Center();
+    auto lon = static_cast<uint32_t>(std::clamp(std::floor(center.lng()) + 180, 0., 359.));
+    auto lat = static_cast<uint32_t>(std::clamp(std::floor(center.lat()) + 90, 0., 179.));
+    keyed.emplace_back(spread(lon) | (spread(lat) << 1), id);
+  }
+  std::sort(keyed.begin(), keyed.end());
+  std::transform(keyed.begin(), keyed.end(), tilequeue.begin(),
+                 [](const std::pair<uint32_t, GraphId>& k) { return k.second; });
+}
+
 } // namespace
 
 namespace valhalla {
@@ -340,6 +395,7 @@ void ElevationBuilder::Build(const boost::property_tree::ptree& pt,
 
   if (tile_ids.empty())
     tile_ids = get_tile_ids(pt);
+  sort_by_hgt_tile(tile_ids);
 
   std::vector<std::shared_ptr<std::thread>> threads(nthreads);
 
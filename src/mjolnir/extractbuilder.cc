@@ -0,0 +1,352 @@
+#include "mjolnir/extractbuilder.h"
+#include "baldr/graphtile.h"
+#include "baldr/graphtileheader.h"
+#include "baldr/tilehierarchy.h"
+#include "baldr/traffictile.h"
+#include "midgard/logging.h"
+#include "midgard/sequence.h"
+#include "scoped_timer.h"
+
+#include <boost/property_tree/ptree.hpp>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <deque>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <future>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <numeric>
+#include <thread>
+#include <unordered_map>
+
+using namespace valhalla::baldr;
+using namespace valhalla::midgard;
+using namespace valhalla::mjolnir;
+
+namespace {
+
+using header_t = tar::header_t;
+constexpr uint64_t kBlockSize = sizeof(header_t);
+
+// Layout of the entries in index.bin, this is what GraphReader expects to find in it
+struct index_entry_t {
+  uint64_t offset;  // byte offset of the tile data from the beginning of the tar
+  uint32_t tile_id; // just level and tileindex hence fitting in 32bits
+  uint32_t size;    // size of the tile in bytes
+};
+static_assert(sizeof(index_entry_t) == 16, "index.bin entries must be 16 bytes");
+
+// A file in the extract
+struct entry_t {
+  GraphId tile_id;
+  std::string name;
+  std::filesystem::path path;
+  uint64_t size;
+  // bytes of padding in front of the tar header of this entry
+  uint64_t padding;
+  // byte offset of the data of this entry from the beginning of the tar
+  uint64_t offset;
+  // number of directed edges in the tile, used to size the traffic tiles
+  uint32_t edge_count;
+};
+
+uint64_t round_up(uint64_t size, uint64_t multiple) {
+  return (size + multiple - 1) / multiple * multiple;
+}
+
+// Distance along the Hilbert curve through an n by n grid (n being a power of 2) to x, y
+uint64_t hilbert_index(uint32_t n, uint32_t x, uint32_t y) {
+  uint64_t d = 0;
+  for (uint32_t s = n / 2; s > 0; s /= 2) {
+    uint32_t rx = (x & s) > 0;
+    uint32_t ry = (y & s) > 0;
+    d += static_cast<uint64_t>(s) * s * ((3 * rx) ^ ry);
+    // rotate the quadrant so the curve stays continuous
+    if (ry == 0) {
+      if (rx == 1) {
+        x = n - 1 - x;
+        y = n - 1 - y;
+      }
+      std::swap(x, y);
+    }
+  }
+  return d;
+}
+
+// Makes a ustar header for a file of the given size
+header_t make_header(const std::string& name, uint64_t size, char typeflag) {
+  header_t header{};
+  if (name.size() >= sizeof(header.name)) {
+    throw std::runtime_error("Path is too long for the tar header: " + name);
+  }
+  std::memcpy(header.name, name.data(), name.size());
+  std::snprintf(header.mode, sizeof(header.mode), "%07o", 0644);
+  std::snprintf(header.uid, sizeof(header.uid), "%07o", 0);
+  std::snprintf(header.gid, sizeof(header.gid), "%07o", 0);
+  std::snprintf(header.size, sizeof(header.size), "%011llo", static_cast<unsigned long long>(size));
+  std::snprintf(header.mtime, sizeof(header.mtime), "%011llo",
+                static_cast<unsigned long long>(std::time(nullptr)));
+  header.typeflag = typeflag;
+  std::memcpy(header.magic, "ustar", 6);
+  std::memcpy(header.version, "00", 2);
+
+  // the checksum is computed with the checksum field filled with spaces
+  std::memset(header.chksum, ' ', sizeof(header.chksum));
+  uint64_t sum = 0;
+  for (size_t i = 0; i < sizeof(header_t); ++i) {
+    sum += reinterpret_cast<const unsigned char*>(&header)[i];
+  }
+  std::snprintf(header.chksum, sizeof(header.chksum) - 1, "%06o", static_cast<unsigned int>(sum));
+  return header;
+}
+
+// Fills a gap of whole blocks between two entries with a pax extended header. Its only record is
+// a comment, which tar implementations ignore, so the archive stays a valid tar
+void write_padding(std::ostream& out, uint64_t gap) {
+  uint64_t size = gap - kBlockSize;
+  auto header = make_header("././@PaxHeader", size, 'x');
+  out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+  if (size > 0) {
+    // a record is "<length of the record> <keyword>=<value>\n"
+    auto length = std::to_string(size);
+    std::string record = length + " comment=";
+    record.append(size - record.size() - 1, '0');
+    record.push_back('\n');
+    out.write(record.data(), record.size());
+  }
+}
+
+// Works out where each entry goes so its data starts on a page and returns the archive's size.
+// index.bin comes first and is the only entry which isn't aligned, as GraphReader wants it first
+uint64_t layout(std::vector<entry_t>& entries) {
+  uint64_t position = kBlockSize + round_up(entries.size() * sizeof(index_entry_t), kBlockSize);
+  for (auto& entry : entries) {
+    entry.padding = (kExtractPageSize - (position + kBlockSize) % kExtractPageSize) % kExtractPageSize;
+    entry.offset = position + entry.padding + kBlockSize;
+    position = entry.offset + round_up(entry.size, kBlockSize);
+  }
+  // tars end with 2 empty blocks
+  return position + 2 * kBlockSize;
+}
+
+// Copies the queued entries into the extract. Each thread has its own stream on the file
+void write_entries(const std::string& path,
+                   std::vector<entry_t>& entries,
+                   const std::function<void(entry_t&, std::vector<char>&)>& get_data,
+                   std::deque<size_t>& entryqueue,
+                   std::mutex& lock,
+                   std::promise<void>& result) {
+  try {
+    std::fstream out(path, std::ios::in | std::ios::out | std::ios::binary);
+    if (!out.is_open()) {
+      throw std::runtime_error("Failed to open " + path);
+    }
+    std::vector<char> data;
+    while (true) {
+      // Get the next entry
+      lock.lock();
+      if (entryqueue.empty()) {
+        lock.unlock();
+        break;
+      }
+      auto& entry = entries[entryqueue.front()];
+      entryqueue.pop_front();
+      lock.unlock();
+
+      get_data(entry, data);
+      if (data.size() != entry.size) {
+        throw std::runtime_error(entry.path.string() + " changed size while building the extract");
+      }
+
+      // write any padding, the header and the data
+      out.seekp(entry.offset - kBlockSize - entry.padding);
+      if (entry.padding) {
+        write_padding(out, entry.padding);
+      }
+      auto header = make_header(entry.name, entry.size, '0');
+      out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+      out.write(data.data(), data.size());
+      if (!out) {
+        throw std::runtime_error("Failed to write " + entry.name + " to " + path);
+      }
+    }
+    result.set_value();
+  } catch (...) {
+    result.set_exception(std::current_exception());
+  }
+}
+
+// Writes the extract to a temporary file next to path and then moves it into place, so anything
+// that has the previous extract mapped keeps working
+void write_extract(const std::string& path,
+                   std::vector<entry_t>& entries,
+                   unsigned int concurrency,
+                   const std::function<void(entry_t&, std::vector<char>&)>& get_data) {
+  auto archive_size = layout(entries);
+  auto tmp_path = path + ".tmp";
+  std::filesystem::path parent = std::filesystem::path(path).parent_path();
+  if (!parent.empty()) {
+    std::filesystem::create_directories(parent);
+  }
+
+  // the index goes first, everything not written afterwards stays zeroed
+  {
+    std::ofstream out(tmp_path, std::ios::out | std::ios::binary | std::ios::trunc);
+    if (!out.is_open()) {
+      throw std::runtime_error("Failed to open " + tmp_path);
+    }
+    std::vector<index_entry_t> index;
+    index.reserve(entries.size());
+    for (const auto& entry : entries) {
+      index.push_back({entry.offset, static_cast<uint32_t>(entry.tile_id.value),
+                       static_cast<uint32_t>(entry.size)});
+    }
+    auto header = make_header("index.bin", index.size() * sizeof(index_entry_t), '0');
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.write(reinterpret_cast<const char*>(index.data()), index.size() * sizeof(index_entry_t));
+  }
+  std::filesystem::resize_file(tmp_path, archive_size);
+
+  // copy the entries in on a few threads
+  std::deque<size_t> entryqueue(entries.size());
+  std::iota(entryqueue.begin(), entryqueue.end(), 0);
+  std::mutex lock;
+  std::vector<std::shared_ptr<std::thread>> threads(
+      std::max(1u, std::min(concurrency, static_cast<unsigned int>(entries.size()))));
+  std::list<std::promise<void>> results;
+  for (auto& thread : threads) {
+    results.emplace_back();
+    thread = std::make_shared<std::thread>(write_entries, std::cref(tmp_path), std::ref(entries),
+                                           std::cref(get_data), std::ref(entryqueue),
+                                           std::ref(lock), std::ref(results.back()));
+  }
+  for (auto& thread : threads) {
+    thread->join();
+  }
+  // rethrow anything that went wrong
+  for (auto& result : results) {
+    result.get_future().get();
+  }
+
+  std::filesystem::rename(tmp_path, path);
+}
+
+} // namespace
+
+namespace valhalla {
+namespace mjolnir {
+
+void ExtractBuilder::SortTiles(std::vector<GraphId>& tile_ids) {
+  auto key = [](const GraphId& tile_id) {
+    const auto& tiles = TileHierarchy::get_tiling(tile_id.level());
+    uint32_t n = 1;
+    while (n < static_cast<uint32_t>(std::max(tiles.ncolumns(), tiles.nrows()))) {
+      n *= 2;
+    }
+    uint32_t x = tile_id.tileid() % tiles.ncolumns();
+    uint32_t y = tile_id.tileid() / tiles.ncolumns();
+    return std::make_pair(tile_id.level(), hilbert_index(n, x, y));
+  };
+  std::sort(tile_ids.begin(), tile_ids.end(),
+            [&key](const GraphId& a, const GraphId& b) { return key(a) < key(b); });
+}
+
+size_t ExtractBuilder::Build(const boost::property_tree::ptree& pt,
+                             const std::string& extract,
+                             bool with_traffic,
+                             const std::optional<AABB2<PointLL>>& bbox) {
+  SCOPED_TIMER();
+  std::filesystem::path tile_dir = pt.get<std::string>("tile_dir");
+  std::string tile_extract = extract.empty() ? pt.get<std::string>("tile_extract", "") : extract;
+  if (tile_extract.empty()) {
+    throw std::runtime_error("No tile extract path was given nor is mjolnir.tile_extract set");
+  }
+  unsigned int concurrency =
+      std::max(1u, pt.get<unsigned int>("concurrency", std::thread::hardware_concurrency()));
+
+  // find all the tiles we want in the extract
+  std::vector<GraphId> tile_ids;
+  std::unordered_map<GraphId, std::pair<std::string, uint64_t>> tile_files;
+  if (std::filesystem::is_directory(tile_dir)) {
+    for (const auto& file : std::filesystem::recursive_directory_iterator(tile_dir)) {
+      if (!file.is_regular_file() || file.path().extension() != ".gph") {
+        continue;
+      }
+      auto name = file.path().lexically_relative(tile_dir).generic_string();
+      GraphId tile_id;
+      try {
+        tile_id = GraphTile::GetTileId(name);
+      } catch (...) {
+        // not a graph tile after all
+        continue;
+      }
+      if (bbox && !TileHierarchy::get_tiling(tile_id.level())
+                       .TileBounds(tile_id.tileid())
+                       .Intersects(*bbox)) {
+        continue;
+      }
+      tile_ids.push_back(tile_id);
+      tile_files.emplace(tile_id, std::make_pair(name, file.file_size()));
+    }
+  }
+  if (tile_ids.empty()) {
+    throw std::runtime_error("Couldn't find any tiles in " + tile_dir.string());
+  }
+
+  // lay them out along the hilbert curve of each level
+  SortTiles(tile_ids);
+  std::vector<entry_t> entries;
+  entries.reserve(tile_ids.size());
+  for (const auto& tile_id : tile_ids) {
+    const auto& file = tile_files[tile_id];
+    entries.push_back({tile_id, file.first, tile_dir / file.first, file.second, 0, 0, 0});
+  }
+
+  // pack the tiles
+  LOG_INFO("Packing " + std::to_string(entries.size()) + " tiles into " + tile_extract);
+  write_extract(tile_extract, entries, concurrency, [](entry_t& entry, std::vector<char>& data) {
+    std::ifstream file(entry.path, std::ios::in | std::ios::binary | std::ios::ate);
+    data.resize(file.tellg());
+    file.seekg(0);
+    file.read(data.data(), data.size());
+    if (!file || data.size() < sizeof(GraphTileHeader)) {
+      throw std::runtime_error("Failed to read tile " + entry.path.string());
+    }
+    entry.edge_count = reinterpret_cast<const GraphTileHeader*>(data.data())->directededgecount();
+  });
+  LOG_INFO("Finished packing the tile extract");
+
+  if (!with_traffic) {
+    return entries.size();
+  }
+
+  // a traffic tile for each graph tile with a speed for each of its edges
+  std::string traffic_extract = pt.get<std::string>("traffic_extract", "");
+  if (traffic_extract.empty()) {
+    traffic_extract =
+        (std::filesystem::path(tile_extract).parent_path() / "traffic.tar").generic_string();
+  }
+  for (auto& entry : entries) {
+    entry.size = sizeof(TrafficTileHeader) + entry.edge_count * sizeof(TrafficSpeed);
+  }
+  LOG_INFO("Writing the traffic extract to " + traffic_extract);
+  write_extract(traffic_extract, entries, concurrency, [](entry_t& entry, std::vector<char>& data) {
+    data.assign(entry.size, 0);
+    auto* header = reinterpret_cast<TrafficTileHeader*>(data.data());
+    header->tile_id = entry.tile_id.value;
+    header->directed_edge_count = entry.edge_count;
+    header->traffic_tile_version = TRAFFIC_TILE_VERSION;
+  });
+  LOG_INFO("Finished writing the traffic extract");
+
+  return entries.size();
+}
+
+} // namespace mjolnir
+} // namespace valhalla
@@ -39,23 +39,29 @@ namespace {
 /**
  * we need the nodes to be sorted by graphid and then by osmid to make a set of tiles
  * we also need to then update the edges that pointed to them
+ * a non zero sort_memory_budget sorts the files externally within that many bytes
  */
-std::map<GraphId, size_t> SortGraph(const std::string& nodes_file, const std::string& edges_file) {
+std::map<GraphId, size_t> SortGraph(const std::string& nodes_file,
+                                    const std::string& edges_file,
+                                    size_t sort_memory_budget,
+                                    unsigned int concurrency) {
   LOG_INFO("Sorting graph...");
 
   // Sort nodes by graphid then by grid within the tile. This sorts nodes geo-spatially which
   // helps performance by improving memory coherence.
   sequence<Node> nodes(nodes_file, false);
-  nodes.sort([](const Node& a, const Node& b) {
-    if (a.graph_id == b.graph_id) {
-      if (a.grid_id == b.grid_id) {
-        return a.node.osmid_ < b.node.osmid_;
-      } else {
-        return a.grid_id < b.grid_id;
-      }
-    }
-    return a.graph_id < b.graph_id;
-  });
+  nodes.external_sort(
+      [](const Node& a, const Node& b) {
+        if (a.graph_id == b.graph_id) {
+          if (a.grid_id == b.grid_id) {
+            return a.node.osmid_ < b.node.osmid_;
+          } else {
+            return a.grid_id < b.grid_id;
+          }
+        }
+        return a.graph_id < b.graph_id;
+      },
+      sort_memory_budget, concurrency);
 
   // run through the sorted nodes, going back to the edges they reference and updating each edge
   // to point to the first (out of the duplicates) nodes index. at the end of this there will be
@@ -118,8 +124,8 @@ std::map<GraphId, size_t> SortGraph(const std::string& nodes_file, const std::st
   auto cmp = [](const std::pair<uint32_t, uint32_t>& a, const std::pair<uint32_t, uint32_t>& b) {
     return a.first < b.first;
   };
-  starts->sort(cmp);
-  ends->sort(cmp);
+  starts->external_sort(cmp, sort_memory_budget, concurrency);
+  ends->external_sort(cmp, sort_memory_budget, concurrency);
 
   sequence<Edge> edges(edges_file, false);
 
@@ -587,6 +593,11 @@ void BuildTileSet(const std::string& ways_file,
         tz_polys = GetTimeZones(*tz_db, tiling.TileBounds(id));
       }
 
+      // Index the polygons over the tile so most nodes don't need to be tested against them all
+      PolygonIndex admin_lookup(admin_polys, tiling.TileBounds(id));
+      PolygonIndex language_lookup(language_polys, tiling.TileBounds(id));
+      PolygonIndex tz_lookup(tz_polys, tiling.TileBounds(id));
+
       // Iterate through the nodes
       uint32_t idx = 0; // Current directed edge index
 
@@ -620,9 +631,9 @@ void BuildTileSet(const std::string& ways_file,
 
         if (use_admin_db) {
           admin_index = (admin_polys.size() == 1) ? admin_polys.begin()->first
-                                                  : GetMultiPolyId(admin_polys, node_ll, graphtile);
+                                                  : GetMultiPolyId(admin_lookup, node_ll, graphtile);
           dor = drive_on_right[admin_index];
-          default_languages = GetMultiPolyIndexes(language_polys, node_ll);
+          default_languages = GetMultiPolyIndexes(language_polys, language_lookup, node_ll);
         }
 
         // Look for potential duplicates
@@ -1330,7 +1341,7 @@ void BuildTileSet(const std::string& ways_file,
 
         // Set the time zone index
         uint32_t tz_index =
-            (tz_polys.size() == 1) ? tz_polys.begin()->first : GetMultiPolyId(tz_polys, node_ll);
+            (tz_polys.size() == 1) ? tz_polys.begin()->first : GetMultiPolyId(tz_lookup, node_ll);
 
         graphtile.nodes().back().set_timezone(tz_index);
 
@@ -1498,7 +1509,10 @@ std::map<GraphId, size_t> GraphBuilder::BuildEdges(const boost::property_tree::p
       },
       pt.get<bool>("mjolnir.data_processing.infer_turn_channels", true));
 
-  return SortGraph(nodes_file, edges_file);
+  return SortGraph(nodes_file, edges_file,
+                   pt.get<size_t>("mjolnir.data_processing.sort_memory_budget_mb", 0) * 1024 * 1024,
+                   std::max(1u, pt.get<unsigned int>("mjolnir.concurrency",
+                                                     std::thread::hardware_concurrency())));
 }
 
 // Build the graph from the input
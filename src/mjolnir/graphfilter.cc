@@ -13,8 +13,16 @@
 
 #include <boost/property_tree/ptree.hpp>
 
+#include <algorithm>
+#include <atomic>
+#include <deque>
 #include <filesystem>
+#include <future>
 #include <iostream>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <thread>
 #include <unordered_map>
 #include <vector>
 
@@ -24,12 +32,12 @@ using namespace valhalla::mjolnir;
 
 namespace {
 
-uint32_t n_original_edges = 0;
-uint32_t n_original_nodes = 0;
-uint32_t n_filtered_edges = 0;
-uint32_t n_filtered_nodes = 0;
-uint32_t can_aggregate = 0;
-uint32_t aggregated = 0;
+std::atomic<uint32_t> n_original_edges(0);
+std::atomic<uint32_t> n_original_nodes(0);
+std::atomic<uint32_t> n_filtered_edges(0);
+std::atomic<uint32_t> n_filtered_nodes(0);
+std::atomic<uint32_t> can_aggregate(0);
+std::atomic<uint32_t> aggregated(0);
 
 // Group wheelchair and pedestrian access together
 constexpr uint32_t kAllPedestrianAccess = (kPedestrianAccess | kWheelchairAccess);
@@ -238,16 +246,81 @@ bool Aggregate(GraphId& start_node,
                         GraphId(), start_node, rc, validate);
 }
 
+/**
+ * Calls tile_function(reader, tile_id) for every tile in the local level, spreading the tiles over
+ * the given number of threads. Each thread has its own GraphReader which is trimmed whenever it is
+ * over committed. Anything thrown by tile_function is rethrown once all of the threads are done.
+ * @param  pt             mjolnir configuration.
+ * @param  concurrency    number of threads to use.
+ * @param  tile_function  called once for each tile with the reader of the thread it runs on.
+ */
+template <typename tile_function_t>
+void ProcessLocalTiles(const boost::property_tree::ptree& pt,
+                       unsigned int concurrency,
+                       const tile_function_t& tile_function) {
+  // Queue up all tiles in the local level
+  std::deque<GraphId> tilequeue;
+  {
+    GraphReader reader(pt);
+    auto local_tiles = reader.GetTileSet(TileHierarchy::levels().back().level);
+    tilequeue.assign(local_tiles.begin(), local_tiles.end());
+  }
+
+  std::mutex lock;
+  auto work = [&pt, &tile_function, &tilequeue, &lock](std::promise<void>& result) {
+    try {
+      GraphReader reader(pt);
+      while (true) {
+        // Get the next tile Id
+        lock.lock();
+        if (tilequeue.empty()) {
+          lock.unlock();
+          break;
+        }
+        GraphId tile_id = tilequeue.front();
+        tilequeue.pop_front();
+        lock.unlock();
+
+        tile_function(reader, tile_id);
+
+        if (reader.OverCommitted()) {
+          reader.Trim();
+        }
+      }
+      result.set_value();
+    } catch (...) {
+      result.set_exception(std::current_exception());
+    }
+  };
+
+  std::vector<std::shared_ptr<std::thread>> threads(
+      std::max(1u, std::min(concurrency, static_cast<unsigned int>(tilequeue.size()))));
+  std::list<std::promise<void>> results;
+  for (auto& thread : threads) {
+    results.emplace_back();
+    thread = std::make_shared<std::thread>(work, std::ref(results.back()));
+  }
+  for (auto& thread : threads) {
+    thread->join();
+  }
+  // rethrow anything that went wrong
+  for (auto& result : results) {
+    result.get_future().get();
+  }
+}
+
 /**
  * Filter edges to optionally remove edges by access.
- * @param  reader  Graph reader.
+ * @param  pt  mjolnir configuration.
+ * @param  concurrency  number of threads to use.
  * @param  old_to_new  Map of original node Ids to new nodes Ids (after filtering).
  * @param  updated_local_indexes Map of nodes with updated local edge indexes (after filtering).
  * @param  include_driving  Include edge if driving (any vehicular) access in either direction.
  * @param  include_bicycle  Include edge if bicycle access in either direction.
  * @param  include_pedestrian  Include edge if pedestrian or wheelchair access in either direction.
  */
-void FilterTiles(GraphReader& reader,
+void FilterTiles(const boost::property_tree::ptree& pt,
+                 unsigned int concurrency,
                  std::unordered_map<GraphId, GraphId>& old_to_new,
                  std::unordered_map<GraphId, std::vector<uint8_t>>& updated_local_indexes,
                  const bool include_driving,
@@ -268,9 +341,13 @@ void FilterTiles(GraphReader& reader,
            (pedestrian_access && include_pedestrian);
   };
 
-  // Iterate through all tiles in the local level
-  auto local_tiles = reader.GetTileSet(TileHierarchy::levels().back().level);
-  for (const auto& tile_id : local_tiles) {
+  // Iterate through all tiles in the local level. The node associations of each tile are merged
+  // into the shared maps once the tile is done, the keys never overlap so the order doesn't matter
+  std::mutex results_lock;
+  ProcessLocalTiles(pt, concurrency, [&](GraphReader& reader, const GraphId& tile_id) {
+    std::unordered_map<GraphId, GraphId> tile_old_to_new;
+    std::unordered_map<GraphId, std::vector<uint8_t>> tile_updated_local_indexes;
+
     // Create a new tilebuilder - should copy header information
     GraphTileBuilder tilebuilder(reader.tile_dir(), tile_id, false);
     n_original_nodes += tilebuilder.header()->nodecount();
@@ -453,12 +530,12 @@ void FilterTiles(GraphReader& reader,
         }
 
         // Associate the old node to the new node.
-        old_to_new[nodeid] = new_node;
+        tile_old_to_new[nodeid] = new_node;
 
         // If any edges from this node have been filtered, add new_local_indexes to the
         // updated_local_indexes map
         if (edge_filtered > 0) {
-          updated_local_indexes[nodeid] = new_local_indexes;
+          tile_updated_local_indexes[nodeid] = new_local_indexes;
         }
 
         // Check if edges at this node can be aggregated. Only 2 edges, same way Id (so that
@@ -505,15 +582,16 @@ void FilterTiles(GraphReader& reader,
       LOG_INFO("Remove file: " + file_location_str + " all edges were filtered");
     }
 
-    if (reader.OverCommitted()) {
-      reader.Trim();
-    }
-  }
-  LOG_INFO("Filtered " + std::to_string(n_filtered_nodes) + " nodes out of " +
-           std::to_string(n_original_nodes));
-  LOG_INFO("Filtered " + std::to_string(n_filtered_edges) + " directededges out of " +
-           std::to_string(n_original_edges));
-  LOG_INFO("Nodes to aggregate: " + std::to_string(can_aggregate));
+    std::lock_guard<std::mutex> guard(results_lock);
+    old_to_new.insert(tile_old_to_new.begin(), tile_old_to_new.end());
+    updated_local_indexes.insert(std::make_move_iterator(tile_updated_local_indexes.begin()),
+                                 std::make_move_iterator(tile_updated_local_indexes.end()));
+  });
+  LOG_INFO("Filtered " + std::to_string(n_filtered_nodes.load()) + " nodes out of " +
+           std::to_string(n_original_nodes.load()));
+  LOG_INFO("Filtered " + std::to_string(n_filtered_edges.load()) + " directededges out of " +
+           std::to_string(n_original_edges.load()));
+  LOG_INFO("Nodes to aggregate: " + std::to_string(can_aggregate.load()));
 }
 
 void GetAggregatedData(GraphReader& reader,
@@ -612,13 +690,17 @@ void ValidateData(GraphReader& reader,
   }
 }
 
-void AggregateTiles(GraphReader& reader, std::unordered_map<GraphId, GraphId>& old_to_new) {
+// Note that both passes only ever read the tile they are working on. Nodes are only marked for
+// aggregation when all of their edges stay within the tile, so an aggregated chain of edges can
+// never leave it. That is what makes it safe to work on the tiles in parallel.
+void AggregateTiles(const boost::property_tree::ptree& pt,
+                    unsigned int concurrency,
+                    std::unordered_map<GraphId, GraphId>& old_to_new) {
 
   SCOPED_TIMER();
   LOG_INFO("Validating edges for aggregation");
   // Iterate through all tiles in the local level
-  auto local_tiles = reader.GetTileSet(TileHierarchy::levels().back().level);
-  for (const auto& tile_id : local_tiles) {
+  ProcessLocalTiles(pt, concurrency, [](GraphReader& reader, const GraphId& tile_id) {
     // Get the graph tile. Read from this tile to create the new tile.
     graph_tile_ptr tile = reader.GetGraphTile(tile_id);
     assert(tile);
@@ -680,18 +762,14 @@ void AggregateTiles(GraphReader& reader, std::unordered_map<GraphId, GraphId>& o
       nodes.emplace_back(std::move(nodeinfo));
     }
     tilebuilder.Update(nodes, directededges);
-
-    if (reader.OverCommitted()) {
-      reader.Trim();
-    }
-  }
+  });
 
   LOG_INFO("Aggregating edges");
-  reader.Clear();
   // Iterate through all tiles in the local level
-  local_tiles = reader.GetTileSet(TileHierarchy::levels().back().level);
-  // Iterate through all tiles in the local level
-  for (const auto& tile_id : local_tiles) {
+  std::mutex results_lock;
+  ProcessLocalTiles(pt, concurrency, [&](GraphReader& reader, const GraphId& tile_id) {
+    std::unordered_map<GraphId, GraphId> tile_old_to_new;
+
     // Create a new tilebuilder - should copy header information
     GraphTileBuilder tilebuilder(reader.tile_dir(), tile_id, false);
 
@@ -832,7 +910,7 @@ void AggregateTiles(GraphReader& reader, std::unordered_map<GraphId, GraphId>& o
           tilebuilder.AddSigns(tilebuilder.nodes().size() - 1, signs);
         }
         // Associate the old node to the new node.
-        old_to_new[nodeid] = new_node;
+        tile_old_to_new[nodeid] = new_node;
       }
     }
 
@@ -848,28 +926,28 @@ void AggregateTiles(GraphReader& reader, std::unordered_map<GraphId, GraphId>& o
       LOG_INFO("Remove file: " + file_location_str + " all edges were filtered");
     }
 
-    if (reader.OverCommitted()) {
-      reader.Trim();
-    }
-  }
+    std::lock_guard<std::mutex> guard(results_lock);
+    old_to_new.insert(tile_old_to_new.begin(), tile_old_to_new.end());
+  });
 
-  LOG_INFO("Aggregated " + std::to_string(aggregated) + " directededges out of " +
-           std::to_string(n_original_edges));
+  LOG_INFO("Aggregated " + std::to_string(aggregated.load()) + " directededges out of " +
+           std::to_string(n_original_edges.load()));
 }
 
 /**
  * Update end nodes of all directed edges.
- * @param  reader  Graph reader.
+ * @param  pt  mjolnir configuration.
+ * @param  concurrency  number of threads to use.
  * @param  old_to_new  Map of original node Ids to new nodes Ids (after filtering).
  */
-void UpdateEndNodes(GraphReader& reader,
-                    std::unordered_map<GraphId, GraphId>& old_to_new,
-                    std::unordered_map<GraphId, std::vector<uint8_t>>& updated_local_indexes) {
+void UpdateEndNodes(const boost::property_tree::ptree& pt,
+                    unsigned int concurrency,
+                    const std::unordered_map<GraphId, GraphId>& old_to_new,
+                    const std::unordered_map<GraphId, std::vector<uint8_t>>& updated_local_indexes) {
   SCOPED_TIMER();
   LOG_INFO("Update end nodes of directed edges");
   // Iterate through all tiles in the local level
-  auto local_tiles = reader.GetTileSet(TileHierarchy::levels().back().level);
-  for (const auto& tile_id : local_tiles) {
+  ProcessLocalTiles(pt, concurrency, [&](GraphReader& reader, const GraphId& tile_id) {
     // Get the graph tile. Skip if no tile exists (should not happen!?)
     graph_tile_ptr tile = reader.GetGraphTile(tile_id);
     assert(tile);
@@ -928,25 +1006,24 @@ void UpdateEndNodes(GraphReader& reader,
 
     // Update the tile with new directededges.
     tilebuilder.Update(nodes, directededges);
-
-    if (reader.OverCommitted()) {
-      reader.Trim();
-    }
-  }
+  });
 }
 
 /**
  * Update Opposing Edge Index and Transitions of all directed edges.
- * @param  reader  Graph reader.
+ * @param  pt  mjolnir configuration.
+ * @param  concurrency  number of threads to use.
  */
-void UpdateOpposingIndexAndTransitions(GraphReader& reader) {
+void UpdateOpposingIndexAndTransitions(const boost::property_tree::ptree& pt,
+                                       unsigned int concurrency) {
   SCOPED_TIMER();
   LOG_INFO("Update Opposing Edge Index of directed edges");
 
-  enhancer_stats stats{std::numeric_limits<float>::min(), 0, 0, 0, 0, 0, 0, {0}};
+  // Tiles are rewritten in place so reading a neighbouring tile has to wait for any write to it
+  std::mutex tile_lock;
   // Iterate through all tiles in the local level
-  auto local_tiles = reader.GetTileSet(TileHierarchy::levels().back().level);
-  for (const auto& tile_id : local_tiles) {
+  ProcessLocalTiles(pt, concurrency, [&tile_lock](GraphReader& reader, const GraphId& tile_id) {
+    enhancer_stats stats{std::numeric_limits<float>::min(), 0, 0, 0, 0, 0, 0, {0}};
     GraphTileBuilder tilebuilder(reader.tile_dir(), tile_id, true);
 
     // Get the graph tile. Read from this tile to create the new tile.
@@ -982,6 +1059,7 @@ void UpdateOpposingIndexAndTransitions(GraphReader& reader) {
         if (tile->id() == edge->endnode().tile_base()) {
           endnodetile = tile;
         } else {
+          std::lock_guard<std::mutex> guard(tile_lock);
           endnodetile = reader.GetGraphTile(edge->endnode());
         }
 
@@ -997,12 +1075,9 @@ void UpdateOpposingIndexAndTransitions(GraphReader& reader) {
     }
 
     // Update the tile with new directededges.
+    std::lock_guard<std::mutex> guard(tile_lock);
     tilebuilder.Update(nodes, directededges);
-
-    if (reader.OverCommitted()) {
-      reader.Trim();
-    }
-  }
+  });
 }
 
 } // namespace
@@ -1012,9 +1087,6 @@ namespace mjolnir {
 
 // Optionally filter edges and nodes based on access.
 void GraphFilter::Filter(const boost::property_tree::ptree& pt) {
-
-  // TODO: thread this. Could be difficult due to sequence creates to associate nodes
-
   SCOPED_TIMER();
   // Edge filtering (optionally exclude edges)
   bool include_driving = pt.get_child("mjolnir").get<bool>("include_driving", true);
@@ -1041,30 +1113,27 @@ void GraphFilter::Filter(const boost::property_tree::ptree& pt) {
   // Map of updated local indexes at nodes where edges have been filtered
   std::unordered_map<GraphId, std::vector<uint8_t>> updated_local_indexes;
 
-  // Construct GraphReader
-  GraphReader reader(pt.get_child("mjolnir"));
+  // Each stage works on the tiles in parallel, every thread with a GraphReader of its own
+  const auto& hierarchy_properties = pt.get_child("mjolnir");
+  unsigned int concurrency =
+      std::max(1u, pt.get<unsigned int>("mjolnir.concurrency", std::thread::hardware_concurrency()));
 
   // Filter edges (and nodes) by access
-  FilterTiles(reader, old_to_new, updated_local_indexes, include_driving, include_bicycle,
-              include_pedestrian);
+  FilterTiles(hierarchy_properties, concurrency, old_to_new, updated_local_indexes, include_driving,
+              include_bicycle, include_pedestrian);
 
-  // Update end nodes. Clear the GraphReader cache first.
-  reader.Clear();
-  UpdateEndNodes(reader, old_to_new, updated_local_indexes);
+  // Update end nodes
+  UpdateEndNodes(hierarchy_properties, concurrency, old_to_new, updated_local_indexes);
 
-  reader.Clear();
   old_to_new.clear();
-  AggregateTiles(reader, old_to_new);
+  AggregateTiles(hierarchy_properties, concurrency, old_to_new);
 
-  // Update end nodes. Clear the GraphReader cache first.
-  reader.Clear();
-  // Only update the indexes once.
+  // Update end nodes. Only update the indexes once.
   updated_local_indexes.clear();
-  UpdateEndNodes(reader, old_to_new, updated_local_indexes);
+  UpdateEndNodes(hierarchy_properties, concurrency, old_to_new, updated_local_indexes);
 
-  // Update Opposing Edge Index. Clear the GraphReader cache first.
-  reader.Clear();
-  UpdateOpposingIndexAndTransitions(reader);
+  // Update Opposing Edge Index
+  UpdateOpposingIndexAndTransitions(hierarchy_properties, concurrency);
 
   LOG_INFO("Done GraphFilter");
 }
@@ -12,8 +12,16 @@
 
 #include <boost/property_tree/ptree.hpp>
 
+#include <algorithm>
+#include <deque>
 #include <filesystem>
+#include <future>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <numeric>
 #include <string>
+#include <thread>
 #include <utility>
 #include <vector>
 
@@ -23,6 +31,9 @@ using namespace valhalla::mjolnir;
 
 namespace {
 
+// How many base tiles each thread reads per batch when creating the node associations
+constexpr size_t kTilesPerThreadBatch = 64;
+
 // Structure to associate old nodes to new nodes. Stored in a sequence so
 // this can work on lower memory computers. Note that an original node can
 // associate to multiple nodes on different hierarchy levels. If a node does
@@ -71,24 +82,31 @@ bool AddUpwardTransition(const GraphId& node, GraphTileBuilder* tilebuilder) {
   }
 }
 
-void SortSequences(const std::string& new_to_old_file, const std::string& old_to_new_file) {
+// A non zero sort_memory_budget sorts the files externally within that many bytes
+void SortSequences(const std::string& new_to_old_file,
+                   const std::string& old_to_new_file,
+                   size_t sort_memory_budget,
+                   unsigned int concurrency) {
   SCOPED_TIMER();
   // Sort the new nodes. Sort so highway level is first
   sequence<std::pair<GraphId, GraphId>> new_to_old(new_to_old_file, false);
-  new_to_old.sort([](const std::pair<GraphId, GraphId>& a, const std::pair<GraphId, GraphId>& b) {
-    if (a.first.level() == b.first.level()) {
-      if (a.first.tileid() == b.first.tileid()) {
-        return a.first.id() < b.first.id();
-      }
-      return a.first.tileid() < b.first.tileid();
-    }
-    return a.first.level() < b.first.level();
-  });
+  new_to_old.external_sort(
+      [](const std::pair<GraphId, GraphId>& a, const std::pair<GraphId, GraphId>& b) {
+        if (a.first.level() == b.first.level()) {
+          if (a.first.tileid() == b.first.tileid()) {
+            return a.first.id() < b.first.id();
+          }
+          return a.first.tileid() < b.first.tileid();
+        }
+        return a.first.level() < b.first.level();
+      },
+      sort_memory_budget, concurrency);
 
   // Sort old to new by node Id
   sequence<OldToNewNodes> old_to_new(old_to_new_file, false);
-  old_to_new.sort(
-      [](const OldToNewNodes& a, const OldToNewNodes& b) { return a.node_id < b.node_id; });
+  old_to_new.external_sort(
+      [](const OldToNewNodes& a, const OldToNewNodes& b) { return a.node_id < b.node_id; },
+      sort_memory_budget, concurrency);
 }
 
 // Convenience method to find the node association.
@@ -105,17 +123,18 @@ OldToNewNodes find_nodes(sequence<OldToNewNodes>& old_to_new, const GraphId& nod
   }
 }
 
-// Form tiles in the new level.
-void FormTilesInNewLevel(GraphReader& reader,
-                         const std::string& new_to_old_file,
-                         const std::string& old_to_new_file) {
-  SCOPED_TIMER();
-  // Use the sequence that associate new nodes to old nodes
-  sequence<std::pair<GraphId, GraphId>> new_to_old(new_to_old_file, false);
-
-  // Use the sorted sequence that associates old nodes to new nodes
-  sequence<OldToNewNodes> old_to_new(old_to_new_file, false);
+// A run of the sorted new to old sequence which makes up a single tile in a new level
+struct NewTile {
+  GraphId tile_id;
+  size_t begin;
+  size_t end;
+};
 
+// Form a single tile in a new level from its run of new nodes
+void FormTileInNewLevel(GraphReader& reader,
+                        sequence<std::pair<GraphId, GraphId>>& new_to_old,
+                        sequence<OldToNewNodes>& old_to_new,
+                        const NewTile& new_tile) {
   // lambda to indicate whether a directed edge should be included
   auto include_edge = [&old_to_new](const DirectedEdge* directededge, const GraphId& base_node,
                                     const uint8_t current_level) {
@@ -143,39 +162,21 @@ void FormTilesInNewLevel(GraphReader& reader,
     }
   };
 
-  // Iterate through the new nodes. They have been sorted by level so that
-  // highway level is done first.
-  reader.Clear();
+  // New tilebuilder for this tile
   bool added = false;
-  uint8_t current_level = std::numeric_limits<uint8_t>::max();
-  GraphId tile_id;
   std::hash<std::string> hasher;
-  PointLL base_ll;
-  GraphTileBuilder* tilebuilder = nullptr;
-  for (auto new_node = new_to_old.begin(); new_node != new_to_old.end(); new_node++) {
-    // Get the node - check if a new tile
-    GraphId nodea = (*new_node).first;
-    if (nodea.tile_base() != tile_id) {
-      // Store the prior tile
-      if (tilebuilder != nullptr) {
-        tilebuilder->StoreTileData();
-        delete tilebuilder;
-      }
-
-      // New tilebuilder for the next tile. Update current level.
-      tile_id = nodea.tile_base();
-      tilebuilder = new GraphTileBuilder(reader.tile_dir(), tile_id, false);
-      current_level = nodea.level();
+  GraphId tile_id = new_tile.tile_id;
+  uint8_t current_level = tile_id.level();
+  GraphTileBuilder tilebuilder(reader.tile_dir(), tile_id, false);
 
-      // Set the base ll for this tile
-      base_ll = TileHierarchy::get_tiling(current_level).Base(tile_id.tileid());
-      tilebuilder->header_builder().set_base_ll(base_ll);
+  // Set the base ll for this tile
+  PointLL base_ll = TileHierarchy::get_tiling(current_level).Base(tile_id.tileid());
+  tilebuilder.header_builder().set_base_ll(base_ll);
 
-      // Check if we need to clear the base/local tile cache
-      if (reader.OverCommitted()) {
-        reader.Trim();
-      }
-    }
+  // Iterate through the new nodes of this tile
+  auto new_node = new_to_old.at(new_tile.begin);
+  for (size_t n = new_tile.begin; n < new_tile.end; ++n, ++new_node) {
+    GraphId nodea = (*new_node).first;
 
     // Get the node in the base level
     GraphId base_node = (*new_node).second;
@@ -186,26 +187,26 @@ void FormTilesInNewLevel(GraphReader& reader,
     }
 
     // Copy the data version & checksum
-    tilebuilder->header_builder().set_dataset_id(tile->header()->dataset_id());
-    tilebuilder->header_builder().set_checksum(tile->header()->checksum());
+    tilebuilder.header_builder().set_dataset_id(tile->header()->dataset_id());
+    tilebuilder.header_builder().set_checksum(tile->header()->checksum());
 
     // Copy node information and set the node lat,lon offsets within the new tile
     NodeInfo baseni = *(tile->node(base_node.id()));
-    tilebuilder->nodes().push_back(baseni);
+    tilebuilder.nodes().push_back(baseni);
     const auto& admin = tile->admininfo(baseni.admin_index());
-    NodeInfo& node = tilebuilder->nodes().back();
+    NodeInfo& node = tilebuilder.nodes().back();
     node.set_latlng(base_ll, baseni.latlng(tile->header()->base_ll()));
-    node.set_edge_index(tilebuilder->directededges().size());
+    node.set_edge_index(tilebuilder.directededges().size());
     node.set_timezone(baseni.timezone());
-    node.set_admin_index(tilebuilder->AddAdmin(admin.country_text(), admin.state_text(),
-                                               admin.country_iso(), admin.state_iso()));
+    node.set_admin_index(tilebuilder.AddAdmin(admin.country_text(), admin.state_text(),
+                                              admin.country_iso(), admin.state_iso()));
 
     // Update node LL based on tile base
     // Density at this node
     uint32_t density1 = baseni.density();
 
     // Current edge count
-    size_t edge_count = tilebuilder->directededges().size();
+    size_t edge_count = tilebuilder.directededges().size();
 
     // Iterate through directed edges of the base node to get remaining
     // directed edges (based on classification/importance cutoff)
@@ -259,13 +260,13 @@ void FormTilesInNewLevel(GraphReader& reader,
         if (signs.size() == 0) {
           LOG_ERROR("Base edge should have signs, but none found");
         }
-        tilebuilder->AddSigns(tilebuilder->directededges().size(), signs);
+        tilebuilder.AddSigns(tilebuilder.directededges().size(), signs);
       }
 
       // Get turn lanes from the base directed edge
       if (directededge->turnlanes()) {
         uint32_t offset = tile->turnlanes_offset(base_edge_id.id());
-        tilebuilder->AddTurnLanes(tilebuilder->directededges().size(), tile->GetName(offset));
+        tilebuilder.AddTurnLanes(tilebuilder.directededges().size(), tile->GetName(offset));
       }
 
       // Get access restrictions from the base directed edge. Add these to
@@ -274,19 +275,19 @@ void FormTilesInNewLevel(GraphReader& reader,
       if (directededge->access_restriction()) {
         auto restrictions = tile->GetAccessRestrictions(base_edge_id.id()).first;
         for (const auto& res : restrictions) {
-          tilebuilder->AddAccessRestriction(AccessRestriction(tilebuilder->directededges().size(),
-                                                              res.type(), res.modes(), res.value(),
-                                                              res.except_destination()));
+          tilebuilder.AddAccessRestriction(AccessRestriction(tilebuilder.directededges().size(),
+                                                             res.type(), res.modes(), res.value(),
+                                                             res.except_destination()));
         }
       }
 
       // Copy lane connectivity
       if (directededge->laneconnectivity()) {
-        tilebuilder->CopyLaneConnectivityFromTile(tile, base_edge_id.id());
+        tilebuilder.CopyLaneConnectivityFromTile(tile, base_edge_id.id());
       }
 
       // Names can be different in the forward and backward direction
-      bool diff_names = tilebuilder->OpposingEdgeInfoDiffers(tile, directededge);
+      bool diff_names = tilebuilder.OpposingEdgeInfoDiffers(tile, directededge);
 
       // Get edge info, shape, and names from the old tile and add to the
       // new. Cannot use edge info offset since edges in arterial and
@@ -296,11 +297,11 @@ void FormTilesInNewLevel(GraphReader& reader,
       std::string encoded_shape = edgeinfo.encoded_shape();
       uint32_t w = hasher(encoded_shape + std::to_string(edgeinfo.wayid()));
       uint32_t edge_info_offset =
-          tilebuilder->AddEdgeInfo(w, nodea, nodeb, edgeinfo.wayid(), edgeinfo.mean_elevation(),
-                                   edgeinfo.bike_network(), edgeinfo.speed_limit(), encoded_shape,
-                                   edgeinfo.GetNames(), edgeinfo.GetTaggedValues(),
-                                   edgeinfo.GetLinguisticTaggedValues(), edgeinfo.GetTypes(), added,
-                                   diff_names);
+          tilebuilder.AddEdgeInfo(w, nodea, nodeb, edgeinfo.wayid(), edgeinfo.mean_elevation(),
+                                  edgeinfo.bike_network(), edgeinfo.speed_limit(), encoded_shape,
+                                  edgeinfo.GetNames(), edgeinfo.GetTaggedValues(),
+                                  edgeinfo.GetLinguisticTaggedValues(), edgeinfo.GetTypes(), added,
+                                  diff_names);
 
       newedge.set_edgeinfo_offset(edge_info_offset);
 
@@ -308,34 +309,34 @@ void FormTilesInNewLevel(GraphReader& reader,
       newedge.set_hierarchy_roadclass(RoadClass::kMotorway, true);
 
       // Add directed edge
-      tilebuilder->directededges().emplace_back(std::move(newedge));
+      tilebuilder.directededges().emplace_back(std::move(newedge));
     }
 
     // Add node transitions
-    uint32_t index = tilebuilder->transitions().size();
+    uint32_t index = tilebuilder.transitions().size();
     auto new_nodes = find_nodes(old_to_new, base_node);
     if (current_level == 0) {
-      AddDownwardTransition(new_nodes.arterial_node, tilebuilder);
-      AddDownwardTransition(new_nodes.local_node, tilebuilder);
+      AddDownwardTransition(new_nodes.arterial_node, &tilebuilder);
+      AddDownwardTransition(new_nodes.local_node, &tilebuilder);
     } else if (current_level == 1) {
-      AddUpwardTransition(new_nodes.highway_node, tilebuilder);
-      AddDownwardTransition(new_nodes.local_node, tilebuilder);
+      AddUpwardTransition(new_nodes.highway_node, &tilebuilder);
+      AddDownwardTransition(new_nodes.local_node, &tilebuilder);
     } else if (current_level == 2) {
-      AddUpwardTransition(new_nodes.highway_node, tilebuilder);
-      AddUpwardTransition(new_nodes.arterial_node, tilebuilder);
+      AddUpwardTransition(new_nodes.highway_node, &tilebuilder);
+      AddUpwardTransition(new_nodes.arterial_node, &tilebuilder);
     } else {
       throw std::logic_error("current_level was never set");
     }
 
     // Set the node transition count and index
-    uint32_t count = tilebuilder->transitions().size() - index;
+    uint32_t count = tilebuilder.transitions().size() - index;
     if (count > 0) {
       node.set_transition_count(count);
       node.set_transition_index(index);
     }
 
     // Set the edge count for the new node
-    node.set_edge_count(tilebuilder->directededges().size() - edge_count);
+    node.set_edge_count(tilebuilder.directededges().size() - edge_count);
 
     // Get named signs from the base node
     if (baseni.named_intersection()) {
@@ -344,14 +345,181 @@ void FormTilesInNewLevel(GraphReader& reader,
         LOG_ERROR("Base node should have signs, but none found");
       }
       node.set_named_intersection(true);
-      tilebuilder->AddSigns(tilebuilder->nodes().size() - 1, signs);
+      tilebuilder.AddSigns(tilebuilder.nodes().size() - 1, signs);
     }
   }
 
-  // Delete the tile builder
-  if (tilebuilder != nullptr) {
-    tilebuilder->StoreTileData();
-    delete tilebuilder;
+  // Store the tile
+  tilebuilder.StoreTileData();
+}
+
+// Form the tiles in the queue. Each thread has its own reader and node association sequences
+void FormTiles(const boost::property_tree::ptree& pt,
+               const std::string& new_to_old_file,
+               const std::string& old_to_new_file,
+               std::deque<NewTile>& tilequeue,
+               std::mutex& lock,
+               std::promise<void>& result) {
+  try {
+    GraphReader reader(pt);
+    sequence<std::pair<GraphId, GraphId>> new_to_old(new_to_old_file, false);
+    sequence<OldToNewNodes> old_to_new(old_to_new_file, false);
+    while (true) {
+      // Get the next tile
+      lock.lock();
+      if (tilequeue.empty()) {
+        lock.unlock();
+        break;
+      }
+      NewTile new_tile = tilequeue.front();
+      tilequeue.pop_front();
+      lock.unlock();
+
+      FormTileInNewLevel(reader, new_to_old, old_to_new, new_tile);
+
+      // Check if we need to clear the base/local tile cache
+      if (reader.OverCommitted()) {
+        reader.Trim();
+      }
+    }
+    result.set_value();
+  } catch (...) {
+    result.set_exception(std::current_exception());
+  }
+}
+
+// Form tiles in the new levels.
+void FormTilesInNewLevel(const boost::property_tree::ptree& pt,
+                         const std::string& new_to_old_file,
+                         const std::string& old_to_new_file,
+                         unsigned int concurrency) {
+  SCOPED_TIMER();
+  // Find the run of new nodes that makes up each new tile. The new nodes have been sorted by tile
+  std::vector<NewTile> new_tiles;
+  {
+    sequence<std::pair<GraphId, GraphId>> new_to_old(new_to_old_file, false);
+    size_t index = 0;
+    for (auto new_node = new_to_old.begin(); new_node != new_to_old.end(); ++new_node, ++index) {
+      GraphId tile_id = (*new_node).first.tile_base();
+      if (new_tiles.empty() || new_tiles.back().tile_id != tile_id) {
+        if (!new_tiles.empty()) {
+          new_tiles.back().end = index;
+        }
+        new_tiles.push_back({tile_id, index, 0});
+      }
+    }
+    if (!new_tiles.empty()) {
+      new_tiles.back().end = index;
+    }
+  }
+
+  // The highway and arterial tiles read from the base tiles, which the local tiles overwrite. So
+  // all of the former have to be done before any of the latter. Each local tile only reads its own
+  // base tile so they are safe to do in parallel with each other
+  auto local_level = TileHierarchy::levels().back().level;
+  auto is_upper = [local_level](const NewTile& t) { return t.tile_id.level() != local_level; };
+  auto local_begin = std::stable_partition(new_tiles.begin(), new_tiles.end(), is_upper);
+  std::deque<NewTile> upper_tiles(new_tiles.begin(), local_begin);
+  std::deque<NewTile> local_tiles(local_begin, new_tiles.end());
+
+  for (auto* tilequeue : {&upper_tiles, &local_tiles}) {
+    std::mutex lock;
+    std::vector<std::shared_ptr<std::thread>> threads(
+        std::max(1u, std::min(concurrency, static_cast<unsigned int>(tilequeue->size()))));
+    std::list<std::promise<void>> results;
+    for (auto& thread : threads) {
+      results.emplace_back();
+      thread = std::make_shared<std::thread>(FormTiles, std::cref(pt), std::cref(new_to_old_file),
+                                             std::cref(old_to_new_file), std::ref(*tilequeue),
+                                             std::ref(lock), std::ref(results.back()));
+    }
+    for (auto& thread : threads) {
+      thread->join();
+    }
+    // rethrow anything that went wrong
+    for (auto& result : results) {
+      result.get_future().get();
+    }
+  }
+}
+
+// The hierarchy levels a base node exists on along with the tiles its new nodes fall in on the
+// highway and arterial levels
+struct NodeLevels {
+  uint32_t highway_tile;
+  uint32_t arterial_tile;
+  uint32_t density;
+  bool levels[3];
+};
+
+// Figure out the levels of each node in the queued base tiles. Each thread has its own reader and
+// only fills out the entries of the tiles it took off the queue
+void GetNodeLevels(const boost::property_tree::ptree& pt,
+                   const GraphId* base_tiles,
+                   std::deque<size_t>& tilequeue,
+                   std::mutex& lock,
+                   std::vector<std::vector<NodeLevels>>& node_levels,
+                   std::promise<void>& result) {
+  try {
+    GraphReader reader(pt);
+    const auto& arterial_level = TileHierarchy::levels()[1];
+    const auto& highway_level = TileHierarchy::levels()[0];
+    while (true) {
+      // Get the next tile
+      lock.lock();
+      if (tilequeue.empty()) {
+        lock.unlock();
+        break;
+      }
+      size_t index = tilequeue.front();
+      tilequeue.pop_front();
+      lock.unlock();
+
+      // Get the graph tile. Skip if no tile exists or no nodes exist in the tile.
+      const GraphId& base_tile_id = base_tiles[index];
+      graph_tile_ptr tile = reader.GetGraphTile(base_tile_id);
+      if (!tile) {
+        continue;
+      }
+
+      // Iterate through the nodes. Add nodes to the new level when
+      // best road class <= the new level classification cutoff
+      auto& nodes = node_levels[index];
+      uint32_t nodecount = tile->header()->nodecount();
+      nodes.resize(nodecount);
+      GraphId edgeid = base_tile_id;
+      PointLL base_ll = tile->header()->base_ll();
+      const NodeInfo* nodeinfo = tile->node(base_tile_id);
+      for (uint32_t i = 0; i < nodecount; i++, nodeinfo++) {
+        // Iterate through the edges to see which levels this node exists.
+        auto& node = nodes[i];
+        node.levels[0] = node.levels[1] = node.levels[2] = false;
+        for (uint32_t j = 0; j < nodeinfo->edge_count(); j++, ++edgeid) {
+          // Update the flag for the level of this edge (skip transit
+          // connection edges)
+          const DirectedEdge* directededge = tile->directededge(edgeid);
+          if (directededge->bss_connection()) {
+            // Despite the road class, Bike Share Stations' connections are always at local level
+            node.levels[2] = true;
+          } else if (directededge->use() != Use::kTransitConnection &&
+                     directededge->use() != Use::kEgressConnection &&
+                     directededge->use() != Use::kPlatformConnection) {
+            node.levels[get_hierarchy_level(directededge)] = true;
+          }
+        }
+        node.highway_tile = highway_level.tiles.TileId(nodeinfo->latlng(base_ll));
+        node.arterial_tile = arterial_level.tiles.TileId(nodeinfo->latlng(base_ll));
+        node.density = nodeinfo->density();
+      }
+
+      // Check if we need to clear the tile cache
+      if (reader.OverCommitted()) {
+        reader.Trim();
+      }
+    }
+    result.set_value();
+  } catch (...) {
+    result.set_exception(std::current_exception());
   }
 }
 
@@ -361,10 +529,16 @@ void FormTilesInNewLevel(GraphReader& reader,
  * associations go both ways: from the "old" nodes on the base/local level
  * to new nodes (using a mapping in memory) and from new nodes to old nodes
  * using a sequence (file).
+ *
+ * The base tiles are read in parallel a batch at a time but the new node Ids
+ * are handed out serially in base tile order, so they do not depend on the
+ * number of threads.
  */
-void CreateNodeAssociations(GraphReader& reader,
+void CreateNodeAssociations(const boost::property_tree::ptree& pt,
+                            GraphReader& reader,
                             const std::string& new_to_old_file,
-                            const std::string& old_to_new_file) {
+                            const std::string& old_to_new_file,
+                            unsigned int concurrency) {
   SCOPED_TIMER();
   // Map of tiles vs. count of nodes. Used to construct new node Ids.
   std::unordered_map<GraphId, uint32_t> new_nodes;
@@ -390,83 +564,77 @@ void CreateNodeAssociations(GraphReader& reader,
   sequence<OldToNewNodes> old_to_new(old_to_new_file, true);
 
   // Hierarchy level information
-  const auto& arterial_level = TileHierarchy::levels()[1];
-  uint32_t al = static_cast<uint32_t>(arterial_level.level);
-  const auto& highway_level = TileHierarchy::levels()[0];
-  uint32_t hl = static_cast<uint32_t>(highway_level.level);
-
-  // Iterate through all tiles in the local level
-  auto local_tiles = reader.GetTileSet();
-  for (const auto& base_tile_id : local_tiles) {
-    // We keep all transit data inside the transit hierarchy
-    if (base_tile_id.level() == TileHierarchy::GetTransitLevel().level) {
-      continue;
+  uint32_t al = static_cast<uint32_t>(TileHierarchy::levels()[1].level);
+  uint32_t hl = static_cast<uint32_t>(TileHierarchy::levels()[0].level);
+
+  // All tiles in the local level. We keep all transit data inside the transit hierarchy
+  std::vector<GraphId> local_tiles;
+  for (const auto& base_tile_id : reader.GetTileSet()) {
+    if (base_tile_id.level() != TileHierarchy::GetTransitLevel().level) {
+      local_tiles.push_back(base_tile_id);
     }
+  }
 
-    // Get the graph tile. Skip if no tile exists or no nodes exist in the tile.
-    graph_tile_ptr tile = reader.GetGraphTile(base_tile_id);
-    if (!tile) {
-      continue;
+  // Work through them a batch at a time so we only hold on to the levels of a few tiles' nodes
+  const size_t batch_size = concurrency * kTilesPerThreadBatch;
+  std::vector<std::vector<NodeLevels>> node_levels;
+  for (size_t batch = 0; batch < local_tiles.size(); batch += batch_size) {
+    // Get the levels of the nodes in this batch of tiles
+    size_t count = std::min(batch_size, local_tiles.size() - batch);
+    node_levels.assign(count, {});
+    std::deque<size_t> tilequeue(count);
+    std::iota(tilequeue.begin(), tilequeue.end(), 0);
+    std::mutex lock;
+    std::vector<std::shared_ptr<std::thread>> threads(
+        std::min(static_cast<size_t>(concurrency), count));
+    std::list<std::promise<void>> results;
+    for (auto& thread : threads) {
+      results.emplace_back();
+      thread = std::make_shared<std::thread>(GetNodeLevels, std::cref(pt), &local_tiles[batch],
+                                             std::ref(tilequeue), std::ref(lock),
+                                             std::ref(node_levels), std::ref(results.back()));
+    }
+    for (auto& thread : threads) {
+      thread->join();
+    }
+    // rethrow anything that went wrong
+    for (auto& result : results) {
+      result.get_future().get();
     }
 
-    // Iterate through the nodes. Add nodes to the new level when
-    // best road class <= the new level classification cutoff
-    bool levels[3];
-    uint32_t nodecount = tile->header()->nodecount();
-    GraphId basenode = base_tile_id;
-    GraphId edgeid = base_tile_id;
-    PointLL base_ll = tile->header()->base_ll();
-    const NodeInfo* nodeinfo = tile->node(basenode);
-    for (uint32_t i = 0; i < nodecount; i++, nodeinfo++, ++basenode) {
-      // Iterate through the edges to see which levels this node exists.
-      levels[0] = levels[1] = levels[2] = false;
-      for (uint32_t j = 0; j < nodeinfo->edge_count(); j++, ++edgeid) {
-        // Update the flag for the level of this edge (skip transit
-        // connection edges)
-        const DirectedEdge* directededge = tile->directededge(edgeid);
-        if (directededge->bss_connection()) {
-          // Despite the road class, Bike Share Stations' connections are always at local level
-          levels[2] = true;
-        } else if (directededge->use() != Use::kTransitConnection &&
-                   directededge->use() != Use::kEgressConnection &&
-                   directededge->use() != Use::kPlatformConnection) {
-          levels[get_hierarchy_level(directededge)] = true;
+    // Associate them in tile order
+    for (size_t t = 0; t < count; ++t) {
+      const GraphId& base_tile_id = local_tiles[batch + t];
+      GraphId basenode = base_tile_id;
+      for (const auto& node : node_levels[t]) {
+        // Associate new nodes to base nodes and base node to new nodes
+        GraphId highway_node, arterial_node, local_node;
+        if (node.levels[0]) {
+          // New node is on the highway level. Associate back to base/local node
+          highway_node = get_new_node(GraphId(node.highway_tile, hl, 0));
+          new_to_old.push_back(std::make_pair(highway_node, basenode));
+        }
+        if (node.levels[1]) {
+          // New node is on the arterial level. Associate back to base/local node
+          arterial_node = get_new_node(GraphId(node.arterial_tile, al, 0));
+          new_to_old.push_back(std::make_pair(arterial_node, basenode));
+        }
+        if (node.levels[2]) {
+          // New node is on the local level. Associate back to base/local node
+          local_node = get_new_node(base_tile_id);
+          new_to_old.push_back(std::make_pair(local_node, basenode));
         }
-      }
 
-      // Associate new nodes to base nodes and base node to new nodes
-      GraphId highway_node, arterial_node, local_node;
-      if (levels[0]) {
-        // New node is on the highway level. Associate back to base/local node
-        GraphId new_tile(highway_level.tiles.TileId(nodeinfo->latlng(base_ll)), hl, 0);
-        highway_node = get_new_node(new_tile);
-        new_to_old.push_back(std::make_pair(highway_node, basenode));
-      }
-      if (levels[1]) {
-        // New node is on the arterial level. Associate back to base/local node
-        GraphId new_tile(arterial_level.tiles.TileId(nodeinfo->latlng(base_ll)), al, 0);
-        arterial_node = get_new_node(new_tile);
-        new_to_old.push_back(std::make_pair(arterial_node, basenode));
-      }
-      if (levels[2]) {
-        // New node is on the local level. Associate back to base/local node
-        local_node = get_new_node(base_tile_id);
-        new_to_old.push_back(std::make_pair(local_node, basenode));
-      }
+        if (!node.levels[0] && !node.levels[1] && !node.levels[2]) {
+          LOG_ERROR("No valid level for this node!");
+        }
 
-      if (!levels[0] && !levels[1] && !levels[2]) {
-        LOG_ERROR("No valid level for this node!");
+        // Associate the old node to the new node(s). Entries in the tuple
+        // that are invalid nodes indicate no node exists in the new level.
+        OldToNewNodes assoc(basenode, highway_node, arterial_node, local_node, node.density);
+        old_to_new.push_back(assoc);
+        ++basenode;
       }
-
-      // Associate the old node to the new node(s). Entries in the tuple
-      // that are invalid nodes indicate no node exists in the new level.
-      OldToNewNodes assoc(basenode, highway_node, arterial_node, local_node, nodeinfo->density());
-      old_to_new.push_back(assoc);
-    }
-
-    // Check if we need to clear the tile cache
-    if (reader.OverCommitted()) {
-      reader.Trim();
     }
   }
 }
@@ -568,24 +736,25 @@ namespace mjolnir {
 void HierarchyBuilder::Build(const boost::property_tree::ptree& pt,
                              const std::string& new_to_old_file,
                              const std::string& old_to_new_file) {
-
-  // TODO: thread this. Might be more possible now that we don't create
-  // shortcuts in the HierarchyBuilder
-
   SCOPED_TIMER();
   // Construct GraphReader
   LOG_INFO("HierarchyBuilder");
   GraphReader reader(pt.get_child("mjolnir"));
+  unsigned int concurrency =
+      std::max(1u, pt.get<unsigned int>("mjolnir.concurrency", std::thread::hardware_concurrency()));
 
   // Association of old nodes to new nodes
-  CreateNodeAssociations(reader, new_to_old_file, old_to_new_file);
+  CreateNodeAssociations(pt.get_child("mjolnir"), reader, new_to_old_file, old_to_new_file,
+                         concurrency);
 
   // Sort the sequences
-  SortSequences(new_to_old_file, old_to_new_file);
+  SortSequences(new_to_old_file, old_to_new_file,
+                pt.get<size_t>("mjolnir.data_processing.sort_memory_budget_mb", 0) * 1024 * 1024,
+                concurrency);
 
   // Iterate through the hierarchy (from highway down to local) and build
   // new tiles
-  FormTilesInNewLevel(reader, new_to_old_file, old_to_new_file);
+  FormTilesInNewLevel(pt.get_child("mjolnir"), new_to_old_file, old_to_new_file, concurrency);
 
   // Remove any base tiles that no longer have any data (nodes and edges
   // only exist on arterial and highway levels)
@@ -0,0 +1,2086 @@
+#include "mjolnir/nativetagtransform.h"
+#include "midgard/logging.h"
+#include "mjolnir/luatagtransform.h"
+
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <optional>
+#include <stdexcept>
+#include <string_view>
+
+using namespace valhalla::mjolnir;
+
+// This mirrors lua/graph.lua statement by statement, including its quirks, so that both transforms
+// produce the same tags. nullptr and std::nullopt play the part of lua's nil and numbers are
+// formatted the way lua converts them to strings. Keep it that way when changing either of them.
+
+namespace {
+
+constexpr const char* kTrue = "true";
+constexpr const char* kFalse = "false";
+
+template <typename T> using table_t = ankerl::unordered_dense::map<std::string_view, T>;
+
+// clang-format off
+// auto, truck, bus, taxi, moped, motorcycle, pedestrian, bike
+const std::array<std::string, 8> kForward = {"auto_forward", "truck_forward", "bus_forward",
+  "taxi_forward", "moped_forward", "motorcycle_forward", "pedestrian_forward", "bike_forward"};
+const std::array<std::string, 8> kBackward = {"auto_backward", "truck_backward", "bus_backward",
+  "taxi_backward", "moped_backward", "motorcycle_backward", "pedestrian_backward", "bike_backward"};
+constexpr size_t kPedestrian = 6;
+
+const table_t<std::array<bool, 8>> kHighway = {
+  {"motorway",         {true,  true,  true,  true,  false, true,  false, false}},
+  {"motorway_link",    {true,  true,  true,  true,  false, true,  false, false}},
+  {"trunk",            {true,  true,  true,  true,  true,  true,  true,  true}},
+  {"trunk_link",       {true,  true,  true,  true,  true,  true,  true,  true}},
+  {"primary",          {true,  true,  true,  true,  true,  true,  true,  true}},
+  {"primary_link",     {true,  true,  true,  true,  true,  true,  true,  true}},
+  {"secondary",        {true,  true,  true,  true,  true,  true,  true,  true}},
+  {"secondary_link",   {true,  true,  true,  true,  true,  true,  true,  true}},
+  {"residential",      {true,  true,  true,  true,  true,  true,  true,  true}},
+  {"residential_link", {true,  true,  true,  true,  true,  true,  true,  true}},
+  {"service",          {true,  true,  true,  true,  true,  true,  true,  true}},
+  {"tertiary",         {true,  true,  true,  true,  true,  true,  true,  true}},
+  {"tertiary_link",    {true,  true,  true,  true,  true,  true,  true,  true}},
+  {"road",             {true,  true,  true,  true,  true,  true,  true,  true}},
+  {"track",            {true,  true,  true,  true,  true,  true,  true,  true}},
+  {"unclassified",     {true,  true,  true,  true,  true,  true,  true,  true}},
+  {"undefined",        {false, false, false, false, false, false, false, false}},
+  {"unknown",          {false, false, false, false, false, false, false, false}},
+  {"living_street",    {true,  true,  true,  true,  true,  true,  true,  true}},
+  {"footway",          {false, false, false, false, false, false, true,  false}},
+  {"pedestrian",       {false, false, false, false, false, false, true,  false}},
+  {"steps",            {false, false, false, false, false, false, true,  true}},
+  {"bridleway",        {false, false, false, false, false, false, false, false}},
+  {"cycleway",         {false, false, false, false, false, false, false, true}},
+  {"path",             {false, false, false, false, false, false, true,  true}},
+  {"bus_guideway",     {false, false, true,  false, false, false, false, false}},
+  {"busway",           {false, false, true,  false, false, false, false, false}},
+  {"corridor",         {false, false, false, false, false, false, true,  false}},
+  {"elevator",         {false, false, false, false, false, false, true,  false}},
+  {"platform",         {false, false, false, false, false, false, true,  false}},
+  {"via_ferrata",      {false, false, false, false, false, false, true,  false}},
+};
+
+const table_t<int> kRoadClass = {
+  {"motorway", 0}, {"motorway_link", 0}, {"trunk", 1}, {"trunk_link", 1}, {"primary", 2},
+  {"primary_link", 2}, {"secondary", 3}, {"secondary_link", 3}, {"tertiary", 4},
+  {"tertiary_link", 4}, {"unclassified", 5}, {"residential", 6}, {"residential_link", 6},
+};
+
+const table_t<int> kRestriction = {
+  {"no_left_turn", 0}, {"no_right_turn", 1}, {"no_straight_on", 2}, {"no_u_turn", 3},
+  {"only_right_turn", 4}, {"only_left_turn", 5}, {"only_straight_on", 6}, {"no_entry", 7},
+  {"no_exit", 8}, {"no_turn", 9},
+};
+
+// the default speed for tracks is lowered afterwards
+constexpr std::array<int, 8> kDefaultSpeed = {105, 90, 75, 60, 50, 40, 35, 25};
+
+const table_t<const char*> kAccess = {
+  {"yes", kTrue}, {"private", kTrue}, {"no", kFalse}, {"permissive", kTrue},
+  {"agricultural", kFalse}, {"use_sidepath", kTrue}, {"delivery", kTrue}, {"designated", kTrue},
+  {"dismount", kTrue}, {"discouraged", kFalse}, {"forestry", kFalse}, {"destination", kTrue},
+  {"customers", kTrue}, {"official", kTrue}, {"public", kTrue}, {"restricted", kTrue},
+  {"allowed", kTrue}, {"emergency", kFalse}, {"psv", kFalse}, {"permit", kTrue},
+  {"residents", kTrue},
+};
+
+const table_t<const char*> kPrivate = {
+  {"private", kTrue}, {"destination", kTrue}, {"customers", kTrue}, {"delivery", kTrue},
+  {"permit", kTrue}, {"residents", kTrue},
+};
+
+const table_t<const char*> kNoThruTraffic = {
+  {"destination", kTrue}, {"customers", kTrue}, {"delivery", kTrue}, {"permit", kTrue},
+  {"residents", kTrue},
+};
+
+const table_t<int> kUse = {
+  {"driveway", 4}, {"alley", 5}, {"parking_aisle", 6}, {"emergency_access", 7},
+  {"drive-through", 8},
+};
+
+// vehicle is the same as motor_vehicle
+const table_t<const char*> kMotorVehicle = {
+  {"yes", kTrue}, {"private", kTrue}, {"no", kFalse}, {"permissive", kTrue},
+  {"agricultural", kFalse}, {"delivery", kTrue}, {"designated", kTrue}, {"discouraged", kFalse},
+  {"forestry", kFalse}, {"destination", kTrue}, {"customers", kTrue}, {"official", kTrue},
+  {"public", kTrue}, {"restricted", kTrue}, {"allowed", kTrue}, {"permit", kTrue},
+  {"residents", kTrue},
+};
+
+const table_t<const char*> kMoped = {
+  {"yes", kTrue}, {"designated", kTrue}, {"private", kTrue}, {"permissive", kTrue},
+  {"destination", kTrue}, {"delivery", kTrue}, {"dismount", kTrue}, {"no", kFalse},
+  {"unknown", kFalse}, {"agricultural", kFalse}, {"permit", kTrue}, {"residents", kTrue},
+};
+
+const table_t<const char*> kFoot = {
+  {"yes", kTrue}, {"private", kTrue}, {"no", kFalse}, {"permissive", kTrue},
+  {"agricultural", kFalse}, {"use_sidepath", kTrue}, {"delivery", kTrue}, {"designated", kTrue},
+  {"discouraged", kFalse}, {"forestry", kFalse}, {"destination", kTrue}, {"customers", kTrue},
+  {"official", kTrue}, {"public", kTrue}, {"restricted", kTrue}, {"crossing", kTrue},
+  {"sidewalk", kTrue}, {"allowed", kTrue}, {"passable", kTrue}, {"footway", kTrue},
+  {"permit", kTrue}, {"residents", kTrue},
+};
+
+const table_t<const char*> kWheelchair = {
+  {"no", kFalse}, {"yes", kTrue}, {"designated", kTrue}, {"limited", kTrue}, {"official", kTrue},
+  {"destination", kTrue}, {"public", kTrue}, {"permissive", kTrue}, {"only", kTrue},
+  {"private", kTrue}, {"impassable", kFalse}, {"partial", kFalse}, {"bad", kFalse},
+  {"half", kFalse}, {"assisted", kTrue}, {"permit", kTrue}, {"residents", kTrue},
+};
+
+// taxi is the same as bus
+const table_t<const char*> kBus = {
+  {"no", kFalse}, {"yes", kTrue}, {"designated", kTrue}, {"urban", kTrue}, {"permissive", kTrue},
+  {"restricted", kTrue}, {"destination", kTrue}, {"delivery", kFalse}, {"official", kTrue},
+  {"permit", kTrue},
+};
+
+const table_t<const char*> kPsv = {
+  {"bus", kTrue}, {"taxi", kTrue}, {"no", kFalse}, {"yes", kTrue}, {"designated", kTrue},
+  {"permissive", kTrue}, {"1", kTrue}, {"2", kTrue},
+};
+
+const table_t<const char*> kTruck = {
+  {"designated", kTrue}, {"yes", kTrue}, {"no", kFalse}, {"destination", kTrue},
+  {"delivery", kTrue}, {"local", kTrue}, {"agricultural", kFalse}, {"private", kTrue},
+  {"discouraged", kFalse}, {"permissive", kTrue}, {"unsuitable", kFalse}, {"official", kTrue},
+  {"forestry", kFalse}, {"permit", kTrue}, {"residents", kTrue},
+};
+
+const table_t<const char*> kTruckHgv = {{"designated", kTrue}, {"local", kTrue}};
+
+const table_t<const char*> kHazmat = {
+  {"designated", kTrue}, {"yes", kTrue}, {"no", kFalse}, {"destination", kFalse},
+  {"delivery", kFalse},
+};
+
+const table_t<const char*> kShoulder = {{"yes", kTrue}, {"both", kTrue}, {"no", kFalse}};
+const table_t<const char*> kShoulderRight = {{"right", kTrue}};
+const table_t<const char*> kShoulderLeft = {{"left", kTrue}};
+
+const table_t<const char*> kBicycle = {
+  {"yes", kTrue}, {"designated", kTrue}, {"use_sidepath", kTrue}, {"no", kFalse},
+  {"permissive", kTrue}, {"destination", kTrue}, {"dismount", kTrue}, {"lane", kTrue},
+  {"track", kTrue}, {"shared", kTrue}, {"shared_lane", kTrue}, {"sidepath", kTrue},
+  {"share_busway", kTrue}, {"none", kFalse}, {"allowed", kTrue}, {"private", kTrue},
+  {"official", kTrue}, {"permit", kTrue}, {"residents", kTrue},
+};
+
+const table_t<const char*> kCycleway = {
+  {"yes", kTrue}, {"designated", kTrue}, {"use_sidepath", kTrue}, {"permissive", kTrue},
+  {"destination", kTrue}, {"dismount", kTrue}, {"lane", kTrue}, {"track", kTrue},
+  {"shared", kTrue}, {"shared_lane", kTrue}, {"sidepath", kTrue}, {"share_busway", kTrue},
+  {"allowed", kTrue}, {"private", kTrue}, {"cyclestreet", kTrue}, {"crossing", kTrue},
+};
+
+const table_t<const char*> kBikeReverse = {
+  {"opposite", kTrue}, {"opposite_lane", kTrue}, {"opposite_track", kTrue},
+};
+
+const table_t<const char*> kBusReverse = {{"opposite", kTrue}, {"opposite_lane", kTrue}};
+
+const table_t<int> kShared = {{"shared_lane", 1}, {"share_busway", 1}, {"shared", 1}};
+const table_t<int> kBuffer = {{"yes", 2}};
+const table_t<int> kDedicated = {{"opposite_lane", 2}, {"lane", 2}, {"buffered_lane", 2}};
+const table_t<int> kSeparated = {{"opposite_track", 3}, {"track", 3}};
+
+const table_t<const char*> kOneway = {
+  {"no", kFalse}, {"false", kFalse}, {"-1", kTrue}, {"yes", kTrue}, {"true", kTrue},
+  {"1", kTrue}, {"reversible", kFalse}, {"alternating", kFalse},
+};
+
+const table_t<const char*> kBridge = {{"yes", kTrue}, {"no", kFalse}, {"1", kTrue}};
+
+const table_t<const char*> kTunnel = {
+  {"yes", kTrue}, {"no", kFalse}, {"1", kTrue}, {"building_passage", kTrue},
+};
+
+const table_t<const char*> kToll = {
+  {"yes", kTrue}, {"no", kFalse}, {"true", kTrue}, {"false", kFalse}, {"1", kTrue},
+  {"interval", kTrue}, {"snowmobile", kTrue},
+};
+
+const table_t<const char*> kLit = {
+  {"yes", kTrue}, {"no", kFalse}, {"24/7", kTrue}, {"automatic", kTrue}, {"limited", kFalse},
+  {"disused", kFalse}, {"dusk-dawn", kTrue}, {"sunset-sunrise", kTrue},
+};
+
+const table_t<int> kConditionalAccessRestriction = {
+  {"none @ destination", 1}, {"none @ delivery", 1}, {"no @ destination", 1},
+  {"none @ (destination)", 1},
+};
+
+// the node tables are the same as above but in the form of a mask
+const table_t<int> kMotorVehicleNode = {
+  {"yes", 1}, {"private", 1}, {"no", 0}, {"permissive", 1}, {"agricultural", 0}, {"delivery", 1},
+  {"designated", 1}, {"discouraged", 0}, {"forestry", 0}, {"destination", 1}, {"customers", 1},
+  {"official", 1}, {"public", 1}, {"restricted", 1}, {"allowed", 1}, {"permit", 1},
+  {"residents", 1},
+};
+
+const table_t<int> kBicycleNode = {
+  {"yes", 4}, {"designated", 4}, {"use_sidepath", 4}, {"no", 0}, {"permissive", 4},
+  {"destination", 4}, {"dismount", 4}, {"lane", 4}, {"track", 4}, {"shared", 4},
+  {"shared_lane", 4}, {"sidepath", 4}, {"share_busway", 4}, {"none", 0}, {"allowed", 4},
+  {"private", 4}, {"official", 4}, {"permit", 4}, {"residents", 4},
+};
+
+const table_t<int> kFootNode = {
+  {"yes", 2}, {"private", 2}, {"no", 0}, {"permissive", 2}, {"agricultural", 0},
+  {"use_sidepath", 2}, {"delivery", 2}, {"designated", 2}, {"discouraged", 0}, {"forestry", 0},
+  {"destination", 2}, {"customers", 2}, {"official", 2}, {"public", 2}, {"restricted", 2},
+  {"crossing", 2}, {"sidewalk", 2}, {"allowed", 2}, {"passable", 2}, {"footway", 2},
+  {"permit", 2}, {"residents", 2},
+};
+
+const table_t<int> kWheelchairNode = {
+  {"no", 0}, {"yes", 256}, {"designated", 256}, {"limited", 256}, {"official", 256},
+  {"destination", 256}, {"public", 256}, {"permissive", 256}, {"only", 256}, {"private", 256},
+  {"impassable", 0}, {"partial", 0}, {"bad", 0}, {"half", 0}, {"assisted", 256},
+  {"permit", 256}, {"residents", 256},
+};
+
+const table_t<int> kMopedNode = {
+  {"yes", 512}, {"designated", 512}, {"private", 512}, {"permissive", 512},
+  {"destination", 512}, {"delivery", 512}, {"dismount", 512}, {"no", 0}, {"unknown", 0},
+  {"agricultural", 0}, {"permit", 512}, {"residents", 512},
+};
+
+const table_t<int> kMotorCycleNode = {
+  {"yes", 1024}, {"private", 1024}, {"no", 0}, {"permissive", 1024}, {"agricultural", 0},
+  {"delivery", 1024}, {"designated", 1024}, {"discouraged", 0}, {"forestry", 0},
+  {"destination", 1024}, {"customers", 1024}, {"official", 1024}, {"public", 1024},
+  {"restricted", 1024}, {"allowed", 1024}, {"permit", 1024},
+};
+
+const table_t<int> kBusNode = {
+  {"no", 0}, {"yes", 64}, {"designated", 64}, {"urban", 64}, {"permissive", 64},
+  {"restricted", 64}, {"destination", 64}, {"delivery", 0}, {"official", 64}, {"permit", 64},
+};
+
+const table_t<int> kTaxiNode = {
+  {"no", 0}, {"yes", 32}, {"designated", 32}, {"urban", 32}, {"permissive", 32},
+  {"restricted", 32}, {"destination", 32}, {"delivery", 0}, {"official", 32}, {"permit", 32},
+};
+
+const table_t<int> kTruckNode = {
+  {"designated", 8}, {"yes", 8}, {"no", 0}, {"destination", 8}, {"delivery", 8}, {"local", 8},
+  {"agricultural", 0}, {"private", 8}, {"discouraged", 0}, {"permissive", 8},
+  {"unsuitable", 0}, {"official", 8}, {"forestry", 0}, {"permit", 8}, {"residents", 8},
+};
+
+const table_t<int> kPsvBusNode = {
+  {"bus", 64}, {"no", 0}, {"yes", 64}, {"designated", 64}, {"permissive", 64}, {"1", 64},
+  {"2", 64},
+};
+
+const table_t<int> kPsvTaxiNode = {
+  {"taxi", 32}, {"no", 0}, {"yes", 32}, {"designated", 32}, {"permissive", 32}, {"1", 32},
+  {"2", 32},
+};
+// clang-format on
+
+bool is(const char* value, std::string_view expected) {
+  return value && expected == value;
+}
+
+const char* get(const table_t<const char*>& table, const char* key) {
+  if (!key) {
+    return nullptr;
+  }
+  auto found = table.find(key);
+  return found == table.end() ? nullptr : found->second;
+}
+
+std::optional<int> get(const table_t<int>& table, const char* key) {
+  if (!key) {
+    return std::nullopt;
+  }
+  auto found = table.find(key);
+  return found == table.end() ? std::nullopt : std::optional<int>(found->second);
+}
+
+// calls the function with each of the non empty parts of a ; separated list until it returns false
+template <typename F> void for_each_part(std::string_view list, const F& f) {
+  while (!list.empty()) {
+    auto end = std::min(list.find(';'), list.size());
+    if (end > 0 && !f(list.substr(0, end))) {
+      return;
+    }
+    list.remove_prefix(std::min(end + 1, list.size()));
+  }
+}
+
+// if the key is a ; separated list every part is looked up, "true" wins over "false"
+const char* any_in(const table_t<const char*>& table, const char* key) {
+  if (!key) {
+    return nullptr;
+  }
+  const char* val = get(table, key);
+  if (val) {
+    return val;
+  }
+  for_each_part(key, [&table, &val](std::string_view part) {
+    auto found = table.find(part);
+    if (found != table.end()) {
+      val = found->second;
+    }
+    return !is(val, kTrue);
+  });
+  return val;
+}
+
+// if the key is a ; separated list every part is looked up, any mode wins over none
+std::optional<int> any_in_num(const table_t<int>& table, const char* key) {
+  if (!key) {
+    return std::nullopt;
+  }
+  auto val = get(table, key);
+  if (val) {
+    return val;
+  }
+  for_each_part(key, [&table, &val](std::string_view part) {
+    auto found = table.find(part);
+    if (found != table.end()) {
+      val = found->second;
+    }
+    return val.value_or(0) <= 0;
+  });
+  return val;
+}
+
+// lua's "a or b" for strings
+template <typename... T> const char* either(const char* value, T... rest) {
+  if constexpr (sizeof...(rest) == 0) {
+    return value;
+  } else {
+    return value ? value : either(rest...);
+  }
+}
+
+// lua's "a or b" for numbers
+template <typename... T> std::optional<int> either(std::optional<int> value, T... rest) {
+  if constexpr (sizeof...(rest) == 0) {
+    return value;
+  } else {
+    return value ? value : either(rest...);
+  }
+}
+
+// the way lua formats numbers when they are converted to strings
+std::string lua_tostring(double value) {
+  if (std::isnan(value)) {
+    return "nan";
+  }
+  char buffer[32];
+  snprintf(buffer, sizeof(buffer), "%.14g", value);
+  return buffer;
+}
+
+// lua's tonumber, nullopt if it isn't a number
+std::optional<double> lua_tonumber(const char* value) {
+  if (!value) {
+    return std::nullopt;
+  }
+  char* end = nullptr;
+  double number = std::strtod(value, &end);
+  if (end == value) {
+    return std::nullopt;
+  }
+  while (std::isspace(static_cast<unsigned char>(*end))) {
+    ++end;
+  }
+  if (*end != '\0') {
+    return std::nullopt;
+  }
+  return number;
+}
+
+// arithmetic on nil is an error in lua, the whole transform fails with it
+double lua_checknumber(const std::optional<double>& value) {
+  if (!value) {
+    throw std::runtime_error("attempt to perform arithmetic on a nil value");
+  }
+  return *value;
+}
+
+double lua_round(double value) {
+  return std::floor(value + 0.5);
+}
+
+double lua_round(double value, int n) {
+  auto scale = std::pow(10., n);
+  return std::floor(value * scale + 0.5) / scale;
+}
+
+bool ends_with(std::string_view value, std::string_view suffix) {
+  return value.size() >= suffix.size() && value.substr(value.size() - suffix.size()) == suffix;
+}
+
+/**
+ * The tags as a lua table. Reading a missing key gives nullptr and assigning nullptr removes it.
+ * Values read from it are only valid until the next assignment.
+ */
+class kv_t {
+public:
+  explicit kv_t(Tags& tags) : tags_(tags) {
+  }
+
+  const char* operator[](const std::string& key) const {
+    auto found = tags_.find(key);
+    return found == tags_.end() ? nullptr : found->second.c_str();
+  }
+
+  bool is(const std::string& key, std::string_view value) const {
+    return ::is((*this)[key], value);
+  }
+
+  std::optional<std::string> copy(const std::string& key) const {
+    auto found = tags_.find(key);
+    return found == tags_.end() ? std::nullopt : std::optional<std::string>(found->second);
+  }
+
+  void set(const std::string& key, const char* value) {
+    if (!value) {
+      tags_.erase(key);
+      return;
+    }
+    // the value may live in the tags we are about to modify
+    std::string copy(value);
+    tags_[key] = std::move(copy);
+  }
+
+  void set(const std::string& key, const std::optional<std::string>& value) {
+    set(key, value ? value->c_str() : nullptr);
+  }
+
+  void set_number(const std::string& key, std::optional<double> value) {
+    set(key, value ? std::optional<std::string>(lua_tostring(*value)) : std::nullopt);
+  }
+
+  void swap(const std::string& a, const std::string& b) {
+    auto forwards = copy(a);
+    set(a, copy(b));
+    set(b, forwards);
+  }
+
+  const Tags& tags() const {
+    return tags_;
+  }
+
+protected:
+  Tags& tags_;
+};
+
+// the type of the restriction in values like no_left_turn @ (07:00-09:00)
+std::optional<std::string> restriction_prefix(const char* restriction) {
+  if (!restriction) {
+    return std::nullopt;
+  }
+  // the spaces before the @ are not counted but we still take that many characters
+  size_t index = 0;
+  const char* c = restriction;
+  for (; *c != '\0' && *c != '@'; ++c) {
+    index += *c != ' ';
+  }
+  if (*c != '@') {
+    return std::nullopt;
+  }
+  return std::string(restriction, index);
+}
+
+// the condition of the restriction in values like no_left_turn @ (07:00-09:00)
+std::optional<std::string> restriction_suffix(const char* restriction) {
+  if (!restriction) {
+    return std::nullopt;
+  }
+  std::string_view value(restriction);
+  auto at = value.find('@');
+  if (at == std::string_view::npos) {
+    return std::nullopt;
+  }
+  // from the first non space after the @, or just the last character if there isn't any
+  auto start = value.find_first_not_of(' ', at + 1);
+  if (start == std::string_view::npos) {
+    start = value.size() - 1;
+  }
+  return std::string(value.substr(start));
+}
+
+// the non negative number at the beginning of the string
+std::optional<std::string> numeric_prefix(const char* value, bool allow_decimals) {
+  if (!value) {
+    return std::nullopt;
+  }
+  size_t index = 0;
+  bool seen_dot = false;
+  for (const char* c = value; *c != '\0'; ++c, ++index) {
+    if (*c < '0' || *c > '9') {
+      if (*c != '.' || !allow_decimals || seen_dot) {
+        break;
+      }
+      seen_dot = true;
+    }
+  }
+  if (index == 0) {
+    return std::nullopt;
+  }
+  return std::string(value, index);
+}
+
+std::optional<double> normalize_speed(const char* speed) {
+  auto prefix = numeric_prefix(speed, false);
+  auto num = lua_tonumber(prefix ? prefix->c_str() : nullptr);
+  if (num) {
+    if (ends_with(speed, "mph")) {
+      num = lua_round(*num * 1.609344);
+    }
+    // anything over 150kph or under 10kph is tossed
+    if (*num > 150 || *num < 10) {
+      return std::nullopt;
+    }
+  }
+  return num;
+}
+
+std::optional<double> normalize_weight(const char* weight) {
+  if (!weight) {
+    return std::nullopt;
+  }
+  std::string w;
+  for (const char* c = weight; *c != '\0'; ++c) {
+    if (!std::isspace(static_cast<unsigned char>(*c))) {
+      w.push_back(*c);
+    }
+  }
+  auto num = numeric_prefix(w.c_str(), true);
+  if (!num) {
+    return std::nullopt;
+  }
+  auto value = lua_tonumber(num->c_str());
+  if (w == *num + "t" || w == *num + "tonne" || w == *num + "tonnes") {
+    return lua_round(lua_checknumber(value), 2);
+  }
+  if (w == *num + "ton" || w == *num + "tons") {
+    return lua_round(lua_checknumber(value), 2);
+  }
+  if (w == *num + "lb" || w == *num + "lbs") {
+    return lua_round(lua_checknumber(value) / 2000, 2);
+  }
+  if (w == *num + "kg") {
+    return lua_round(lua_checknumber(value) / 1000, 2);
+  }
+  return lua_round(lua_checknumber(value), 2);
+}
+
+std::optional<double> normalize_measurement(const char* measurement) {
+  if (!measurement) {
+    return std::nullopt;
+  }
+  // european style decimal separators
+  std::string m(measurement);
+  std::replace(m.begin(), m.end(), ',', '.');
+
+  // the simple case, its just a plain number
+  if (auto num = lua_tonumber(m.c_str())) {
+    return lua_round(*num, 2);
+  }
+
+  // compound expressions like 3ft6in, every term matching (%d+[.,]?%d*) *([a-zA-Z"']*) is summed
+  // up in meters
+  auto is_digit = [](char c) { return c >= '0' && c <= '9'; };
+  auto is_unit = [](char c) {
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c == '"' || c == '\'';
+  };
+  double sum = 0;
+  size_t count = 0;
+  for (size_t i = 0; i < m.size();) {
+    if (!is_digit(m[i])) {
+      ++i;
+      continue;
+    }
+    auto start = i;
+    while (i < m.size() && is_digit(m[i])) {
+      ++i;
+    }
+    if (i < m.size() && (m[i] == '.' || m[i] == ',')) {
+      ++i;
+    }
+    while (i < m.size() && is_digit(m[i])) {
+      ++i;
+    }
+    auto item = m.substr(start, i - start);
+    while (i < m.size() && m[i] == ' ') {
+      ++i;
+    }
+    start = i;
+    while (i < m.size() && is_unit(m[i])) {
+      ++i;
+    }
+    std::string unit = m.substr(start, i - start);
+    for (auto& c : unit) {
+      c = std::tolower(static_cast<unsigned char>(c));
+    }
+
+    auto item_num = lua_tonumber(item.c_str());
+    if (!item_num) {
+      return std::nullopt;
+    }
+    if (unit == "m" || unit == "meter" || unit == "meters") {
+      sum = sum + *item_num;
+    } else if (unit == "cm") {
+      sum = sum + *item_num * 0.01;
+    } else if (unit == "ft" || unit == "feet" || unit == "foot" || unit == "'") {
+      sum = sum + *item_num * 0.3048;
+    } else if (unit == "in" || unit == "inches" || unit == "inch" || unit == "\"" || unit == "''") {
+      sum = sum + *item_num * 0.0254;
+    } else {
+      return std::nullopt;
+    }
+    ++count;
+  }
+  if (count > 0) {
+    return lua_round(sum, 2);
+  }
+  return std::nullopt;
+}
+
+// whether cash, notes or coins are the only payment types which aren't tagged as no
+bool is_cash_only_payment(const kv_t& kv) {
+  bool allows_cash_payment = false;
+  bool allows_noncash_payment = false;
+  for (const auto& tag : kv.tags()) {
+    if (tag.first.compare(0, 8, "payment:") != 0) {
+      continue;
+    }
+    auto payment_type = std::string_view(tag.first).substr(8);
+    bool is_cash_payment_type =
+        payment_type == "cash" || payment_type == "notes" || payment_type == "coins";
+    bool is_no = tag.second.size() == 2 &&
+                 std::toupper(static_cast<unsigned char>(tag.second[0])) == 'N' &&
+                 std::toupper(static_cast<unsigned char>(tag.second[1])) == 'O';
+    if (is_cash_payment_type && !allows_cash_payment) {
+      allows_cash_payment = !is_no;
+    }
+    if (!is_cash_payment_type && !allows_noncash_payment) {
+      allows_noncash_payment = !is_no;
+    }
+  }
+  return allows_cash_payment && !allows_noncash_payment;
+}
+
+void set_all(kv_t& kv, const std::array<std::string, 8>& keys, const char* value, bool pedestrian) {
+  for (size_t i = 0; i < keys.size(); ++i) {
+    if (pedestrian || i != kPedestrian) {
+      kv.set(keys[i], value);
+    }
+  }
+}
+
+// returns true if the way should be filtered
+bool filter_tags_generic(kv_t& kv) {
+  if ((kv.is("highway", "construction") && !kv["construction"]) || kv.is("highway", "proposed")) {
+    return true;
+  }
+
+  // toss actual areas
+  if (kv.is("area", "yes")) {
+    return true;
+  }
+
+  // figure out what basic type of road it is
+  auto highway = kv.copy(kv.is("highway", "construction") ? "construction" : "highway");
+  auto found = highway ? kHighway.find(*highway) : kHighway.end();
+  const std::array<bool, 8>* forward = found == kHighway.end() ? nullptr : &found->second;
+  bool ferry = kv.is("route", "ferry");
+  bool rail = kv.is("route", "shuttle_train");
+  const char* access = any_in(kAccess, kv["access"]);
+
+  kv.set("emergency_forward", kFalse);
+  kv.set("emergency_backward", kFalse);
+
+  if (ferry || rail || kv["highway"]) {
+    if (kv.is("access", "emergency") || kv.is("emergency", "yes") ||
+        kv.is("service", "emergency_access")) {
+      kv.set("emergency_forward", kTrue);
+      kv.set("emergency_tag", kTrue);
+    }
+
+    if (kv.is("emergency", "no")) {
+      kv.set("emergency_tag", kFalse);
+    }
+  }
+
+  const char* vehicle_access = any_in(kMotorVehicle, kv["vehicle"]);
+  const char* motor_vehicle_access = either(any_in(kMotorVehicle, kv["motor_vehicle"]), vehicle_access);
+  // expects access=private not to be combined with other values
+  bool no_access = kv.is("impassable", "yes") || is(access, kFalse) ||
+                   (kv.is("access", "private") &&
+                    (kv.is("emergency", "yes") || kv.is("service", "emergency_access")));
+  if (forward) {
+    for (size_t i = 0; i < kForward.size(); ++i) {
+      kv.set(kForward[i], (*forward)[i] ? kTrue : kFalse);
+    }
+
+    if (no_access) {
+      set_all(kv, kForward, kFalse, true);
+      set_all(kv, kBackward, kFalse, true);
+    } else if (kv.is("smoothness", "impassable")) {
+      // don't change ped access
+      set_all(kv, kForward, kFalse, false);
+      set_all(kv, kBackward, kFalse, false);
+    }
+
+    // check for overrides of the defaults
+    kv.set("auto_tag", either(any_in(kMotorVehicle, kv["motorcar"]), motor_vehicle_access));
+    kv.set("auto_forward", either(kv["auto_tag"], kv["auto_forward"]));
+
+    kv.set("truck_tag", either(any_in(kTruck, kv["hgv"]), motor_vehicle_access));
+    kv.set("truck_forward", either(kv["truck_tag"], kv["truck_forward"]));
+
+    kv.set("bus_tag", either(any_in(kBus, kv["bus"]), any_in(kPsv, kv["psv"]),
+                             get(kPsv, kv["lanes:psv:forward"]), motor_vehicle_access));
+    kv.set("bus_forward", either(kv["bus_tag"], kv["bus_forward"]));
+
+    kv.set("taxi_tag", either(any_in(kBus, kv["taxi"]), any_in(kPsv, kv["psv"]),
+                              get(kPsv, kv["lanes:psv:forward"]), motor_vehicle_access));
+    kv.set("taxi_forward", either(kv["taxi_tag"], kv["taxi_forward"]));
+
+    kv.set("foot_tag", either(any_in(kFoot, kv["foot"]), get(kFoot, kv["pedestrian"])));
+    kv.set("pedestrian_forward", either(kv["foot_tag"], kv["pedestrian_forward"]));
+
+    kv.set("bike_tag",
+           either(any_in(kBicycle, kv["bicycle"]), any_in(kCycleway, kv["cycleway"]),
+                  any_in(kBicycle, kv["bicycle_road"]), get(kBicycle, kv["cyclestreet"]),
+                  vehicle_access));
+    kv.set("bike_forward", either(kv["bike_tag"], kv["bike_forward"]));
+
+    kv.set("moped_tag", either(any_in(kMoped, kv["moped"]), any_in(kMoped, kv["mofa"]),
+                               motor_vehicle_access));
+    kv.set("moped_forward", either(kv["moped_tag"], kv["moped_forward"]));
+
+    kv.set("motorcycle_tag",
+           either(any_in(kMotorVehicle, kv["motorcycle"]), motor_vehicle_access));
+    kv.set("motorcycle_forward", either(kv["motorcycle_tag"], kv["motorcycle_forward"]));
+
+    if (kv.is("access", "psv")) {
+      kv.set("taxi_forward", kTrue);
+      kv.set("taxi_tag", kTrue);
+
+      kv.set("bus_forward", kTrue);
+      kv.set("bus_tag", kTrue);
+    }
+
+    if (kv.is("motorroad", "yes")) {
+      kv.set("motorroad_tag", kTrue);
+    }
+  } // its not a highway type that we know of
+  else if (ferry || rail) {
+    // if its a ferry and these tags dont show up we want to set them to true, unless there is
+    // inverse access like access=no + foot=yes
+    const char* default_val = no_access ? kFalse : kTrue;
+    const char* ped_val = default_val;
+    if (kv.is("smoothness", "impassable")) {
+      // don't change ped access
+      default_val = kFalse;
+    }
+
+    kv.set("auto_tag", either(any_in(kMotorVehicle, kv["motorcar"]), motor_vehicle_access));
+    kv.set("auto_forward", either(kv["auto_tag"], default_val));
+
+    kv.set("truck_tag", either(any_in(kTruck, kv["hgv"]), motor_vehicle_access));
+    kv.set("truck_forward", either(any_in(kTruck, kv["hgv"]), kv["truck_forward"],
+                                   motor_vehicle_access, default_val));
+
+    kv.set("bus_tag", either(any_in(kBus, kv["bus"]), any_in(kPsv, kv["psv"]),
+                             get(kPsv, kv["lanes:psv:forward"]), motor_vehicle_access));
+    kv.set("bus_forward", either(kv["bus_tag"], default_val));
+
+    kv.set("taxi_tag", either(any_in(kBus, kv["taxi"]), any_in(kPsv, kv["psv"]),
+                              get(kPsv, kv["lanes:psv:forward"]), motor_vehicle_access));
+    kv.set("taxi_forward", either(kv["taxi_tag"], default_val));
+
+    kv.set("foot_tag", either(any_in(kFoot, kv["foot"]), get(kFoot, kv["pedestrian"])));
+    kv.set("pedestrian_forward", either(kv["foot_tag"], ped_val));
+
+    kv.set("bike_tag",
+           either(any_in(kBicycle, kv["bicycle"]), any_in(kCycleway, kv["cycleway"]),
+                  any_in(kBicycle, kv["bicycle_road"]), get(kBicycle, kv["cyclestreet"]),
+                  vehicle_access));
+    kv.set("bike_forward", either(kv["bike_tag"], default_val));
+
+    kv.set("moped_tag", either(any_in(kMoped, kv["moped"]), any_in(kMoped, kv["mofa"]),
+                               motor_vehicle_access));
+    kv.set("moped_forward", either(kv["moped_tag"], default_val));
+
+    kv.set("motorcycle_tag",
+           either(any_in(kMotorVehicle, kv["motorcycle"]), motor_vehicle_access));
+    kv.set("motorcycle_forward", either(kv["motorcycle_tag"], default_val));
+
+    if (!kv["bike_tag"]) {
+      if (kv.is("sac_scale", "hiking")) {
+        kv.set("bike_forward", kTrue);
+        kv.set("bike_tag", kTrue);
+      } else if (kv["sac_scale"]) {
+        kv.set("bike_forward", kFalse);
+      }
+    }
+
+    if (kv.is("access", "psv")) {
+      kv.set("taxi_forward", kTrue);
+      kv.set("taxi_tag", kTrue);
+
+      kv.set("bus_forward", kTrue);
+      kv.set("bus_tag", kTrue);
+    }
+
+    if (kv.is("motorroad", "yes")) {
+      kv.set("motorroad_tag", kTrue);
+    }
+  } else {
+    // something we have no idea about
+    set_all(kv, kForward, kFalse, true);
+    set_all(kv, kBackward, kFalse, true);
+  }
+
+  // expect access=permissive and access=hov not to be combined with other values
+  if ((kv.is("access", "permissive") || kv.is("access", "hov") || kv.is("access", "taxi")) &&
+      kv.is("oneway", "reversible")) {
+    // for now enable only for buses if the tag exists and they are allowed
+    if (kv.is("bus_forward", kTrue)) {
+      kv.set("auto_forward", kFalse);
+      kv.set("truck_forward", kFalse);
+      kv.set("pedestrian_forward", kFalse);
+      kv.set("bike_forward", kFalse);
+      kv.set("moped_forward", kFalse);
+      kv.set("motorcycle_forward", kFalse);
+    } else {
+      return true;
+    }
+  }
+
+  // service=driveway means all are routable
+  if (kv.is("service", "driveway") && !kv["access"]) {
+    kv.set("auto_forward", kTrue);
+    kv.set("truck_forward", kTrue);
+    kv.set("bus_forward", kTrue);
+    kv.set("taxi_forward", kTrue);
+    kv.set("pedestrian_forward", kTrue);
+    kv.set("bike_forward", kTrue);
+    kv.set("moped_forward", kTrue);
+    kv.set("motorcycle_forward", kTrue);
+  }
+
+  // check the oneway-ness and traversability against the direction of the geom
+  if ((kv.is("oneway", "yes") && kv.is("oneway:bicycle", "no")) ||
+      kv.is("bicycle:backward", "yes") || kv.is("bicycle:backward", "no")) {
+    kv.set("bike_backward", kTrue);
+  }
+
+  if (!kv["bike_backward"] || kv.is("bike_backward", kFalse)) {
+    kv.set("bike_backward",
+           either(get(kBikeReverse, kv["cycleway"]), get(kBikeReverse, kv["cycleway:left"]),
+                  get(kBikeReverse, kv["cycleway:right"]), kFalse));
+  }
+
+  const char* oneway_bike = nullptr;
+  if (kv.is("bike_backward", kTrue)) {
+    oneway_bike = get(kOneway, kv["oneway:bicycle"]);
+  }
+
+  if (!kv["oneway:bus"] && kv["oneway:psv"]) {
+    kv.set("oneway:bus", kv["oneway:psv"]);
+  }
+
+  if ((kv.is("oneway", "yes") && kv.is("oneway:bus", "no")) || kv.is("bus:backward", "yes") ||
+      kv.is("bus:backward", "designated")) {
+    kv.set("bus_backward", kTrue);
+  }
+
+  if (!kv["bus_backward"] || kv.is("bus_backward", kFalse)) {
+    kv.set("bus_backward",
+           either(get(kBusReverse, kv["busway"]), get(kBusReverse, kv["busway:left"]),
+                  get(kBusReverse, kv["busway:right"]), get(kPsv, kv["lanes:psv:backward"]),
+                  kFalse));
+  }
+
+  const char* oneway_bus = nullptr;
+  if (kv.is("bus_backward", kTrue)) {
+    oneway_bus = get(kOneway, kv["oneway:bus"]);
+    if (is(oneway_bus, kFalse) && kv.is("bus:backward", "yes")) {
+      oneway_bus = kTrue;
+    }
+  }
+
+  if (!kv["oneway:taxi"] && kv["oneway:psv"]) {
+    kv.set("oneway:taxi", kv["oneway:psv"]);
+  }
+
+  if ((kv.is("oneway", "yes") && kv.is("oneway:taxi", "no")) || kv.is("taxi:backward", "yes") ||
+      kv.is("taxi:backward", "designated")) {
+    kv.set("taxi_backward", kTrue);
+  }
+
+  if (!kv["taxi_backward"] || kv.is("taxi_backward", kFalse)) {
+    kv.set("taxi_backward", either(get(kPsv, kv["lanes:psv:backward"]), kFalse));
+  }
+
+  const char* oneway_taxi = nullptr;
+  if (kv.is("taxi_backward", kTrue)) {
+    oneway_taxi = get(kOneway, kv["oneway:taxi"]);
+    if (is(oneway_taxi, kFalse) && kv.is("taxi:backward", "yes")) {
+      oneway_taxi = kTrue;
+    }
+  }
+
+  if (!kv["moped_backward"]) {
+    kv.set("moped_backward", kFalse);
+  }
+
+  if ((kv.is("oneway", "yes") && (kv.is("oneway:moped", "no") || kv.is("oneway:mofa", "no"))) ||
+      kv.is("moped:backward", "yes") || kv.is("mofa:backward", "yes")) {
+    kv.set("moped_backward", kTrue);
+  }
+
+  const char* oneway_moped = nullptr;
+  if (kv.is("moped_backward", kTrue)) {
+    oneway_moped = either(get(kOneway, kv["oneway:moped"]), get(kOneway, kv["oneway:mofa"]));
+  }
+
+  if (!kv["motorcycle_backward"]) {
+    kv.set("motorcycle_backward", kFalse);
+  }
+
+  if ((kv.is("oneway", "yes") && kv.is("oneway:motorcycle", "no")) ||
+      kv.is("motorcycle:backward", "yes")) {
+    kv.set("motorcycle_backward", kTrue);
+  }
+
+  const char* oneway_motorcycle = nullptr;
+  if (kv.is("motorcycle_backward", kTrue)) {
+    oneway_motorcycle = get(kOneway, kv["oneway:motorcycle"]);
+  }
+
+  if (!kv["pedestrian_backward"]) {
+    kv.set("pedestrian_backward", kFalse);
+  }
+
+  if ((kv.is("oneway", "yes") && kv.is("oneway:foot", "no")) || kv.is("foot:backward", "yes")) {
+    kv.set("pedestrian_backward", kTrue);
+  }
+
+  const char* oneway_foot = nullptr;
+  if (kv.is("pedestrian_backward", kTrue)) {
+    oneway_foot = get(kOneway, kv["oneway:foot"]);
+  }
+
+  bool oneway_reverse = kv.is("oneway", "-1");
+  const char* oneway_norm = get(kOneway, kv["oneway"]);
+  if (kv.is("junction", "roundabout") || kv.is("junction", "circular")) {
+    oneway_norm = kTrue;
+    kv.set("roundabout", kTrue);
+  } else {
+    kv.set("roundabout", kFalse);
+  }
+  if (kv.is("junction", "intersection")) {
+    kv.set("tagged_internal_intersection", kTrue);
+  }
+  kv.set("oneway", oneway_norm);
+  // applies the oneway-ness of a mode which may travel against the oneway direction
+  auto against_oneway = [&kv](const char* mode_oneway, const std::string& forward) {
+    if (is(mode_oneway, kTrue)) {
+      // only in reverse
+      kv.set(forward, kFalse);
+    } else if (is(mode_oneway, kFalse)) {
+      // in both directions
+      kv.set(forward, kTrue);
+    }
+  };
+  if (is(oneway_norm, kTrue)) {
+    kv.set("auto_backward", kFalse);
+    kv.set("truck_backward", kFalse);
+    kv.set("emergency_backward", kFalse);
+
+    if (kv.is("bike_backward", kTrue)) {
+      against_oneway(oneway_bike, "bike_forward");
+    }
+    if (kv.is("bus_backward", kTrue)) {
+      against_oneway(oneway_bus, "bus_forward");
+    }
+    if (kv.is("taxi_backward", kTrue)) {
+      against_oneway(oneway_taxi, "taxi_forward");
+    }
+    if (kv.is("moped_backward", kTrue)) {
+      against_oneway(oneway_moped, "moped_forward");
+    }
+    if (kv.is("motorcycle_backward", kTrue)) {
+      against_oneway(oneway_motorcycle, "motorcycle_forward");
+    }
+    // don't apply oneway tag unless oneway:foot or pedestrian only way
+    if (kv.is("highway", "footway") || kv.is("highway", "pedestrian") ||
+        kv.is("highway", "steps") || kv.is("highway", "path") || kv["oneway:foot"]) {
+      if (kv.is("pedestrian_backward", kTrue)) {
+        against_oneway(oneway_foot, "pedestrian_forward");
+      }
+    } else {
+      kv.set("pedestrian_backward", kv["pedestrian_forward"]);
+    }
+  } // without oneway tagging the way is bidirectional despite the directional tagging above
+  else if (!oneway_norm || is(oneway_norm, kFalse)) {
+    kv.set("auto_backward", kv["auto_forward"]);
+    kv.set("truck_backward", kv["truck_forward"]);
+    kv.set("emergency_backward", kv["emergency_forward"]);
+
+    if (kv.is("bike_backward", kFalse) && !kv.is("oneway:bicycle", "-1") &&
+        (!kv["oneway:bicycle"] || kv.is("oneway:bicycle", "no"))) {
+      kv.set("bike_backward", kv["bike_forward"]);
+    }
+
+    if (kv.is("bus_backward", kFalse) && !kv.is("oneway:bus", "-1") && !kv["oneway:bus"]) {
+      kv.set("bus_backward", kv["bus_forward"]);
+    }
+
+    if (kv.is("taxi_backward", kFalse) && !kv.is("oneway:taxi", "-1") && !kv["oneway:taxi"]) {
+      kv.set("taxi_backward", kv["taxi_forward"]);
+    }
+
+    if (kv.is("moped_backward", kFalse) &&
+        (!kv["oneway:moped"] || kv.is("oneway:moped", "no")) &&
+        (!kv["oneway:mofa"] || kv.is("oneway:mofa", "no"))) {
+      kv.set("moped_backward", kv["moped_forward"]);
+    }
+
+    if (kv.is("motorcycle_backward", kFalse) && !kv.is("oneway:motorcycle", "-1") &&
+        (!kv["oneway:motorcycle"] || kv.is("oneway:motorcycle", "no"))) {
+      kv.set("motorcycle_backward", kv["motorcycle_forward"]);
+    }
+
+    if (kv.is("pedestrian_backward", kFalse) &&
+        (!kv["oneway:foot"] || kv.is("oneway:foot", "no"))) {
+      kv.set("pedestrian_backward", kv["pedestrian_forward"]);
+    }
+  }
+
+  // bike forward / backward overrides
+  auto cycle_lane = [&kv](const std::string& key) {
+    return either(get(kShared, kv[key]), get(kSeparated, kv[key]), get(kDedicated, kv[key]));
+  };
+  if (cycle_lane("cycleway:both") ||
+      (cycle_lane("cycleway:right") && cycle_lane("cycleway:left"))) {
+    kv.set("bike_forward", kTrue);
+    kv.set("bike_backward", kTrue);
+  }
+
+  if (kv.is("busway", "lane") || (kv.is("busway:left", "lane") && kv.is("busway:right", "lane"))) {
+    kv.set("bus_forward", kTrue);
+    kv.set("bus_backward", kTrue);
+  }
+
+  // let all the :forward overrides through
+  if (const char* mv_forward = either(kv["motor_vehicle:forward"], kv["vehicle:forward"])) {
+    const char* access_forward = any_in(kMotorVehicle, mv_forward);
+    kv.set("auto_forward", access_forward);
+    kv.set("truck_forward", access_forward);
+    kv.set("bus_forward", access_forward);
+    kv.set("taxi_forward", access_forward);
+    kv.set("moped_forward", access_forward);
+    kv.set("motorcycle_forward", access_forward);
+  }
+  if (kv["foot:forward"]) {
+    kv.set("pedestrian_forward", any_in(kFoot, kv["foot:forward"]));
+  }
+  if (const char* bk_forward = either(kv["bicycle:forward"], kv["vehicle:forward"])) {
+    kv.set("bike_forward", any_in(kBicycle, bk_forward));
+  }
+
+  // let all the :backward overrides through
+  if (const char* mv_backward = either(kv["motor_vehicle:backward"], kv["vehicle:backward"])) {
+    const char* access_backward = any_in(kMotorVehicle, mv_backward);
+    kv.set("auto_backward", access_backward);
+    kv.set("truck_backward", access_backward);
+    kv.set("bus_backward", access_backward);
+    kv.set("taxi_backward", access_backward);
+    kv.set("moped_backward", access_backward);
+    kv.set("motorcycle_backward", access_backward);
+  }
+  if (kv["foot:backward"]) {
+    kv.set("pedestrian_backward", any_in(kFoot, kv["foot:backward"]));
+  }
+  if (const char* bk_backward = either(kv["bicycle:backward"], kv["vehicle:backward"])) {
+    kv.set("bike_backward", any_in(kBicycle, bk_backward));
+  }
+
+  kv.set("oneway_reverse", kFalse);
+
+  // flip the onewayness
+  if (oneway_reverse) {
+    kv.set("oneway_reverse", kTrue);
+    kv.swap("auto_forward", "auto_backward");
+    kv.swap("truck_forward", "truck_backward");
+    kv.swap("emergency_forward", "emergency_backward");
+    kv.swap("bus_forward", "bus_backward");
+    kv.swap("taxi_forward", "taxi_backward");
+    kv.swap("bike_forward", "bike_backward");
+    kv.swap("moped_forward", "moped_backward");
+    kv.swap("motorcycle_forward", "motorcycle_backward");
+    kv.swap("pedestrian_forward", "pedestrian_backward");
+  }
+
+  if (kv.is("oneway:bicycle", "-1")) {
+    kv.swap("bike_forward", "bike_backward");
+  }
+
+  if (kv.is("oneway:moped", "-1") || kv.is("oneway:mofa", "-1")) {
+    kv.swap("moped_forward", "moped_backward");
+  }
+
+  if (kv.is("oneway:motorcycle", "-1")) {
+    kv.swap("motorcycle_forward", "motorcycle_backward");
+  }
+
+  if (kv.is("oneway:foot", "-1")) {
+    kv.swap("pedestrian_forward", "pedestrian_backward");
+  }
+
+  if (kv.is("oneway:bus", "-1")) {
+    kv.swap("bus_forward", "bus_backward");
+  }
+
+  // bus only logic
+  if (kv.is("lanes:bus", "1")) {
+    kv.set("bus_forward", kTrue);
+    kv.set("bus_backward", kFalse);
+  } else if (kv.is("lanes:bus", "2")) {
+    kv.set("bus_forward", kTrue);
+    kv.set("bus_backward", kTrue);
+  }
+
+  if (kv.is("oneway:taxi", "-1")) {
+    kv.swap("taxi_forward", "taxi_backward");
+  }
+
+  if (kv.is("lanes:psv", "1")) {
+    kv.set("taxi_forward", kTrue);
+    kv.set("taxi_backward", kFalse);
+  } else if (kv.is("lanes:psv", "2")) {
+    kv.set("taxi_forward", kTrue);
+    kv.set("taxi_backward", kTrue);
+  }
+
+  // if none of the modes were set we are done looking at this, taxi isn't considered
+  bool no_modes = true;
+  for (const auto* mode : {"auto", "truck", "bus", "bike", "emergency", "moped", "motorcycle",
+                           "pedestrian"}) {
+    no_modes = no_modes && kv.is(std::string(mode) + "_forward", kFalse) &&
+               kv.is(std::string(mode) + "_backward", kFalse);
+  }
+  if (no_modes && !kv.is("highway", "bridleway")) {
+    // save bridleways for country access logic
+    return true;
+  }
+
+  kv.set("FIXME", nullptr);
+  kv.set("note", nullptr);
+  kv.set("source", nullptr);
+
+  // set a few flags
+  auto rc = get(kRoadClass, highway ? highway->c_str() : nullptr);
+  if (!kv["highway"] && ferry) {
+    rc = 2;
+  } else if (!kv["highway"] && (kv["railway"] || kv.is("route", "shuttle_train"))) {
+    rc = 2;
+  } else if (!rc) {
+    // service and other
+    rc = 7;
+  }
+  kv.set_number("road_class", *rc);
+
+  double default_speed = kDefaultSpeed[*rc];
+  // lower the default speed for driveways
+  if (kv.is("service", "driveway")) {
+    default_speed = std::floor(default_speed * 0.5);
+  }
+  kv.set_number("default_speed", default_speed);
+
+  kv.set("lit", get(kLit, kv["lit"]));
+
+  // all of these modes are out
+  auto no_vehicles = [&kv]() {
+    for (const auto* mode : {"auto", "truck", "bus", "bike", "moped", "motorcycle"}) {
+      if (!kv.is(std::string(mode) + "_forward", kFalse) ||
+          !kv.is(std::string(mode) + "_backward", kFalse)) {
+        return false;
+      }
+    }
+    return true;
+  };
+
+  auto use = get(kUse, kv["service"]);
+  if (kv["highway"]) {
+    if (kv.is("highway", "construction")) {
+      use = 43;
+    } else if (kv.is("highway", "track")) {
+      use = 3;
+    } else if (kv.is("highway", "living_street")) {
+      use = 10;
+    } else if (!use && kv.is("highway", "service")) {
+      use = 11;
+    } else if (kv.is("highway", "cycleway")) {
+      use = 20;
+    } else if (kv.is("pedestrian_forward", kFalse) && kv.is("auto_forward", kFalse) &&
+               kv.is("auto_backward", kFalse) &&
+               (kv.is("bike_forward", kTrue) || kv.is("bike_backward", kTrue))) {
+      use = 20;
+    } else if (kv.is("highway", "footway") && kv.is("footway", "sidewalk")) {
+      use = 24;
+    } else if (kv.is("highway", "footway") && kv.is("footway", "crossing")) {
+      use = 32;
+    } else if (kv.is("highway", "footway")) {
+      use = 25;
+    } else if (kv.is("highway", "elevator")) {
+      use = 33;
+    } else if (kv.is("highway", "steps") && kv["conveying"]) {
+      // escalator
+      use = 34;
+    } else if (kv.is("highway", "steps")) {
+      use = 26;
+    } else if (kv.is("highway", "path")) {
+      use = 27;
+    } else if (kv.is("highway", "pedestrian")) {
+      use = 28;
+    } else if (kv.is("highway", "platform")) {
+      use = 35;
+    } else if (kv.is("pedestrian_forward", kTrue) && no_vehicles()) {
+      use = 28;
+    } else if (kv.is("highway", "bridleway")) {
+      use = 29;
+    }
+  }
+
+  if (!use && kv["service"]) {
+    // other
+    use = 40;
+  } else if (!use) {
+    // general road, no special use
+    use = 0;
+  }
+
+  // do not override 'construction' use
+  if (use != 43 && (kv.is("access", "emergency") || kv.is("emergency", "yes")) &&
+      no_vehicles()) {
+    use = 7;
+  }
+
+  kv.set_number("use", *use);
+
+  const char* r_shoulder = either(get(kShoulder, kv["shoulder"]), get(kShoulder, kv["shoulder:both"]));
+  const char* l_shoulder = r_shoulder;
+
+  if (!r_shoulder) {
+    r_shoulder = either(get(kShoulder, kv["shoulder:right"]), get(kShoulderRight, kv["shoulder"]),
+                        kFalse);
+    l_shoulder = either(get(kShoulder, kv["shoulder:left"]), get(kShoulderLeft, kv["shoulder"]),
+                        kFalse);
+
+    // if the road is oneway and only one shoulder is tagged we set both, so that the side of the
+    // road we drive on doesn't make the edge miss the shoulder
+    if (is(oneway_norm, kTrue) && is(r_shoulder, kTrue) && is(l_shoulder, kFalse)) {
+      l_shoulder = kTrue;
+    } else if (is(oneway_norm, kTrue) && is(r_shoulder, kFalse) && is(l_shoulder, kTrue)) {
+      r_shoulder = kTrue;
+    }
+  }
+
+  kv.set("shoulder_right", r_shoulder);
+  kv.set("shoulder_left", l_shoulder);
+
+  const char* cycle_lane_right_opposite = kFalse;
+  const char* cycle_lane_left_opposite = kFalse;
+
+  int cycle_lane_right = 0;
+  int cycle_lane_left = 0;
+
+  // we have special use cases for cycle lanes when on a cycleway, footway, or path
+  if ((use == 20 || use == 25 || use == 27) &&
+      (kv.is("bike_forward", kTrue) || kv.is("bike_backward", kTrue))) {
+    if (kv.is("pedestrian_forward", kFalse)) {
+      // separated
+      cycle_lane_right = 3;
+    } else if (kv.is("segregated", "yes")) {
+      // dedicated
+      cycle_lane_right = 2;
+    } else if (kv.is("segregated", "no")) {
+      // shared
+      cycle_lane_right = 1;
+    } else if (use == 20) {
+      // no segregated tag but tagged as a cycleway so we assume separated lanes
+      cycle_lane_right = 2;
+    } else {
+      // no segregated tag and tagged as a footway or path so we assume shared lanes
+      cycle_lane_right = 1;
+    }
+    cycle_lane_left = cycle_lane_right;
+  } else {
+    // set flags if any of the lanes are marked "opposite" (contraflow)
+    cycle_lane_right_opposite = either(get(kBikeReverse, kv["cycleway"]), kFalse);
+    cycle_lane_left_opposite = cycle_lane_right_opposite;
+
+    if (is(cycle_lane_right_opposite, kFalse)) {
+      cycle_lane_right_opposite = either(get(kBikeReverse, kv["cycleway:right"]), kFalse);
+      cycle_lane_left_opposite = either(get(kBikeReverse, kv["cycleway:left"]), kFalse);
+    }
+
+    // figure out which side of the road has what cyclelane
+    cycle_lane_right =
+        either(cycle_lane("cycleway"), get(kBuffer, kv["cycleway:both:buffer"])).value_or(0);
+    cycle_lane_left = cycle_lane_right;
+
+    if (cycle_lane_right == 0) {
+      cycle_lane_right =
+          either(cycle_lane("cycleway:right"), get(kBuffer, kv["cycleway:right:buffer"]))
+              .value_or(0);
+      cycle_lane_left =
+          either(cycle_lane("cycleway:left"), get(kBuffer, kv["cycleway:left:buffer"])).value_or(0);
+    }
+
+    // with oneway:bicycle=no and no opposite_lane/opposite_track tags there are situations where
+    // the cyclelane is considered a two-way, see wiki.openstreetmap.org/wiki/Bicycle
+    if (kv.is("oneway:bicycle", "no") && is(cycle_lane_right_opposite, kFalse) &&
+        is(cycle_lane_left_opposite, kFalse)) {
+      if (cycle_lane_right == 2 || cycle_lane_right == 3) {
+        // example M1 or M2d but on the right side
+        if (is(oneway_norm, kTrue)) {
+          cycle_lane_left = cycle_lane_right;
+          cycle_lane_left_opposite = kTrue;
+        } // example L1b
+        else if (cycle_lane_left == 0) {
+          cycle_lane_left = cycle_lane_right;
+        }
+      } else if (cycle_lane_left == 2 || cycle_lane_left == 3) {
+        // example M2d
+        if (is(oneway_norm, kTrue)) {
+          cycle_lane_right = cycle_lane_left;
+          cycle_lane_right_opposite = kTrue;
+        } // example L1b but on the left side
+        else if (cycle_lane_right == 0) {
+          cycle_lane_right = cycle_lane_left;
+        }
+      }
+    }
+  }
+
+  kv.set_number("cycle_lane_right", cycle_lane_right);
+  kv.set_number("cycle_lane_left", cycle_lane_left);
+
+  kv.set("cycle_lane_right_opposite", cycle_lane_right_opposite);
+  kv.set("cycle_lane_left_opposite", cycle_lane_left_opposite);
+
+  if (highway && highway->find("_link") != std::string::npos) {
+    kv.set("link", kTrue);
+  }
+
+  if (kv.is("highway", "via_ferrata") && !kv["sac_scale"]) {
+    kv.set("sac_scale", "difficult_alpine_hiking");
+  }
+
+  // TODO: "private" also has directionality which we don't parse and handle yet
+  kv.set("private", either(any_in(kPrivate, kv["access"]), any_in(kPrivate, kv["motor_vehicle"]),
+                           any_in(kPrivate, kv["motorcar"]), any_in(kPrivate, kv["vehicle"]),
+                           kFalse));
+  kv.set("private_hgv", either(any_in(kPrivate, kv["hgv"]), kv["private"], kFalse));
+  kv.set("no_thru_traffic", either(any_in(kNoThruTraffic, kv["access"]), kFalse));
+  kv.set("ferry", ferry ? kTrue : kFalse);
+  kv.set("rail", kv.is("auto_forward", kTrue) &&
+                         (kv.is("railway", "rail") || kv.is("route", "shuttle_train"))
+                     ? kTrue
+                     : kFalse);
+
+  if (kv.is("maxspeed", "none")) {
+    // special case unlimited speed limit (german autobahn)
+    kv.set("max_speed", "unlimited");
+  } else {
+    kv.set_number("max_speed", normalize_speed(kv["maxspeed"]));
+  }
+
+  kv.set_number("advisory_speed", normalize_speed(kv["maxspeed:advisory"]));
+  kv.set_number("average_speed", normalize_speed(kv["maxspeed:practical"]));
+  kv.set_number("backward_speed", normalize_speed(kv["maxspeed:backward"]));
+  kv.set_number("forward_speed", normalize_speed(kv["maxspeed:forward"]));
+  kv.set("wheelchair", any_in(kWheelchair, kv["wheelchair"]));
+
+  // lower the default speed for tracks
+  if (kv.is("highway", "track")) {
+    kv.set_number("default_speed", 5);
+    if (kv.is("tracktype", "grade1")) {
+      kv.set_number("default_speed", 20);
+    } else if (kv.is("tracktype", "grade2")) {
+      kv.set_number("default_speed", 15);
+    } else if (kv.is("tracktype", "grade3")) {
+      kv.set_number("default_speed", 12);
+    } else if (kv.is("tracktype", "grade4")) {
+      kv.set_number("default_speed", 10);
+    }
+  }
+
+  // use unsigned_ref if all the conditions are met
+  if (!kv["name"] && !kv["name:en"] && !kv["alt_name"] && !kv["official_name"] && !kv["ref"] &&
+      !kv["int_ref"] &&
+      (kv.is("highway", "motorway") || kv.is("highway", "trunk") || kv.is("highway", "primary")) &&
+      kv["unsigned_ref"]) {
+    kv.set("ref", kv["unsigned_ref"]);
+  }
+
+  auto lane_count = [](const char* lanes) -> std::optional<double> {
+    auto prefix = numeric_prefix(lanes, false);
+    auto count = lua_tonumber(prefix ? prefix->c_str() : nullptr);
+    if (count && *count > 15) {
+      return std::nullopt;
+    }
+    return count;
+  };
+  kv.set_number("lanes", lane_count(kv["lanes"]));
+  kv.set_number("forward_lanes", lane_count(kv["lanes:forward"]));
+  kv.set_number("backward_lanes", lane_count(kv["lanes:backward"]));
+
+  kv.set("bridge", either(get(kBridge, kv["bridge"]), kFalse));
+
+  kv.set("hov_tag", kTrue);
+  if (kv.is("hov", "no")) {
+    kv.set("hov_forward", kFalse);
+    kv.set("hov_backward", kFalse);
+  } else {
+    kv.set("hov_forward", kv["auto_forward"]);
+    kv.set("hov_backward", kv["auto_backward"]);
+  }
+
+  // hov restrictions
+  if ((kv["hov"] && !kv.is("hov", "no")) || kv["hov:lanes"] || kv["hov:minimum"]) {
+    bool only_hov_allowed = kv.is("hov", "designated");
+
+    // if hov:lanes is specified ensure all lanes are tagged designated
+    if (only_hov_allowed && kv["hov:lanes"]) {
+      std::string_view lanes(kv["hov:lanes"]);
+      while (true) {
+        auto end = std::min(lanes.find('|'), lanes.size());
+        if (lanes.substr(0, end) != "designated") {
+          only_hov_allowed = false;
+        }
+        if (end == lanes.size()) {
+          break;
+        }
+        lanes.remove_prefix(end + 1);
+      }
+    }
+
+    // we are strict about hov:minimum and only accept 2 or 3, because routing onto an hov lane
+    // without the correct number of occupants is illegal
+    if (only_hov_allowed) {
+      if (kv.is("hov:minimum", "2")) {
+        kv.set("hov_type", "HOV2");
+      } else if (kv.is("hov:minimum", "3")) {
+        kv.set("hov_type", "HOV3");
+      } else {
+        only_hov_allowed = false;
+      }
+    }
+
+    // hov lanes are sometimes time-conditional and can change direction, we avoid these
+    if (only_hov_allowed) {
+      bool avoid_these_hovs = kv.is("oneway", "alternating") || kv.is("oneway", "reversible") ||
+                              kv.is("oneway", kFalse) || kv["oneway:conditional"] ||
+                              kv["access:conditional"];
+      only_hov_allowed = !avoid_these_hovs;
+    }
+
+    if (only_hov_allowed) {
+      // a true hov only lane (not mixed), none of the following costings can use it
+      if (!kv["auto_tag"]) {
+        kv.set("auto_forward", kFalse);
+        kv.set("auto_backward", kFalse);
+      }
+
+      if (!kv["truck_tag"]) {
+        kv.set("truck_forward", kFalse);
+        kv.set("truck_backward", kFalse);
+      }
+
+      if (!kv["foot_tag"]) {
+        kv.set("pedestrian_forward", kFalse);
+        kv.set("pedestrian_backward", kFalse);
+      }
+
+      if (!kv["bike_tag"]) {
+        kv.set("bike_forward", kFalse);
+        kv.set("bike_backward", kFalse);
+      }
+    } else {
+      // this is not an hov only lane
+      kv.set("hov_forward", kFalse);
+      kv.set("hov_backward", kFalse);
+    }
+  }
+
+  kv.set("tunnel", either(get(kTunnel, kv["tunnel"]), kFalse));
+  kv.set("toll", either(get(kToll, kv["toll"]), kFalse));
+
+
+  // truck goodies
+  auto maxheight = normalize_measurement(kv["maxheight"]);
+  kv.set_number("maxheight", maxheight ? maxheight : normalize_measurement(kv["maxheight:physical"]));
+  auto maxwidth = normalize_measurement(kv["maxwidth"]);
+  kv.set_number("maxwidth", maxwidth ? maxwidth : normalize_measurement(kv["maxwidth:physical"]));
+  kv.set_number("maxlength", normalize_measurement(kv["maxlength"]));
+  kv.set_number("maxweight", normalize_weight(kv["maxweight"]));
+  kv.set_number("maxaxleload", normalize_weight(kv["maxaxleload"]));
+  kv.set_number("maxaxles", lua_tonumber(kv["maxaxles"]));
+
+  // forward/backward only tags
+  kv.set_number("maxheight_forward", normalize_measurement(kv["maxheight:forward"]));
+  kv.set_number("maxheight_backward", normalize_measurement(kv["maxheight:backward"]));
+  kv.set_number("maxlength_forward", normalize_measurement(kv["maxlength:forward"]));
+  kv.set_number("maxlength_backward", normalize_measurement(kv["maxlength:backward"]));
+  kv.set_number("maxweight_forward", normalize_weight(kv["maxweight:forward"]));
+  kv.set_number("maxweight_backward", normalize_weight(kv["maxweight:backward"]));
+  kv.set_number("maxwidth_forward", normalize_measurement(kv["maxwidth:forward"]));
+  kv.set_number("maxwidth_backward", normalize_measurement(kv["maxwidth:backward"]));
+
+  // TODO: hazmat really should have subcategories
+  for (const std::string suffix : {"", ":forward", ":backward"}) {
+    const char* hazmat = nullptr;
+    for (const std::string category : {"", ":water", ":A", ":B", ":C", ":D", ":E"}) {
+      hazmat = either(hazmat, get(kHazmat, kv["hazmat" + category + suffix]));
+    }
+    kv.set(suffix.empty() ? "hazmat" : "hazmat_" + suffix.substr(1), hazmat);
+  }
+
+  kv.set_number("maxspeed:hgv", normalize_speed(kv["maxspeed:hgv"]));
+  kv.set_number("maxspeed:hgv:forward", normalize_speed(kv["maxspeed:hgv:forward"]));
+  kv.set_number("maxspeed:hgv:backward", normalize_speed(kv["maxspeed:hgv:backward"]));
+
+  // restrictions which don't apply to destination traffic get a ~ which the graph parser picks up
+  auto except_destination = [&kv](const std::string& tag) {
+    return get(kConditionalAccessRestriction, kv[tag + ":conditional"]) == 1 && kv[tag];
+  };
+  for (const auto& [restriction, directed] : std::initializer_list<std::pair<std::string, bool>>{
+           {"maxweight", true},
+           {"maxheight", true},
+           {"maxlength", true},
+           {"maxwidth", true},
+           {"hazmat", true},
+           {"maxaxles", false},
+           {"maxaxleload", false},
+       }) {
+    if (except_destination(restriction)) {
+      kv.set(restriction, std::string(kv[restriction]) + "~");
+    }
+    if (directed) {
+      for (const std::string direction : {"forward", "backward"}) {
+        auto key = restriction + "_" + direction;
+        if (except_destination(restriction + ":" + direction)) {
+          kv.set(key, (kv[key] ? std::string(kv[key]) : "nil") + "~");
+        }
+      }
+    }
+  }
+
+  if (kv["hgv:national_network"] || kv["hgv:state_network"] || any_in(kTruckHgv, kv["hgv"])) {
+    kv.set("truck_route", kTrue);
+  }
+
+  auto nref = kv.copy("ncn_ref");
+  auto rref = kv.copy("rcn_ref");
+  auto lref = kv.copy("lcn_ref");
+  int bike_mask = 0;
+  if (nref || kv.is("ncn", "yes")) {
+    bike_mask = 1;
+  }
+  if (rref || kv.is("rcn", "yes")) {
+    bike_mask |= 2;
+  }
+  if (lref || kv.is("lcn", "yes")) {
+    bike_mask |= 4;
+  }
+  if (kv.is("mtb", "yes")) {
+    bike_mask |= 8;
+  }
+
+  kv.set("bike_national_ref", nref);
+  kv.set("bike_regional_ref", rref);
+  kv.set("bike_local_ref", lref);
+  kv.set_number("bike_network_mask", bike_mask);
+
+  // explicitly turn off access for construction, older routers which don't know about
+  // Use::kConstruction only look at the access to decide whether an edge is routable
+  if (kv.is("highway", "construction")) {
+    set_all(kv, kForward, kFalse, true);
+    set_all(kv, kBackward, kFalse, true);
+    kv.set("hov_forward", kFalse);
+    kv.set("hov_backward", kFalse);
+    kv.set("emergency_forward", kFalse);
+    kv.set("emergency_backward", kFalse);
+  }
+
+  return false;
+}
+
+// returns true if the node should be filtered, which it never is
+bool nodes_proc(kv_t& kv) {
+  // normalize a few tags that we care about
+  const char* initial_access = any_in(kAccess, kv["access"]);
+  const char* access = either(initial_access, kTrue);
+
+  // expect access=private not to be combined with other values
+  if (kv.is("impassable", "yes") ||
+      (kv.is("access", "private") &&
+       (kv.is("emergency", "yes") || kv.is("service", "emergency_access")))) {
+    access = kFalse;
+  }
+
+  std::optional<int> hov_tag;
+  if ((kv["hov"] && !kv.is("hov", "no")) || kv["hov:lanes"] || kv["hov:minimum"]) {
+    hov_tag = 128;
+  }
+
+  auto foot_tag = any_in_num(kFootNode, kv["foot"]);
+  auto wheelchair_tag = any_in_num(kWheelchairNode, kv["wheelchair"]);
+  auto bike_tag = any_in_num(kBicycleNode, kv["bicycle"]);
+  auto truck_tag = any_in_num(kTruckNode, kv["hgv"]);
+  auto auto_tag = any_in_num(kMotorVehicleNode, kv["motorcar"]);
+  auto motor_vehicle_tag = any_in_num(kMotorVehicleNode, kv["motor_vehicle"]);
+  auto moped_tag = either(any_in_num(kMopedNode, kv["moped"]), any_in_num(kMopedNode, kv["mofa"]));
+  auto motorcycle_tag = any_in_num(kMotorCycleNode, kv["motorcycle"]);
+
+  if (!auto_tag) {
+    auto_tag = motor_vehicle_tag;
+  }
+  std::optional<int> bus_tag;
+  std::optional<int> taxi_tag;
+
+  if (kv.is("access", "psv")) {
+    bus_tag = 64;
+    taxi_tag = 32;
+  } else {
+    bus_tag = any_in_num(kBusNode, kv["bus"]);
+    taxi_tag = any_in_num(kTaxiNode, kv["taxi"]);
+  }
+
+  if (!bus_tag) {
+    bus_tag = any_in_num(kPsvBusNode, kv["psv"]);
+  }
+  // if bus was not set and car is
+  if (!bus_tag && auto_tag == 1) {
+    bus_tag = 64;
+  }
+
+  // if wheelchair was not set and foot is
+  if (!wheelchair_tag && foot_tag == 2) {
+    wheelchair_tag = 256;
+  }
+
+  // if hov was not set and car is
+  if (!hov_tag && auto_tag == 1) {
+    hov_tag = 128;
+  }
+
+  if (!taxi_tag) {
+    taxi_tag = any_in_num(kPsvTaxiNode, kv["psv"]);
+  }
+  // if taxi was not set and car is
+  if (!taxi_tag && auto_tag == 1) {
+    taxi_tag = 32;
+  }
+
+  // if truck was not set and car is
+  if (!truck_tag && auto_tag == 1) {
+    truck_tag = 8;
+  }
+
+  // must shut these off if motor_vehicle = 0
+  if (motor_vehicle_tag == 0) {
+    hov_tag = hov_tag.value_or(0);
+    bus_tag = bus_tag.value_or(0);
+    taxi_tag = taxi_tag.value_or(0);
+    truck_tag = truck_tag.value_or(0);
+    moped_tag = moped_tag.value_or(0);
+    motorcycle_tag = motorcycle_tag.value_or(0);
+  }
+
+  std::optional<int> emergency_tag;
+  if (kv.is("access", "emergency") || kv.is("emergency", "yes") ||
+      kv.is("service", "emergency_access")) {
+    emergency_tag = 16;
+  }
+
+  // do not shut off bike access if there is a highway crossing
+  if (bike_tag == 0 && kv.is("highway", "crossing")) {
+    bike_tag = 4;
+  }
+
+  // if a tag exists use it, otherwise access is allowed for all modes unless access = false or
+  // hov = designated or vehicle = no. if access = private use the allowed modes, but consider the
+  // private_access tag as true.
+  int auto_ = auto_tag.value_or(1);
+  int truck = truck_tag.value_or(8);
+  int bus = bus_tag.value_or(64);
+  int taxi = either(taxi_tag, auto_tag).value_or(32);
+  int foot = foot_tag.value_or(2);
+  int wheelchair = wheelchair_tag.value_or(256);
+  int bike = bike_tag.value_or(4);
+  int emergency = emergency_tag.value_or(16);
+  int hov = either(hov_tag, auto_tag).value_or(128);
+  int moped = moped_tag.value_or(512);
+  int motorcycle = motorcycle_tag.value_or(1024);
+
+  // if access = false use the tag if it exists, otherwise no access for that mode
+  if (is(access, kFalse) || kv.is("vehicle", "no") || kv.is("smoothness", "impassable") ||
+      kv.is("hov", "designated")) {
+    auto_ = auto_tag.value_or(0);
+    truck = truck_tag.value_or(0);
+    bus = bus_tag.value_or(0);
+    taxi = taxi_tag.value_or(0);
+
+    // don't change ped if vehicle = no
+    if (is(access, kFalse) || kv.is("hov", "designated")) {
+      foot = foot_tag.value_or(0);
+    }
+
+    wheelchair = wheelchair_tag.value_or(0);
+    bike = bike_tag.value_or(0);
+    moped = moped_tag.value_or(0);
+    motorcycle = motorcycle_tag.value_or(0);
+    emergency = emergency_tag.value_or(0);
+    hov = hov_tag.value_or(0);
+  }
+
+  // check for gates, bollards, walls and sump_busters
+  bool gate = kv.is("barrier", "gate") || kv.is("barrier", "yes") ||
+              kv.is("barrier", "lift_gate") || kv.is("barrier", "swing_gate") ||
+              kv.is("barrier", "sliding_beam");
+  bool bollard = false;
+  bool sump_buster = false;
+  bool wall = false;
+
+  if (!gate) {
+    // if there was a bollard cars can't get through it
+    bollard = kv.is("barrier", "bollard") || kv.is("barrier", "block") ||
+              kv.is("bollard", "removable") || kv.is("barrier", "kissing_gate") ||
+              kv.is("barrier", "motorcycle_barrier") || kv.is("barrier", "cycle_barrier") ||
+              kv.is("barrier", "chain") || kv.is("barrier", "bar");
+
+    // if sump_buster then no access for auto, hov, and taxi unless a tag exists
+    sump_buster = kv.is("barrier", "sump_buster");
+
+    // if there is a kind of wall, there is no access for all profiles unless a tag exists
+    wall = kv.is("barrier", "fence") || kv.is("barrier", "barrier_board") ||
+           kv.is("barrier", "wall") || kv.is("barrier", "jersey_barrier") ||
+           kv.is("barrier", "debris");
+
+    // save the following as gates
+    if (bollard && kv.is("bollard", "rising")) {
+      gate = true;
+      bollard = false;
+    }
+
+    // bollard = true shuts off access when access is not originally specified
+    if (bollard && !initial_access) {
+      auto_ = auto_tag.value_or(0);
+      truck = truck_tag.value_or(0);
+      bus = bus_tag.value_or(0);
+      taxi = taxi_tag.value_or(0);
+      foot = foot_tag.value_or(2);
+      wheelchair = wheelchair_tag.value_or(256);
+      bike = bike_tag.value_or(4);
+      moped = moped_tag.value_or(0);
+      motorcycle = motorcycle_tag.value_or(0);
+      emergency = emergency_tag.value_or(0);
+      hov = hov_tag.value_or(0);
+    } // sump_buster = true shuts off access unless the tag exists
+    else if (sump_buster) {
+      auto_ = auto_tag.value_or(0);
+      truck = truck_tag.value_or(8);
+      bus = bus_tag.value_or(64);
+      taxi = taxi_tag.value_or(0);
+      foot = foot_tag.value_or(2);
+      wheelchair = wheelchair_tag.value_or(256);
+      bike = bike_tag.value_or(4);
+      moped = moped_tag.value_or(512);
+      motorcycle = motorcycle_tag.value_or(1024);
+      emergency = emergency_tag.value_or(16);
+      hov = hov_tag.value_or(0);
+    } // wall = true shuts off access unless a tag exists
+    else if (wall) {
+      auto_ = auto_tag.value_or(0);
+      truck = truck_tag.value_or(0);
+      bus = bus_tag.value_or(0);
+      taxi = taxi_tag.value_or(0);
+      foot = foot_tag.value_or(0);
+      wheelchair = wheelchair_tag.value_or(0);
+      bike = bike_tag.value_or(0);
+      moped = moped_tag.value_or(0);
+      motorcycle = motorcycle_tag.value_or(0);
+      emergency = emergency_tag.value_or(0);
+      hov = hov_tag.value_or(0);
+    }
+  }
+
+  // if nothing blocks access at this node assume access is allowed
+  if (!gate && !bollard && !sump_buster && !wall && is(access, kTrue)) {
+    if (kv.is("highway", "crossing") || kv.is("railway", "crossing") ||
+        kv.is("footway", "crossing") || kv.is("cycleway", "crossing") ||
+        kv.is("foot", "crossing") || kv.is("bicycle", "crossing") ||
+        kv.is("pedestrian", "crossing") || kv["crossing"]) {
+      auto_ = auto_tag.value_or(1);
+      truck = truck_tag.value_or(8);
+      bus = bus_tag.value_or(64);
+      taxi = taxi_tag.value_or(32);
+      foot = foot_tag.value_or(2);
+      wheelchair = wheelchair_tag.value_or(256);
+      bike = bike_tag.value_or(4);
+      moped = moped_tag.value_or(512);
+      motorcycle = motorcycle_tag.value_or(1024);
+      emergency = emergency_tag.value_or(16);
+      hov = hov_tag.value_or(128);
+    }
+  }
+
+  // store the gate and bollard info
+  kv.set("gate", gate ? kTrue : kFalse);
+  kv.set("bollard", bollard ? kTrue : kFalse);
+  kv.set("sump_buster", sump_buster ? kTrue : kFalse);
+
+  if (kv.is("barrier", "border_control")) {
+    kv.set("border_control", kTrue);
+  } else if (kv.is("barrier", "toll_booth")) {
+    kv.set("toll_booth", kTrue);
+    if (is_cash_only_payment(kv)) {
+      kv.set("cash_only_toll", kTrue);
+    }
+  } else if (kv.is("highway", "toll_gantry")) {
+    kv.set("toll_gantry", kTrue);
+  } else if (kv.is("entrance", "yes") && kv.is("indoor", "yes")) {
+    kv.set("building_entrance", kTrue);
+  } else if (kv.is("highway", "elevator")) {
+    kv.set("elevator", kTrue);
+  }
+
+  if (kv.is("amenity", "bicycle_rental") ||
+      (kv.is("shop", "bicycle") && kv.is("service:bicycle:rental", "yes"))) {
+    kv.set("bicycle_rental", kTrue);
+  }
+
+  if (kv.is("traffic_signals:direction", "forward")) {
+    kv.set("forward_signal", kTrue);
+
+    if (!kv["public_transport"] && kv["name"]) {
+      kv.set("junction", "named");
+    }
+  }
+
+  if (kv.is("traffic_signals:direction", "backward")) {
+    kv.set("backward_signal", kTrue);
+
+    if (!kv["public_transport"] && kv["name"]) {
+      kv.set("junction", "named");
+    }
+  }
+
+  // stop signs and give ways with an unknown direction are dropped
+  for (const auto& [sign, prefix] : std::initializer_list<std::pair<std::string, std::string>>{
+           {"stop", "stop"}, {"give_way", "yield"}}) {
+    if (kv.is("highway", sign)) {
+      if (kv.is("direction", "both")) {
+        kv.set("forward_" + prefix, kTrue);
+        kv.set("backward_" + prefix, kTrue);
+      } else if (kv.is("direction", "forward")) {
+        kv.set("forward_" + prefix, kTrue);
+      } else if (kv.is("direction", "backward") || kv.is("direction", "reverse")) {
+        kv.set("backward_" + prefix, kTrue);
+      } else if (kv["direction"] && !kv[sign]) {
+        kv.set("highway", nullptr);
+      }
+    }
+  }
+
+  if (!kv["public_transport"] && kv["name"]) {
+    if (kv.is("highway", "traffic_signals")) {
+      if (!kv.is("junction", "yes")) {
+        kv.set("junction", "named");
+      }
+    } else if (kv.is("junction", "yes") || kv.is("reference_point", "yes")) {
+      kv.set("junction", "named");
+    }
+  }
+
+  kv.set("private", either(any_in(kPrivate, kv["access"]), any_in(kPrivate, kv["motor_vehicle"]),
+                           kFalse));
+
+  // store a mask denoting access
+  kv.set_number("access_mask", auto_ | emergency | truck | bike | foot | wheelchair | bus | hov |
+                                   moped | motorcycle | taxi);
+
+  // if no information about access is given
+  bool tagged_access = initial_access || auto_tag || truck_tag || bus_tag || taxi_tag ||
+                       foot_tag || wheelchair_tag || bike_tag || moped_tag || motorcycle_tag ||
+                       emergency_tag || hov_tag;
+  kv.set_number("tagged_access", tagged_access ? 1 : 0);
+
+  return false;
+}
+
+// returns true if the way should be filtered
+bool ways_proc(kv_t& kv, size_t nokeys) {
+  // if there were no tags passed in
+  if (nokeys == 0) {
+    return true;
+  }
+
+  // does it at least have some interesting tags
+  return filter_tags_generic(kv);
+}
+
+// returns true if the relation should be filtered
+bool rels_proc(kv_t& kv) {
+  if (kv.is("type", "connectivity")) {
+    return false;
+  }
+
+  if (!kv.is("type", "route") && !kv.is("type", "restriction")) {
+    return true;
+  }
+
+  if (kv["restriction:probable"] && (kv["restriction"] || kv["restriction:conditional"])) {
+    kv.set("restriction:probable", nullptr);
+  }
+
+  auto prefix = [&kv](const std::string& key) {
+    auto type = restriction_prefix(kv[key]);
+    return type ? get(kRestriction, type->c_str()) : std::nullopt;
+  };
+  auto restrict =
+      either(get(kRestriction, kv["restriction"]), prefix("restriction:conditional"),
+             prefix("restriction:probable"));
+
+  const std::array<std::string, 9> types = {
+      "restriction:hgv",    "restriction:emergency",  "restriction:taxi",
+      "restriction:motorcar", "restriction:bus",      "restriction:bicycle",
+      "restriction:hazmat", "restriction:motorcycle", "restriction:foot",
+  };
+  std::optional<int> restrict_type;
+  for (const auto& type : types) {
+    restrict_type = either(restrict_type, get(kRestriction, kv[type]));
+  }
+
+  // restrictions with type win over just restriction key, people enter both
+  if (restrict_type) {
+    restrict = restrict_type;
+  }
+
+  if (kv.is("type", "restriction") || kv["restriction:conditional"] ||
+      kv["restriction:probable"]) {
+    if (!restrict) {
+      return true;
+    }
+
+    kv.set("restriction:conditional", restriction_suffix(kv["restriction:conditional"]));
+    kv.set("restriction:probable", restriction_suffix(kv["restriction:probable"]));
+
+    for (const auto& type : types) {
+      auto value = get(kRestriction, kv[type]);
+      kv.set_number(type, value ? std::optional<double>(*value) : std::nullopt);
+    }
+
+    if (!restrict_type) {
+      kv.set_number("restriction", *restrict);
+    } else {
+      kv.set("restriction", nullptr);
+    }
+    return false;
+  } else if (kv.is("route", "bicycle") || kv.is("route", "mtb")) {
+    int bike_mask = 0;
+
+    if (kv.is("network", "mtb") || kv.is("route", "mtb")) {
+      bike_mask = 8;
+    }
+
+    if (kv.is("network", "ncn")) {
+      bike_mask |= 1;
+    } else if (kv.is("network", "rcn")) {
+      bike_mask |= 2;
+    } else if (kv.is("network", "lcn")) {
+      bike_mask |= 4;
+    }
+
+    kv.set_number("bike_network_mask", bike_mask);
+
+    kv.set("day_on", nullptr);
+    kv.set("day_off", nullptr);
+    kv.set("restriction", nullptr);
+    return false;
+  } // has a restriction but type is not restriction...ignore
+  else if (restrict) {
+    return true;
+  }
+
+  kv.set("day_on", nullptr);
+  kv.set("day_off", nullptr);
+  kv.set("restriction", nullptr);
+  return false;
+}
+
+std::string to_string(OSMType type) {
+  if (type == OSMType::kNode) {
+    return "node";
+  } else if (type == OSMType::kWay) {
+    return "way";
+  }
+  return "relation";
+}
+
+} // namespace
+
+namespace valhalla {
+namespace mjolnir {
+
+Tags NativeTagTransform::Transform(OSMType type, uint64_t osmid, const osmium::TagList& maptags) {
+  Tags result;
+  try {
+    size_t count = 0;
+    for (const auto& tag : maptags) {
+      result[tag.key()] = tag.value();
+      ++count;
+    }
+
+    kv_t kv(result);
+    bool filter = type == OSMType::kNode  ? nodes_proc(kv)
+                  : type == OSMType::kWay ? ways_proc(kv, count)
+                                          : rels_proc(kv);
+    if (filter) {
+      result.clear();
+    }
+  } catch (std::exception& e) {
+    // same as when the lua script fails, we log it and move on without the object
+    LOG_ERROR("Failed to transform the tags of " + ::to_string(type) + " " + std::to_string(osmid) +
+              ": " + e.what());
+    result.clear();
+  }
+  return result;
+}
+
+std::unique_ptr<TagTransform> TagTransform::Create(const std::string& lua) {
+  if (lua.empty()) {
+    return std::make_unique<NativeTagTransform>();
+  }
+  return std::make_unique<LuaTagTransform>(lua);
+}
+
+} // namespace mjolnir
+} // namespace valhalla
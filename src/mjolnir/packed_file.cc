@@ -0,0 +1,265 @@
+#include "mjolnir/packed_file.h"
+#include "midgard/logging.h"
+
+#ifdef ENABLE_LZ4
+#include <lz4.h>
+#endif
+#include <zlib.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+
+using valhalla::mjolnir::Compression;
+
+// identifies the file and its layout. the file starts with a header, each block with its raw and
+// stored size. every block holds the same number of records except for the last one
+constexpr char kMagic[4] = {'V', 'S', 'Q', 'Z'};
+constexpr uint8_t kVersion = 1;
+// a megabyte per block keeps the reads large
+constexpr size_t kBlockBytes = 1024 * 1024;
+
+struct file_header_t {
+  char magic[4];
+  uint8_t version;
+  uint8_t compression;
+  uint16_t spare;
+  uint32_t record_size;
+  uint32_t block_records;
+};
+
+struct block_header_t {
+  uint32_t raw_bytes;
+  uint32_t stored_bytes;
+  uint8_t compressed;
+  uint8_t spare[3];
+};
+
+// compresses raw into stored, returns false if it didn't get any smaller
+bool compress(Compression compression, const std::vector<char>& raw, std::vector<char>& stored) {
+  switch (compression) {
+    case Compression::kLz4: {
+#ifdef ENABLE_LZ4
+      stored.resize(LZ4_compressBound(static_cast<int>(raw.size())));
+      int size = LZ4_compress_default(raw.data(), stored.data(), static_cast<int>(raw.size()),
+                                      static_cast<int>(stored.size()));
+      if (size <= 0) {
+        return false;
+      }
+      stored.resize(size);
+      break;
+#else
+      return false;
+#endif
+    }
+    case Compression::kZlib: {
+      uLongf size = compressBound(raw.size());
+      stored.resize(size);
+      // the files are only kept for the duration of the build, favour speed over size
+      if (compress2(reinterpret_cast<Bytef*>(stored.data()), &size,
+                    reinterpret_cast<const Bytef*>(raw.data()), raw.size(), Z_BEST_SPEED) != Z_OK) {
+        return false;
+      }
+      stored.resize(size);
+      break;
+    }
+    case Compression::kNone:
+      return false;
+  }
+  return stored.size() < raw.size();
+}
+
+// decompresses stored into raw which is already sized to the expected raw size
+bool decompress(Compression compression, const std::vector<char>& stored, std::vector<char>& raw) {
+  switch (compression) {
+    case Compression::kLz4:
+#ifdef ENABLE_LZ4
+      return LZ4_decompress_safe(stored.data(), raw.data(), static_cast<int>(stored.size()),
+                                 static_cast<int>(raw.size())) == static_cast<int>(raw.size());
+#else
+      return false;
+#endif
+    case Compression::kZlib: {
+      uLongf size = raw.size();
+      return uncompress(reinterpret_cast<Bytef*>(raw.data()), &size,
+                        reinterpret_cast<const Bytef*>(stored.data()), stored.size()) == Z_OK &&
+             size == raw.size();
+    }
+    case Compression::kNone:
+      break;
+  }
+  return false;
+}
+
+// writes the records in blocks, compressing them as they fill up
+class block_writer {
+public:
+  block_writer(const std::string& file_name, Compression compression, uint32_t record_size)
+      : file_(file_name, std::ios_base::binary | std::ios_base::trunc), file_name_(file_name),
+        compression_(compression), block_bytes_(kBlockBytes / record_size * record_size) {
+    if (!file_) {
+      throw std::runtime_error("pack: " + file_name + ": " + strerror(errno));
+    }
+    block_.reserve(block_bytes_);
+    file_header_t header{};
+    std::copy(std::begin(kMagic), std::end(kMagic), header.magic);
+    header.version = kVersion;
+    header.compression = static_cast<uint8_t>(compression);
+    header.record_size = record_size;
+    header.block_records = static_cast<uint32_t>(block_bytes_ / record_size);
+    file_.write(reinterpret_cast<const char*>(&header), sizeof(header));
+  }
+
+  void append(const char* bytes, size_t count) {
+    while (count) {
+      size_t n = std::min(count, block_bytes_ - block_.size());
+      block_.insert(block_.end(), bytes, bytes + n);
+      bytes += n;
+      count -= n;
+      if (block_.size() == block_bytes_) {
+        write_block();
+      }
+    }
+  }
+
+  void close() {
+    if (!block_.empty()) {
+      write_block();
+    }
+    file_.close();
+    if (!file_) {
+      throw std::runtime_error("pack: " + file_name_ + ": failed to write");
+    }
+  }
+
+protected:
+  void write_block() {
+    block_header_t header{};
+    header.raw_bytes = static_cast<uint32_t>(block_.size());
+    header.compressed = compress(compression_, block_, stored_);
+    const auto& data = header.compressed ? stored_ : block_;
+    header.stored_bytes = static_cast<uint32_t>(data.size());
+    file_.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file_.write(data.data(), data.size());
+    block_.clear();
+  }
+
+  std::ofstream file_;
+  std::string file_name_;
+  Compression compression_;
+  size_t block_bytes_;
+  std::vector<char> block_;
+  std::vector<char> stored_;
+};
+
+} // namespace
+
+namespace valhalla {
+namespace mjolnir {
+
+Compression compression_from_string(const std::string& name) {
+  if (name == "none") {
+    return Compression::kNone;
+  }
+  if (name == "lz4") {
+#ifdef ENABLE_LZ4
+    return Compression::kLz4;
+#else
+    LOG_WARN("lz4 support is not compiled in, compressing with zlib instead");
+    return Compression::kZlib;
+#endif
+  }
+  if (name == "zlib") {
+    return Compression::kZlib;
+  }
+  throw std::runtime_error("Unknown compression " + name);
+}
+
+uint64_t pack(const std::string& file_name, Compression compression, uint32_t record_size) {
+  const auto packed_name = file_name + kPackedSuffix;
+  std::ifstream in(file_name, std::ios_base::binary);
+  if (!in) {
+    throw std::runtime_error("pack: " + file_name + ": " + strerror(errno));
+  }
+  if (record_size == 0 || record_size > kBlockBytes ||
+      std::filesystem::file_size(file_name) % record_size) {
+    throw std::runtime_error("pack: " + file_name + " has an incorrect size for the records");
+  }
+
+  // a failed pack leaves the file as it was
+  try {
+    block_writer writer(packed_name, compression, record_size);
+    std::vector<char> buffer(kBlockBytes);
+    while (in.read(buffer.data(), buffer.size()) || in.gcount()) {
+      writer.append(buffer.data(), in.gcount());
+    }
+    writer.close();
+  } catch (...) {
+    std::filesystem::remove(packed_name);
+    throw;
+  }
+  in.close();
+  std::filesystem::remove(file_name);
+  return std::filesystem::file_size(packed_name);
+}
+
+void unpack(const std::string& file_name) {
+  const auto packed_name = file_name + kPackedSuffix;
+  std::ifstream in(packed_name, std::ios_base::binary);
+  if (!in) {
+    throw std::runtime_error("unpack: " + packed_name + ": " + strerror(errno));
+  }
+  file_header_t header{};
+  if (!in.read(reinterpret_cast<char*>(&header), sizeof(header)) ||
+      !std::equal(std::begin(kMagic), std::end(kMagic), header.magic) ||
+      header.version != kVersion || header.record_size == 0 || header.block_records == 0) {
+    throw std::runtime_error("unpack: " + packed_name + " is not a packed file");
+  }
+  const auto compression = static_cast<Compression>(header.compression);
+
+  // a failed unpack leaves the packed copy as it was
+  try {
+    std::ofstream out(file_name, std::ios_base::binary | std::ios_base::trunc);
+    if (!out) {
+      throw std::runtime_error("unpack: " + file_name + ": " + strerror(errno));
+    }
+    std::vector<char> raw, stored;
+    block_header_t block{};
+    while (in.read(reinterpret_cast<char*>(&block), sizeof(block))) {
+      auto& target = block.compressed ? stored : raw;
+      target.resize(block.stored_bytes);
+      if (!in.read(target.data(), target.size())) {
+        throw std::runtime_error("unpack: " + packed_name + " is truncated");
+      }
+      if (block.compressed) {
+        raw.resize(block.raw_bytes);
+        if (!decompress(compression, stored, raw)) {
+          throw std::runtime_error("unpack: " + packed_name + " has a corrupt block");
+        }
+      }
+      out.write(raw.data(), raw.size());
+    }
+    if (in.gcount() != 0) {
+      throw std::runtime_error("unpack: " + packed_name + " is truncated");
+    }
+    out.close();
+    if (!out) {
+      throw std::runtime_error("unpack: " + file_name + ": failed to write");
+    }
+  } catch (...) {
+    std::filesystem::remove(file_name);
+    throw;
+  }
+  in.close();
+  std::filesystem::remove(packed_name);
+}
+
+} // namespace mjolnir
+} // namespace valhalla
@@ -5,11 +5,11 @@
 #include "graph_lua_proc.h"
 #include "midgard/logging.h"
 #include "midgard/sequence.h"
-#include "mjolnir/luatagtransform.h"
 #include "mjolnir/osmaccess.h"
 #include "mjolnir/osmlinguistic.h"
 #include "mjolnir/osmnodelinguistic.h"
 #include "mjolnir/osmway.h"
+#include "mjolnir/tagtransform.h"
 #include "mjolnir/timeparsing.h"
 #include "mjolnir/util.h"
 #include "proto/common.pb.h"
@@ -162,7 +162,7 @@ private:
 // Construct PBFGraphParser based on properties file and input PBF extract
 struct graph_parser {
   graph_parser(const boost::property_tree::ptree& pt, OSMData& osmdata)
-      : lua_(get_lua(pt)), osmdata_(osmdata) {
+      : lua_(TagTransform::Create(get_lua(pt))), osmdata_(osmdata) {
     current_way_node_index_ = last_node_ = last_way_ = last_relation_ = 0;
 
     highway_cutoff_rc_ = RoadClass::kPrimary;
@@ -184,8 +184,8 @@ struct graph_parser {
     use_rest_area_ = pt.get<bool>("data_processing.use_rest_area", false);
     use_admin_db_ = pt.get<bool>("data_processing.use_admin_db", true);
 
-    empty_node_tags_ = lua_.Transform(OSMType::kNode, 0, {});
-    empty_relation_tags_ = lua_.Transform(OSMType::kRelation, 0, {});
+    empty_node_tags_ = lua_->Transform(OSMType::kNode, 0, {});
+    empty_relation_tags_ = lua_->Transform(OSMType::kRelation, 0, {});
 
     tag_handlers_["driving_side"] = [this]() {
       if (!use_admin_db_) {
@@ -1987,6 +1987,10 @@ struct graph_parser {
       }
       return std::string((std::istreambuf_iterator<char>(lua)), std::istreambuf_iterator<char>());
     }
+    // an empty script selects the native port of graph.lua
+    if (pt.get<bool>("data_processing.use_native_tag_transform", false)) {
+      return {};
+    }
     return std::string(lua_graph_lua, lua_graph_lua + lua_graph_lua_len);
   }
 
@@ -2001,7 +2005,7 @@ struct graph_parser {
 
     // Get tags - do't bother with Lua callout if the taglist is empty
     const Tags tags = node.tags().empty() ? empty_node_tags_
-                                          : lua_.Transform(OSMType::kNode, node.id(), node.tags());
+                                          : lua_->Transform(OSMType::kNode, node.id(), node.tags());
 
     // bail if there is nothing bike related
     Tags::const_iterator found = tags.find("amenity");
@@ -2077,8 +2081,8 @@ struct graph_parser {
 
     // Get tags if not already available.  Don't bother calling Lua if there
     // are no OSM tags to process.
-    const Tags tags =
-        node.tags().empty() ? empty_node_tags_ : lua_.Transform(OSMType::kNode, osmid, node.tags());
+    const Tags tags = node.tags().empty() ? empty_node_tags_
+                                          : lua_->Transform(OSMType::kNode, osmid, node.tags());
 
     const auto highway = tags.find("highway");
     bool is_highway_junction = ((highway != tags.end()) && (highway->second == "motorway_junction"));
@@ -2348,7 +2352,7 @@ struct graph_parser {
   };
 
   static void transform_way(const osmium::Way& way,
-                            LuaTagTransform& lua,
+                            TagTransform& lua,
                             const Tags& empty_way_tags,
                             std::vector<Way>& transformed) {
     std::vector<uint64_t> nodes;
@@ -3829,7 +3833,7 @@ struct graph_parser {
     // Get tags
     const Tags tags = relation.tags().empty()
                           ? empty_relation_tags_
-                          : lua_.Transform(OSMType::kRelation, osmid, relation.tags());
+                          : lua_->Transform(OSMType::kRelation, osmid, relation.tags());
     if (tags.empty()) {
       return;
     }
@@ -5057,8 +5061,8 @@ struct graph_parser {
   // Road class assignment needs to be set to the highway cutoff for ferries and auto trains.
   RoadClass highway_cutoff_rc_;
 
-  // Lua Tag Transformation class
-  LuaTagTransform lua_;
+  // Tag Transformation class, either running lua or the native port of graph.lua
+  std::unique_ptr<TagTransform> lua_;
 
   // Pointer to all the OSM data (for use by callbacks)
   OSMData& osmdata_;
@@ -5180,8 +5184,8 @@ OSMData PBFGraphParser::ParseWays(const boost::property_tree::ptree& pt,
     lua_pool.reserve(lua_concurrency);
     for (size_t i = 0; i < lua_concurrency; ++i) {
       lua_pool.emplace_back(std::thread([&lua_script, &buffer_queue] {
-        LuaTagTransform lua(lua_script);
-        const Tags empty_way_tags = lua.Transform(OSMType::kWay, 0, {});
+        auto lua = TagTransform::Create(lua_script);
+        const Tags empty_way_tags = lua->Transform(OSMType::kWay, 0, {});
 
         while (true) {
           std::pair<osmium::memory::Buffer, std::promise<Ways>> buffer_promise;
@@ -5192,7 +5196,7 @@ OSMData PBFGraphParser::ParseWays(const boost::property_tree::ptree& pt,
 
           Ways transformed;
           for (const osmium::memory::Item& item : buffer_promise.first) {
-            graph_parser::transform_way(static_cast<const osmium::Way&>(item), lua, empty_way_tags,
+            graph_parser::transform_way(static_cast<const osmium::Way&>(item), *lua, empty_way_tags,
                                         transformed);
           }
           buffer_promise.second.set_value(std::move(transformed));
@@ -5355,14 +5359,21 @@ void PBFGraphParser::ParseNodes(const boost::property_tree::ptree& pt,
   }
   parser.reset(nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr);
 
+  // the way nodes can be far larger than memory, those can be sorted externally within a budget
+  const size_t sort_memory_budget =
+      pt.get<size_t>("data_processing.sort_memory_budget_mb", 0) * 1024 * 1024;
+  const unsigned int sort_concurrency =
+      std::max(1u, pt.get<unsigned int>("concurrency", std::thread::hardware_concurrency()));
+
   // we need to sort the refs so that we can easily (sequentially) update them
   // during node processing, we use memory mapping here because otherwise we aren't
   // using much mem, the scoping makes sure to let it go when done sorting
   LOG_INFO("Sorting osm way node references by node id...");
   {
     sequence<OSMWayNode> way_nodes(way_nodes_file, false);
-    way_nodes.sort(
-        [](const OSMWayNode& a, const OSMWayNode& b) { return a.node.osmid_ < b.node.osmid_; });
+    way_nodes.external_sort(
+        [](const OSMWayNode& a, const OSMWayNode& b) { return a.node.osmid_ < b.node.osmid_; },
+        sort_memory_budget, sort_concurrency);
   }
 
   // Parse node in all the input files. Skip any that are not marked from
@@ -5394,13 +5405,15 @@ void PBFGraphParser::ParseNodes(const boost::property_tree::ptree& pt,
   LOG_INFO("Sorting osm way node references by way index and node shape index...");
   {
     sequence<OSMWayNode> way_nodes(way_nodes_file, false);
-    way_nodes.sort([](const OSMWayNode& a, const OSMWayNode& b) {
-      if (a.way_index == b.way_index) {
-        // TODO: if its equal we have screwed something up, should we check and throw here?
-        return a.way_shape_node_index < b.way_shape_node_index;
-      }
-      return a.way_index < b.way_index;
-    });
+    way_nodes.external_sort(
+        [](const OSMWayNode& a, const OSMWayNode& b) {
+          if (a.way_index == b.way_index) {
+            // TODO: if its equal we have screwed something up, should we check and throw here?
+            return a.way_shape_node_index < b.way_shape_node_index;
+          }
+          return a.way_index < b.way_index;
+        },
+        sort_memory_budget, sort_concurrency);
   }
 
   // Some OSM extracts do not have changeset Ids. For these set the max changeset Id
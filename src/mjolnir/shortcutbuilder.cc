@@ -17,7 +17,14 @@
 #include <boost/format.hpp>
 #endif
 
+#include <algorithm>
+#include <deque>
+#include <future>
+#include <list>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <thread>
 #include <tuple>
 #include <utility>
 #include <vector>
@@ -600,161 +607,221 @@ std::pair<uint32_t, uint32_t> AddShortcutEdges(GraphReader& reader,
   return {shortcut_count, total_edge_count};
 }
 
-// Form shortcuts for tiles in this level.
-// Returns {shortcut_count, total_edge_count, exceeded_max_count}.
-std::tuple<uint32_t, uint32_t, uint32_t> FormShortcuts(GraphReader& reader, const TileLevel& level) {
-  // Iterate through the tiles at this level (TODO - can we mark the tiles
-  // the tiles that shortcuts end within?)
-  reader.Clear();
-  bool added = false;
-  uint32_t shortcut_count = 0;
-  uint32_t total_edge_count = 0;
-  uint32_t exceeded_max_count = 0;
-  uint32_t ntiles = level.tiles.TileCount();
-  uint32_t tile_level = (uint32_t)level.level;
-  graph_tile_ptr tile;
-  for (uint32_t tileid = 0; tileid < ntiles; tileid++) {
-    // Get the graph tile. Skip if no tile exists (common case)
-    tile = reader.GetGraphTile(GraphId(tileid, tile_level, 0));
-    if (!tile) {
-      continue;
-    }
-
-    // Create GraphTileBuilder for the new tile
-    GraphId new_tile(tileid, tile_level, 0);
-    GraphTileBuilder tilebuilder(reader.tile_dir(), new_tile, false);
-
-    // Since the old tile is not serialized we must copy any data that is not
-    // dependent on edge Id into the new builders (e.g., node transitions)
-    if (tile->header()->transitioncount() > 0) {
-      for (uint32_t i = 0; i < tile->header()->transitioncount(); ++i) {
-        tilebuilder.transitions().emplace_back(std::move(*(tile->transition(i))));
+using shortcut_stats_t = std::tuple<uint32_t, uint32_t, uint32_t>;
+
+// Form shortcuts for the tiles in the queue. Each thread has its own reader and rewrites one tile
+// at a time. Walking a shortcut may read a neighbouring tile that another thread has already
+// rewritten, which is the same situation as when the cache is trimmed in a single thread: only
+// the base edges are considered (see CanContract) so the result doesn't depend on tile order.
+// Fills the promise with {shortcut_count, total_edge_count, exceeded_max_count}, or with the
+// exception if one was thrown so that it reaches the caller instead of terminating the build.
+void FormShortcutsInTiles(const boost::property_tree::ptree& pt,
+                          std::deque<GraphId>& tilequeue,
+                          std::mutex& lock,
+                          std::promise<shortcut_stats_t>& result) {
+  try {
+    GraphReader reader(pt);
+    bool added = false;
+    uint32_t shortcut_count = 0;
+    uint32_t total_edge_count = 0;
+    uint32_t exceeded_max_count = 0;
+    graph_tile_ptr tile;
+    while (true) {
+      // Get the next tile Id
+      lock.lock();
+      if (tilequeue.empty()) {
+        lock.unlock();
+        break;
       }
-    }
+      GraphId new_tile = tilequeue.front();
+      tilequeue.pop_front();
+      lock.unlock();
 
-    // Iterate through the nodes in the tile
-    GraphId node_id(tileid, tile_level, 0);
-    for (uint32_t n = 0; n < tile->header()->nodecount(); n++, ++node_id) {
-      // Get the node info, copy node index and count from old tile
-      NodeInfo nodeinfo = *(tile->node(node_id));
-      uint32_t old_edge_index = nodeinfo.edge_index();
-      uint32_t old_edge_count = nodeinfo.edge_count();
-
-      // Update node information
-      const auto& admin = tile->admininfo(nodeinfo.admin_index());
-      nodeinfo.set_edge_index(tilebuilder.directededges().size());
-      nodeinfo.set_admin_index(tilebuilder.AddAdmin(admin.country_text(), admin.state_text(),
-                                                    admin.country_iso(), admin.state_iso()));
-
-      // Current edge count
-      size_t edge_count = tilebuilder.directededges().size();
-
-      // Add shortcut edges first.
-      std::unordered_map<uint32_t, uint32_t> shortcuts;
-      auto stats = AddShortcutEdges(reader, tile, tilebuilder, node_id, old_edge_index,
-                                    old_edge_count, shortcuts);
-      shortcut_count += stats.first;
-      total_edge_count += stats.second;
-      if (stats.first > kMaxShortcutsFromNode) {
-        ++exceeded_max_count;
+      // Get the graph tile. Skip if no tile exists
+      tile = reader.GetGraphTile(new_tile);
+      if (!tile) {
+        continue;
       }
+      uint32_t tileid = new_tile.tileid();
+      uint32_t tile_level = new_tile.level();
 
-      // Copy the rest of the directed edges from this node
-      GraphId edgeid(tileid, tile_level, old_edge_index);
-      for (uint32_t i = 0; i < old_edge_count; i++, ++edgeid) {
-        // Copy the directed edge information and update end node,
-        // edge data offset, and opp_index
-        const DirectedEdge* directededge = tile->directededge(edgeid);
-        DirectedEdge newedge = *directededge;
-
-        // Get signs from the base directed edge
-        if (directededge->sign()) {
-          std::vector<SignInfo> signs = tile->GetSigns(edgeid.id());
-          if (signs.size() == 0) {
-            LOG_ERROR("Base edge should have signs, but none found");
-          }
-          tilebuilder.AddSigns(tilebuilder.directededges().size(), signs);
+      // Create GraphTileBuilder for the new tile
+      GraphTileBuilder tilebuilder(reader.tile_dir(), new_tile, false);
+
+      // Since the old tile is not serialized we must copy any data that is not
+      // dependent on edge Id into the new builders (e.g., node transitions)
+      if (tile->header()->transitioncount() > 0) {
+        for (uint32_t i = 0; i < tile->header()->transitioncount(); ++i) {
+          tilebuilder.transitions().emplace_back(std::move(*(tile->transition(i))));
         }
+      }
 
-        // Get turn lanes from the base directed edge
-        if (directededge->turnlanes()) {
-          uint32_t offset = tile->turnlanes_offset(edgeid.id());
-          tilebuilder.AddTurnLanes(tilebuilder.directededges().size(), tile->GetName(offset));
+      // Iterate through the nodes in the tile
+      GraphId node_id(tileid, tile_level, 0);
+      for (uint32_t n = 0; n < tile->header()->nodecount(); n++, ++node_id) {
+        // Get the node info, copy node index and count from old tile
+        NodeInfo nodeinfo = *(tile->node(node_id));
+        uint32_t old_edge_index = nodeinfo.edge_index();
+        uint32_t old_edge_count = nodeinfo.edge_count();
+
+        // Update node information
+        const auto& admin = tile->admininfo(nodeinfo.admin_index());
+        nodeinfo.set_edge_index(tilebuilder.directededges().size());
+        nodeinfo.set_admin_index(tilebuilder.AddAdmin(admin.country_text(), admin.state_text(),
+                                                      admin.country_iso(), admin.state_iso()));
+
+        // Current edge count
+        size_t edge_count = tilebuilder.directededges().size();
+
+        // Add shortcut edges first.
+        std::unordered_map<uint32_t, uint32_t> shortcuts;
+        auto stats = AddShortcutEdges(reader, tile, tilebuilder, node_id, old_edge_index,
+                                      old_edge_count, shortcuts);
+        shortcut_count += stats.first;
+        total_edge_count += stats.second;
+        if (stats.first > kMaxShortcutsFromNode) {
+          ++exceeded_max_count;
         }
 
-        // Get access restrictions from the base directed edge. Add these to
-        // the list of access restrictions in the new tile. Update the
-        // edge index in the restriction to be the current directed edge Id
-        if (directededge->access_restriction()) {
-          auto restrictions = tile->GetAccessRestrictions(edgeid.id()).first;
-          for (const auto& res : restrictions) {
-            tilebuilder.AddAccessRestriction(AccessRestriction(tilebuilder.directededges().size(),
-                                                               res.type(), res.modes(), res.value(),
-                                                               res.except_destination()));
+        // Copy the rest of the directed edges from this node
+        GraphId edgeid(tileid, tile_level, old_edge_index);
+        for (uint32_t i = 0; i < old_edge_count; i++, ++edgeid) {
+          // Copy the directed edge information and update end node,
+          // edge data offset, and opp_index
+          const DirectedEdge* directededge = tile->directededge(edgeid);
+          DirectedEdge newedge = *directededge;
+
+          // Get signs from the base directed edge
+          if (directededge->sign()) {
+            std::vector<SignInfo> signs = tile->GetSigns(edgeid.id());
+            if (signs.size() == 0) {
+              LOG_ERROR("Base edge should have signs, but none found");
+            }
+            tilebuilder.AddSigns(tilebuilder.directededges().size(), signs);
           }
-        }
 
-        // Copy lane connectivity
-        if (directededge->laneconnectivity()) {
-          tilebuilder.CopyLaneConnectivityFromTile(tile, edgeid.id());
-        }
+          // Get turn lanes from the base directed edge
+          if (directededge->turnlanes()) {
+            uint32_t offset = tile->turnlanes_offset(edgeid.id());
+            tilebuilder.AddTurnLanes(tilebuilder.directededges().size(), tile->GetName(offset));
+          }
 
-        // Names can be different in the forward and backward direction
-        bool diff_names = tilebuilder.OpposingEdgeInfoDiffers(tile, directededge);
-
-        // Get edge info, shape, and names from the old tile and add
-        // to the new. Use prior edgeinfo offset as the key to make sure
-        // edges that have the same end nodes are differentiated (this
-        // should be a valid key since tile sizes aren't changed)
-        auto edgeinfo = tile->edgeinfo(directededge);
-        uint32_t edge_info_offset =
-            tilebuilder.AddEdgeInfo(directededge->edgeinfo_offset(), node_id, directededge->endnode(),
-                                    edgeinfo.wayid(), edgeinfo.mean_elevation(),
-                                    edgeinfo.bike_network(), edgeinfo.speed_limit(),
-                                    edgeinfo.encoded_shape(), edgeinfo.GetNames(),
-                                    edgeinfo.GetTaggedValues(), edgeinfo.GetLinguisticTaggedValues(),
-                                    edgeinfo.GetTypes(), added, diff_names);
-
-        newedge.set_edgeinfo_offset(edge_info_offset);
-
-        // Set the superseded mask - this is the shortcut mask that supersedes this edge
-        // (outbound from the node). Do not set (keep as 0) if maximum number of shortcuts
-        // from a node has been exceeded.
-        auto s = shortcuts.find(i);
-        uint32_t superseded_idx = (s != shortcuts.end()) ? s->second : 0;
-        if (superseded_idx <= kMaxShortcutsFromNode) {
-          newedge.set_superseded(superseded_idx);
-        }
+          // Get access restrictions from the base directed edge. Add these to
+          // the list of access restrictions in the new tile. Update the
+          // edge index in the restriction to be the current directed edge Id
+          if (directededge->access_restriction()) {
+            auto restrictions = tile->GetAccessRestrictions(edgeid.id()).first;
+            for (const auto& res : restrictions) {
+              tilebuilder.AddAccessRestriction(AccessRestriction(tilebuilder.directededges().size(),
+                                                                 res.type(), res.modes(), res.value(),
+                                                                 res.except_destination()));
+            }
+          }
 
-        // Add directed edge
-        tilebuilder.directededges().emplace_back(std::move(newedge));
-      }
+          // Copy lane connectivity
+          if (directededge->laneconnectivity()) {
+            tilebuilder.CopyLaneConnectivityFromTile(tile, edgeid.id());
+          }
 
-      // Set the edge count for the new node
-      nodeinfo.set_edge_count(tilebuilder.directededges().size() - edge_count);
+          // Names can be different in the forward and backward direction
+          bool diff_names = tilebuilder.OpposingEdgeInfoDiffers(tile, directededge);
+
+          // Get edge info, shape, and names from the old tile and add
+          // to the new. Use prior edgeinfo offset as the key to make sure
+          // edges that have the same end nodes are differentiated (this
+          // should be a valid key since tile sizes aren't changed)
+          auto edgeinfo = tile->edgeinfo(directededge);
+          uint32_t edge_info_offset =
+              tilebuilder.AddEdgeInfo(directededge->edgeinfo_offset(), node_id,
+                                      directededge->endnode(), edgeinfo.wayid(),
+                                      edgeinfo.mean_elevation(), edgeinfo.bike_network(),
+                                      edgeinfo.speed_limit(), edgeinfo.encoded_shape(),
+                                      edgeinfo.GetNames(), edgeinfo.GetTaggedValues(),
+                                      edgeinfo.GetLinguisticTaggedValues(), edgeinfo.GetTypes(),
+                                      added, diff_names);
+
+          newedge.set_edgeinfo_offset(edge_info_offset);
+
+          // Set the superseded mask - this is the shortcut mask that supersedes this edge
+          // (outbound from the node). Do not set (keep as 0) if maximum number of shortcuts
+          // from a node has been exceeded.
+          auto s = shortcuts.find(i);
+          uint32_t superseded_idx = (s != shortcuts.end()) ? s->second : 0;
+          if (superseded_idx <= kMaxShortcutsFromNode) {
+            newedge.set_superseded(superseded_idx);
+          }
+
+          // Add directed edge
+          tilebuilder.directededges().emplace_back(std::move(newedge));
+        }
 
-      // Get named signs from the base node
-      if (nodeinfo.named_intersection()) {
+        // Set the edge count for the new node
+        nodeinfo.set_edge_count(tilebuilder.directededges().size() - edge_count);
 
-        std::vector<SignInfo> signs = tile->GetSigns(n, true);
-        if (signs.size() == 0) {
-          LOG_ERROR("Base node should have signs, but none found");
+        // Get named signs from the base node
+        if (nodeinfo.named_intersection()) {
+
+          std::vector<SignInfo> signs = tile->GetSigns(n, true);
+          if (signs.size() == 0) {
+            LOG_ERROR("Base node should have signs, but none found");
+          }
+          tilebuilder.AddSigns(tilebuilder.nodes().size(), signs);
         }
-        tilebuilder.AddSigns(tilebuilder.nodes().size(), signs);
+        tilebuilder.nodes().emplace_back(std::move(nodeinfo));
       }
-      tilebuilder.nodes().emplace_back(std::move(nodeinfo));
-    }
 
-    // Store the new tile
-    tilebuilder.StoreTileData();
-    LOG_DEBUG((boost::format("ShortcutBuilder created tile %1%: %2% bytes") % tile %
-               tilebuilder.header_builder().end_offset())
-                  .str());
+      // Store the new tile
+      tilebuilder.StoreTileData();
+      LOG_DEBUG((boost::format("ShortcutBuilder created tile %1%: %2% bytes") % tile %
+                 tilebuilder.header_builder().end_offset())
+                    .str());
 
-    // Check if we need to clear the tile cache.
-    if (reader.OverCommitted()) {
-      reader.Trim();
+      // Check if we need to clear the tile cache.
+      if (reader.OverCommitted()) {
+        reader.Trim();
+      }
     }
+    result.set_value({shortcut_count, total_edge_count, exceeded_max_count});
+  } catch (...) {
+    result.set_exception(std::current_exception());
+  }
+}
+
+// Form shortcuts for tiles in this level using the given number of threads.
+// Returns {shortcut_count, total_edge_count, exceeded_max_count}.
+shortcut_stats_t FormShortcuts(const boost::property_tree::ptree& pt,
+                               GraphReader& reader,
+                               const TileLevel& level,
+                               unsigned int concurrency) {
+  // Queue up the tiles at this level in a fixed order
+  auto tileset = reader.GetTileSet(level.level);
+  std::deque<GraphId> tilequeue(tileset.begin(), tileset.end());
+  std::sort(tilequeue.begin(), tilequeue.end());
+  std::mutex lock;
+
+  // Spawn the threads and wait for them to finish
+  std::vector<std::shared_ptr<std::thread>> threads(
+      std::max(1u, std::min(concurrency, static_cast<unsigned int>(tilequeue.size()))));
+  std::list<std::promise<shortcut_stats_t>> results;
+  for (auto& thread : threads) {
+    results.emplace_back();
+    thread = std::make_shared<std::thread>(FormShortcutsInTiles, std::cref(pt),
+                                           std::ref(tilequeue), std::ref(lock),
+                                           std::ref(results.back()));
+  }
+  for (auto& thread : threads) {
+    thread->join();
+  }
+
+  // Total up the stats from each thread
+  uint32_t shortcut_count = 0;
+  uint32_t total_edge_count = 0;
+  uint32_t exceeded_max_count = 0;
+  for (auto& result : results) {
+    auto [sc_count, edge_count, exceeded_max] = result.get_future().get();
+    shortcut_count += sc_count;
+    total_edge_count += edge_count;
+    exceeded_max_count += exceeded_max;
   }
   return {shortcut_count, total_edge_count, exceeded_max_count};
 }
@@ -768,14 +835,12 @@ namespace mjolnir {
 // only connect to 2 edges on the hierarchy level, and have compatible
 // attributes. Shortcut edges are inserted before regular edges.
 void ShortcutBuilder::Build(const boost::property_tree::ptree& pt) {
-
-  // TODO: thread this. would need to make sure we dont make shortcuts
-  // across tile boundaries so that we are only messing with one tile
-  // in one thread at a time
-
   SCOPED_TIMER();
   // Get GraphReader
   GraphReader reader(pt.get_child("mjolnir"));
+  unsigned int concurrency = std::max(static_cast<unsigned int>(1),
+                                      pt.get<unsigned int>("mjolnir.concurrency",
+                                                           std::thread::hardware_concurrency()));
 
   uint32_t total_exceeded_max = 0;
   auto tile_level = TileHierarchy::levels().rbegin();
@@ -783,7 +848,8 @@ void ShortcutBuilder::Build(const boost::property_tree::ptree& pt) {
   for (; tile_level != TileHierarchy::levels().rend(); ++tile_level) {
     // Create shortcuts on this level
     LOG_INFO("Creating shortcuts on level " + std::to_string(tile_level->level));
-    auto [sc_count, edge_count, exceeded_max] = FormShortcuts(reader, *tile_level);
+    auto [sc_count, edge_count, exceeded_max] =
+        FormShortcuts(pt.get_child("mjolnir"), reader, *tile_level, concurrency);
     [[maybe_unused]] uint32_t avg = sc_count ? (edge_count / sc_count) : 0;
     LOG_INFO("Finished with " + std::to_string(sc_count) + " shortcuts superseding " +
              std::to_string(edge_count) + " edges, average ~" + std::to_string(avg) +
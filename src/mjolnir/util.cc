@@ -12,6 +12,9 @@
 #include "mjolnir/graphfilter.h"
 #include "mjolnir/graphvalidator.h"
 #include "mjolnir/hierarchybuilder.h"
+#include "mjolnir/node_expander.h"
+#include "mjolnir/osmaccess.h"
+#include "mjolnir/packed_file.h"
 #include "mjolnir/pbfgraphparser.h"
 #include "mjolnir/restrictionbuilder.h"
 #include "mjolnir/shortcutbuilder.h"
@@ -49,6 +52,14 @@ const std::string cr_to_file = "complex_to_restrictions.bin";
 const std::string new_to_old_file = "new_nodes_to_old_nodes.bin";
 const std::string old_to_new_file = "old_nodes_to_new_nodes.bin";
 
+// A temporary file along with the stage which writes it and the stages which read it afterwards
+struct intermediate_file_t {
+  std::string name;
+  uint32_t record_size;
+  BuildStage writer;
+  std::vector<BuildStage> readers;
+};
+
 uint64_t get_pbf_checksum(std::vector<std::string> paths, const std::string& tile_dir) {
   std::sort(paths.begin(), paths.end());
 
@@ -680,11 +691,6 @@ bool build_tile_set(const boost::property_tree::ptree& original_config,
     std::filesystem::create_directories(tile_dir);
   }
 
-  // Snapshot for per-stage delta reporting
-  auto log_stage = [&config](BuildStage stage) { build_stats::get().log_stage(stage, config); };
-  // nothing to report, but logic only works correctly if every stage is logged
-  log_stage(BuildStage::kInitialize);
-
   // Set up the temporary (*.bin) files used during processing
   std::string ways_bin = tile_dir + ways_file;
   std::string way_nodes_bin = tile_dir + way_nodes_file;
@@ -699,6 +705,87 @@ bool build_tile_set(const boost::property_tree::ptree& original_config,
   std::string new_to_old_bin = tile_dir + new_to_old_file;
   std::string old_to_new_bin = tile_dir + old_to_new_file;
 
+  // The temporary files can be compressed while they are idle, which keeps the disk footprint of
+  // large builds down. The stages still work on the raw files so they are unpacked before use
+  auto compression = compression_from_string(
+      config.get<std::string>("mjolnir.data_processing.intermediate_compression", "none"));
+  const std::vector<intermediate_file_t> intermediates{
+      {ways_bin,
+       sizeof(OSMWay),
+       BuildStage::kParseWays,
+       {BuildStage::kConstructEdges, BuildStage::kBuild}},
+      {way_nodes_bin,
+       sizeof(OSMWayNode),
+       BuildStage::kParseWays,
+       {BuildStage::kParseNodes, BuildStage::kConstructEdges, BuildStage::kBuild}},
+      {nodes_bin, sizeof(Node), BuildStage::kConstructEdges, {BuildStage::kBuild}},
+      {edges_bin, sizeof(Edge), BuildStage::kConstructEdges, {BuildStage::kBuild}},
+      {access_bin, sizeof(OSMAccess), BuildStage::kParseWays, {BuildStage::kEnhance}},
+      {bss_nodes_bin, sizeof(OSMBSSNode), BuildStage::kParseNodes, {BuildStage::kBss}},
+      {linguistic_node_bin,
+       sizeof(OSMNodeLinguistic),
+       BuildStage::kParseNodes,
+       {BuildStage::kBuild}},
+      {cr_from_bin,
+       sizeof(OSMRestriction),
+       BuildStage::kParseRelations,
+       {BuildStage::kBuild, BuildStage::kRestrictions}},
+      {cr_to_bin,
+       sizeof(OSMRestriction),
+       BuildStage::kParseRelations,
+       {BuildStage::kBuild, BuildStage::kRestrictions}},
+  };
+
+  // Compress the files which none of the next few stages to run reads, packing the others would
+  // only have them unpacked again right away. Files which are about to be rewritten, or which
+  // nobody reads anymore before the cleanup removes them, are left alone
+  constexpr int kPackLookahead = 3;
+  auto pack_idle = [&](BuildStage stage) {
+    if (compression == Compression::kNone) {
+      return;
+    }
+    // a resumed build skips straight to its start stage
+    const int next = std::max(static_cast<int>(stage) + 1, static_cast<int>(start_stage));
+    for (const auto& file : intermediates) {
+      if (!std::filesystem::exists(file.name) ||
+          (stage < file.writer && start_stage <= file.writer && file.writer <= end_stage)) {
+        continue;
+      }
+      auto reader = std::find_if(file.readers.begin(), file.readers.end(), [&](BuildStage r) {
+        return next <= static_cast<int>(r) && r <= end_stage;
+      });
+      if (reader != file.readers.end() ? static_cast<int>(*reader) - next < kPackLookahead
+                                       : BuildStage::kCleanup <= end_stage) {
+        continue;
+      }
+      auto raw_size = std::filesystem::file_size(file.name);
+      auto packed_size = pack(file.name, compression, file.record_size);
+      LOG_INFO("Compressed " + file.name + " from " + std::to_string(raw_size) + " to " +
+               std::to_string(packed_size) + " bytes");
+    }
+  };
+
+  // Decompress the files the stage is about to read
+  auto unpack_for = [&](BuildStage stage) {
+    for (const auto& file : intermediates) {
+      if (std::find(file.readers.begin(), file.readers.end(), stage) == file.readers.end() ||
+          std::filesystem::exists(file.name) ||
+          !std::filesystem::exists(file.name + kPackedSuffix)) {
+        continue;
+      }
+      unpack(file.name);
+      LOG_INFO("Decompressed " + file.name);
+    }
+  };
+
+  // Snapshot for per-stage delta reporting, the packing counts towards the stage before it
+  auto log_stage = [&config, &pack_idle](BuildStage stage) {
+    pack_idle(stage);
+    build_stats::get().log_stage(stage, config);
+  };
+  // nothing to report, but logic only works correctly if every stage is logged
+  log_stage(BuildStage::kInitialize);
+
   // OSMData class
   OSMData osm_data{0};
 
@@ -735,6 +822,7 @@ bool build_tile_set(const boost::property_tree::ptree& original_config,
   if (start_stage <= BuildStage::kParseNodes && BuildStage::kParseNodes <= end_stage) {
     // Read the OSM protocol buffer file. Callbacks for nodes
     // are defined within the PBFParser class
+    unpack_for(BuildStage::kParseNodes);
     PBFGraphParser::ParseNodes(config.get_child("mjolnir"), input_files, way_nodes_bin, bss_nodes_bin,
                                linguistic_node_bin, osm_data);
 
@@ -753,6 +841,7 @@ bool build_tile_set(const boost::property_tree::ptree& original_config,
     if (start_stage == BuildStage::kConstructEdges)
       osm_data.read_from_temp_files(tile_dir);
 
+    unpack_for(BuildStage::kConstructEdges);
     tiles = GraphBuilder::BuildEdges(config, ways_bin, way_nodes_bin, nodes_bin, edges_bin);
     // Output manifest
     TileManifest manifest{tiles};
@@ -762,6 +851,7 @@ bool build_tile_set(const boost::property_tree::ptree& original_config,
 
   // Build Valhalla routing tiles
   if (start_stage <= BuildStage::kBuild && BuildStage::kBuild <= end_stage) {
+    unpack_for(BuildStage::kBuild);
     if (start_stage == BuildStage::kBuild) {
       // Read OSMData from files if building tiles is the first stage
       osm_data.read_from_temp_files(tile_dir);
@@ -789,6 +879,7 @@ bool build_tile_set(const boost::property_tree::ptree& original_config,
     if (start_stage == BuildStage::kEnhance) {
       osm_data.read_from_unique_names_file(tile_dir);
     }
+    unpack_for(BuildStage::kEnhance);
     GraphEnhancer::Enhance(config, osm_data, access_bin);
     log_stage(BuildStage::kEnhance);
   }
@@ -810,6 +901,7 @@ bool build_tile_set(const boost::property_tree::ptree& original_config,
     if (start_stage == BuildStage::kBss) {
       osm_data.read_from_unique_names_file(tile_dir);
     }
+    unpack_for(BuildStage::kBss);
     BssBuilder::Build(config, osm_data, bss_nodes_bin);
     log_stage(BuildStage::kBss);
   }
@@ -849,6 +941,7 @@ bool build_tile_set(const boost::property_tree::ptree& original_config,
   // elevation into the tiles reads each tile and serializes the data to "builders"
   // within the tile. However, there is no serialization currently available for complex restrictions.
   if (start_stage <= BuildStage::kRestrictions && BuildStage::kRestrictions <= end_stage) {
+    unpack_for(BuildStage::kRestrictions);
     RestrictionBuilder::Build(config, cr_from_bin, cr_to_bin);
     log_stage(BuildStage::kRestrictions);
   }
@@ -874,6 +967,9 @@ bool build_tile_set(const boost::property_tree::ptree& original_config,
     remove_temp_file(new_to_old_bin);
     remove_temp_file(old_to_new_bin);
     remove_temp_file(tile_manifest);
+    for (const auto& file : intermediates) {
+      remove_temp_file(file.name + kPackedSuffix);
+    }
     OSMData::cleanup_temp_files(tile_dir);
     log_stage(BuildStage::kCleanup);
   }
@@ -0,0 +1,107 @@
+#include "benchmark_utils.h"
+#include "midgard/logging.h"
+#include "mjolnir/packed_file.h"
+
+#include <boost/property_tree/ptree.hpp>
+#include <cxxopts.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+using namespace valhalla::mjolnir;
+
+namespace {
+
+struct result_t {
+  uint64_t raw_bytes = 0;
+  uint64_t packed_bytes = 0;
+  double pack_secs = 0;
+  double unpack_secs = 0;
+};
+
+// packs and unpacks a copy of the file the same way the build does between its stages
+result_t benchmark(const std::filesystem::path& file, Compression compression) {
+  const auto copy = file.string() + ".benchmark";
+  std::filesystem::copy_file(file, copy, std::filesystem::copy_options::overwrite_existing);
+
+  result_t result;
+  result.raw_bytes = std::filesystem::file_size(copy);
+  auto start = std::chrono::steady_clock::now();
+  // the record size only matters for its validation, a byte at a time works for any file
+  result.packed_bytes = pack(copy, compression);
+  result.pack_secs = seconds_since(start);
+  start = std::chrono::steady_clock::now();
+  unpack(copy);
+  result.unpack_secs = seconds_since(start);
+
+  std::filesystem::remove(copy);
+  return result;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  const auto program = std::filesystem::path(__FILE__).stem().string();
+  // args
+  boost::property_tree::ptree config;
+
+  // clang-format off
+  cxxopts::Options options(
+    program,
+    program + " " + VALHALLA_PRINT_VERSION + "\n\n"
+    "valhalla_benchmark_sequences is a program to time and size the compression of the\n"
+    "intermediate *.bin files of a tile build, as done for mjolnir.data_processing.\n"
+    "intermediate_compression. Every file is packed and unpacked the way the build does it\n"
+    "between its stages and the wall time of both is reported. Run valhalla_build_tiles\n"
+    "with an end stage before cleanup to keep the files in the tile_dir, then run this\n"
+    "against the same config.\n");
+  add_benchmark_options(options, true);
+  // clang-format on
+
+  if (auto exit_code = parse_benchmark_args(program, options, argc, argv, &config))
+    return *exit_code;
+
+  std::filesystem::path tile_dir = config.get<std::string>("mjolnir.tile_dir");
+  std::vector<std::filesystem::path> files;
+  for (const auto& entry : std::filesystem::directory_iterator(tile_dir)) {
+    if (entry.is_regular_file() && entry.path().extension() == ".bin") {
+      files.push_back(entry.path());
+    }
+  }
+  std::sort(files.begin(), files.end());
+  if (files.empty()) {
+    LOG_ERROR("No intermediate *.bin files found in " + tile_dir.string());
+    return EXIT_FAILURE;
+  }
+
+  const std::vector<std::string> codecs{"none", "lz4", "zlib"};
+  std::vector<result_t> totals(codecs.size());
+  const table_t table({{"file", 36}, {"codec", 6}, {"raw bytes", 16}, {"packed bytes", 16},
+                       {"ratio", 8}, {"pack s", 10}, {"unpack s", 10}});
+  auto row = [&table](const std::string& name, const std::string& codec, const result_t& r) {
+    table.row(name, codec, r.raw_bytes, r.packed_bytes,
+              static_cast<double>(r.packed_bytes) / std::max<uint64_t>(r.raw_bytes, 1), r.pack_secs,
+              r.unpack_secs);
+  };
+
+  table.header();
+  for (const auto& file : files) {
+    for (size_t i = 0; i < codecs.size(); ++i) {
+      auto result = benchmark(file, compression_from_string(codecs[i]));
+      row(file.filename().string(), codecs[i], result);
+      totals[i].raw_bytes += result.raw_bytes;
+      totals[i].packed_bytes += result.packed_bytes;
+      totals[i].pack_secs += result.pack_secs;
+      totals[i].unpack_secs += result.unpack_secs;
+    }
+  }
+  for (size_t i = 0; i < codecs.size(); ++i) {
+    row("total", codecs[i], totals[i]);
+  }
+
+  return EXIT_SUCCESS;
+}
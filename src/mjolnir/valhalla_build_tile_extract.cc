@@ -0,0 +1,87 @@
+#include "argparse_utils.h"
+#include "midgard/aabb2.h"
+#include "midgard/pointll.h"
+#include "mjolnir/extractbuilder.h"
+
+#include <boost/algorithm/string.hpp>
+#include <cxxopts.hpp>
+
+#include <filesystem>
+#include <optional>
+
+using namespace valhalla::midgard;
+
+int main(int argc, char** argv) {
+  const auto program = std::filesystem::path(__FILE__).stem().string();
+  // args
+  boost::property_tree::ptree config;
+  std::string extract;
+  bool overwrite = false;
+  bool with_traffic = false;
+  std::optional<AABB2<PointLL>> bbox;
+
+  try {
+    // clang-format off
+    cxxopts::Options options(
+      program,
+      program + " " + VALHALLA_PRINT_VERSION + "\n\n"
+      "valhalla_build_tile_extract is a program that packs the graph tiles in mjolnir.tile_dir \n"
+      "into a tar extract which can be memory mapped via mjolnir.tile_extract. The extract \n"
+      "starts with an index of the tiles, the tiles of each level are ordered along a Hilbert \n"
+      "curve and each tile starts on a page boundary."
+      "\n\n");
+
+    options.add_options()
+      ("h,help", "Print this help message.")
+      ("v,version", "Print the version of this software.")
+      ("c,config", "Path to the json configuration file.", cxxopts::value<std::string>())
+      ("i,inline-config", "Inline JSON config", cxxopts::value<std::string>())
+      ("j,concurrency", "Number of threads to use. Defaults to all threads.", cxxopts::value<uint32_t>())
+      ("e,extract-tar", "Where to write the extract. Defaults to mjolnir.tile_extract.", cxxopts::value<std::string>(extract))
+      ("O,overwrite", "Overwrite an existing extract.", cxxopts::value<bool>(overwrite))
+      ("t,with-traffic", "Also write an empty traffic extract to mjolnir.traffic_extract.", cxxopts::value<bool>(with_traffic))
+      ("b,bbox", "Only pack the tiles intersecting this bounding box: min_x,min_y,max_x,max_y", cxxopts::value<std::string>());
+    // clang-format on
+
+    auto result = options.parse(argc, argv);
+    if (!parse_common_args(program, options, result, &config, true))
+      return EXIT_SUCCESS;
+
+    if (result.count("bbox")) {
+      std::vector<std::string> coords;
+      boost::algorithm::split(coords, result["bbox"].as<std::string>(),
+                              boost::algorithm::is_any_of(","));
+      if (coords.size() != 4) {
+        throw cxxopts::exceptions::exception("Bounding box must be min_x,min_y,max_x,max_y\n\n" +
+                                             options.help());
+      }
+      bbox.emplace(std::stod(coords[0]), std::stod(coords[1]), std::stod(coords[2]),
+                   std::stod(coords[3]));
+    }
+  } catch (cxxopts::exceptions::exception& e) {
+    std::cerr << e.what() << std::endl;
+    return EXIT_FAILURE;
+  } catch (std::exception& e) {
+    std::cerr << "Unable to parse command line options because: " << e.what() << "\n"
+              << "This is a bug, please report it at " PACKAGE_BUGREPORT << "\n";
+    return EXIT_FAILURE;
+  }
+
+  if (extract.empty()) {
+    extract = config.get<std::string>("mjolnir.tile_extract", "");
+  }
+  if (!overwrite && !extract.empty() && std::filesystem::exists(extract)) {
+    std::cerr << extract << " already exists, use --overwrite to replace it" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  try {
+    valhalla::mjolnir::ExtractBuilder::Build(config.get_child("mjolnir"), extract, with_traffic,
+                                             bbox);
+  } catch (std::exception& e) {
+    std::cerr << e.what() << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
@@ -8,6 +8,12 @@
 #include "proto/directions.pb.h"
 #include "proto/options.pb.h"
 
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <thread>
+#include <vector>
+
 namespace {
 // Minimum edge length to verify heading (~3 feet)
 constexpr auto kMinEdgeLength = 0.001f;
@@ -22,42 +28,92 @@ namespace odin {
 // NarrativeBuilder::Build to form the maneuver list. This method
 // calls PopulateDirectionsLeg to transform the maneuver list into the
 // trip directions.
-void DirectionsBuilder::Build(Api& api, const MarkupFormatter& markup_formatter) {
+void DirectionsBuilder::Build(Api& api,
+                              const MarkupFormatter& markup_formatter,
+                              unsigned int concurrency) {
   const auto& options = api.options();
+
+  // Lay out all of the directions up front so that the output order matches the trip order
+  // and so that no thread ever has to modify the repeated fields themselves
+  std::vector<std::pair<TripLeg*, DirectionsLeg*>> jobs;
   for (auto& trip_route : *api.mutable_trip()->mutable_routes()) {
     auto& directions_route = *api.mutable_directions()->mutable_routes()->Add();
     for (auto& trip_path : *trip_route.mutable_legs()) {
-      auto& trip_directions = *directions_route.mutable_legs()->Add();
+      jobs.emplace_back(&trip_path, directions_route.mutable_legs()->Add());
+    }
+  }
 
-      // Validate trip path node list
-      if (trip_path.node_size() < 1) {
-        throw valhalla_exception_t{210};
-      }
+  // Nothing to parallelize so just do it here
+  concurrency = std::max(1u, std::min(concurrency, static_cast<unsigned int>(jobs.size())));
+  if (concurrency == 1) {
+    for (auto& job : jobs) {
+      BuildLeg(options, markup_formatter, *job.first, *job.second);
+    }
+    return;
+  }
+
+  // Each thread grabs the next leg until there are none left, any exception is kept with its leg
+  std::atomic<size_t> next_job(0);
+  std::vector<std::exception_ptr> errors(jobs.size());
+  auto work = [&]() {
+    for (size_t i = next_job++; i < jobs.size(); i = next_job++) {
+      try {
+        BuildLeg(options, markup_formatter, *jobs[i].first, *jobs[i].second);
+      } catch (...) { errors[i] = std::current_exception(); }
+    }
+  };
+
+  // The calling thread does its share of the work as well
+  std::vector<std::thread> threads;
+  threads.reserve(concurrency - 1);
+  for (unsigned int i = 1; i < concurrency; ++i) {
+    threads.emplace_back(work);
+  }
+  work();
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  // Report the error of the first leg that failed, as the serial version would have
+  for (const auto& error : errors) {
+    if (error) {
+      std::rethrow_exception(error);
+    }
+  }
+}
 
-      // Create an enhanced trip path from the specified trip_path
-      EnhancedTripLeg etp(trip_path);
+// Builds the maneuvers, narrative and directions for a single trip leg.
+void DirectionsBuilder::BuildLeg(const Options& options,
+                                 const MarkupFormatter& markup_formatter,
+                                 TripLeg& trip_path,
+                                 DirectionsLeg& trip_directions) {
+  // Validate trip path node list
+  if (trip_path.node_size() < 1) {
+    throw valhalla_exception_t{210};
+  }
 
-      // Produce maneuvers if desired
-      std::list<Maneuver> maneuvers;
-      if (options.directions_type() != DirectionsType::none) {
-        // Update the heading of ~0 length edges
-        UpdateHeading(&etp);
+  // Create an enhanced trip path from the specified trip_path
+  EnhancedTripLeg etp(trip_path);
 
-        ManeuversBuilder maneuversBuilder(options, &etp);
-        maneuvers = maneuversBuilder.Build();
+  // Produce maneuvers if desired
+  std::list<Maneuver> maneuvers;
+  if (options.directions_type() != DirectionsType::none) {
+    // Update the heading of ~0 length edges
+    UpdateHeading(&etp);
 
-        // Create the instructions if desired
-        if (options.directions_type() == DirectionsType::instructions) {
-          std::unique_ptr<NarrativeBuilder> narrative_builder =
-              NarrativeBuilderFactory::Create(options, &etp, markup_formatter);
-          narrative_builder->Build(maneuvers);
-        }
-      }
+    ManeuversBuilder maneuversBuilder(options, &etp);
+    maneuvers = maneuversBuilder.Build();
 
-      // Return trip directions
-      PopulateDirectionsLeg(options, &etp, maneuvers, trip_directions);
+    // Create the instructions if desired
+    if (options.directions_type() == DirectionsType::instructions) {
+      std::unique_ptr<NarrativeBuilder> narrative_builder =
+          NarrativeBuilderFactory::Create(options, &etp, markup_formatter);
+      narrative_builder->Build(maneuvers);
     }
   }
+
+  // Return trip directions
+  PopulateDirectionsLeg(options, &etp, maneuvers, trip_directions);
 }
 
 // Update the heading of ~0 length edges.
@@ -350,6 +350,12 @@ void NarrativeDictionary::Load(PhraseSet& phrase_handle,
                                const boost::property_tree::ptree& phrase_pt) {
 
   phrase_handle.phrases = as_unordered_map<std::string, std::string>(phrase_pt, kPhrasesKey);
+
+  // Compile the phrases into templates
+  phrase_handle.templates.clear();
+  for (const auto& phrase : phrase_handle.phrases) {
+    phrase_handle.templates.emplace(phrase.first, PhraseTemplate(phrase.second));
+  }
 }
 
 void NarrativeDictionary::Load(StartSubset& start_handle,
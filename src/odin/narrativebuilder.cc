@@ -560,13 +560,13 @@ std::string NarrativeBuilder::FormVerbalAlertApproachInstruction(float distance,
   uint8_t phrase_id = 0;
 
   // Set instruction to the determined tagged phrase
-  instruction = dictionary_.approach_verbal_alert_subset.phrases.at(std::to_string(phrase_id));
+  const auto& phrase =
+      dictionary_.approach_verbal_alert_subset.templates.at(std::to_string(phrase_id));
 
   // Replace phrase tags with values
-  boost::replace_all(instruction, kLengthTag,
-                     FormLength(distance, dictionary_.approach_verbal_alert_subset.metric_lengths,
-                                dictionary_.approach_verbal_alert_subset.us_customary_lengths));
-  boost::replace_all(instruction, kCurrentVerbalCueTag, verbal_cue);
+  std::string length = FormLength(distance, dictionary_.approach_verbal_alert_subset.metric_lengths,
+                                  dictionary_.approach_verbal_alert_subset.us_customary_lengths);
+  phrase.Render(instruction, {{kLengthTag, length}, {kCurrentVerbalCueTag, verbal_cue}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -625,12 +625,12 @@ std::string NarrativeBuilder::FormStartInstruction(Maneuver& maneuver) {
   }
 
   // Set instruction to the determined tagged phrase
-  instruction = dictionary_.start_subset.phrases.at(std::to_string(phrase_id));
+  const auto& phrase = dictionary_.start_subset.templates.at(std::to_string(phrase_id));
 
   // Replace phrase tags with values
-  boost::replace_all(instruction, kCardinalDirectionTag, cardinal_direction);
-  boost::replace_all(instruction, kStreetNamesTag, street_names);
-  boost::replace_all(instruction, kBeginStreetNamesTag, begin_street_names);
+  phrase.Render(instruction, {{kCardinalDirectionTag, cardinal_direction},
+                              {kStreetNamesTag, street_names},
+                              {kBeginStreetNamesTag, begin_street_names}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -712,15 +712,15 @@ std::string NarrativeBuilder::FormVerbalStartInstruction(Maneuver& maneuver,
   }
 
   // Set instruction to the determined tagged phrase
-  instruction = dictionary_.start_verbal_subset.phrases.at(std::to_string(phrase_id));
+  const auto& phrase = dictionary_.start_verbal_subset.templates.at(std::to_string(phrase_id));
 
   // Replace phrase tags with values
-  boost::replace_all(instruction, kCardinalDirectionTag, cardinal_direction);
-  boost::replace_all(instruction, kStreetNamesTag, street_names);
-  boost::replace_all(instruction, kBeginStreetNamesTag, begin_street_names);
-  boost::replace_all(instruction, kLengthTag,
-                     FormLength(maneuver, dictionary_.start_verbal_subset.metric_lengths,
-                                dictionary_.start_verbal_subset.us_customary_lengths));
+  std::string length = FormLength(maneuver, dictionary_.start_verbal_subset.metric_lengths,
+                                  dictionary_.start_verbal_subset.us_customary_lengths);
+  phrase.Render(instruction, {{kCardinalDirectionTag, cardinal_direction},
+                              {kStreetNamesTag, street_names},
+                              {kBeginStreetNamesTag, begin_street_names},
+                              {kLengthTag, length}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -765,12 +765,14 @@ std::string NarrativeBuilder::FormDestinationInstruction(Maneuver& maneuver) {
   }
 
   // Set instruction to the determined tagged phrase
-  instruction = dictionary_.destination_subset.phrases.at(std::to_string(phrase_id));
+  const auto& phrase = dictionary_.destination_subset.templates.at(std::to_string(phrase_id));
 
   if (phrase_id > 0) {
     // Replace phrase tags with values
-    boost::replace_all(instruction, kRelativeDirectionTag, relative_direction);
-    boost::replace_all(instruction, kDestinationTag, destination);
+    phrase.Render(instruction, {{kRelativeDirectionTag, relative_direction},
+                                {kDestinationTag, destination}});
+  } else {
+    phrase.Render(instruction, {});
   }
 
   // If enabled, form articulated prepositions
@@ -821,12 +823,15 @@ std::string NarrativeBuilder::FormVerbalAlertDestinationInstruction(Maneuver& ma
   }
 
   // Set instruction to the determined tagged phrase
-  instruction = dictionary_.destination_verbal_alert_subset.phrases.at(std::to_string(phrase_id));
+  const auto& phrase =
+      dictionary_.destination_verbal_alert_subset.templates.at(std::to_string(phrase_id));
 
   if (phrase_id > 0) {
     // Replace phrase tags with values
-    boost::replace_all(instruction, kRelativeDirectionTag, relative_direction);
-    boost::replace_all(instruction, kDestinationTag, destination);
+    phrase.Render(instruction, {{kRelativeDirectionTag, relative_direction},
+                                {kDestinationTag, destination}});
+  } else {
+    phrase.Render(instruction, {});
   }
 
   // If enabled, form articulated prepositions
@@ -877,12 +882,15 @@ std::string NarrativeBuilder::FormVerbalDestinationInstruction(Maneuver& maneuve
   }
 
   // Set instruction to the determined tagged phrase
-  instruction = dictionary_.destination_verbal_subset.phrases.at(std::to_string(phrase_id));
+  const auto& phrase =
+      dictionary_.destination_verbal_subset.templates.at(std::to_string(phrase_id));
 
   if (phrase_id > 0) {
     // Replace phrase tags with values
-    boost::replace_all(instruction, kRelativeDirectionTag, relative_direction);
-    boost::replace_all(instruction, kDestinationTag, destination);
+    phrase.Render(instruction, {{kRelativeDirectionTag, relative_direction},
+                                {kDestinationTag, destination}});
+  } else {
+    phrase.Render(instruction, {});
   }
 
   // If enabled, form articulated prepositions
@@ -907,11 +915,11 @@ std::string NarrativeBuilder::FormBecomesInstruction(Maneuver& maneuver, Maneuve
   uint8_t phrase_id = 0;
 
   // Set instruction to the determined tagged phrase
-  instruction = dictionary_.becomes_subset.phrases.at(std::to_string(phrase_id));
+  const auto& phrase = dictionary_.becomes_subset.templates.at(std::to_string(phrase_id));
 
   // Replace phrase tags with values
-  boost::replace_all(instruction, kPreviousStreetNamesTag, prev_street_names);
-  boost::replace_all(instruction, kStreetNamesTag, street_names);
+  phrase.Render(instruction, {{kPreviousStreetNamesTag, prev_street_names},
+                              {kStreetNamesTag, street_names}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -942,11 +950,11 @@ std::string NarrativeBuilder::FormVerbalBecomesInstruction(Maneuver& maneuver,
   uint8_t phrase_id = 0;
 
   // Set instruction to the determined tagged phrase
-  instruction = dictionary_.becomes_verbal_subset.phrases.at(std::to_string(phrase_id));
+  const auto& phrase = dictionary_.becomes_verbal_subset.templates.at(std::to_string(phrase_id));
 
   // Replace phrase tags with values
-  boost::replace_all(instruction, kPreviousStreetNamesTag, prev_street_names);
-  boost::replace_all(instruction, kStreetNamesTag, street_names);
+  phrase.Render(instruction, {{kPreviousStreetNamesTag, prev_street_names},
+                              {kStreetNamesTag, street_names}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -993,12 +1001,12 @@ std::string NarrativeBuilder::FormContinueInstruction(Maneuver& maneuver,
   }
 
   // Set instruction to the determined tagged phrase
-  instruction = dictionary_.continue_subset.phrases.at(std::to_string(phrase_id));
+  const auto& phrase = dictionary_.continue_subset.templates.at(std::to_string(phrase_id));
 
   // Replace phrase tags with values
-  boost::replace_all(instruction, kStreetNamesTag, street_names);
-  boost::replace_all(instruction, kJunctionNameTag, junction_name);
-  boost::replace_all(instruction, kTowardSignTag, guide_sign);
+  phrase.Render(instruction, {{kStreetNamesTag, street_names},
+                              {kJunctionNameTag, junction_name},
+                              {kTowardSignTag, guide_sign}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -1049,12 +1057,13 @@ std::string NarrativeBuilder::FormVerbalAlertContinueInstruction(Maneuver& maneu
   }
 
   // Set instruction to the determined tagged phrase
-  instruction = dictionary_.continue_verbal_alert_subset.phrases.at(std::to_string(phrase_id));
+  const auto& phrase =
+      dictionary_.continue_verbal_alert_subset.templates.at(std::to_string(phrase_id));
 
   // Replace phrase tags with values
-  boost::replace_all(instruction, kStreetNamesTag, street_names);
-  boost::replace_all(instruction, kJunctionNameTag, junction_name);
-  boost::replace_all(instruction, kTowardSignTag, guide_sign);
+  phrase.Render(instruction, {{kStreetNamesTag, street_names},
+                              {kJunctionNameTag, junction_name},
+                              {kTowardSignTag, guide_sign}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -1114,15 +1123,15 @@ std::string NarrativeBuilder::FormVerbalContinueInstruction(Maneuver& maneuver,
   }
 
   // Set instruction to the determined tagged phrase
-  instruction = dictionary_.continue_verbal_subset.phrases.at(std::to_string(phrase_id));
+  const auto& phrase = dictionary_.continue_verbal_subset.templates.at(std::to_string(phrase_id));
 
   // Replace phrase tags with values
-  boost::replace_all(instruction, kLengthTag,
-                     FormLength(maneuver, dictionary_.continue_verbal_subset.metric_lengths,
-                                dictionary_.continue_verbal_subset.us_customary_lengths));
-  boost::replace_all(instruction, kStreetNamesTag, street_names);
-  boost::replace_all(instruction, kJunctionNameTag, junction_name);
-  boost::replace_all(instruction, kTowardSignTag, guide_sign);
+  std::string length = FormLength(maneuver, dictionary_.continue_verbal_subset.metric_lengths,
+                                  dictionary_.continue_verbal_subset.us_customary_lengths);
+  phrase.Render(instruction, {{kLengthTag, length},
+                              {kStreetNamesTag, street_names},
+                              {kJunctionNameTag, junction_name},
+                              {kTowardSignTag, guide_sign}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -1199,15 +1208,16 @@ std::string NarrativeBuilder::FormTurnInstruction(Maneuver& maneuver,
   }
 
   // Set instruction to the determined tagged phrase
-  instruction = subset->phrases.at(std::to_string(phrase_id));
+  const auto& phrase = subset->templates.at(std::to_string(phrase_id));
 
   // Replace phrase tags with values
-  boost::replace_all(instruction, kRelativeDirectionTag,
-                     FormRelativeTwoDirection(maneuver.type(), subset->relative_directions));
-  boost::replace_all(instruction, kStreetNamesTag, street_names);
-  boost::replace_all(instruction, kBeginStreetNamesTag, begin_street_names);
-  boost::replace_all(instruction, kJunctionNameTag, junction_name);
-  boost::replace_all(instruction, kTowardSignTag, guide_sign);
+  std::string relative_direction =
+      FormRelativeTwoDirection(maneuver.type(), subset->relative_directions);
+  phrase.Render(instruction, {{kRelativeDirectionTag, relative_direction},
+                              {kStreetNamesTag, street_names},
+                              {kBeginStreetNamesTag, begin_street_names},
+                              {kJunctionNameTag, junction_name},
+                              {kTowardSignTag, guide_sign}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -1307,15 +1317,16 @@ std::string NarrativeBuilder::FormVerbalTurnInstruction(Maneuver& maneuver,
   }
 
   // Set instruction to the determined tagged phrase
-  instruction = subset->phrases.at(std::to_string(phrase_id));
+  const auto& phrase = subset->templates.at(std::to_string(phrase_id));
 
   // Replace phrase tags with values
-  boost::replace_all(instruction, kRelativeDirectionTag,
-                     FormRelativeTwoDirection(maneuver.type(), subset->relative_directions));
-  boost::replace_all(instruction, kStreetNamesTag, street_names);
-  boost::replace_all(instruction, kBeginStreetNamesTag, begin_street_names);
-  boost::replace_all(instruction, kJunctionNameTag, junction_name);
-  boost::replace_all(instruction, kTowardSignTag, guide_sign);
+  std::string relative_direction =
+      FormRelativeTwoDirection(maneuver.type(), subset->relative_directions);
+  phrase.Render(instruction, {{kRelativeDirectionTag, relative_direction},
+                              {kStreetNamesTag, street_names},
+                              {kBeginStreetNamesTag, begin_street_names},
+                              {kJunctionNameTag, junction_name},
+                              {kTowardSignTag, guide_sign}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -1377,16 +1388,16 @@ std::string NarrativeBuilder::FormUturnInstruction(Maneuver& maneuver,
   }
 
   // Set instruction to the determined tagged phrase
-  instruction = dictionary_.uturn_subset.phrases.at(std::to_string(phrase_id));
+  const auto& phrase = dictionary_.uturn_subset.templates.at(std::to_string(phrase_id));
 
   // Replace phrase tags with values
-  boost::replace_all(instruction, kRelativeDirectionTag,
-                     FormRelativeTwoDirection(maneuver.type(),
-                                              dictionary_.uturn_subset.relative_directions));
-  boost::replace_all(instruction, kStreetNamesTag, street_names);
-  boost::replace_all(instruction, kCrossStreetNamesTag, cross_street_names);
-  boost::replace_all(instruction, kJunctionNameTag, junction_name);
-  boost::replace_all(instruction, kTowardSignTag, guide_sign);
+  std::string relative_direction =
+      FormRelativeTwoDirection(maneuver.type(), dictionary_.uturn_subset.relative_directions);
+  phrase.Render(instruction, {{kRelativeDirectionTag, relative_direction},
+                              {kStreetNamesTag, street_names},
+                              {kCrossStreetNamesTag, cross_street_names},
+                              {kJunctionNameTag, junction_name},
+                              {kTowardSignTag, guide_sign}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -1532,14 +1543,14 @@ std::string NarrativeBuilder::FormVerbalUturnInstruction(uint8_t phrase_id,
   instruction.reserve(kInstructionInitialCapacity);
 
   // Set instruction to the determined tagged phrase
-  instruction = dictionary_.uturn_verbal_subset.phrases.at(std::to_string(phrase_id));
+  const auto& phrase = dictionary_.uturn_verbal_subset.templates.at(std::to_string(phrase_id));
 
   // Replace phrase tags with values
-  boost::replace_all(instruction, kRelativeDirectionTag, relative_dir);
-  boost::replace_all(instruction, kStreetNamesTag, street_names);
-  boost::replace_all(instruction, kCrossStreetNamesTag, cross_street_names);
-  boost::replace_all(instruction, kJunctionNameTag, junction_name);
-  boost::replace_all(instruction, kTowardSignTag, guide_sign);
+  phrase.Render(instruction, {{kRelativeDirectionTag, relative_dir},
+                              {kStreetNamesTag, street_names},
+                              {kCrossStreetNamesTag, cross_street_names},
+                              {kJunctionNameTag, junction_name},
+                              {kTowardSignTag, guide_sign}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -1586,12 +1597,12 @@ std::string NarrativeBuilder::FormRampStraightInstruction(Maneuver& maneuver,
   }
 
   // Set instruction to the determined tagged phrase
-  instruction = dictionary_.ramp_straight_subset.phrases.at(std::to_string(phrase_id));
+  const auto& phrase = dictionary_.ramp_straight_subset.templates.at(std::to_string(phrase_id));
 
   // Replace phrase tags with values
-  boost::replace_all(instruction, kBranchSignTag, exit_branch_sign);
-  boost::replace_all(instruction, kTowardSignTag, exit_toward_sign);
-  boost::replace_all(instruction, kNameSignTag, exit_name_sign);
+  phrase.Render(instruction, {{kBranchSignTag, exit_branch_sign},
+                              {kTowardSignTag, exit_toward_sign},
+                              {kNameSignTag, exit_name_sign}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -1691,12 +1702,13 @@ std::string NarrativeBuilder::FormVerbalRampStraightInstruction(uint8_t phrase_i
   instruction.reserve(kInstructionInitialCapacity);
 
   // Set instruction to the determined tagged phrase
-  instruction = dictionary_.ramp_straight_verbal_subset.phrases.at(std::to_string(phrase_id));
+  const auto& phrase =
+      dictionary_.ramp_straight_verbal_subset.templates.at(std::to_string(phrase_id));
 
   // Replace phrase tags with values
-  boost::replace_all(instruction, kBranchSignTag, exit_branch_sign);
-  boost::replace_all(instruction, kTowardSignTag, exit_toward_sign);
-  boost::replace_all(instruction, kNameSignTag, exit_name_sign);
+  phrase.Render(instruction, {{kBranchSignTag, exit_branch_sign},
+                              {kTowardSignTag, exit_toward_sign},
+                              {kNameSignTag, exit_name_sign}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -1765,15 +1777,15 @@ std::string NarrativeBuilder::FormRampInstruction(Maneuver& maneuver,
   }
 
   // Set instruction to the determined tagged phrase
-  instruction = dictionary_.ramp_subset.phrases.at(std::to_string(phrase_id));
+  const auto& phrase = dictionary_.ramp_subset.templates.at(std::to_string(phrase_id));
 
   // Replace phrase tags with values
-  boost::replace_all(instruction, kRelativeDirectionTag,
-                     FormRelativeTwoDirection(maneuver.type(),
-                                              dictionary_.ramp_subset.relative_directions));
-  boost::replace_all(instruction, kBranchSignTag, exit_branch_sign);
-  boost::replace_all(instruction, kTowardSignTag, exit_toward_sign);
-  boost::replace_all(instruction, kNameSignTag, exit_name_sign);
+  std::string relative_direction =
+      FormRelativeTwoDirection(maneuver.type(), dictionary_.ramp_subset.relative_directions);
+  phrase.Render(instruction, {{kRelativeDirectionTag, relative_direction},
+                              {kBranchSignTag, exit_branch_sign},
+                              {kTowardSignTag, exit_toward_sign},
+                              {kNameSignTag, exit_name_sign}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -1925,13 +1937,13 @@ std::string NarrativeBuilder::FormVerbalRampInstruction(uint8_t phrase_id,
   instruction.reserve(kInstructionInitialCapacity);
 
   // Set instruction to the determined tagged phrase
-  instruction = dictionary_.ramp_verbal_subset.phrases.at(std::to_string(phrase_id));
+  const auto& phrase = dictionary_.ramp_verbal_subset.templates.at(std::to_string(phrase_id));
 
   // Replace phrase tags with values
-  boost::replace_all(instruction, kRelativeDirectionTag, relative_dir);
-  boost::replace_all(instruction, kBranchSignTag, exit_branch_sign);
-  boost::replace_all(instruction, kTowardSignTag, exit_toward_sign);
-  boost::replace_all(instruction, kNameSignTag, exit_name_sign);
+  phrase.Render(instruction, {{kRelativeDirectionTag, relative_dir},
+                              {kBranchSignTag, exit_branch_sign},
+                              {kTowardSignTag, exit_toward_sign},
+                              {kNameSignTag, exit_name_sign}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -2010,16 +2022,16 @@ std::string NarrativeBuilder::FormExitInstruction(Maneuver& maneuver,
   }
 
   // Set instruction to the determined tagged phrase
-  instruction = dictionary_.exit_subset.phrases.at(std::to_string(phrase_id));
+  const auto& phrase = dictionary_.exit_subset.templates.at(std::to_string(phrase_id));
 
   // Replace phrase tags with values
-  boost::replace_all(instruction, kRelativeDirectionTag,
-                     FormRelativeTwoDirection(maneuver.type(),
-                                              dictionary_.exit_subset.relative_directions));
-  boost::replace_all(instruction, kNumberSignTag, exit_number_sign);
-  boost::replace_all(instruction, kBranchSignTag, exit_branch_sign);
-  boost::replace_all(instruction, kTowardSignTag, exit_toward_sign);
-  boost::replace_all(instruction, kNameSignTag, exit_name_sign);
+  std::string relative_direction =
+      FormRelativeTwoDirection(maneuver.type(), dictionary_.exit_subset.relative_directions);
+  phrase.Render(instruction, {{kRelativeDirectionTag, relative_direction},
+                              {kNumberSignTag, exit_number_sign},
+                              {kBranchSignTag, exit_branch_sign},
+                              {kTowardSignTag, exit_toward_sign},
+                              {kNameSignTag, exit_name_sign}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -2181,14 +2193,14 @@ std::string NarrativeBuilder::FormVerbalExitInstruction(uint8_t phrase_id,
   instruction.reserve(kInstructionInitialCapacity);
 
   // Set instruction to the determined tagged phrase
-  instruction = dictionary_.exit_verbal_subset.phrases.at(std::to_string(phrase_id));
+  const auto& phrase = dictionary_.exit_verbal_subset.templates.at(std::to_string(phrase_id));
 
   // Replace phrase tags with values
-  boost::replace_all(instruction, kRelativeDirectionTag, relative_dir);
-  boost::replace_all(instruction, kNumberSignTag, exit_number_sign);
-  boost::replace_all(instruction, kBranchSignTag, exit_branch_sign);
-  boost::replace_all(instruction, kTowardSignTag, exit_toward_sign);
-  boost::replace_all(instruction, kNameSignTag, exit_name_sign);
+  phrase.Render(instruction, {{kRelativeDirectionTag, relative_dir},
+                              {kNumberSignTag, exit_number_sign},
+                              {kBranchSignTag, exit_branch_sign},
+                              {kTowardSignTag, exit_toward_sign},
+                              {kNameSignTag, exit_name_sign}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -2270,15 +2282,15 @@ std::string NarrativeBuilder::FormKeepInstruction(Maneuver& maneuver,
   }
 
   // Set instruction to the determined tagged phrase
-  instruction = dictionary_.keep_subset.phrases.at(std::to_string(phrase_id));
+  const auto& phrase = dictionary_.keep_subset.templates.at(std::to_string(phrase_id));
 
   // Replace phrase tags with values
-  boost::replace_all(instruction, kRelativeDirectionTag,
-                     FormRelativeThreeDirection(maneuver.type(),
-                                                dictionary_.keep_subset.relative_directions));
-  boost::replace_all(instruction, kNumberSignTag, exit_number_sign);
-  boost::replace_all(instruction, kStreetNamesTag, street_names);
-  boost::replace_all(instruction, kTowardSignTag, toward_sign);
+  std::string relative_direction =
+      FormRelativeThreeDirection(maneuver.type(), dictionary_.keep_subset.relative_directions);
+  phrase.Render(instruction, {{kRelativeDirectionTag, relative_direction},
+                              {kNumberSignTag, exit_number_sign},
+                              {kStreetNamesTag, street_names},
+                              {kTowardSignTag, toward_sign}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -2461,13 +2473,13 @@ std::string NarrativeBuilder::FormVerbalKeepInstruction(uint8_t phrase_id,
   instruction.reserve(kInstructionInitialCapacity);
 
   // Set instruction to the determined tagged phrase
-  instruction = dictionary_.keep_verbal_subset.phrases.at(std::to_string(phrase_id));
+  const auto& phrase = dictionary_.keep_verbal_subset.templates.at(std::to_string(phrase_id));
 
   // Replace phrase tags with values
-  boost::replace_all(instruction, kRelativeDirectionTag, relative_dir);
-  boost::replace_all(instruction, kNumberSignTag, exit_number_sign);
-  boost::replace_all(instruction, kStreetNamesTag, street_names);
-  boost::replace_all(instruction, kTowardSignTag, toward_sign);
+  phrase.Render(instruction, {{kRelativeDirectionTag, relative_dir},
+                              {kNumberSignTag, exit_number_sign},
+                              {kStreetNamesTag, street_names},
+                              {kTowardSignTag, toward_sign}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -2520,15 +2532,16 @@ std::string NarrativeBuilder::FormKeepToStayOnInstruction(Maneuver& maneuver,
   }
 
   // Set instruction to the determined tagged phrase
-  instruction = dictionary_.keep_to_stay_on_subset.phrases.at(std::to_string(phrase_id));
+  const auto& phrase = dictionary_.keep_to_stay_on_subset.templates.at(std::to_string(phrase_id));
 
   // Replace phrase tags with values
-  boost::replace_all(instruction, kRelativeDirectionTag,
-                     FormRelativeThreeDirection(maneuver.type(), dictionary_.keep_to_stay_on_subset
-                                                                     .relative_directions));
-  boost::replace_all(instruction, kStreetNamesTag, street_names);
-  boost::replace_all(instruction, kNumberSignTag, exit_number_sign);
-  boost::replace_all(instruction, kTowardSignTag, toward_sign);
+  std::string relative_direction =
+      FormRelativeThreeDirection(maneuver.type(),
+                                 dictionary_.keep_to_stay_on_subset.relative_directions);
+  phrase.Render(instruction, {{kRelativeDirectionTag, relative_direction},
+                              {kStreetNamesTag, street_names},
+                              {kNumberSignTag, exit_number_sign},
+                              {kTowardSignTag, toward_sign}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -2619,13 +2632,14 @@ std::string NarrativeBuilder::FormVerbalKeepToStayOnInstruction(uint8_t phrase_i
   instruction.reserve(kInstructionInitialCapacity);
 
   // Set instruction to the determined tagged phrase
-  instruction = dictionary_.keep_to_stay_on_verbal_subset.phrases.at(std::to_string(phrase_id));
+  const auto& phrase =
+      dictionary_.keep_to_stay_on_verbal_subset.templates.at(std::to_string(phrase_id));
 
   // Replace phrase tags with values
-  boost::replace_all(instruction, kRelativeDirectionTag, relative_dir);
-  boost::replace_all(instruction, kStreetNamesTag, street_names);
-  boost::replace_all(instruction, kNumberSignTag, exit_number_sign);
-  boost::replace_all(instruction, kTowardSignTag, toward_sign);
+  phrase.Render(instruction, {{kRelativeDirectionTag, relative_dir},
+                              {kStreetNamesTag, street_names},
+                              {kNumberSignTag, exit_number_sign},
+                              {kTowardSignTag, toward_sign}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -2677,12 +2691,12 @@ std::string NarrativeBuilder::FormMergeInstruction(Maneuver& maneuver,
   }
 
   // Set instruction to the determined tagged phrase
-  instruction = dictionary_.merge_subset.phrases.at(std::to_string(phrase_id));
+  const auto& phrase = dictionary_.merge_subset.templates.at(std::to_string(phrase_id));
 
   // Replace phrase tags with values
-  boost::replace_all(instruction, kRelativeDirectionTag, relative_direction);
-  boost::replace_all(instruction, kStreetNamesTag, street_names);
-  boost::replace_all(instruction, kTowardSignTag, guide_sign);
+  phrase.Render(instruction, {{kRelativeDirectionTag, relative_direction},
+                              {kStreetNamesTag, street_names},
+                              {kTowardSignTag, guide_sign}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -2752,12 +2766,12 @@ std::string NarrativeBuilder::FormVerbalMergeInstruction(Maneuver& maneuver,
   }
 
   // Set instruction to the determined tagged phrase
-  instruction = dictionary_.merge_verbal_subset.phrases.at(std::to_string(phrase_id));
+  const auto& phrase = dictionary_.merge_verbal_subset.templates.at(std::to_string(phrase_id));
 
   // Replace phrase tags with values
-  boost::replace_all(instruction, kRelativeDirectionTag, relative_direction);
-  boost::replace_all(instruction, kStreetNamesTag, street_names);
-  boost::replace_all(instruction, kTowardSignTag, guide_sign);
+  phrase.Render(instruction, {{kRelativeDirectionTag, relative_direction},
+                              {kStreetNamesTag, street_names},
+                              {kTowardSignTag, guide_sign}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -2875,15 +2889,15 @@ std::string NarrativeBuilder::FormEnterRoundaboutInstruction(Maneuver& maneuver,
   }
 
   // Set instruction to the determined tagged phrase
-  instruction = dictionary_.enter_roundabout_subset.phrases.at(std::to_string(phrase_id));
+  const auto& phrase = dictionary_.enter_roundabout_subset.templates.at(std::to_string(phrase_id));
 
   // Replace phrase tags with values
-  boost::replace_all(instruction, kOrdinalValueTag, ordinal_value);
-  boost::replace_all(instruction, kStreetNamesTag, street_names);
-  boost::replace_all(instruction, kTowardSignTag, guide_sign);
-  boost::replace_all(instruction, kRoundaboutExitStreetNamesTag, roundabout_exit_street_names);
-  boost::replace_all(instruction, kRoundaboutExitBeginStreetNamesTag,
-                     roundabout_exit_begin_street_names);
+  phrase.Render(instruction,
+                {{kOrdinalValueTag, ordinal_value},
+                 {kStreetNamesTag, street_names},
+                 {kTowardSignTag, guide_sign},
+                 {kRoundaboutExitStreetNamesTag, roundabout_exit_street_names},
+                 {kRoundaboutExitBeginStreetNamesTag, roundabout_exit_begin_street_names}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -3027,15 +3041,16 @@ std::string NarrativeBuilder::FormVerbalEnterRoundaboutInstruction(Maneuver& man
   }
 
   // Set instruction to the determined tagged phrase
-  instruction = dictionary_.enter_roundabout_verbal_subset.phrases.at(std::to_string(phrase_id));
+  const auto& phrase =
+      dictionary_.enter_roundabout_verbal_subset.templates.at(std::to_string(phrase_id));
 
   // Replace phrase tags with values
-  boost::replace_all(instruction, kOrdinalValueTag, ordinal_value);
-  boost::replace_all(instruction, kStreetNamesTag, street_names);
-  boost::replace_all(instruction, kTowardSignTag, guide_sign);
-  boost::replace_all(instruction, kRoundaboutExitStreetNamesTag, roundabout_exit_street_names);
-  boost::replace_all(instruction, kRoundaboutExitBeginStreetNamesTag,
-                     roundabout_exit_begin_street_names);
+  phrase.Render(instruction,
+                {{kOrdinalValueTag, ordinal_value},
+                 {kStreetNamesTag, street_names},
+                 {kTowardSignTag, guide_sign},
+                 {kRoundaboutExitStreetNamesTag, roundabout_exit_street_names},
+                 {kRoundaboutExitBeginStreetNamesTag, roundabout_exit_begin_street_names}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -3090,12 +3105,12 @@ std::string NarrativeBuilder::FormExitRoundaboutInstruction(Maneuver& maneuver,
   }
 
   // Set instruction to the determined tagged phrase
-  instruction = dictionary_.exit_roundabout_subset.phrases.at(std::to_string(phrase_id));
+  const auto& phrase = dictionary_.exit_roundabout_subset.templates.at(std::to_string(phrase_id));
 
   // Replace phrase tags with values
-  boost::replace_all(instruction, kStreetNamesTag, street_names);
-  boost::replace_all(instruction, kBeginStreetNamesTag, begin_street_names);
-  boost::replace_all(instruction, kTowardSignTag, guide_sign);
+  phrase.Render(instruction, {{kStreetNamesTag, street_names},
+                              {kBeginStreetNamesTag, begin_street_names},
+                              {kTowardSignTag, guide_sign}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -3154,12 +3169,13 @@ std::string NarrativeBuilder::FormVerbalExitRoundaboutInstruction(Maneuver& mane
   }
 
   // Set instruction to the determined tagged phrase
-  instruction = dictionary_.exit_roundabout_verbal_subset.phrases.at(std::to_string(phrase_id));
+  const auto& phrase =
+      dictionary_.exit_roundabout_verbal_subset.templates.at(std::to_string(phrase_id));
 
   // Replace phrase tags with values
-  boost::replace_all(instruction, kStreetNamesTag, street_names);
-  boost::replace_all(instruction, kBeginStreetNamesTag, begin_street_names);
-  boost::replace_all(instruction, kTowardSignTag, guide_sign);
+  phrase.Render(instruction, {{kStreetNamesTag, street_names},
+                              {kBeginStreetNamesTag, begin_street_names},
+                              {kTowardSignTag, guide_sign}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -3204,12 +3220,12 @@ std::string NarrativeBuilder::FormEnterFerryInstruction(Maneuver& maneuver,
   }
 
   // Set instruction to the determined tagged phrase
-  instruction = dictionary_.enter_ferry_subset.phrases.at(std::to_string(phrase_id));
+  const auto& phrase = dictionary_.enter_ferry_subset.templates.at(std::to_string(phrase_id));
 
   // Replace phrase tags with values
-  boost::replace_all(instruction, kStreetNamesTag, street_names);
-  boost::replace_all(instruction, kFerryLabelTag, ferry_label);
-  boost::replace_all(instruction, kTowardSignTag, guide_sign);
+  phrase.Render(instruction, {{kStreetNamesTag, street_names},
+                              {kFerryLabelTag, ferry_label},
+                              {kTowardSignTag, guide_sign}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -3271,12 +3287,13 @@ std::string NarrativeBuilder::FormVerbalEnterFerryInstruction(Maneuver& maneuver
   }
 
   // Set instruction to the determined tagged phrase
-  instruction = dictionary_.enter_ferry_verbal_subset.phrases.at(std::to_string(phrase_id));
+  const auto& phrase =
+      dictionary_.enter_ferry_verbal_subset.templates.at(std::to_string(phrase_id));
 
   // Replace phrase tags with values
-  boost::replace_all(instruction, kStreetNamesTag, street_names);
-  boost::replace_all(instruction, kFerryLabelTag, ferry_label);
-  boost::replace_all(instruction, kTowardSignTag, guide_sign);
+  phrase.Render(instruction, {{kStreetNamesTag, street_names},
+                              {kFerryLabelTag, ferry_label},
+                              {kTowardSignTag, guide_sign}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -3310,11 +3327,12 @@ std::string NarrativeBuilder::FormTransitConnectionStartInstruction(Maneuver& ma
   }
 
   // Set instruction to the determined tagged phrase
-  instruction = dictionary_.transit_connection_start_subset.phrases.at(std::to_string(phrase_id));
+  const auto& phrase =
+      dictionary_.transit_connection_start_subset.templates.at(std::to_string(phrase_id));
 
   // Replace phrase tags with values
-  boost::replace_all(instruction, kTransitPlatformTag, transit_stop);
-  boost::replace_all(instruction, kStationLabelTag, station_label);
+  phrase.Render(instruction, {{kTransitPlatformTag, transit_stop},
+                              {kStationLabelTag, station_label}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -3348,12 +3366,12 @@ std::string NarrativeBuilder::FormVerbalTransitConnectionStartInstruction(Maneuv
   }
 
   // Set instruction to the determined tagged phrase
-  instruction =
-      dictionary_.transit_connection_start_verbal_subset.phrases.at(std::to_string(phrase_id));
+  const auto& phrase =
+      dictionary_.transit_connection_start_verbal_subset.templates.at(std::to_string(phrase_id));
 
   // Replace phrase tags with values
-  boost::replace_all(instruction, kTransitPlatformTag, transit_stop);
-  boost::replace_all(instruction, kStationLabelTag, station_label);
+  phrase.Render(instruction, {{kTransitPlatformTag, transit_stop},
+                              {kStationLabelTag, station_label}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -3387,11 +3405,12 @@ std::string NarrativeBuilder::FormTransitConnectionTransferInstruction(Maneuver&
   }
 
   // Set instruction to the determined tagged phrase
-  instruction = dictionary_.transit_connection_transfer_subset.phrases.at(std::to_string(phrase_id));
+  const auto& phrase =
+      dictionary_.transit_connection_transfer_subset.templates.at(std::to_string(phrase_id));
 
   // Replace phrase tags with values
-  boost::replace_all(instruction, kTransitPlatformTag, transit_stop);
-  boost::replace_all(instruction, kStationLabelTag, station_label);
+  phrase.Render(instruction, {{kTransitPlatformTag, transit_stop},
+                              {kStationLabelTag, station_label}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -3425,12 +3444,12 @@ std::string NarrativeBuilder::FormVerbalTransitConnectionTransferInstruction(Man
   }
 
   // Set instruction to the determined tagged phrase
-  instruction =
-      dictionary_.transit_connection_transfer_verbal_subset.phrases.at(std::to_string(phrase_id));
+  const auto& phrase =
+      dictionary_.transit_connection_transfer_verbal_subset.templates.at(std::to_string(phrase_id));
 
   // Replace phrase tags with values
-  boost::replace_all(instruction, kTransitPlatformTag, transit_stop);
-  boost::replace_all(instruction, kStationLabelTag, station_label);
+  phrase.Render(instruction, {{kTransitPlatformTag, transit_stop},
+                              {kStationLabelTag, station_label}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -3464,12 +3483,12 @@ std::string NarrativeBuilder::FormTransitConnectionDestinationInstruction(Maneuv
   }
 
   // Set instruction to the determined tagged phrase
-  instruction =
-      dictionary_.transit_connection_destination_subset.phrases.at(std::to_string(phrase_id));
+  const auto& phrase =
+      dictionary_.transit_connection_destination_subset.templates.at(std::to_string(phrase_id));
 
   // Replace phrase tags with values
-  boost::replace_all(instruction, kTransitPlatformTag, transit_stop);
-  boost::replace_all(instruction, kStationLabelTag, station_label);
+  phrase.Render(instruction, {{kTransitPlatformTag, transit_stop},
+                              {kStationLabelTag, station_label}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -3503,12 +3522,12 @@ std::string NarrativeBuilder::FormVerbalTransitConnectionDestinationInstruction(
   }
 
   // Set instruction to the determined tagged phrase
-  instruction =
-      dictionary_.transit_connection_destination_verbal_subset.phrases.at(std::to_string(phrase_id));
+  const auto& phrase = dictionary_.transit_connection_destination_verbal_subset.templates.at(
+      std::to_string(phrase_id));
 
   // Replace phrase tags with values
-  boost::replace_all(instruction, kTransitPlatformTag, transit_stop);
-  boost::replace_all(instruction, kStationLabelTag, station_label);
+  phrase.Render(instruction, {{kTransitPlatformTag, transit_stop},
+                              {kStationLabelTag, station_label}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -3532,12 +3551,13 @@ std::string NarrativeBuilder::FormDepartInstruction(Maneuver& maneuver) {
   }
 
   // Set instruction to the determined tagged phrase
-  instruction = dictionary_.depart_subset.phrases.at(std::to_string(phrase_id));
+  const auto& phrase = dictionary_.depart_subset.templates.at(std::to_string(phrase_id));
 
   // Replace phrase tags with values
-  boost::replace_all(instruction, kTransitPlatformTag, transit_stop_name);
-  boost::replace_all(instruction, kTimeTag,
-                     get_localized_time(maneuver.GetTransitDepartureTime(), dictionary_.GetLocale()));
+  std::string localized_time =
+      get_localized_time(maneuver.GetTransitDepartureTime(), dictionary_.GetLocale());
+  phrase.Render(instruction, {{kTransitPlatformTag, transit_stop_name},
+                              {kTimeTag, localized_time}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -3561,12 +3581,13 @@ std::string NarrativeBuilder::FormVerbalDepartInstruction(Maneuver& maneuver) {
   }
 
   // Set instruction to the determined tagged phrase
-  instruction = dictionary_.depart_verbal_subset.phrases.at(std::to_string(phrase_id));
+  const auto& phrase = dictionary_.depart_verbal_subset.templates.at(std::to_string(phrase_id));
 
   // Replace phrase tags with values
-  boost::replace_all(instruction, kTransitPlatformTag, transit_stop_name);
-  boost::replace_all(instruction, kTimeTag,
-                     get_localized_time(maneuver.GetTransitDepartureTime(), dictionary_.GetLocale()));
+  std::string localized_time =
+      get_localized_time(maneuver.GetTransitDepartureTime(), dictionary_.GetLocale());
+  phrase.Render(instruction, {{kTransitPlatformTag, transit_stop_name},
+                              {kTimeTag, localized_time}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -3590,12 +3611,13 @@ std::string NarrativeBuilder::FormArriveInstruction(Maneuver& maneuver) {
   }
 
   // Set instruction to the determined tagged phrase
-  instruction = dictionary_.arrive_subset.phrases.at(std::to_string(phrase_id));
+  const auto& phrase = dictionary_.arrive_subset.templates.at(std::to_string(phrase_id));
 
   // Replace phrase tags with values
-  boost::replace_all(instruction, kTransitPlatformTag, transit_stop_name);
-  boost::replace_all(instruction, kTimeTag,
-                     get_localized_time(maneuver.GetTransitArrivalTime(), dictionary_.GetLocale()));
+  std::string localized_time =
+      get_localized_time(maneuver.GetTransitArrivalTime(), dictionary_.GetLocale());
+  phrase.Render(instruction, {{kTransitPlatformTag, transit_stop_name},
+                              {kTimeTag, localized_time}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -3619,12 +3641,13 @@ std::string NarrativeBuilder::FormVerbalArriveInstruction(Maneuver& maneuver) {
   }
 
   // Set instruction to the determined tagged phrase
-  instruction = dictionary_.arrive_verbal_subset.phrases.at(std::to_string(phrase_id));
+  const auto& phrase = dictionary_.arrive_verbal_subset.templates.at(std::to_string(phrase_id));
 
   // Replace phrase tags with values
-  boost::replace_all(instruction, kTransitPlatformTag, transit_stop_name);
-  boost::replace_all(instruction, kTimeTag,
-                     get_localized_time(maneuver.GetTransitArrivalTime(), dictionary_.GetLocale()));
+  std::string localized_time =
+      get_localized_time(maneuver.GetTransitArrivalTime(), dictionary_.GetLocale());
+  phrase.Render(instruction, {{kTransitPlatformTag, transit_stop_name},
+                              {kTimeTag, localized_time}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -3652,15 +3675,16 @@ std::string NarrativeBuilder::FormTransitInstruction(Maneuver& maneuver) {
   }
 
   // Set instruction to the determined tagged phrase
-  instruction = dictionary_.transit_subset.phrases.at(std::to_string(phrase_id));
+  const auto& phrase = dictionary_.transit_subset.templates.at(std::to_string(phrase_id));
 
   // Replace phrase tags with values
-  boost::replace_all(instruction, kTransitNameTag,
-                     FormTransitName(maneuver, dictionary_.transit_subset.empty_transit_name_labels));
-  boost::replace_all(instruction, kTransitHeadSignTag, transit_headsign);
-  boost::replace_all(instruction, kTransitPlatformCountTag,
-                     std::to_string(stop_count)); // TODO: locale specific numerals
-  boost::replace_all(instruction, kTransitPlatformCountLabelTag, stop_count_label);
+  std::string transit_name = FormTransitName(maneuver,
+                                             dictionary_.transit_subset.empty_transit_name_labels);
+  phrase.Render(instruction, {{kTransitNameTag, transit_name},
+                              {kTransitHeadSignTag, transit_headsign},
+                              // TODO: locale specific numerals
+                              {kTransitPlatformCountTag, std::to_string(stop_count)},
+                              {kTransitPlatformCountLabelTag, stop_count_label}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -3684,13 +3708,13 @@ std::string NarrativeBuilder::FormVerbalTransitInstruction(Maneuver& maneuver) {
   }
 
   // Set instruction to the determined tagged phrase
-  instruction = dictionary_.transit_verbal_subset.phrases.at(std::to_string(phrase_id));
+  const auto& phrase = dictionary_.transit_verbal_subset.templates.at(std::to_string(phrase_id));
 
   // Replace phrase tags with values
-  boost::replace_all(instruction, kTransitNameTag,
-                     FormTransitName(maneuver,
-                                     dictionary_.transit_verbal_subset.empty_transit_name_labels));
-  boost::replace_all(instruction, kTransitHeadSignTag, transit_headsign);
+  std::string transit_name =
+      FormTransitName(maneuver, dictionary_.transit_verbal_subset.empty_transit_name_labels);
+  phrase.Render(instruction, {{kTransitNameTag, transit_name},
+                              {kTransitHeadSignTag, transit_headsign}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -3719,16 +3743,16 @@ std::string NarrativeBuilder::FormTransitRemainOnInstruction(Maneuver& maneuver)
   }
 
   // Set instruction to the determined tagged phrase
-  instruction = dictionary_.transit_remain_on_subset.phrases.at(std::to_string(phrase_id));
+  const auto& phrase = dictionary_.transit_remain_on_subset.templates.at(std::to_string(phrase_id));
 
   // Replace phrase tags with values
-  boost::replace_all(instruction, kTransitNameTag,
-                     FormTransitName(maneuver,
-                                     dictionary_.transit_remain_on_subset.empty_transit_name_labels));
-  boost::replace_all(instruction, kTransitHeadSignTag, transit_headsign);
-  boost::replace_all(instruction, kTransitPlatformCountTag,
-                     std::to_string(stop_count)); // TODO: locale specific numerals
-  boost::replace_all(instruction, kTransitPlatformCountLabelTag, stop_count_label);
+  std::string transit_name =
+      FormTransitName(maneuver, dictionary_.transit_remain_on_subset.empty_transit_name_labels);
+  phrase.Render(instruction, {{kTransitNameTag, transit_name},
+                              {kTransitHeadSignTag, transit_headsign},
+                              // TODO: locale specific numerals
+                              {kTransitPlatformCountTag, std::to_string(stop_count)},
+                              {kTransitPlatformCountLabelTag, stop_count_label}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -3752,13 +3776,15 @@ std::string NarrativeBuilder::FormVerbalTransitRemainOnInstruction(Maneuver& man
   }
 
   // Set instruction to the determined tagged phrase
-  instruction = dictionary_.transit_remain_on_verbal_subset.phrases.at(std::to_string(phrase_id));
+  const auto& phrase =
+      dictionary_.transit_remain_on_verbal_subset.templates.at(std::to_string(phrase_id));
 
   // Replace phrase tags with values
-  boost::replace_all(instruction, kTransitNameTag,
-                     FormTransitName(maneuver, dictionary_.transit_remain_on_verbal_subset
-                                                   .empty_transit_name_labels));
-  boost::replace_all(instruction, kTransitHeadSignTag, transit_headsign);
+  std::string transit_name =
+      FormTransitName(maneuver,
+                      dictionary_.transit_remain_on_verbal_subset.empty_transit_name_labels);
+  phrase.Render(instruction, {{kTransitNameTag, transit_name},
+                              {kTransitHeadSignTag, transit_headsign}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -3787,16 +3813,16 @@ std::string NarrativeBuilder::FormTransitTransferInstruction(Maneuver& maneuver)
   }
 
   // Set instruction to the determined tagged phrase
-  instruction = dictionary_.transit_transfer_subset.phrases.at(std::to_string(phrase_id));
+  const auto& phrase = dictionary_.transit_transfer_subset.templates.at(std::to_string(phrase_id));
 
   // Replace phrase tags with values
-  boost::replace_all(instruction, kTransitNameTag,
-                     FormTransitName(maneuver,
-                                     dictionary_.transit_transfer_subset.empty_transit_name_labels));
-  boost::replace_all(instruction, kTransitHeadSignTag, transit_headsign);
-  boost::replace_all(instruction, kTransitPlatformCountTag,
-                     std::to_string(stop_count)); // TODO: locale specific numerals
-  boost::replace_all(instruction, kTransitPlatformCountLabelTag, stop_count_label);
+  std::string transit_name =
+      FormTransitName(maneuver, dictionary_.transit_transfer_subset.empty_transit_name_labels);
+  phrase.Render(instruction, {{kTransitNameTag, transit_name},
+                              {kTransitHeadSignTag, transit_headsign},
+                              // TODO: locale specific numerals
+                              {kTransitPlatformCountTag, std::to_string(stop_count)},
+                              {kTransitPlatformCountLabelTag, stop_count_label}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -3820,13 +3846,15 @@ std::string NarrativeBuilder::FormVerbalTransitTransferInstruction(Maneuver& man
   }
 
   // Set instruction to the determined tagged phrase
-  instruction = dictionary_.transit_transfer_verbal_subset.phrases.at(std::to_string(phrase_id));
+  const auto& phrase =
+      dictionary_.transit_transfer_verbal_subset.templates.at(std::to_string(phrase_id));
 
   // Replace phrase tags with values
-  boost::replace_all(instruction, kTransitNameTag,
-                     FormTransitName(maneuver, dictionary_.transit_transfer_verbal_subset
-                                                   .empty_transit_name_labels));
-  boost::replace_all(instruction, kTransitHeadSignTag, transit_headsign);
+  std::string transit_name =
+      FormTransitName(maneuver,
+                      dictionary_.transit_transfer_verbal_subset.empty_transit_name_labels);
+  phrase.Render(instruction, {{kTransitNameTag, transit_name},
+                              {kTransitHeadSignTag, transit_headsign}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -3868,13 +3896,14 @@ std::string NarrativeBuilder::FormVerbalPostTransitionInstruction(Maneuver& mane
   }
 
   // Set instruction to the determined tagged phrase
-  instruction = dictionary_.post_transition_verbal_subset.phrases.at(std::to_string(phrase_id));
+  const auto& phrase =
+      dictionary_.post_transition_verbal_subset.templates.at(std::to_string(phrase_id));
 
   // Replace phrase tags with values
-  boost::replace_all(instruction, kLengthTag,
-                     FormLength(maneuver, dictionary_.post_transition_verbal_subset.metric_lengths,
-                                dictionary_.post_transition_verbal_subset.us_customary_lengths));
-  boost::replace_all(instruction, kStreetNamesTag, street_names);
+  std::string length = FormLength(maneuver,
+                                  dictionary_.post_transition_verbal_subset.metric_lengths,
+                                  dictionary_.post_transition_verbal_subset.us_customary_lengths);
+  phrase.Render(instruction, {{kLengthTag, length}, {kStreetNamesTag, street_names}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -3896,13 +3925,13 @@ std::string NarrativeBuilder::FormVerbalPostTransitionTransitInstruction(Maneuve
                                                     .transit_stop_count_labels);
 
   // Set instruction to the determined tagged phrase
-  instruction =
-      dictionary_.post_transition_transit_verbal_subset.phrases.at(std::to_string(phrase_id));
+  const auto& phrase =
+      dictionary_.post_transition_transit_verbal_subset.templates.at(std::to_string(phrase_id));
 
   // Replace phrase tags with values
-  boost::replace_all(instruction, kTransitPlatformCountTag,
-                     std::to_string(stop_count)); // TODO: locale specific numerals
-  boost::replace_all(instruction, kTransitPlatformCountLabelTag, stop_count_label);
+  // TODO: locale specific numerals
+  phrase.Render(instruction, {{kTransitPlatformCountTag, std::to_string(stop_count)},
+                              {kTransitPlatformCountLabelTag, stop_count_label}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -3947,13 +3976,12 @@ std::string NarrativeBuilder::FormVerbalSuccinctStartTransitionInstruction(Maneu
   }
 
   // Set instruction to the determined tagged phrase
-  instruction = dictionary_.start_verbal_subset.phrases.at(std::to_string(phrase_id));
+  const auto& phrase = dictionary_.start_verbal_subset.templates.at(std::to_string(phrase_id));
 
   // Replace phrase tags with values
-  boost::replace_all(instruction, kCardinalDirectionTag, cardinal_direction);
-  boost::replace_all(instruction, kLengthTag,
-                     FormLength(maneuver, dictionary_.start_verbal_subset.metric_lengths,
-                                dictionary_.start_verbal_subset.us_customary_lengths));
+  std::string length = FormLength(maneuver, dictionary_.start_verbal_subset.metric_lengths,
+                                  dictionary_.start_verbal_subset.us_customary_lengths);
+  phrase.Render(instruction, {{kCardinalDirectionTag, cardinal_direction}, {kLengthTag, length}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -4013,13 +4041,14 @@ NarrativeBuilder::FormVerbalSuccinctTurnTransitionInstruction(Maneuver& maneuver
   }
 
   // Set instruction to the determined tagged phrase
-  instruction = subset->phrases.at(std::to_string(phrase_id));
+  const auto& phrase = subset->templates.at(std::to_string(phrase_id));
 
   // Replace phrase tags with values
-  boost::replace_all(instruction, kRelativeDirectionTag,
-                     FormRelativeTwoDirection(maneuver.type(), subset->relative_directions));
-  boost::replace_all(instruction, kJunctionNameTag, junction_name);
-  boost::replace_all(instruction, kTowardSignTag, guide_sign);
+  std::string relative_direction =
+      FormRelativeTwoDirection(maneuver.type(), subset->relative_directions);
+  phrase.Render(instruction, {{kRelativeDirectionTag, relative_direction},
+                              {kJunctionNameTag, junction_name},
+                              {kTowardSignTag, guide_sign}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -4059,14 +4088,15 @@ NarrativeBuilder::FormVerbalSuccinctUturnTransitionInstruction(Maneuver& maneuve
                                                maneuver.verbal_formatter(), &markup_formatter_);
   }
   // Set instruction to the determined tagged phrase
-  instruction = dictionary_.uturn_verbal_subset.phrases.at(std::to_string(phrase_id));
+  const auto& phrase = dictionary_.uturn_verbal_subset.templates.at(std::to_string(phrase_id));
 
   // Replace phrase tags with values
-  boost::replace_all(instruction, kRelativeDirectionTag,
-                     FormRelativeTwoDirection(maneuver.type(),
-                                              dictionary_.uturn_verbal_subset.relative_directions));
-  boost::replace_all(instruction, kJunctionNameTag, junction_name);
-  boost::replace_all(instruction, kTowardSignTag, guide_sign);
+  std::string relative_direction =
+      FormRelativeTwoDirection(maneuver.type(),
+                               dictionary_.uturn_verbal_subset.relative_directions);
+  phrase.Render(instruction, {{kRelativeDirectionTag, relative_direction},
+                              {kJunctionNameTag, junction_name},
+                              {kTowardSignTag, guide_sign}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -4111,11 +4141,11 @@ NarrativeBuilder::FormVerbalSuccinctMergeTransitionInstruction(Maneuver& maneuve
   }
 
   // Set instruction to the determined tagged phrase
-  instruction = dictionary_.merge_verbal_subset.phrases.at(std::to_string(phrase_id));
+  const auto& phrase = dictionary_.merge_verbal_subset.templates.at(std::to_string(phrase_id));
 
   // Replace phrase tags with values
-  boost::replace_all(instruction, kRelativeDirectionTag, relative_direction);
-  boost::replace_all(instruction, kTowardSignTag, guide_sign);
+  phrase.Render(instruction, {{kRelativeDirectionTag, relative_direction},
+                              {kTowardSignTag, guide_sign}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -4159,11 +4189,11 @@ std::string NarrativeBuilder::FormVerbalSuccinctEnterRoundaboutTransitionInstruc
   }
 
   // Set instruction to the determined tagged phrase
-  instruction = dictionary_.enter_roundabout_verbal_subset.phrases.at(std::to_string(phrase_id));
+  const auto& phrase =
+      dictionary_.enter_roundabout_verbal_subset.templates.at(std::to_string(phrase_id));
 
   // Replace phrase tags with values
-  boost::replace_all(instruction, kOrdinalValueTag, ordinal_value);
-  boost::replace_all(instruction, kTowardSignTag, guide_sign);
+  phrase.Render(instruction, {{kOrdinalValueTag, ordinal_value}, {kTowardSignTag, guide_sign}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -4195,9 +4225,10 @@ std::string NarrativeBuilder::FormVerbalSuccinctExitRoundaboutTransitionInstruct
   }
 
   // Set instruction to the determined tagged phrase
-  instruction = dictionary_.exit_roundabout_verbal_subset.phrases.at(std::to_string(phrase_id));
+  const auto& phrase =
+      dictionary_.exit_roundabout_verbal_subset.templates.at(std::to_string(phrase_id));
 
-  boost::replace_all(instruction, kTowardSignTag, guide_sign);
+  phrase.Render(instruction, {{kTowardSignTag, guide_sign}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -4224,10 +4255,10 @@ std::string NarrativeBuilder::FormElevatorInstruction(Maneuver& maneuver) {
   }
 
   // Set instruction to the determined tagged phrase
-  instruction = dictionary_.elevator_subset.phrases.at(std::to_string(phrase_id));
+  const auto& phrase = dictionary_.elevator_subset.templates.at(std::to_string(phrase_id));
 
   // Replace phrase tags with values
-  boost::replace_all(instruction, kLevelTag, end_level);
+  phrase.Render(instruction, {{kLevelTag, end_level}});
 
   return instruction;
 }
@@ -4249,10 +4280,10 @@ std::string NarrativeBuilder::FormStepsInstruction(Maneuver& maneuver) {
   }
 
   // Set instruction to the determined tagged phrase
-  instruction = dictionary_.steps_subset.phrases.at(std::to_string(phrase_id));
+  const auto& phrase = dictionary_.steps_subset.templates.at(std::to_string(phrase_id));
 
   // Replace phrase tags with values
-  boost::replace_all(instruction, kLevelTag, end_level);
+  phrase.Render(instruction, {{kLevelTag, end_level}});
 
   return instruction;
 }
@@ -4272,10 +4303,10 @@ std::string NarrativeBuilder::FormGenericLevelChangeInstruction(Maneuver& maneuv
   }
 
   // Set instruction to the determined tagged phrase
-  instruction = dictionary_.level_change_subset.phrases.at(std::to_string(phrase_id));
+  const auto& phrase = dictionary_.level_change_subset.templates.at(std::to_string(phrase_id));
 
   // Replace phrase tags with values
-  boost::replace_all(instruction, kLevelTag, end_level);
+  phrase.Render(instruction, {{kLevelTag, end_level}});
 
   return instruction;
 }
@@ -4310,10 +4341,10 @@ std::string NarrativeBuilder::FormEscalatorInstruction(Maneuver& maneuver) {
   }
 
   // Set instruction to the determined tagged phrase
-  instruction = dictionary_.escalator_subset.phrases.at(std::to_string(phrase_id));
+  const auto& phrase = dictionary_.escalator_subset.templates.at(std::to_string(phrase_id));
 
   // Replace phrase tags with values
-  boost::replace_all(instruction, kLevelTag, end_level);
+  phrase.Render(instruction, {{kLevelTag, end_level}});
 
   return instruction;
 }
@@ -4337,10 +4368,10 @@ std::string NarrativeBuilder::FormEnterBuildingInstruction(Maneuver& maneuver) {
   }
 
   // Set instruction to the determined tagged phrase
-  instruction = dictionary_.enter_building_subset.phrases.at(std::to_string(phrase_id));
+  const auto& phrase = dictionary_.enter_building_subset.templates.at(std::to_string(phrase_id));
 
   // Replace phrase tags with values
-  boost::replace_all(instruction, kStreetNamesTag, street_names);
+  phrase.Render(instruction, {{kStreetNamesTag, street_names}});
 
   return instruction;
 }
@@ -4364,10 +4395,10 @@ std::string NarrativeBuilder::FormExitBuildingInstruction(Maneuver& maneuver) {
   }
 
   // Set instruction to the determined tagged phrase
-  instruction = dictionary_.exit_building_subset.phrases.at(std::to_string(phrase_id));
+  const auto& phrase = dictionary_.exit_building_subset.templates.at(std::to_string(phrase_id));
 
   // Replace phrase tags with values
-  boost::replace_all(instruction, kStreetNamesTag, street_names);
+  phrase.Render(instruction, {{kStreetNamesTag, street_names}});
 
   return instruction;
 }
@@ -4417,10 +4448,10 @@ std::string NarrativeBuilder::FormPassInstruction(Maneuver& maneuver) {
   }
 
   // Set instruction to the determined tagged phrase
-  instruction = dictionary_.pass_subset.phrases.at(std::to_string(phrase_id));
+  const auto& phrase = dictionary_.pass_subset.templates.at(std::to_string(phrase_id));
 
   // Replace phrase tags with values
-  boost::replace_all(instruction, kObjectLabelTag, object_label);
+  phrase.Render(instruction, {{kObjectLabelTag, object_label}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -4848,14 +4879,15 @@ std::string NarrativeBuilder::FormVerbalMultiCue(Maneuver& maneuver,
   if (maneuver.distant_verbal_multi_cue()) {
     phrase_id = 1;
   }
-  instruction = dictionary_.verbal_multi_cue_subset.phrases.at(std::to_string(phrase_id));
+  const auto& phrase = dictionary_.verbal_multi_cue_subset.templates.at(std::to_string(phrase_id));
 
   // Replace phrase tags with values
-  boost::replace_all(instruction, kCurrentVerbalCueTag, first_verbal_cue);
-  boost::replace_all(instruction, kNextVerbalCueTag, second_verbal_cue);
-  boost::replace_all(instruction, kLengthTag,
-                     FormLength(maneuver, dictionary_.post_transition_verbal_subset.metric_lengths,
-                                dictionary_.post_transition_verbal_subset.us_customary_lengths));
+  std::string length = FormLength(maneuver,
+                                  dictionary_.post_transition_verbal_subset.metric_lengths,
+                                  dictionary_.post_transition_verbal_subset.us_customary_lengths);
+  phrase.Render(instruction, {{kCurrentVerbalCueTag, first_verbal_cue},
+                              {kNextVerbalCueTag, second_verbal_cue},
+                              {kLengthTag, length}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -0,0 +1,77 @@
+#include "odin/phrase_template.h"
+
+namespace {
+
+// phrase tags are an upper case name with underscores in angle brackets, ie: <STREET_NAMES>
+bool IsTagCharacter(char c) {
+  return (c >= 'A' && c <= 'Z') || c == '_';
+}
+
+} // namespace
+
+namespace valhalla {
+namespace odin {
+
+PhraseTemplate::PhraseTemplate(std::string phrase) : phrase_(std::move(phrase)) {
+  size_t literal_begin = 0;
+  size_t pos = 0;
+  while ((pos = phrase_.find('<', pos)) != std::string::npos) {
+    // find the end of what could be a tag
+    size_t end = pos + 1;
+    while (end < phrase_.size() && IsTagCharacter(phrase_[end])) {
+      ++end;
+    }
+
+    // not a tag so its part of the literal text, keep going after the bracket
+    if (end == pos + 1 || end == phrase_.size() || phrase_[end] != '>') {
+      ++pos;
+      continue;
+    }
+
+    // close off the literal text before the tag and add the tag itself
+    if (pos > literal_begin) {
+      tokens_.push_back({static_cast<uint32_t>(literal_begin),
+                         static_cast<uint32_t>(pos - literal_begin), false});
+    }
+    tokens_.push_back({static_cast<uint32_t>(pos), static_cast<uint32_t>(end + 1 - pos), true});
+    literal_begin = pos = end + 1;
+  }
+
+  // whatever is left over is literal text
+  if (literal_begin < phrase_.size()) {
+    tokens_.push_back({static_cast<uint32_t>(literal_begin),
+                       static_cast<uint32_t>(phrase_.size() - literal_begin), false});
+  }
+}
+
+void PhraseTemplate::Render(std::string& output,
+                            const TagValue* values_begin,
+                            const TagValue* values_end) const {
+  // resolve the value of each token up front so we can size the output exactly once
+  thread_local std::vector<std::string_view> parts;
+  parts.clear();
+  size_t size = 0;
+  for (const auto& token : tokens_) {
+    std::string_view part(phrase_.data() + token.offset, token.length);
+    if (token.tag) {
+      for (const auto* value = values_begin; value != values_end; ++value) {
+        if (value->first == part) {
+          part = value->second;
+          break;
+        }
+      }
+    }
+    size += part.size();
+    parts.push_back(part);
+  }
+
+  // write it out in one go
+  output.clear();
+  output.reserve(size);
+  for (const auto& part : parts) {
+    output.append(part);
+  }
+}
+
+} // namespace odin
+} // namespace valhalla
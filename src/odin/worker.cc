@@ -5,6 +5,7 @@
 
 #include <boost/property_tree/ptree.hpp>
 
+#include <algorithm>
 #include <functional>
 #include <string>
 
@@ -17,7 +18,8 @@ namespace valhalla {
 namespace odin {
 
 odin_worker_t::odin_worker_t(const boost::property_tree::ptree& config)
-    : service_worker_t(config), markup_formatter_(config) {
+    : service_worker_t(config), markup_formatter_(config),
+      concurrency_(std::max(1u, config.get<unsigned int>("odin.concurrency", 1))) {
   // signal that the worker started successfully
   started();
 }
@@ -31,7 +33,7 @@ std::string odin_worker_t::narrate(Api& request) const {
 
   // get some annotated directions
   try {
-    odin::DirectionsBuilder().Build(request, markup_formatter_);
+    odin::DirectionsBuilder().Build(request, markup_formatter_, concurrency_);
   } catch (const std::exception& e) { throw valhalla_exception_t{202, e.what()}; }
 
   // serialize those to the proper format
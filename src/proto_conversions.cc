@@ -125,6 +125,7 @@ bool Options_Action_Enum_Parse(const std::string& action, Options::Action* a) {
       {"centroid", Options::centroid},
       {"status", Options::status},
       {"tile", Options::tile},
+      {"accessibility", Options::accessibility},
   };
   auto i = actions.find(action);
   if (i == actions.cend())
@@ -160,6 +161,7 @@ const std::string& Options_Action_Enum_Name(const Options::Action action) {
       {Options::centroid, "centroid"},
       {Options::status, "status"},
       {Options::tile, "tile"},
+      {Options::accessibility, "accessibility"},
   };
   auto i = actions.find(action);
   return i == actions.cend() ? empty_str : i->second;
@@ -280,7 +282,7 @@ const std::string& ShapeMatch_Enum_Name(const ShapeMatch match) {
 bool Options_Format_Enum_Parse(const std::string& format, Options::Format* f) {
   static const std::unordered_map<std::string, Options::Format> formats{
       {"json", Options::json}, {"gpx", Options::gpx},         {"osrm", Options::osrm},
-      {"pbf", Options::pbf},   {"geotiff", Options::geotiff},
+      {"pbf", Options::pbf},   {"geotiff", Options::geotiff}, {"binary", Options::binary},
   };
   auto i = formats.find(format);
   if (i == formats.cend())
@@ -292,7 +294,7 @@ bool Options_Format_Enum_Parse(const std::string& format, Options::Format* f) {
 const std::string& Options_Format_Enum_Name(const Options::Format match) {
   static const std::unordered_map<int, std::string> formats{
       {Options::json, "json"}, {Options::gpx, "gpx"},         {Options::osrm, "osrm"},
-      {Options::pbf, "pbf"},   {Options::geotiff, "geotiff"},
+      {Options::pbf, "pbf"},   {Options::geotiff, "geotiff"}, {Options::binary, "binary"},
   };
   auto i = formats.find(match);
   return i == formats.cend() ? empty_str : i->second;
@@ -13,15 +13,16 @@
 #endif
 #include <sys/stat.h>
 
+#include <algorithm>
 #include <cmath>
 #include <cstddef>
 #include <filesystem>
 #include <future>
 #include <list>
+#include <numeric>
 #include <optional>
 #include <regex>
 #include <unordered_map>
-#include <unordered_set>
 
 namespace {
 // srtmgl1 holds 1x1 degree tiles but oversamples the edge of the tile
@@ -36,6 +37,9 @@ constexpr int16_t NO_DATA_HIGH = 16384;
 constexpr int16_t NO_DATA_LOW = -16384;
 constexpr size_t TILE_COUNT = 180 * 360;
 constexpr int8_t UNPACKED_TILES_COUNT = 50;
+// number of postings interpolated together by the batched sampler, wide enough to fill an avx512
+// register with doubles (or two avx2 ones) while staying cheap to handle on scalar only targets
+constexpr size_t BATCH_WIDTH = 8;
 
 // macro is faster than inline function for this...
 #define out_of_range(v) v > NO_DATA_HIGH || v < NO_DATA_LOW
@@ -44,6 +48,11 @@ int16_t flip(int16_t value) {
   return ((value & 0xFF) << 8) | ((value >> 8) & 0xFF);
 }
 
+// branchless version of flip on an unsigned value so the compiler can turn it into a vector shuffle
+inline uint16_t flip_u(uint16_t value) {
+  return static_cast<uint16_t>((value << 8) | (value >> 8));
+}
+
 uint64_t file_size(const std::string& file_name) {
   // TODO: detect gzip and actually validate the uncompressed size?
   struct stat s {};
@@ -284,13 +293,87 @@ public:
     // if we were missing some we need to adjust by that
     return value / adjust;
   }
+
+  /**
+   * Batched version of get(u, v) which interpolates up to BATCH_WIDTH postings at once. The posts
+   * are gathered first and then byte swapped and interpolated in straight line loops over plain
+   * arrays, which lets the compiler vectorize them for whatever instruction set we target. On
+   * targets without simd the same loops simply run as scalar code. The arithmetic is done in
+   * the same order as in get(u, v) so the results match the single posting path.
+   *
+   * @param u      fractional column of each posting
+   * @param v      fractional row of each posting
+   * @param count  number of postings, at most BATCH_WIDTH
+   * @param out    the sampled values
+   */
+  void get(const double* u, const double* v, size_t count, double* out) const {
+    alignas(64) double a_coef[BATCH_WIDTH], b_coef[BATCH_WIDTH], c_coef[BATCH_WIDTH],
+        d_coef[BATCH_WIDTH], has_next_row[BATCH_WIDTH];
+    alignas(64) size_t top[BATCH_WIDTH], bottom[BATCH_WIDTH];
+    alignas(16) uint16_t a_raw[BATCH_WIDTH], b_raw[BATCH_WIDTH], c_raw[BATCH_WIDTH],
+        d_raw[BATCH_WIDTH];
+
+    // integer pixels and coefficients
+    for (size_t i = 0; i < BATCH_WIDTH; ++i) {
+      // lanes past the end are computed on a copy of the last posting and simply not written out
+      auto j = i < count ? i : count - 1;
+      size_t x = std::floor(u[j]);
+      size_t y = std::floor(v[j]);
+      double u_ratio = u[j] - x;
+      double v_ratio = v[j] - y;
+      double u_inv = 1 - u_ratio;
+      double v_inv = 1 - v_ratio;
+      a_coef[i] = u_inv * v_inv;
+      b_coef[i] = u_ratio * v_inv;
+      c_coef[i] = u_inv * v_ratio;
+      d_coef[i] = u_ratio * v_ratio;
+      // when we are right on the last row we read the same row again and zero its coefficients,
+      // this keeps us from reading past the end of the image without branching per lane
+      has_next_row[i] = y < HGT_DIM - 1;
+      top[i] = y * HGT_DIM + x;
+      bottom[i] = (y < HGT_DIM - 1 ? y + 1 : y) * HGT_DIM + x;
+    }
+
+    // gather the big endian posts
+    const auto* posts = reinterpret_cast<const uint16_t*>(data);
+    for (size_t i = 0; i < BATCH_WIDTH; ++i) {
+      a_raw[i] = posts[top[i]];
+      b_raw[i] = posts[top[i] + 1];
+      c_raw[i] = posts[bottom[i]];
+      d_raw[i] = posts[bottom[i] + 1];
+    }
+
+    // byte swap, mask out the missing posts and interpolate
+    for (size_t i = 0; i < BATCH_WIDTH; ++i) {
+      double a = static_cast<int16_t>(flip_u(a_raw[i]));
+      double b = static_cast<int16_t>(flip_u(b_raw[i]));
+      double c = static_cast<int16_t>(flip_u(c_raw[i]));
+      double d = static_cast<int16_t>(flip_u(d_raw[i]));
+      double ac = (out_of_range(a)) ? 0. : a_coef[i];
+      double bc = (out_of_range(b)) ? 0. : b_coef[i];
+      double cc = (out_of_range(c)) ? 0. : c_coef[i] * has_next_row[i];
+      double dc = (out_of_range(d)) ? 0. : d_coef[i] * has_next_row[i];
+      double value = a * ac + b * bc;
+      double adjust = ac + bc;
+      value += c * cc + d * dc;
+      adjust += cc + dc;
+      a_coef[i] = adjust == 0 ? get_no_data_value() : value / adjust;
+    }
+
+    for (size_t i = 0; i < count; ++i) {
+      out[i] = a_coef[i];
+    }
+  }
 };
 
 struct cache_t {
   // Cached tiles
   std::vector<cache_item_t> cache;
-  // Set of reusable tile indexes
-  std::unordered_set<uint16_t> reusable;
+  // Reusable tile indexes, least recently used first, along with where they are in that order
+  std::list<uint16_t> reusable;
+  std::unordered_map<uint16_t, std::list<uint16_t>::iterator> reusable_positions;
+  // How many tiles to keep unpacked before reusing the memory of the least recently used ones
+  size_t max_unpacked = UNPACKED_TILES_COUNT;
   // Map of pending tiles. No matter how many requests received, only one inflate job per tile
   // started.
   std::unordered_map<uint16_t, std::shared_future<tile_data>> pending_tiles;
@@ -367,6 +450,10 @@ tile_data cache_t::source(uint16_t index) {
   // item in cache is already unpacked
   const char* unpacked = item.get_unpacked();
   if (unpacked) {
+    auto position = reusable_positions.find(index);
+    if (position != reusable_positions.end()) {
+      reusable.splice(reusable.end(), reusable, position->second);
+    }
     auto rv = tile_data(this, index, true, (const int16_t*)unpacked);
     mutex.unlock();
     return rv;
@@ -375,11 +462,13 @@ tile_data cache_t::source(uint16_t index) {
   std::promise<tile_data> promise;
   it = pending_tiles.emplace(index, promise.get_future()).first;
 
-  if (reusable.size() >= UNPACKED_TILES_COUNT) {
-    for (auto i : reusable) {
-      if (cache[i].get_usages() <= 0) {
+  // reuse the memory of the least recently used tile nobody is sampling from at the moment
+  if (reusable.size() >= max_unpacked) {
+    for (auto i = reusable.begin(); i != reusable.end(); ++i) {
+      if (cache[*i].get_usages() <= 0) {
+        unpacked = cache[*i].detach_unpacked();
+        reusable_positions.erase(*i);
         reusable.erase(i);
-        unpacked = cache[i].detach_unpacked();
         break;
       }
     }
@@ -387,7 +476,7 @@ tile_data cache_t::source(uint16_t index) {
   if (!unpacked) {
     unpacked = (char*)malloc(HGT_BYTES);
   }
-  reusable.insert(index);
+  reusable_positions[index] = reusable.insert(reusable.end(), index);
   auto rv = tile_data(this, index, true, (const int16_t*)unpacked);
   mutex.unlock();
 
@@ -439,6 +528,12 @@ sample::sample(const boost::property_tree::ptree& pt)
 
   // this line used only for testing, for more details check elevation_builder.cc
   remote_path_ = pt.get<std::string>("additional_data.elevation_dir", "");
+
+  // bound the memory of the decompressed tiles, they are shared by every thread sampling from us
+  auto cache_mb = pt.get<size_t>("additional_data.elevation_cache_mb", 0);
+  if (cache_mb) {
+    cache_->max_unpacked = std::max<size_t>(1, cache_mb * 1024 * 1024 / HGT_BYTES);
+  }
 }
 
 sample::sample(const std::string& data_source) {
@@ -484,12 +579,63 @@ template <class coord_t> double sample::get(const coord_t& coord) {
 }
 
 template <class coords_t> std::vector<double> sample::get_all(const coords_t& coords) {
-  std::vector<double> values;
-  values.reserve(coords.size());
+  // figure out which tile each posting lands in and its fractional pixel within that tile
+  std::vector<uint16_t> indices;
+  std::vector<double> us, vs;
+  indices.reserve(coords.size());
+  us.reserve(coords.size());
+  vs.reserve(coords.size());
+  for (const auto& coord : coords) {
+    auto lon = std::floor(coord.first);
+    auto lat = std::floor(coord.second);
+    indices.push_back(static_cast<uint16_t>(lat + 90) * 360 + static_cast<uint16_t>(lon + 180));
+    // NOTE: data is arranged from upper left to bottom right, so y is flipped
+    us.push_back((coord.first - lon) * (HGT_DIM - 1));
+    vs.push_back((1.0 - (coord.second - lat)) * (HGT_DIM - 1));
+  }
+
+  // group the postings by tile, most shapes never leave their tile so skip the sort if we can
+  std::vector<uint32_t> order(indices.size());
+  std::iota(order.begin(), order.end(), 0);
+  if (!std::is_sorted(indices.begin(), indices.end())) {
+    std::stable_sort(order.begin(), order.end(),
+                     [&indices](uint32_t a, uint32_t b) { return indices[a] < indices[b]; });
+  }
 
+  std::vector<double> values(indices.size(), get_no_data_value());
+  alignas(64) double u[BATCH_WIDTH], v[BATCH_WIDTH], out[BATCH_WIDTH];
   tile_data tile;
-  for (const auto& coord : coords) {
-    values.emplace_back(get(coord, tile));
+  for (auto run = order.begin(); run != order.end();) {
+    // find the postings that share this tile
+    auto index = indices[*run];
+    auto run_end = std::find_if(run, order.end(),
+                                [&indices, index](uint32_t i) { return indices[i] != index; });
+
+    // get the tile once for the whole run, fetching it remotely if we have to
+    tile = cache_->source(index);
+    if (!tile && fetch(index)) {
+      tile = cache_->source(index);
+    }
+
+    // nothing to do but leave the no data values in place
+    if (!tile) {
+      run = run_end;
+      continue;
+    }
+
+    // interpolate the whole run in batches
+    while (run != run_end) {
+      size_t count = std::min<size_t>(BATCH_WIDTH, run_end - run);
+      for (size_t i = 0; i < count; ++i) {
+        u[i] = us[run[i]];
+        v[i] = vs[run[i]];
+      }
+      tile.get(u, v, count, out);
+      for (size_t i = 0; i < count; ++i) {
+        values[run[i]] = out[i];
+      }
+      run += count;
+    }
   }
 
   return values;
@@ -0,0 +1,198 @@
+#include "thor/accessibility.h"
+#include "baldr/graphconstants.h"
+
+#include <algorithm>
+#include <limits>
+
+using namespace valhalla::midgard;
+using namespace valhalla::baldr;
+using namespace valhalla::sif;
+
+namespace {
+
+constexpr size_t kRoadClassCount = static_cast<size_t>(RoadClass::kInvalid);
+
+// How much of the stretch from a0 to a1 of some metric is within the limit
+float reached_fraction(const float a0, const float a1, const float limit) {
+  if (a1 <= limit) {
+    return 1.f;
+  }
+  if (a0 >= limit) {
+    return 0.f;
+  }
+  return (limit - a0) / (a1 - a0);
+}
+
+} // namespace
+
+namespace valhalla {
+namespace thor {
+
+// Default constructor
+Accessibility::Accessibility(const boost::property_tree::ptree& config)
+    : Dijkstras(config), max_seconds_(0.f), max_meters_(0.f) {
+}
+
+// Index the targets by the edges they were correlated to
+void Accessibility::SetTargets(
+    const google::protobuf::RepeatedPtrField<valhalla::Location>& targets) {
+  target_edges_.clear();
+  for (int i = 0; i < targets.size(); ++i) {
+    for (const auto& edge : targets.Get(i).correlation().edges()) {
+      target_edges_.emplace(edge.graph_id(),
+                            std::make_pair(static_cast<uint32_t>(i),
+                                           static_cast<float>(edge.percent_along())));
+    }
+  }
+  target_reached_.resize(targets.size());
+}
+
+// Expand from the locations and sum up the scores of what was reached
+void Accessibility::Expand(const ExpansionType& expansion_type,
+                           Api& api,
+                           GraphReader& reader,
+                           const sif::mode_costing_t& mode_costing,
+                           const travel_mode_t mode,
+                           valhalla::Accessibility::Origin& origin) {
+  // Each contour has a limit per metric, the expansion stops once it is beyond all of them
+  contours_.clear();
+  max_seconds_ = max_meters_ = std::numeric_limits<float>::lowest();
+  for (const auto& contour : api.options().contours()) {
+    if (contour.has_time_case()) {
+      contours_.push_back({true, contour.time() * kSecPerMinute});
+      max_seconds_ = std::max(max_seconds_, contours_.back().limit);
+    }
+    if (contour.has_distance_case()) {
+      contours_.push_back({false, contour.distance() * kMetersPerKm});
+      max_meters_ = std::max(max_meters_, contours_.back().limit);
+    }
+  }
+  scores_.assign(contours_.size(), score_t{0.0, 0, std::vector<uint32_t>(kRoadClassCount, 0), 0});
+  std::fill(target_reached_.begin(), target_reached_.end(),
+            std::make_pair(std::numeric_limits<float>::max(), std::numeric_limits<float>::max()));
+
+  // Compute the expansion
+  Dijkstras::Expand(expansion_type, api, reader, mode_costing, mode);
+
+  // Count the targets reached within each contour
+  for (const auto& reached : target_reached_) {
+    for (size_t i = 0; i < contours_.size(); ++i) {
+      if ((contours_[i].time ? reached.first : reached.second) <= contours_[i].limit) {
+        ++scores_[i].targets;
+      }
+    }
+  }
+
+  origin.Clear();
+  for (size_t i = 0; i < contours_.size(); ++i) {
+    auto* score = origin.add_scores();
+    score->set_metric(contours_[i].time ? valhalla::Accessibility::time
+                                        : valhalla::Accessibility::distance);
+    score->set_metric_value(contours_[i].time ? contours_[i].limit * kMinPerSec
+                                              : contours_[i].limit * kKmPerMeter);
+    score->set_length(scores_[i].length);
+    score->set_edges(scores_[i].edges);
+    score->mutable_road_class_edges()->Add(scores_[i].road_class_edges.begin(),
+                                           scores_[i].road_class_edges.end());
+    score->set_targets(scores_[i].targets);
+  }
+}
+
+// here we add the edge we just reached up to its end node to the scores
+void Accessibility::ExpandingNode(baldr::GraphReader& graphreader,
+                                  graph_tile_ptr /*tile*/,
+                                  const baldr::NodeInfo* /*node*/,
+                                  const sif::EdgeLabel& current,
+                                  const sif::EdgeLabel* previous) {
+  // Transit lines and ferries can't really be "reached" you just pass along them
+  graph_tile_ptr tile = graphreader.GetGraphTile(current.edgeid().tile_base());
+  const DirectedEdge* edge = tile->directededge(current.edgeid());
+  if (edge->IsTransitLine() || edge->use() == Use::kFerry) {
+    return;
+  }
+
+  // The time and distance at both ends of what was traversed of the edge, for the origin edges
+  // that is only the part from the location to the end node
+  float secs0 = previous ? previous->cost().secs : 0.0f;
+  float dist0 = previous ? static_cast<float>(previous->path_distance()) : 0.0f;
+  float secs1 = current.cost().secs;
+  float dist1 = static_cast<float>(current.path_distance());
+  float length = dist1 - dist0;
+
+  // The targets along the edge are reached in proportion to how far along it they are
+  auto range = target_edges_.equal_range(current.edgeid());
+  for (auto itr = range.first; itr != range.second; ++itr) {
+    float remaining = (1.f - itr->second.second) * edge->length();
+    if (remaining > length) {
+      continue;
+    }
+    float secs = length > 0.f ? secs1 - (secs1 - secs0) * remaining / length : secs1;
+    auto& reached = target_reached_[itr->second.first];
+    reached.first = std::min(reached.first, secs);
+    reached.second = std::min(reached.second, dist1 - remaining);
+  }
+
+  // Nothing was traversed of an origin edge that the location sits at the end of
+  if (length <= 0.f) {
+    return;
+  }
+
+  // Two way edges only count once, for the direction that was settled first. The origin edges
+  // are the exception since each direction only covers part of them
+  graph_tile_ptr t2;
+  GraphId opp = graphreader.GetOpposingEdgeId(current.edgeid(), t2);
+  if (edgestatus_.Get(opp).set() == EdgeSet::kPermanent && !current.origin()) {
+    return;
+  }
+
+  // Add whatever part of the edge is within each contour
+  auto road_class = static_cast<size_t>(edge->classification());
+  for (size_t i = 0; i < contours_.size(); ++i) {
+    float fraction = contours_[i].time ? reached_fraction(secs0, secs1, contours_[i].limit)
+                                       : reached_fraction(dist0, dist1, contours_[i].limit);
+    if (fraction <= 0.f) {
+      continue;
+    }
+    auto& score = scores_[i];
+    score.length += fraction * length;
+    ++score.edges;
+    if (road_class < kRoadClassCount) {
+      ++score.road_class_edges[road_class];
+    }
+  }
+}
+
+ExpansionRecommendation Accessibility::ShouldExpand(baldr::GraphReader& /*graphreader*/,
+                                                    const sif::EdgeLabel& pred,
+                                                    const ExpansionType route_type) {
+  float time;
+  uint32_t dist;
+  if (route_type == ExpansionType::multimodal) {
+    // Skip edges with large penalties (e.g. ferries?), MMCompute function will skip expanding this
+    // label. Without a time contour there is no such limit
+    if (max_seconds_ > 0.f && pred.cost().cost > max_seconds_ * 2) {
+      return ExpansionRecommendation::prune_expansion;
+    }
+    time = pred.predecessor() == kInvalidLabel ? 0.f : mmedgelabels_[pred.predecessor()].cost().secs;
+    dist =
+        pred.predecessor() == kInvalidLabel ? 0 : mmedgelabels_[pred.predecessor()].path_distance();
+  } else {
+    time = pred.predecessor() == kInvalidLabel ? 0.f : bdedgelabels_[pred.predecessor()].cost().secs;
+    dist =
+        pred.predecessor() == kInvalidLabel ? 0 : bdedgelabels_[pred.predecessor()].path_distance();
+  }
+
+  // Nothing that starts beyond every contour adds to the scores, nor does anything after it. Unlike
+  // the isochrone there is no padding, there are no grid cells around the edges to fill in
+  return (time > max_seconds_ && dist > max_meters_) ? ExpansionRecommendation::prune_expansion
+                                                     : ExpansionRecommendation::continue_expansion;
+}
+
+void Accessibility::GetExpansionHints(uint32_t& bucket_count,
+                                      uint32_t& edge_label_reservation) const {
+  bucket_count = 20000;
+  edge_label_reservation = kInitialEdgeLabelCountDijkstras;
+}
+
+} // namespace thor
+} // namespace valhalla
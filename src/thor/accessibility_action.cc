@@ -0,0 +1,47 @@
+#include "thor/worker.h"
+#include "tyr/serializers.h"
+
+using namespace valhalla::baldr;
+
+namespace valhalla {
+namespace thor {
+
+std::string thor_worker_t::accessibility(Api& request) {
+  // time this whole method and save that statistic
+  auto _ = measure_scope_time(request);
+
+  const auto& options = request.options();
+  adjust_locations(request);
+  auto costing = parse_costing(request);
+
+  bool reverse = options.reverse() || options.date_time_type() == valhalla::Options::arrive_by;
+  auto expansion_type = costing == "multimodal" || costing == "transit"
+                            ? ExpansionType::multimodal
+                            : (reverse ? ExpansionType::reverse : ExpansionType::forward);
+
+  // every location is scored on its own with a copy of the request holding just that location
+  Api single;
+  single.mutable_options()->CopyFrom(options);
+  single.mutable_options()->clear_targets();
+  single.mutable_options()->mutable_locations()->Clear();
+  auto* location = single.mutable_options()->add_locations();
+
+  // the algorithm keeps its labels and edge status arrays from one location to the next
+  accessibility_gen.SetTargets(options.targets());
+  auto* result = request.mutable_accessibility();
+  result->Clear();
+  for (const auto& l : options.locations()) {
+    if (interrupt) {
+      (*interrupt)();
+    }
+    location->CopyFrom(l);
+    accessibility_gen.Expand(expansion_type, single, *reader, mode_costing, mode,
+                             *result->add_origins());
+    accessibility_gen.Reset();
+  }
+
+  return tyr::serializeAccessibility(request);
+}
+
+} // namespace thor
+} // namespace valhalla
@@ -1,5 +1,6 @@
 #include "thor/alternates.h"
 
+#include <algorithm>
 #include <vector>
 
 using namespace valhalla::thor;
@@ -147,36 +148,60 @@ bool validate_alternate_by_stretch(const std::vector<PathInfo>& optimal_path,
 // Limited Sharing. Compare length of edge segments shared between optimal path and
 // candidate path. If they share more than kAtMostShared throw out this alternate.
 // Note that you should recover all shortcuts before call this function.
-bool validate_alternate_by_sharing(std::vector<std::unordered_set<GraphId>>& shared_edgeids,
+bool validate_alternate_by_sharing(SharedEdges& shared_edges,
                                    const std::vector<std::vector<PathInfo>>& paths,
                                    const std::vector<PathInfo>& candidate_path,
                                    float at_most_shared) {
 
   // we will calculate the overlap in edge duration between the candidate_path and paths (paths is a
   // vector of the fastest path + any alternates already chosen)
-  if (paths.size() > shared_edgeids.size())
-    shared_edgeids.resize(paths.size());
+  if (paths.size() > shared_edges.paths.size())
+    shared_edges.paths.resize(paths.size());
+
+  // sort the candidate's edges once, remembering where on the path each of them is. A path can
+  // have the same edge more than once, every one of them counts
+  auto& candidate = shared_edges.candidate;
+  candidate.clear();
+  candidate.reserve(candidate_path.size());
+  for (uint32_t j = 0; j < candidate_path.size(); ++j)
+    candidate.emplace_back(candidate_path[j].edgeid, j);
+  std::sort(candidate.begin(), candidate.end());
 
   // we check each accepted path against the candidate
+  auto& hits = shared_edges.hits;
   for (size_t i = 0; i < paths.size(); ++i) {
-    // cache edge ids encountered on the current best path. Don't care about shortcuts because they
+    // cache the sorted edge ids of the current best path. Don't care about shortcuts because they
     // have already been recovered.
-    auto& shared = shared_edgeids[i];
+    auto& shared = shared_edges.paths[i];
     if (shared.empty()) {
+      shared.reserve(paths[i].size());
       for (const auto& pi : paths[i])
-        shared.insert(pi.edgeid);
+        shared.push_back(pi.edgeid);
+      std::sort(shared.begin(), shared.end());
+      shared.erase(std::unique(shared.begin(), shared.end()), shared.end());
     }
 
     // if an edge on the candidate_path is encountered that is also on one of the existing paths,
-    // we count it as a "shared" edge
+    // we count it as a "shared" edge. Both are sorted so a single pass over them marks them all
+    hits.assign(candidate_path.size(), false);
+    auto shared_itr = shared.cbegin();
+    for (const auto& c : candidate) {
+      shared_itr = std::lower_bound(shared_itr, shared.cend(), c.first);
+      if (shared_itr == shared.cend())
+        break;
+      if (*shared_itr == c.first)
+        hits[c.second] = true;
+    }
+
+    // sum up the shared lengths in path order so the total is exactly what it always was
     float shared_length = 0.f;
-    for (const auto& cpi : candidate_path) {
-      const auto length = &cpi == &candidate_path.front()
-                              ? cpi.path_distance
-                              : cpi.path_distance - (&cpi - 1)->path_distance;
-      if (shared.find(cpi.edgeid) != shared.end()) {
-        shared_length += length;
-      }
+    for (size_t j = 0; j < candidate_path.size(); ++j) {
+      if (!hits[j])
+        continue;
+      const auto& cpi = candidate_path[j];
+      const auto length =
+          j == 0 ? cpi.path_distance : cpi.path_distance - (&cpi - 1)->path_distance;
+      shared_length += length;
     }
 
     // throw this alternate away if any of the chosen paths shares more than at_most_shared with it
@@ -314,13 +314,14 @@ inline bool BidirectionalAStar::ExpandInner(baldr::GraphReader& graphreader,
   if (t2 == nullptr && !get_opp_edge_data())
     return false;
 
-  const auto& end_node_ll = t2->get_node_ll(meta.edge->endnode());
-
-  // Find the sort cost (with A* heuristic) using the lat,lng at the
-  // end node of the directed edge.
-  float dist = 0.0f;
-  float sortcost = newcost.cost + (FORWARD ? astarheuristic_forward_.Get(end_node_ll, dist)
-                                           : astarheuristic_reverse_.Get(end_node_ll, dist));
+  // Find the sort cost (with A* heuristic) using the lat,lng at the end node of the directed
+  // edge. Expand has computed the distances of the end nodes of the node's edges in its tile
+  const bool batched = heuristic_batch_.Has(meta.edge_id, meta.edge);
+  const auto end_node_ll = batched ? midgard::PointLL{} : t2->get_node_ll(meta.edge->endnode());
+  const auto& heuristic = FORWARD ? astarheuristic_forward_ : astarheuristic_reverse_;
+  float dist =
+      batched ? heuristic_batch_.Distance(meta.edge_id) : heuristic.GetDistance(end_node_ll);
+  float sortcost = newcost.cost + heuristic.Get(dist);
 
   // not_thru_pruning_ is only set to false on the 2nd pass in route_action.
   // We allow settling not_thru edges so we can connect both trees on them.
@@ -335,7 +336,8 @@ inline bool BidirectionalAStar::ExpandInner(baldr::GraphReader& graphreader,
         kUnlimitedTransitions) {
       // Override distance to the destination with a distance from the origin.
       // It will be used by hierarchy limits
-      dist = astarheuristic_reverse_.GetDistance(end_node_ll);
+      dist = batched ? heuristic_batch_.Distance(meta.edge_id, 1)
+                     : astarheuristic_reverse_.GetDistance(end_node_ll);
     }
     edgelabels_forward_.emplace_back(pred_idx, meta.edge_id, opp_edge_id, meta.edge, newcost,
                                      sortcost, dist, mode_, transition_cost, not_thru_pruning,
@@ -354,7 +356,8 @@ inline bool BidirectionalAStar::ExpandInner(baldr::GraphReader& graphreader,
         kUnlimitedTransitions) {
       // Override distance to the origin with a distance from the destination.
       // It will be used by hierarchy limits
-      dist = astarheuristic_forward_.GetDistance(end_node_ll);
+      dist = batched ? heuristic_batch_.Distance(meta.edge_id, 1)
+                     : astarheuristic_forward_.GetDistance(end_node_ll);
     }
     edgelabels_reverse_.emplace_back(pred_idx, meta.edge_id, opp_edge_id, meta.edge, newcost,
                                      sortcost, dist, mode_, transition_cost, not_thru_pruning,
@@ -419,6 +422,15 @@ void BidirectionalAStar::Expand(baldr::GraphReader& graphreader,
 
   auto& edgestatus = FORWARD ? edgestatus_forward_ : edgestatus_reverse_;
 
+  // Compute the heuristics of the end nodes of all the edges at once, the distance from the other
+  // end is only used by the hierarchy limits
+  heuristic_batch_.Gather(node, tile, nodeinfo);
+  heuristic_batch_.Compute(FORWARD ? astarheuristic_forward_ : astarheuristic_reverse_);
+  if ((FORWARD ? hierarchy_limits_forward_ : hierarchy_limits_reverse_)[node.level()]
+          .max_up_transitions() != kUnlimitedTransitions) {
+    heuristic_batch_.Compute(FORWARD ? astarheuristic_reverse_ : astarheuristic_forward_, 1);
+  }
+
   // If we encounter a node with an access restriction like a barrier we allow a uturn
   if (!costing_->Allowed(nodeinfo)) {
     const DirectedEdge* opp_edge = nullptr;
@@ -1224,7 +1236,7 @@ std::vector<std::vector<PathInfo>> BidirectionalAStar::FormPath(GraphReader& gra
     filter_alternates_by_stretch(best_connections_);
   }
   // For looking up edge ids on previously chosen best paths
-  std::vector<std::unordered_set<GraphId>> shared_edgeids;
+  SharedEdges shared_edges;
 
   // get maximum amount of sharing parameter based on origin->destination distance
   float max_sharing = desired_paths_count_ > 1 ? get_max_sharing(origin, dest) : 0.f;
@@ -1382,7 +1394,7 @@ std::vector<std::vector<PathInfo>> BidirectionalAStar::FormPath(GraphReader& gra
     }
 
     // For the first path just add it for subsequent paths only add if it passes viability tests
-    if (paths.empty() || (validate_alternate_by_sharing(shared_edgeids, paths, path, max_sharing) &&
+    if (paths.empty() || (validate_alternate_by_sharing(shared_edges, paths, path, max_sharing) &&
                           validate_alternate_by_stretch(paths.front(), path) &&
                           validate_alternate_by_local_optimality(path))) {
       paths.emplace_back(std::move(path));
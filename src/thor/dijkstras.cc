@@ -8,6 +8,13 @@ using namespace valhalla::midgard;
 using namespace valhalla::baldr;
 using namespace valhalla::sif;
 
+namespace {
+
+// The most edge statuses Reset keeps allocated for the next expansion (16MB)
+constexpr size_t kMaxReusedEdgeStatuses = 4 * 1024 * 1024;
+
+} // namespace
+
 namespace valhalla {
 namespace thor {
 
@@ -21,7 +28,18 @@ Dijkstras::Dijkstras(const boost::property_tree::ptree& config)
 
 // Clear the temporary information generated during path construction.
 void Dijkstras::Clear() {
-  // Clear the edge labels, edge status flags, and adjacency list
+  ClearLabels();
+  edgestatus_.clear();
+}
+
+// Clear the temporary information but keep the edge status arrays for the next expansion
+void Dijkstras::Reset() {
+  ClearLabels();
+  edgestatus_.reset(kMaxReusedEdgeStatuses);
+}
+
+void Dijkstras::ClearLabels() {
+  // Clear the edge labels and adjacency list
   // TODO - clear only the edge label set that was used?
   auto reservation = clear_reserved_memory_ ? 0 : max_reserved_labels_count_;
   if (bdedgelabels_.size() > reservation) {
@@ -37,7 +55,6 @@ void Dijkstras::Clear() {
 
   adjacencylist_.clear();
   mmadjacencylist_.clear();
-  edgestatus_.clear();
 }
 
 // Initialize - create adjacency list, edgestatus support, and reserve
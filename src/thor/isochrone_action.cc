@@ -1,13 +1,30 @@
 #include "thor/worker.h"
 #include "tyr/serializers.h"
 
+#include <chrono>
+#include <condition_variable>
+#include <exception>
+#include <mutex>
+#include <thread>
+
 using namespace valhalla::baldr;
 using namespace valhalla::midgard;
 
+namespace {
+
+// How many finished isochrones per thread may wait for an earlier one before the threads pause
+constexpr uint32_t kBatchWindowPerThread = 4;
+
+// How often the streaming thread checks the interrupt while it waits for the next isochrone
+constexpr std::chrono::milliseconds kBatchInterruptInterval(100);
+
+} // namespace
+
 namespace valhalla {
 namespace thor {
 
-std::string thor_worker_t::isochrones(Api& request) {
+std::string thor_worker_t::isochrones(Api& request,
+                                      const std::function<void(const char*, size_t)>* sink) {
   // time this whole method and save that statistic
   auto _ = measure_scope_time(request);
 
@@ -36,6 +53,8 @@ std::string thor_worker_t::isochrones(Api& request) {
   auto expansion_type = costing == "multimodal" || costing == "transit"
                             ? ExpansionType::multimodal
                             : (reverse ? ExpansionType::reverse : ExpansionType::forward);
+  if (options.batch())
+    return batch_isochrones(request, intervals, expansion_type, sink);
   auto grid = isochrone_gen.Expand(expansion_type, request, *reader, mode_costing, mode);
 
   // e.g. in case of /expansion request
@@ -43,8 +62,151 @@ std::string thor_worker_t::isochrones(Api& request) {
     return "";
 
   // make the final output (pbf, json or geotiff)
-  std::string ret = tyr::serializeIsochrones(request, intervals, grid);
+  std::string ret =
+      tyr::serializeIsochrones(request, intervals, grid, sink, isochrone_contour_concurrency);
+
+  return ret;
+}
+
+std::string
+thor_worker_t::batch_isochrones(Api& request,
+                                const std::vector<GriddedData<2>::contour_interval_t>& intervals,
+                                const ExpansionType expansion_type,
+                                const std::function<void(const char*, size_t)>* sink) {
+  const auto& locations = request.options().locations();
+  const int count = locations.size();
+
+  // the feature collections are written as a json array in the order of the locations
+  std::string ret;
+  auto write = [&](const std::string& part) {
+    if (sink) {
+      (*sink)(part.data(), part.size());
+    } else {
+      ret += part;
+    }
+  };
+
+  // every thread makes its isochrones with a copy of the request holding a single location
+  auto make_single = [&request]() {
+    Api single;
+    single.mutable_options()->CopyFrom(request.options());
+    single.mutable_options()->mutable_locations()->Clear();
+    single.mutable_options()->add_locations();
+    single.mutable_info()->mutable_warnings()->CopyFrom(request.info().warnings());
+    return single;
+  };
+  // the algorithm keeps its labels, edge status arrays and grid from one location to the next
+  auto isochrone_at = [&](Isochrone& algorithm, GraphReader& graphreader, Api& single, int index) {
+    single.mutable_options()->mutable_locations(0)->CopyFrom(locations.Get(index));
+    auto grid = algorithm.Expand(expansion_type, single, graphreader, mode_costing, mode);
+    auto single_intervals = intervals;
+    auto json = tyr::serializeIsochrones(single, single_intervals, grid, nullptr);
+    grid.reset();
+    algorithm.Reset();
+    return json;
+  };
 
+  // With a single thread (or location) we simply make them one after the other
+  uint32_t concurrency = std::min<uint32_t>(isochrone_workers_.size() + 1, count);
+  if (concurrency <= 1) {
+    Api single = make_single();
+    for (int index = 0; index < count; ++index) {
+      if (interrupt) {
+        (*interrupt)();
+      }
+      write(index == 0 ? "[" : ",");
+      write(isochrone_at(isochrone_gen, *reader, single, index));
+    }
+    write("]");
+    return ret;
+  }
+
+  // Otherwise the threads take the next location off a shared counter while this thread writes
+  // the finished isochrones in order. The threads may not get too far ahead of the writing so
+  // that a slow location can't make the others pile up in memory
+  std::mutex reader_mutex, results_mutex;
+  std::condition_variable results_changed;
+  std::vector<std::string> results(count);
+  std::vector<bool> finished(count, false);
+  int next = 0, written = 0;
+  const int window = concurrency * kBatchWindowPerThread;
+  bool failed = false;
+  std::vector<std::exception_ptr> errors(concurrency + 1);
+  auto fail = [&](std::exception_ptr& error) {
+    error = std::current_exception();
+    {
+      std::lock_guard<std::mutex> lock(results_mutex);
+      failed = true;
+    }
+    results_changed.notify_all();
+  };
+
+  auto work = [&](Isochrone& algorithm, std::exception_ptr& error) {
+    try {
+      ConcurrentGraphReader graphreader(*reader, reader_mutex);
+      Api single = make_single();
+      while (true) {
+        int index;
+        {
+          std::unique_lock<std::mutex> lock(results_mutex);
+          results_changed.wait(lock, [&]() {
+            return failed || next == count || next < written + window;
+          });
+          if (failed || next == count) {
+            break;
+          }
+          index = next++;
+        }
+        auto json = isochrone_at(algorithm, graphreader, single, index);
+        {
+          std::lock_guard<std::mutex> lock(results_mutex);
+          results[index] = std::move(json);
+          finished[index] = true;
+        }
+        results_changed.notify_all();
+      }
+    } catch (...) { fail(error); }
+  };
+  std::vector<std::thread> threads;
+  threads.reserve(concurrency);
+  threads.emplace_back(work, std::ref(isochrone_gen), std::ref(errors[0]));
+  for (uint32_t i = 1; i < concurrency; ++i) {
+    threads.emplace_back(work, std::ref(*isochrone_workers_[i - 1]), std::ref(errors[i]));
+  }
+
+  // only this thread checks the interrupt and writes to the sink
+  try {
+    std::unique_lock<std::mutex> lock(results_mutex);
+    while (written < count && !failed) {
+      if (!finished[written]) {
+        results_changed.wait_for(lock, kBatchInterruptInterval);
+        if (interrupt) {
+          lock.unlock();
+          (*interrupt)();
+          lock.lock();
+        }
+        continue;
+      }
+      std::string json = std::move(results[written]);
+      results[written] = std::string();
+      int index = written++;
+      lock.unlock();
+      results_changed.notify_all();
+      write(index == 0 ? "[" : ",");
+      write(json);
+      lock.lock();
+    }
+  } catch (...) { fail(errors[concurrency]); }
+
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  for (const auto& error : errors) {
+    if (error) {
+      std::rethrow_exception(error);
+    }
+  }
+  write("]");
   return ret;
 }
 
@@ -0,0 +1,312 @@
+#include "thor/localsearch_optimizer.h"
+#include "midgard/logging.h"
+
+#include <algorithm>
+#include <atomic>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <initializer_list>
+#include <limits>
+#include <numeric>
+#include <random>
+#include <thread>
+
+namespace {
+
+// A move has to improve the tour by more than this to be taken, which keeps rounding noise in the
+// (double) sums from making the search cycle
+constexpr double kMinImprovement = 1e-3;
+
+// The longest segment Or-opt moves around
+constexpr uint32_t kMaxOrOptLength = 3;
+
+using clock_type = std::chrono::steady_clock;
+
+/**
+ * Improves a single tour until no 2-opt, Or-opt or segment exchange move makes it cheaper or the
+ * deadline passes. Costs of the tour's stretches are kept as prefix sums in both directions so that
+ * reversing a stretch can be priced in constant time even when the costs are asymmetric.
+ */
+class tour_search_t {
+public:
+  tour_search_t(const uint32_t count, const std::vector<float>& costs)
+      : count_(count), costs_(costs), fwd_(count), bwd_(count), pos_(count), active_(count) {
+  }
+
+  // runs the local search on the tour in place and returns its cost
+  double improve(std::vector<uint32_t>& tour, const clock_type::time_point& deadline) {
+    tour_ = std::move(tour);
+    update();
+    // every location but the fixed ends starts out looking for improvements
+    queue_.clear();
+    std::fill(active_.begin(), active_.end(), false);
+    for (uint32_t i = 1; i + 1 < count_; ++i) {
+      activate(tour_[i]);
+    }
+
+    while (!queue_.empty() && clock_type::now() < deadline) {
+      uint32_t location = queue_.front();
+      queue_.pop_front();
+      active_[location] = false;
+      uint32_t p = pos_[location];
+      if (two_opt(p) || or_opt(p) || exchange(p)) {
+        activate(location);
+      }
+    }
+
+    tour = std::move(tour_);
+    return fwd_[count_ - 1];
+  }
+
+protected:
+  double cost(const uint32_t from, const uint32_t to) const {
+    return costs_[from * count_ + to];
+  }
+
+  // the cost of the stretch from position i to j going forward or backward through the tour
+  double forward(const uint32_t i, const uint32_t j) const {
+    return fwd_[j] - fwd_[i];
+  }
+  double backward(const uint32_t i, const uint32_t j) const {
+    return bwd_[j] - bwd_[i];
+  }
+
+  // wakes up a location to look for improvements, the fixed ends are never moved
+  void activate(const uint32_t location) {
+    if (location != 0 && location + 1 != count_ && !active_[location]) {
+      active_[location] = true;
+      queue_.push_back(location);
+    }
+  }
+
+  // wakes up the locations at the given positions, the ones whose edges are about to change
+  void activate_at(std::initializer_list<uint32_t> positions) {
+    for (auto p : positions) {
+      activate(tour_[p]);
+    }
+  }
+
+  // recomputes the prefix sums and positions after the tour changed
+  void update() {
+    fwd_[0] = bwd_[0] = 0.0;
+    pos_[tour_[0]] = 0;
+    for (uint32_t i = 1; i < count_; ++i) {
+      fwd_[i] = fwd_[i - 1] + cost(tour_[i - 1], tour_[i]);
+      bwd_[i] = bwd_[i - 1] + cost(tour_[i], tour_[i - 1]);
+      pos_[tour_[i]] = i;
+    }
+  }
+
+  // reverses the stretch [l, r] where one of its ends is at position p
+  bool two_opt(const uint32_t p) {
+    auto delta = [this](const uint32_t l, const uint32_t r) {
+      return cost(tour_[l - 1], tour_[r]) + cost(tour_[l], tour_[r + 1]) + backward(l, r) -
+             cost(tour_[l - 1], tour_[l]) - cost(tour_[r], tour_[r + 1]) - forward(l, r);
+    };
+    for (uint32_t q = 1; q + 1 < count_; ++q) {
+      if (q == p) {
+        continue;
+      }
+      uint32_t l = std::min(p, q), r = std::max(p, q);
+      if (delta(l, r) < -kMinImprovement) {
+        activate_at({l - 1, l, r, r + 1});
+        std::reverse(tour_.begin() + l, tour_.begin() + r + 1);
+        update();
+        return true;
+      }
+    }
+    return false;
+  }
+
+  // moves the stretch of up to 3 locations starting at position p elsewhere, possibly reversed
+  bool or_opt(const uint32_t p) {
+    for (uint32_t length = 1; length <= kMaxOrOptLength; ++length) {
+      uint32_t s = p, e = p + length - 1;
+      if (e + 1 >= count_) {
+        break;
+      }
+      double removed = cost(tour_[s - 1], tour_[s]) + cost(tour_[e], tour_[e + 1]) -
+                       cost(tour_[s - 1], tour_[e + 1]);
+      double fw = forward(s, e), bw = backward(s, e);
+      // insert between positions j and j + 1 on either side of the stretch
+      for (uint32_t j = 0; j + 1 < count_; ++j) {
+        if (j + 1 >= s && j <= e) {
+          j = e;
+          continue;
+        }
+        double gap = cost(tour_[j], tour_[j + 1]);
+        bool reversed = false;
+        double delta = cost(tour_[j], tour_[s]) + fw + cost(tour_[e], tour_[j + 1]) - gap - removed;
+        if (length > 1) {
+          double rdelta =
+              cost(tour_[j], tour_[e]) + bw + cost(tour_[s], tour_[j + 1]) - gap - removed;
+          if (rdelta < delta) {
+            delta = rdelta;
+            reversed = true;
+          }
+        }
+        if (delta < -kMinImprovement) {
+          activate_at({s - 1, s, e, e + 1, j, j + 1});
+          uint32_t first;
+          if (j > e) {
+            std::rotate(tour_.begin() + s, tour_.begin() + e + 1, tour_.begin() + j + 1);
+            first = j - length + 1;
+          } else {
+            std::rotate(tour_.begin() + j + 1, tour_.begin() + s, tour_.begin() + e + 1);
+            first = j + 1;
+          }
+          if (reversed) {
+            std::reverse(tour_.begin() + first, tour_.begin() + first + length);
+          }
+          update();
+          return true;
+        }
+      }
+    }
+    return false;
+  }
+
+  // swaps the neighbouring stretches [a, b - 1] and [b, c] where the first one starts at p
+  bool exchange(const uint32_t p) {
+    const uint32_t a = p;
+    for (uint32_t b = a + 1; b + 1 < count_; ++b) {
+      double before = cost(tour_[a - 1], tour_[a]) + cost(tour_[b - 1], tour_[b]);
+      for (uint32_t c = b; c + 1 < count_; ++c) {
+        double delta = cost(tour_[a - 1], tour_[b]) + cost(tour_[c], tour_[a]) +
+                       cost(tour_[b - 1], tour_[c + 1]) - before - cost(tour_[c], tour_[c + 1]);
+        if (delta < -kMinImprovement) {
+          activate_at({a - 1, a, b - 1, b, c, c + 1});
+          std::rotate(tour_.begin() + a, tour_.begin() + b, tour_.begin() + c + 1);
+          update();
+          return true;
+        }
+      }
+    }
+    return false;
+  }
+
+  uint32_t count_;
+  const std::vector<float>& costs_;
+  std::vector<uint32_t> tour_;
+  std::vector<double> fwd_;
+  std::vector<double> bwd_;
+  std::vector<uint32_t> pos_;
+  std::vector<bool> active_;
+  std::deque<uint32_t> queue_;
+};
+
+// greedily visits the cheapest location reachable from the last one
+std::vector<uint32_t> nearest_neighbour_tour(const uint32_t count,
+                                             const std::vector<float>& costs) {
+  std::vector<uint32_t> tour{0};
+  std::vector<bool> visited(count, false);
+  for (uint32_t i = 1; i + 1 < count; ++i) {
+    uint32_t from = tour.back(), best = 0;
+    float best_cost = 0.0f;
+    for (uint32_t to = 1; to + 1 < count; ++to) {
+      if (!visited[to] && (best == 0 || costs[from * count + to] < best_cost)) {
+        best = to;
+        best_cost = costs[from * count + to];
+      }
+    }
+    visited[best] = true;
+    tour.push_back(best);
+  }
+  tour.push_back(count - 1);
+  return tour;
+}
+
+std::vector<uint32_t> random_tour(const uint32_t count, const uint32_t seed) {
+  std::vector<uint32_t> tour(count);
+  std::iota(tour.begin(), tour.end(), 0);
+  std::shuffle(tour.begin() + 1, tour.end() - 1, std::mt19937(seed));
+  return tour;
+}
+
+double tour_cost(const uint32_t count,
+                 const std::vector<float>& costs,
+                 const std::vector<uint32_t>& tour) {
+  double c = 0.0;
+  for (size_t i = 0; i + 1 < tour.size(); ++i) {
+    c += costs[tour[i] * count + tour[i + 1]];
+  }
+  return c;
+}
+
+} // namespace
+
+namespace valhalla {
+namespace thor {
+
+LocalSearchOptimizer::LocalSearchOptimizer(const boost::property_tree::ptree& config)
+    : starts_(std::max(config.get<uint32_t>("optimizer.starts", kDefaultOptimizerStarts), 1u)),
+      concurrency_(std::max(config.get<uint32_t>("optimizer.concurrency", 1), 1u)),
+      max_time_(config.get<uint32_t>("optimizer.max_time", kDefaultOptimizerMaxTime)), seed_(0) {
+}
+
+// Optimize the tour through a set of locations given the cost matrix
+// among all locations. The first location (origin) and last location
+// (destination) remain fixed in the tour.
+std::vector<uint32_t> LocalSearchOptimizer::Solve(const uint32_t count,
+                                                  const std::vector<float>& costs) const {
+  // Handle trivial cases the same way as the annealer
+  if (count == 2) {
+    return {0, 1};
+  } else if (count == 3) {
+    return {0, 1, 2};
+  } else if (count == 4) {
+    std::vector<uint32_t> tour1 = {0, 1, 2, 3};
+    std::vector<uint32_t> tour2 = {0, 2, 1, 3};
+    return (tour_cost(count, costs, tour1) < tour_cost(count, costs, tour2)) ? tour1 : tour2;
+  }
+
+  // The first start is the nearest neighbour tour, the others are random. Once the deadline has
+  // passed the first start still gets a (truncated) search, the ones not begun yet are skipped.
+  const auto deadline = clock_type::now() + max_time_;
+  std::vector<std::vector<uint32_t>> tours(starts_);
+  std::vector<double> tour_costs(starts_, std::numeric_limits<double>::max());
+  std::atomic<uint32_t> next(0);
+  std::atomic<bool> failed(false);
+  auto work = [&](std::exception_ptr& error) {
+    try {
+      tour_search_t search(count, costs);
+      for (uint32_t k = next++; k < starts_ && !failed; k = next++) {
+        if (k > 0 && clock_type::now() >= deadline) {
+          break;
+        }
+        tours[k] = k == 0 ? nearest_neighbour_tour(count, costs) : random_tour(count, seed_ + k);
+        tour_costs[k] = search.improve(tours[k], deadline);
+      }
+    } catch (...) {
+      error = std::current_exception();
+      failed = true;
+    }
+  };
+
+  const uint32_t thread_count = std::min(concurrency_, starts_);
+  std::vector<std::exception_ptr> errors(thread_count);
+  std::vector<std::thread> threads;
+  threads.reserve(thread_count - 1);
+  for (uint32_t i = 1; i < thread_count; ++i) {
+    threads.emplace_back(work, std::ref(errors[i]));
+  }
+  work(errors[0]);
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  for (const auto& error : errors) {
+    if (error) {
+      std::rethrow_exception(error);
+    }
+  }
+
+  // The cheapest tour wins, ties go to the lowest start so the result doesn't depend on threading
+  uint32_t best = std::min_element(tour_costs.begin(), tour_costs.end()) - tour_costs.begin();
+  LOG_DEBUG("Best tour cost = " + std::to_string(tour_costs[best]) +
+            " start = " + std::to_string(best));
+  return tours[best];
+}
+
+} // namespace thor
+} // namespace valhalla
@@ -1,3 +1,4 @@
+#include "baldr/datetime.h"
 #include "thor/worker.h"
 #include "tyr/serializers.h"
 
@@ -85,7 +86,8 @@ thor_worker_t::get_matrix_algorithm(Api& request, const bool has_time, const std
   }
 }
 
-std::string thor_worker_t::matrix(Api& request) {
+std::string thor_worker_t::matrix(Api& request,
+                                  const std::function<void(const char*, size_t)>* sink) {
   // time this whole method and save that statistic
   auto _ = measure_scope_time(request);
 
@@ -117,16 +119,71 @@ std::string thor_worker_t::matrix(Api& request) {
   }
   LOG_INFO("matrix::" + std::string(algo->name()));
 
+  // no matrix_locations for CostMatrix
+  if (algo->name() == "costmatrix" &&
+      options.matrix_locations() != std::numeric_limits<uint32_t>::max()) {
+    add_warning(request, 211);
+  }
+
+  if (!options.has_date_time_end_case()) {
+    if (compute_matrix(request, algo, costing)) {
+      // add a warning that we needed to open destonly etc
+      add_warning(request, 400, get_unfound_indices(request.matrix().second_pass()));
+    }
+    return tyr::serializeMatrix(request, sink);
+  }
+
+  // a date_time range is a convenience for asking for the matrix at many date_times at once. every
+  // date_time runs an expansion of its own, which is no cheaper than a request per date_time apart
+  // from correlating the locations once and keeping the algorithm's reserved memory and timezone
+  // caches. the matrices are appended one after the other
+  auto date_times = DateTime::date_time_range(options.date_time(), options.date_time_end(),
+                                              options.date_time_step());
+  auto cost = mode_costing[static_cast<uint32_t>(mode)];
+  const auto hierarchy_limits = cost->GetHierarchyLimits();
+  Matrix matrices;
+  bool second_pass = false;
+  for (size_t i = 0; i < date_times.size(); ++i) {
+    // without time the matrix would be the same for each date_time, so we just repeat it
+    if (has_time || i == 0) {
+      for (auto* locations : {options.mutable_sources(), options.mutable_targets()}) {
+        for (auto& location : *locations) {
+          if (!location.date_time().empty()) {
+            location.set_date_time(date_times[i]);
+          }
+        }
+      }
+      // undo whatever a second pass relaxed for the previous date_time
+      if (i > 0) {
+        algo->Clear();
+        algo->set_not_thru_pruning(true);
+        cost->GetHierarchyLimits() = hierarchy_limits;
+        cost->set_allow_conditional_destination(false);
+      }
+      request.clear_matrix();
+      second_pass = compute_matrix(request, algo, costing) || second_pass;
+    }
+    matrices.MergeFrom(request.matrix());
+  }
+  matrices.mutable_date_times()->Assign(date_times.begin(), date_times.end());
+  request.mutable_matrix()->Swap(&matrices);
+
+  // warn once for the whole range, the indices run over all of its matrices
+  if (second_pass) {
+    add_warning(request, 400, get_unfound_indices(request.matrix().second_pass()));
+  }
+
+  return tyr::serializeMatrix(request, sink);
+}
+
+bool thor_worker_t::compute_matrix(Api& request,
+                                   MatrixAlgorithm* algo,
+                                   const std::string& costing) {
   // TODO(nils): TDMatrix doesn't care about either destonly or no_thru
   if (algo->name() != "costmatrix") {
     algo->SourceToTarget(request, *reader, mode_costing, mode,
                          max_matrix_distance.find(costing)->second);
-    return tyr::serializeMatrix(request);
-  }
-
-  // no matrix_locations for CostMatrix
-  if (options.matrix_locations() != std::numeric_limits<uint32_t>::max()) {
-    add_warning(request, 211);
+    return false;
   }
 
   // for costmatrix try a second pass if the first didn't work out
@@ -148,12 +205,9 @@ std::string thor_worker_t::matrix(Api& request) {
     algo->set_not_thru_pruning(false);
     algo->SourceToTarget(request, *reader, mode_costing, mode,
                          max_matrix_distance.find(costing)->second);
-
-    // add a warning that we needed to open destonly etc
-    add_warning(request, 400, get_unfound_indices(request.matrix().second_pass()));
+    return true;
   };
-
-  return tyr::serializeMatrix(request);
+  return false;
 }
 } // namespace thor
 } // namespace valhalla
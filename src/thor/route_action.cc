@@ -457,6 +457,39 @@ std::vector<std::vector<thor::PathInfo>> thor_worker_t::get_path(PathAlgorithm*
   // Find the path.
   valhalla::sif::cost_ptr_t cost = mode_costing[static_cast<uint32_t>(mode)];
 
+  // The second pass relaxes the limits. Use less aggressive hierarchy transition limits, and retry
+  // with more candidate edges (add those filtered by heading on first pass).
+  auto relax = [&]() {
+    add_warning(request, 401);
+    // add filtered edges to candidate edges for origin and destination
+    origin.mutable_correlation()->mutable_edges()->MergeFrom(origin.correlation().filtered_edges());
+    destination.mutable_correlation()->mutable_edges()->MergeFrom(
+        destination.correlation().filtered_edges());
+
+    path_algorithm->Clear();
+    cost->set_pass(1);
+    const bool using_bd = path_algorithm == &bidir_astar;
+    cost->RelaxHierarchyLimits(using_bd);
+    cost->set_allow_destination_only(true);
+    cost->set_allow_conditional_destination(true);
+    path_algorithm->set_not_thru_pruning(false);
+  };
+
+  // Someone may have asked for the same path already, if it took a second pass the locations and
+  // costing are left as if it ran again
+  std::string cache_key;
+  if (route_cache_.enabled()) {
+    cache_key = RouteCache::Key(options, path_algorithm->name(), origin, destination);
+    if (const auto* cached = route_cache_.Find(cache_key)) {
+      if (cached->relaxed) {
+        relax();
+      }
+      origin.set_date_time(cached->origin_date_time);
+      destination.set_date_time(cached->destination_date_time);
+      return cached->paths;
+    }
+  }
+
   // If bidirectional A* disable use of destination-only edges on the
   // first pass. If there is a failure, we allow them on the second pass.
   // Other path algorithms can use destination-only edges on the first pass.
@@ -479,35 +512,32 @@ std::vector<std::vector<thor::PathInfo>> thor_worker_t::get_path(PathAlgorithm*
     }
   }
 
-  // If path is not found try again with relaxed limits (if allowed). Use less aggressive
-  // hierarchy transition limits, and retry with more candidate edges (add those filtered
-  // by heading on first pass).
+  // If path is not found try again with relaxed limits (if allowed).
+  bool relaxed = false;
   if ((paths.empty() || ped_second_pass) && cost->AllowMultiPass()) {
-    add_warning(request, 401);
-    // add filtered edges to candidate edges for origin and destination
-    origin.mutable_correlation()->mutable_edges()->MergeFrom(origin.correlation().filtered_edges());
-    destination.mutable_correlation()->mutable_edges()->MergeFrom(
-        destination.correlation().filtered_edges());
-
-    path_algorithm->Clear();
-    cost->set_pass(1);
-    const bool using_bd = path_algorithm == &bidir_astar;
-    cost->RelaxHierarchyLimits(using_bd);
-    cost->set_allow_destination_only(true);
-    cost->set_allow_conditional_destination(true);
-    path_algorithm->set_not_thru_pruning(false);
+    relax();
+    relaxed = true;
     // Get the best path. Return if not empty (else return the original path)
     auto relaxed_paths =
         path_algorithm->GetBestPath(origin, destination, *reader, mode_costing, mode, options);
     if (!relaxed_paths.empty()) {
-      return relaxed_paths;
+      paths = std::move(relaxed_paths);
     }
   }
 
+  if (!cache_key.empty() && !paths.empty()) {
+    route_cache_.Insert(std::move(cache_key),
+                        {paths, relaxed, origin.date_time(), destination.date_time()});
+  }
   return paths;
 }
 
 void thor_worker_t::path_arrive_by(Api& api, const std::string& costing) {
+  // Whatever was cached is of no use anymore if the tiles or the live speeds changed
+  if (route_cache_.enabled()) {
+    route_cache_.Validate(*reader);
+  }
+
   // Things we'll need
   TripRoute* route = nullptr;
   GraphId first_edge;
@@ -734,6 +764,11 @@ void thor_worker_t::path_arrive_by(Api& api, const std::string& costing) {
 }
 
 void thor_worker_t::path_depart_at(Api& api, const std::string& costing) {
+  // Whatever was cached is of no use anymore if the tiles or the live speeds changed
+  if (route_cache_.enabled()) {
+    route_cache_.Validate(*reader);
+  }
+
   // Things we'll need
   TripRoute* route = nullptr;
   GraphId last_edge;
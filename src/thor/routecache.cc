@@ -0,0 +1,160 @@
+#include "thor/routecache.h"
+#include "baldr/graphreader.h"
+
+#include <boost/property_tree/ptree.hpp>
+#include <google/protobuf/io/coded_stream.h>
+#include <google/protobuf/io/zero_copy_stream_impl_lite.h>
+
+#include <algorithm>
+#include <chrono>
+#include <functional>
+
+namespace {
+
+template <typename T> void append(std::string& key, const T& value) {
+  key.append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+void append(std::string& key, const std::string& value) {
+  append(key, static_cast<uint32_t>(value.size()));
+  key.append(value);
+}
+
+// What the path search uses of a location. The filtered edges are in there as well because the
+// second pass adds them to the candidates
+void append(std::string& key, const valhalla::Location& location) {
+  // the search resolves "current" to the local time of the origin, to the minute
+  const bool current = location.date_time() == "current";
+  append(key, static_cast<uint8_t>(current));
+  if (current) {
+    const auto now = std::chrono::system_clock::now().time_since_epoch();
+    append(key, static_cast<int64_t>(std::chrono::duration_cast<std::chrono::minutes>(now).count()));
+  } else {
+    append(key, location.date_time());
+  }
+  for (const auto* edges :
+       {&location.correlation().edges(), &location.correlation().filtered_edges()}) {
+    append(key, static_cast<uint32_t>(edges->size()));
+    for (const auto& edge : *edges) {
+      append(key, edge.graph_id());
+      append(key, edge.percent_along());
+      append(key, edge.distance());
+      append(key, static_cast<uint8_t>(edge.begin_node() | edge.end_node() << 1));
+    }
+  }
+}
+
+// Hashes every costing of the request, multimodal ones use several. The options of a costing hold
+// a map so they have to be serialized deterministically, and the map of costings is iterated in no
+// particular order either
+uint64_t costing_hash(const valhalla::Options& options) {
+  std::vector<int> types;
+  types.reserve(options.costings().size());
+  for (const auto& costing : options.costings()) {
+    types.push_back(costing.first);
+  }
+  std::sort(types.begin(), types.end());
+
+  std::string bytes;
+  {
+    google::protobuf::io::StringOutputStream stream(&bytes);
+    google::protobuf::io::CodedOutputStream coded(&stream);
+    coded.SetSerializationDeterministic(true);
+    for (const auto type : types) {
+      coded.WriteVarint32(static_cast<uint32_t>(type));
+      options.costings().at(type).SerializeToCodedStream(&coded);
+    }
+  }
+  return std::hash<std::string>{}(bytes);
+}
+
+} // namespace
+
+namespace valhalla {
+namespace thor {
+
+RouteCache::RouteCache(const boost::property_tree::ptree& config)
+    : max_entries_(config.get<size_t>("route_cache.max_entries", 0)), tileset_generation_(0),
+      traffic_version_(0), hits_(0), misses_(0), evictions_(0) {
+  index_.reserve(max_entries_);
+  const auto interval = config.get<float>("route_cache.traffic_check_interval", 1.f);
+  traffic_check_interval_ = std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+      std::chrono::duration<float>(interval));
+}
+
+void RouteCache::Validate(const baldr::GraphReader& reader) {
+  const auto tileset_generation = reader.TileSetGeneration();
+  auto traffic_version = traffic_version_;
+  const auto now = std::chrono::steady_clock::now();
+  if (tileset_generation != tileset_generation_ ||
+      now - traffic_checked_ >= traffic_check_interval_) {
+    traffic_version = reader.TrafficVersion();
+    traffic_checked_ = now;
+  }
+
+  if (tileset_generation != tileset_generation_ || traffic_version != traffic_version_) {
+    tileset_generation_ = tileset_generation;
+    traffic_version_ = traffic_version;
+    Clear();
+  }
+}
+
+std::string RouteCache::Key(const Options& options,
+                            const std::string& algorithm,
+                            const valhalla::Location& origin,
+                            const valhalla::Location& destination) {
+  std::string key;
+  key.reserve(128);
+  append(key, costing_hash(options));
+  append(key, static_cast<uint8_t>(options.costing_type()));
+  append(key, static_cast<uint8_t>(options.date_time_type()));
+  append(key, options.alternates());
+  append(key, algorithm);
+  append(key, origin);
+  append(key, destination);
+  return key;
+}
+
+const RouteCache::entry_t* RouteCache::Find(const std::string& key) {
+  auto found = index_.find(key);
+  if (found == index_.end()) {
+    ++misses_;
+    return nullptr;
+  }
+  ++hits_;
+  entries_.splice(entries_.begin(), entries_, found->second);
+  return &found->second->second;
+}
+
+void RouteCache::Insert(std::string key, entry_t entry) {
+  // replace whatever is cached already
+  auto found = index_.find(key);
+  if (found != index_.end()) {
+    found->second->second = std::move(entry);
+    entries_.splice(entries_.begin(), entries_, found->second);
+    return;
+  }
+
+  if (entries_.size() >= max_entries_) {
+    index_.erase(entries_.back().first);
+    entries_.pop_back();
+    ++evictions_;
+  }
+  entries_.emplace_front(key, std::move(entry));
+  index_.emplace(std::move(key), entries_.begin());
+}
+
+void RouteCache::Clear() {
+  entries_.clear();
+  index_.clear();
+}
+
+void RouteCache::Report(Status::RouteCache& status) const {
+  status.set_hits(hits_);
+  status.set_misses(misses_);
+  status.set_entries(entries_.size());
+  status.set_evictions(evictions_);
+}
+
+} // namespace thor
+} // namespace valhalla
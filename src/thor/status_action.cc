@@ -2,7 +2,7 @@
 
 namespace valhalla {
 namespace thor {
-void thor_worker_t::status(Api&) const {
+void thor_worker_t::status(Api& request) const {
 #ifdef ENABLE_SERVICES
   // if we are in the process of shutting down we signal that here
   // should react by draining traffic (though they are likely doing this as they are usually the ones
@@ -11,6 +11,11 @@ void thor_worker_t::status(Api&) const {
     throw valhalla_exception_t{402};
   }
 #endif
+
+  // the route cache of this worker, the other workers have their own
+  if (route_cache_.enabled()) {
+    route_cache_.Report(*request.mutable_status()->mutable_route_cache());
+  }
 }
 } // namespace thor
 } // namespace valhalla
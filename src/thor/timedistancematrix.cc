@@ -3,6 +3,10 @@
 #include "midgard/logging.h"
 
 #include <algorithm>
+#include <atomic>
+#include <exception>
+#include <mutex>
+#include <thread>
 #include <vector>
 
 using namespace valhalla::baldr;
@@ -16,7 +20,8 @@ TimeDistanceMatrix::TimeDistanceMatrix(const boost::property_tree::ptree& config
     : MatrixAlgorithm(config), settled_count_(0), current_cost_threshold_(0),
       max_reserved_labels_count_(config.get<uint32_t>("max_reserved_labels_count_dijkstras",
                                                       kInitialEdgeLabelCountDijkstras)),
-      mode_(travel_mode_t::kDrive) {
+      mode_(travel_mode_t::kDrive),
+      concurrency_(std::max(1u, config.get<uint32_t>("timedistancematrix.concurrency", 1))) {
 }
 
 // Compute a cost threshold in seconds based on average speed for the travel mode.
@@ -195,11 +200,6 @@ template <const ExpansionType expansion_direction, const bool FORWARD>
 bool TimeDistanceMatrix::ComputeMatrix(Api& request,
                                        baldr::GraphReader& graphreader,
                                        const float max_matrix_distance) {
-  bool invariant = request.options().date_time_type() == Options::invariant;
-  uint32_t matrix_locations = request.options().matrix_locations();
-
-  uint32_t bucketsize = costing_->UnitSize();
-
   auto& origins = FORWARD ? *request.mutable_options()->mutable_sources()
                           : *request.mutable_options()->mutable_targets();
   auto& destinations = FORWARD ? *request.mutable_options()->mutable_targets()
@@ -213,94 +213,170 @@ bool TimeDistanceMatrix::ComputeMatrix(Api& request,
   // reserve the PBF vectors
   reserve_pbf_arrays(*request.mutable_matrix(), num_elements, request.options().verbose(),
                      costing_->pass());
+  auto& matrix = *request.mutable_matrix();
+
+  // With a single thread (or origin) we simply run the expansions one after the other
+  uint32_t concurrency = std::min<uint32_t>(concurrency_, origins.size());
+  if (concurrency <= 1) {
+    for (int origin_index = 0; origin_index < origins.size(); ++origin_index) {
+      ComputeOrigin<expansion_direction>(request, matrix, graphreader, origin_index,
+                                         time_infos[origin_index], max_matrix_distance);
+    }
+    // TODO(nils): implement second pass here too
+    return true;
+  }
 
-  for (int origin_index = 0; origin_index < origins.size(); ++origin_index) {
-    // reserve some space for the next dijkstras (will be cleared at the end of the loop)
-    edgelabels_.reserve(max_reserved_labels_count_);
-    auto& origin = origins.Get(origin_index);
-    const auto& time_info = time_infos[origin_index];
-
-    current_cost_threshold_ = GetCostThreshold(max_matrix_distance);
-
-    // Construct adjacency list. Set bucket size and cost range based on DynamicCost.
-    adjacencylist_.reuse(0.0f, current_cost_threshold_, bucketsize, &edgelabels_);
-
-    // Initialize the origin and set the available destination edges
-    settled_count_ = 0;
-    SetOrigin<expansion_direction>(graphreader, origin, time_info);
-    SetDestinationEdges();
-
-    uint32_t n = 0;
-    // Collect edge_ids used for settling a location to determine its time zone
-    std::unordered_map<uint32_t, baldr::GraphId> dest_edge_ids;
-    dest_edge_ids.reserve(destinations.size());
-
-    // Find shortest path
-    graph_tile_ptr tile;
-    while (true) {
-      // Get next element from adjacency list. Check that it is valid. An
-      // invalid label indicates there are no edges that can be expanded.
-      uint32_t predindex = adjacencylist_.pop();
-      if (predindex == kInvalidLabel) {
-        // Can not expand any further...
-        FormTimeDistanceMatrix(request, graphreader, FORWARD, origin_index, origin.date_time(),
-                               time_info.timezone_index, dest_edge_ids);
-        break;
+  // Otherwise each thread takes the next origin off a shared counter and expands it with its own
+  // labels, edge status and destinations. The tiles come from the request's reader through a lock
+  while (workers_.size() < concurrency - 1) {
+    boost::property_tree::ptree config;
+    config.put("max_reserved_labels_count_dijkstras", max_reserved_labels_count_);
+    config.put("clear_reserved_memory", clear_reserved_memory_);
+    workers_.emplace_back(std::make_unique<TimeDistanceMatrix>(config));
+  }
+  for (uint32_t i = 0; i < concurrency - 1; ++i) {
+    auto& worker = *workers_[i];
+    worker.mode_ = mode_;
+    worker.costing_ = costing_;
+    worker.max_expansion_distance_ = max_expansion_distance_;
+    worker.destinations_ = destinations_;
+    worker.dest_edges_ = dest_edges_;
+  }
+
+  std::mutex reader_mutex;
+  std::atomic<int> next_origin(0);
+  std::atomic<bool> failed(false);
+  std::vector<std::exception_ptr> errors(concurrency);
+  // only this thread has the interrupt set, if it fires the other threads stop at their next origin
+  auto work = [&](TimeDistanceMatrix& algorithm, uint32_t thread) {
+    try {
+      ConcurrentGraphReader reader(graphreader, reader_mutex);
+      for (int origin_index = next_origin++; origin_index < origins.size() && !failed;
+           origin_index = next_origin++) {
+        algorithm.ComputeOrigin<expansion_direction>(request, matrix, reader, origin_index,
+                                                     time_infos[origin_index],
+                                                     max_matrix_distance);
       }
+    } catch (...) {
+      errors[thread] = std::current_exception();
+      failed = true;
+    }
+  };
+  std::vector<std::thread> threads;
+  threads.reserve(concurrency - 1);
+  for (uint32_t i = 1; i < concurrency; ++i) {
+    threads.emplace_back(work, std::ref(*workers_[i - 1]), i);
+  }
+  work(*this, 0);
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  for (const auto& error : errors) {
+    if (error) {
+      std::rethrow_exception(error);
+    }
+  }
+
+  // TODO(nils): implement second pass here too
+  return true;
+}
+
+template <const ExpansionType expansion_direction, const bool FORWARD>
+void TimeDistanceMatrix::ComputeOrigin(const Api& request,
+                                       valhalla::Matrix& matrix,
+                                       baldr::GraphReader& graphreader,
+                                       const int origin_index,
+                                       const baldr::TimeInfo& time_info,
+                                       const float max_matrix_distance) {
+  bool invariant = request.options().date_time_type() == Options::invariant;
+  uint32_t matrix_locations = request.options().matrix_locations();
+  uint32_t bucketsize = costing_->UnitSize();
+  const int target_count = request.options().targets().size();
 
-      // Copy the EdgeLabel for use in costing
-      EdgeLabel pred = edgelabels_[predindex];
+  const auto& origins = FORWARD ? request.options().sources() : request.options().targets();
+  const auto& destinations = FORWARD ? request.options().targets() : request.options().sources();
 
-      // Remove label from adjacency list, mark it as permanently labeled.
+  // reserve some space for the next dijkstras (will be cleared at the end)
+  edgelabels_.reserve(max_reserved_labels_count_);
+  auto& origin = origins.Get(origin_index);
 
-      // Mark the edge as permanently labeled. Do not do this for an origin
-      // edge. Otherwise loops/around the block cases will not work
-      if (!pred.origin()) {
-        edgestatus_.Update(pred.edgeid(), EdgeSet::kPermanent);
-      }
+  current_cost_threshold_ = GetCostThreshold(max_matrix_distance);
 
-      // Identify any destinations on this edge
-      auto destedge = dest_edges_.find(pred.edgeid());
-      if (destedge != dest_edges_.end()) {
-        // Update any destinations along this edge. Return if all destinations
-        // have been settled or the requested amount of destinations has been found
-        tile = graphreader.GetGraphTile(pred.edgeid());
-        const DirectedEdge* edge = tile->directededge(pred.edgeid());
-
-        for (auto& dest_id : destedge->second) {
-          dest_edge_ids[dest_id] = pred.edgeid();
-        }
-        if (UpdateDestinations<expansion_direction>(origin, destinations, destedge->second, edge,
-                                                    tile, graphreader, pred, time_info,
-                                                    matrix_locations)) {
-          FormTimeDistanceMatrix(request, graphreader, FORWARD, origin_index, origin.date_time(),
-                                 time_info.timezone_index, dest_edge_ids);
-          break;
-        }
-      }
+  // Construct adjacency list. Set bucket size and cost range based on DynamicCost.
+  adjacencylist_.reuse(0.0f, current_cost_threshold_, bucketsize, &edgelabels_);
 
-      // Terminate when we are beyond the cost threshold
-      if (pred.cost().cost > current_cost_threshold_) {
-        FormTimeDistanceMatrix(request, graphreader, FORWARD, origin_index, origin.date_time(),
-                               time_info.timezone_index, dest_edge_ids);
-        break;
-      }
+  // Initialize the origin and set the available destination edges
+  settled_count_ = 0;
+  SetOrigin<expansion_direction>(graphreader, origin, time_info);
+  SetDestinationEdges();
+
+  uint32_t n = 0;
+  // Collect edge_ids used for settling a location to determine its time zone
+  std::unordered_map<uint32_t, baldr::GraphId> dest_edge_ids;
+  dest_edge_ids.reserve(destinations.size());
+
+  // Find shortest path
+  graph_tile_ptr tile;
+  while (true) {
+    // Get next element from adjacency list. Check that it is valid. An
+    // invalid label indicates there are no edges that can be expanded.
+    uint32_t predindex = adjacencylist_.pop();
+    if (predindex == kInvalidLabel) {
+      // Can not expand any further...
+      FormTimeDistanceMatrix(matrix, target_count, graphreader, FORWARD, origin_index,
+                             origin.date_time(), time_info.timezone_index, dest_edge_ids);
+      break;
+    }
+
+    // Copy the EdgeLabel for use in costing
+    EdgeLabel pred = edgelabels_[predindex];
 
-      // Expand forward from the end node of the predecessor edge.
-      Expand<expansion_direction>(graphreader, pred.endnode(), pred, predindex, false, time_info,
-                                  invariant);
+    // Remove label from adjacency list, mark it as permanently labeled.
 
-      // Allow this process to be aborted
-      if (interrupt_ && (n++ % kInterruptIterationsInterval) == 0) {
-        (*interrupt_)();
+    // Mark the edge as permanently labeled. Do not do this for an origin
+    // edge. Otherwise loops/around the block cases will not work
+    if (!pred.origin()) {
+      edgestatus_.Update(pred.edgeid(), EdgeSet::kPermanent);
+    }
+
+    // Identify any destinations on this edge
+    auto destedge = dest_edges_.find(pred.edgeid());
+    if (destedge != dest_edges_.end()) {
+      // Update any destinations along this edge. Return if all destinations
+      // have been settled or the requested amount of destinations has been found
+      tile = graphreader.GetGraphTile(pred.edgeid());
+      const DirectedEdge* edge = tile->directededge(pred.edgeid());
+
+      for (auto& dest_id : destedge->second) {
+        dest_edge_ids[dest_id] = pred.edgeid();
       }
+      if (UpdateDestinations<expansion_direction>(origin, destinations, destedge->second, edge,
+                                                  tile, graphreader, pred, time_info,
+                                                  matrix_locations)) {
+        FormTimeDistanceMatrix(matrix, target_count, graphreader, FORWARD, origin_index,
+                               origin.date_time(), time_info.timezone_index, dest_edge_ids);
+        break;
+      }
+    }
+
+    // Terminate when we are beyond the cost threshold
+    if (pred.cost().cost > current_cost_threshold_) {
+      FormTimeDistanceMatrix(matrix, target_count, graphreader, FORWARD, origin_index,
+                             origin.date_time(), time_info.timezone_index, dest_edge_ids);
+      break;
     }
 
-    reset();
+    // Expand forward from the end node of the predecessor edge.
+    Expand<expansion_direction>(graphreader, pred.endnode(), pred, predindex, false, time_info,
+                                invariant);
+
+    // Allow this process to be aborted
+    if (interrupt_ && (n++ % kInterruptIterationsInterval) == 0) {
+      (*interrupt_)();
+    }
   }
 
-  // TODO(nils): implement second pass here too
-  return true;
+  reset();
 }
 
 template bool
@@ -598,7 +674,8 @@ bool TimeDistanceMatrix::UpdateDestinations(
 }
 
 // Form the time, distance matrix from the destinations list
-void TimeDistanceMatrix::FormTimeDistanceMatrix(Api& request,
+void TimeDistanceMatrix::FormTimeDistanceMatrix(valhalla::Matrix& matrix,
+                                                const int target_count,
                                                 GraphReader& reader,
                                                 const bool forward,
                                                 const uint32_t origin_index,
@@ -607,12 +684,10 @@ void TimeDistanceMatrix::FormTimeDistanceMatrix(Api& request,
                                                 std::unordered_map<uint32_t, GraphId>& edge_ids) {
   // when it's forward, origin_index will be the source_index
   // when it's reverse, origin_index will be the target_index
-  valhalla::Matrix& matrix = *request.mutable_matrix();
   graph_tile_ptr tile;
   for (uint32_t i = 0; i < destinations_.size(); i++) {
     auto& dest = destinations_[i];
-    auto pbf_idx = forward ? (origin_index * request.options().targets().size()) + i
-                           : (i * request.options().targets().size()) + origin_index;
+    auto pbf_idx = forward ? (origin_index * target_count) + i : (i * target_count) + origin_index;
     matrix.mutable_from_indices()->Set(pbf_idx, forward ? origin_index : i);
     matrix.mutable_to_indices()->Set(pbf_idx, forward ? i : origin_index);
     matrix.mutable_distances()->Set(pbf_idx, dest.distance);
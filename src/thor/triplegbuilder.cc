@@ -44,6 +44,151 @@ constexpr uint8_t kNotTagged = 0;
 constexpr uint8_t kTunnelTag = static_cast<uint8_t>(baldr::TaggedValue::kTunnel);
 constexpr uint8_t kBridgeTag = static_cast<uint8_t>(baldr::TaggedValue::kBridge);
 
+/**
+ * The attributes requested of a leg, looked up in the controller once before the leg is built. The
+ * controller hashes the key of an attribute each time it is asked for one, which adds up over the
+ * many attributes of every node, edge and shape point of a route. The plan also knows which whole
+ * parts of the leg none of the attributes were requested for so that they can be skipped along with
+ * the graph lookups they would need. Attributes of things few edges have, like signs and transit
+ * routes, are still looked up in the controller when they are needed.
+ */
+struct AttributePlan {
+  explicit AttributePlan(const AttributesController& controller) : controller(controller) {
+    node_admin_index = controller(kNodeAdminIndex);
+    node_elapsed_time = controller(kNodeElapsedTime);
+    node_fork = controller(kNodeFork);
+    node_intersecting_edge_begin_heading = controller(kNodeIntersectingEdgeBeginHeading);
+    node_intersecting_edge_cyclability = controller(kNodeIntersectingEdgeCyclability);
+    node_intersecting_edge_driveability = controller(kNodeIntersectingEdgeDriveability);
+    node_intersecting_edge_from_edge_name_consistency =
+        controller(kNodeIntersectingEdgeFromEdgeNameConsistency);
+    node_intersecting_edge_lane_count = controller(kNodeIntersectingEdgeLaneCount);
+    node_intersecting_edge_road_class = controller(kNodeIntersectingEdgeRoadClass);
+    node_intersecting_edge_sign_info = controller(kNodeIntersectingEdgeSignInfo);
+    node_intersecting_edge_to_edge_name_consistency =
+        controller(kNodeIntersectingEdgeToEdgeNameConsistency);
+    node_intersecting_edge_use = controller(kNodeIntersectingEdgeUse);
+    node_intersecting_edge_walkability = controller(kNodeIntersectingEdgeWalkability);
+    node_time_zone = controller(kNodeTimeZone);
+    node_traffic_signal = controller(kNodeTrafficSignal);
+    node_transition_time = controller(kNodeTransitionTime);
+    node_type = controller(kNodeType);
+    edge_begin_heading = controller(kEdgeBeginHeading);
+    edge_begin_osm_node_id = controller(kEdgeBeginOsmNodeId);
+    edge_begin_shape_index = controller(kEdgeBeginShapeIndex);
+    edge_bicycle_network = controller(kEdgeBicycleNetwork);
+    edge_bicycle_type = controller(kEdgeBicycleType);
+    edge_bridge = controller(kEdgeBridge);
+    edge_conditional_speed_limits = controller(kEdgeConditionalSpeedLimits);
+    edge_country_crossing = controller(kEdgeCountryCrossing);
+    edge_curvature = controller(kEdgeCurvature);
+    edge_cycle_lane = controller(kEdgeCycleLane);
+    edge_default_speed = controller(kEdgeDefaultSpeed);
+    edge_density = controller(kEdgeDensity);
+    edge_destination_only = controller(kEdgeDestinationOnly);
+    edge_drive_on_right = controller(kEdgeDriveOnRight);
+    edge_elevation = controller(kEdgeElevation);
+    edge_end_heading = controller(kEdgeEndHeading);
+    edge_end_osm_node_id = controller(kEdgeEndOsmNodeId);
+    edge_end_shape_index = controller(kEdgeEndShapeIndex);
+    edge_forward = controller(kEdgeForward);
+    edge_hov_type = controller(kEdgeHovType);
+    edge_id = controller(kEdgeId);
+    edge_indoor = controller(kEdgeIndoor);
+    edge_internal_intersection = controller(kEdgeInternalIntersection);
+    edge_is_urban = controller(kEdgeIsUrban);
+    edge_landmarks = controller(kEdgeLandmarks);
+    edge_lane_connectivity = controller(kEdgeLaneConnectivity);
+    edge_lane_count = controller(kEdgeLaneCount);
+    edge_length = controller(kEdgeLength);
+    edge_levels = controller(kEdgeLevels);
+    edge_max_downward_grade = controller(kEdgeMaxDownwardGrade);
+    edge_max_upward_grade = controller(kEdgeMaxUpwardGrade);
+    edge_mean_elevation = controller(kEdgeMeanElevation);
+    edge_names = controller(kEdgeNames);
+    edge_pedestrian_type = controller(kEdgePedestrianType);
+    edge_road_class = controller(kEdgeRoadClass);
+    edge_roundabout = controller(kEdgeRoundabout);
+    edge_sac_scale = controller(kEdgeSacScale);
+    edge_shoulder = controller(kEdgeShoulder);
+    edge_sidewalk = controller(kEdgeSidewalk);
+    edge_sign_junction_name = controller(kEdgeSignJunctionName);
+    edge_speed = controller(kEdgeSpeed);
+    edge_speed_limit = controller(kEdgeSpeedLimit);
+    edge_speed_type = controller(kEdgeSpeedType);
+    edge_speeds_faded = controller(kEdgeSpeedsFaded);
+    edge_speeds_non_faded = controller(kEdgeSpeedsNonFaded);
+    edge_surface = controller(kEdgeSurface);
+    edge_tagged_values = controller(kEdgeTaggedValues);
+    edge_toll = controller(kEdgeToll);
+    edge_traffic_signal = controller(kEdgeTrafficSignal);
+    edge_travel_mode = controller(kEdgeTravelMode);
+    edge_traversability = controller(kEdgeTraversability);
+    edge_truck_route = controller(kEdgeTruckRoute);
+    edge_truck_speed = controller(kEdgeTruckSpeed);
+    edge_tunnel = controller(kEdgeTunnel);
+    edge_unpaved = controller(kEdgeUnpaved);
+    edge_use = controller(kEdgeUse);
+    edge_vehicle_type = controller(kEdgeVehicleType);
+    edge_way_id = controller(kEdgeWayId);
+    edge_weighted_grade = controller(kEdgeWeightedGrade);
+    shape_attributes_closure = controller(kShapeAttributesClosure);
+    shape_attributes_congestion = controller(kShapeAttributesCongestion);
+    shape_attributes_length = controller(kShapeAttributesLength);
+    shape_attributes_speed = controller(kShapeAttributesSpeed);
+    shape_attributes_speed_limit = controller(kShapeAttributesSpeedLimit);
+    shape_attributes_time = controller(kShapeAttributesTime);
+    incidents = controller(kIncidents);
+    osm_changeset = controller(kOsmChangeset);
+    shape = controller(kShape);
+
+    edge_signs = controller(kEdgeSignExitNumber) || controller(kEdgeSignExitBranch) ||
+                 controller(kEdgeSignExitToward) || controller(kEdgeSignExitName) ||
+                 controller(kEdgeSignGuideBranch) || controller(kEdgeSignGuideToward) ||
+                 controller(kEdgeSignGuidanceViewJunction) ||
+                 controller(kEdgeSignGuidanceViewSignboard);
+    intersecting_edges =
+        node_intersecting_edge_begin_heading || node_intersecting_edge_cyclability ||
+        node_intersecting_edge_driveability || node_intersecting_edge_from_edge_name_consistency ||
+        node_intersecting_edge_lane_count || node_intersecting_edge_road_class ||
+        node_intersecting_edge_sign_info || node_intersecting_edge_to_edge_name_consistency ||
+        node_intersecting_edge_use || node_intersecting_edge_walkability;
+    shape_attributes = controller.category_attribute_enabled(kShapeAttributesCategory);
+  }
+
+  const AttributesController& controller;
+  // node attributes
+  bool node_admin_index, node_elapsed_time, node_fork, node_intersecting_edge_begin_heading,
+      node_intersecting_edge_cyclability, node_intersecting_edge_driveability,
+      node_intersecting_edge_from_edge_name_consistency, node_intersecting_edge_lane_count,
+      node_intersecting_edge_road_class, node_intersecting_edge_sign_info,
+      node_intersecting_edge_to_edge_name_consistency, node_intersecting_edge_use,
+      node_intersecting_edge_walkability, node_time_zone, node_traffic_signal, node_transition_time,
+      node_type;
+  // edge attributes
+  bool edge_begin_heading, edge_begin_osm_node_id, edge_begin_shape_index, edge_bicycle_network,
+      edge_bicycle_type, edge_bridge, edge_conditional_speed_limits, edge_country_crossing,
+      edge_curvature, edge_cycle_lane, edge_default_speed, edge_density, edge_destination_only,
+      edge_drive_on_right, edge_elevation, edge_end_heading, edge_end_osm_node_id,
+      edge_end_shape_index, edge_forward, edge_hov_type, edge_id, edge_indoor,
+      edge_internal_intersection, edge_is_urban, edge_landmarks, edge_lane_connectivity,
+      edge_lane_count, edge_length, edge_levels, edge_max_downward_grade, edge_max_upward_grade,
+      edge_mean_elevation, edge_names, edge_pedestrian_type, edge_road_class, edge_roundabout,
+      edge_sac_scale, edge_shoulder, edge_sidewalk, edge_sign_junction_name, edge_speed,
+      edge_speed_limit, edge_speed_type, edge_speeds_faded, edge_speeds_non_faded, edge_surface,
+      edge_tagged_values, edge_toll, edge_traffic_signal, edge_travel_mode, edge_traversability,
+      edge_truck_route, edge_truck_speed, edge_tunnel, edge_unpaved, edge_use, edge_vehicle_type,
+      edge_way_id, edge_weighted_grade;
+  // shape attributes
+  bool shape_attributes_closure, shape_attributes_congestion, shape_attributes_length,
+      shape_attributes_speed, shape_attributes_speed_limit, shape_attributes_time;
+  // leg attributes
+  bool incidents, osm_changeset, shape;
+  // whole parts of the leg: the signs of the edges, the intersecting edges at the nodes and the
+  // attributes along the shape
+  bool edge_signs, intersecting_edges, shape_attributes;
+};
+
 uint32_t
 GetAdminIndex(const AdminInfo& admin_info,
               std::unordered_map<AdminInfo, uint32_t, AdminInfo::AdminInfoHasher>& admin_info_map,
@@ -183,7 +328,7 @@ valhalla::TripLeg_Closure* fetch_or_create_closure_annotation(TripLeg& leg) {
  * Chops up the shape for an edge so that we have shape points where speeds change along the edge
  * and where incidents occur along the edge. Also sets the various per shape point attributes
  * such as time, distance, speed. Also updates the incidents list on the edge with their shape indices
- * @param controller
+ * @param plan
  * @param tile
  * @param edge
  * @param shape
@@ -195,7 +340,7 @@ valhalla::TripLeg_Closure* fetch_or_create_closure_annotation(TripLeg& leg) {
  * @param cut_for_traffic
  * @param incidents
  */
-void SetShapeAttributes(const AttributesController& controller,
+void SetShapeAttributes(const AttributePlan& plan,
                         const graph_tile_ptr& tile,
                         const graph_tile_ptr& end_node_tile,
                         const DirectedEdge* edge,
@@ -210,14 +355,12 @@ void SetShapeAttributes(const AttributesController& controller,
   // TODO: if this is a transit edge then the costing will throw
 
   // bail if nothing to do
-  if (!cut_for_traffic && incidents.start_index == incidents.end_index &&
-      !controller.category_attribute_enabled(kShapeAttributesCategory)) {
+  if (!cut_for_traffic && incidents.start_index == incidents.end_index && !plan.shape_attributes) {
     return;
   }
 
   // initialize shape_attributes once
-  if (!leg.has_shape_attributes() &&
-      controller.category_attribute_enabled(kShapeAttributesCategory)) {
+  if (!leg.has_shape_attributes() && plan.shape_attributes) {
     leg.mutable_shape_attributes();
   }
 
@@ -318,23 +461,23 @@ void SetShapeAttributes(const AttributesController& controller,
   assert(cut_itr != cuts.cend());
 
   // reservations
-  if (controller(kShapeAttributesTime)) {
+  if (plan.shape_attributes_time) {
     leg.mutable_shape_attributes()->mutable_time()->Reserve(leg.shape_attributes().time_size() +
                                                             shape.size() + cuts.size());
   }
-  if (controller(kShapeAttributesLength)) {
+  if (plan.shape_attributes_length) {
     leg.mutable_shape_attributes()->mutable_length()->Reserve(leg.shape_attributes().length_size() +
                                                               shape.size() + cuts.size());
   }
-  if (controller(kShapeAttributesSpeed)) {
+  if (plan.shape_attributes_speed) {
     leg.mutable_shape_attributes()->mutable_speed()->Reserve(leg.shape_attributes().speed_size() +
                                                              shape.size() + cuts.size());
   }
-  if (controller(kShapeAttributesSpeedLimit)) {
+  if (plan.shape_attributes_speed_limit) {
     leg.mutable_shape_attributes()->mutable_speed_limit()->Reserve(
         leg.shape_attributes().speed_limit_size() + shape.size() + cuts.size());
   }
-  if (controller(kShapeAttributesCongestion)) {
+  if (plan.shape_attributes_congestion) {
     leg.mutable_shape_attributes()->mutable_speed()->Reserve(
         leg.shape_attributes().congestion_size() + shape.size() + cuts.size());
   }
@@ -355,7 +498,7 @@ void SetShapeAttributes(const AttributesController& controller,
       distance *= coef;
       shift = 1;
     }
-    if (controller(kShapeAttributesClosure)) {
+    if (plan.shape_attributes_closure) {
       // Process closure annotations
       if (cut_itr->closed) {
         // Found a closure. Fetch a new annotation, or the last closure
@@ -381,23 +524,23 @@ void SetShapeAttributes(const AttributesController& controller,
     }
 
     // Set shape attributes time per shape point if requested
-    if (controller(kShapeAttributesTime)) {
+    if (plan.shape_attributes_time) {
       // convert time to milliseconds and then round to an integer
       leg.mutable_shape_attributes()->add_time((time * kMillisecondPerSec) + 0.5);
     }
 
     // Set shape attributes length per shape point if requested
-    if (controller(kShapeAttributesLength)) {
+    if (plan.shape_attributes_length) {
       // convert length to decimeters and then round to an integer
       leg.mutable_shape_attributes()->add_length((distance * kDecimeterPerMeter) + 0.5);
     }
-    if (controller(kShapeAttributesCongestion)) {
+    if (plan.shape_attributes_congestion) {
       // convert length to decimeters and then round to an integer
       leg.mutable_shape_attributes()->add_congestion(cut_itr->congestion);
     }
 
     // Set shape attributes speed per shape point if requested
-    if (controller(kShapeAttributesSpeed)) {
+    if (plan.shape_attributes_speed) {
       // convert speed to decimeters per sec and then round to an integer
       double decimeters_sec = (distance * kDecimeterPerMeter / time) + 0.5;
       if (std::isnan(decimeters_sec) || time == 0.) { // avoid NaN
@@ -407,7 +550,7 @@ void SetShapeAttributes(const AttributesController& controller,
     }
 
     // Set the maxspeed if requested
-    if (controller(kShapeAttributesSpeedLimit)) {
+    if (plan.shape_attributes_speed_limit) {
       leg.mutable_shape_attributes()->add_speed_limit(edgeinfo.speed_limit());
     }
 
@@ -490,22 +633,22 @@ void CopyLocations(TripLeg& trip_path,
 /**
  * Set begin and end heading if requested.
  * @param  trip_edge  Trip path edge to add headings.
- * @param  controller Controller specifying attributes to add to trip edge.
+ * @param  plan       Which attributes to add to trip edge.
  * @param  edge       Directed edge.
  * @param  shape      Trip shape.
  */
 void SetHeadings(TripLeg_Edge* trip_edge,
-                 const AttributesController& controller,
+                 const AttributePlan& plan,
                  const DirectedEdge* edge,
                  const std::vector<PointLL>& shape,
                  const uint32_t begin_index) {
-  if (controller(kEdgeBeginHeading) || controller(kEdgeEndHeading)) {
+  if (plan.edge_begin_heading || plan.edge_end_heading) {
     float offset = GetOffsetForHeading(edge->classification(), edge->use());
-    if (controller(kEdgeBeginHeading)) {
+    if (plan.edge_begin_heading) {
       trip_edge->set_begin_heading(
           std::round(PointLL::HeadingAlongPolyline(shape, offset, begin_index, shape.size() - 1)));
     }
-    if (controller(kEdgeEndHeading)) {
+    if (plan.edge_end_heading) {
       trip_edge->set_end_heading(
           std::round(PointLL::HeadingAtEndOfPolyline(shape, offset, begin_index, shape.size() - 1)));
     }
@@ -516,18 +659,17 @@ void SetHeadings(TripLeg_Edge* trip_edge,
  * Add landmarks in the directed edge to trip edge.
  * @param  edgeinfo    Edge info of the directed edge.
  * @param  trip_edge   Trip path edge to add landmarks.
- * @param  controller  Controller specifying whether we want landmarks in the graph to come out the
- * other side.
+ * @param  plan        Whether we want landmarks in the graph to come out the other side.
  * @param  edge        Directed edge where the landmarks are stored.
  * @param  shape       Trip shape.
  */
 void AddLandmarks(const EdgeInfo& edgeinfo,
                   TripLeg_Edge* trip_edge,
-                  const AttributesController& controller,
+                  const AttributePlan& plan,
                   const DirectedEdge* edge,
                   const std::vector<PointLL>& shape,
                   const uint32_t begin_index) {
-  if (!controller(kEdgeLandmarks)) {
+  if (!plan.edge_landmarks) {
     return;
   }
 
@@ -801,7 +943,7 @@ void ProcessNonTaggedValue(valhalla::StreetName* trip_edge_name,
 
 /**
  * Add trip intersecting edge.
- * @param  controller   Controller to determine which attributes to set.
+ * @param  plan         Which attributes to set.
  * @param  directededge Directed edge on the path.
  * @param  prev_de  Previous directed edge on the path.
  * @param  local_edge_index  Index of the local intersecting path edge at intersection.
@@ -810,7 +952,7 @@ void ProcessNonTaggedValue(valhalla::StreetName* trip_edge_name,
  * @param  intersecting_de Intersecting directed edge. Will be nullptr except when
  *                         on the local hierarchy.
  */
-void AddTripIntersectingEdge(const AttributesController& controller,
+void AddTripIntersectingEdge(const AttributePlan& plan,
                              const graph_tile_ptr& graphtile,
                              const DirectedEdge* directededge,
                              const DirectedEdge* prev_de,
@@ -822,7 +964,7 @@ void AddTripIntersectingEdge(const AttributesController& controller,
   TripLeg_IntersectingEdge* intersecting_edge = trip_node->add_intersecting_edge();
 
   // Set the heading for the intersecting edge if requested
-  if (controller(kNodeIntersectingEdgeBeginHeading)) {
+  if (plan.node_intersecting_edge_begin_heading) {
     intersecting_edge->set_begin_heading(nodeinfo->heading(local_edge_index));
   }
 
@@ -838,7 +980,7 @@ void AddTripIntersectingEdge(const AttributesController& controller,
                          : Traversability::kNone;
   }
   // Set the walkability flag for the intersecting edge if requested
-  if (controller(kNodeIntersectingEdgeWalkability)) {
+  if (plan.node_intersecting_edge_walkability) {
     intersecting_edge->set_walkability(GetTripLegTraversability(traversability));
   }
 
@@ -852,30 +994,30 @@ void AddTripIntersectingEdge(const AttributesController& controller,
                                                                          : Traversability::kNone;
   }
   // Set the cyclability flag for the intersecting edge if requested
-  if (controller(kNodeIntersectingEdgeCyclability)) {
+  if (plan.node_intersecting_edge_cyclability) {
     intersecting_edge->set_cyclability(GetTripLegTraversability(traversability));
   }
 
   // Set the driveability flag for the intersecting edge if requested
-  if (controller(kNodeIntersectingEdgeDriveability)) {
+  if (plan.node_intersecting_edge_driveability) {
     intersecting_edge->set_driveability(
         GetTripLegTraversability(nodeinfo->local_driveability(local_edge_index)));
   }
 
   // Set the previous/intersecting edge name consistency if requested
-  if (controller(kNodeIntersectingEdgeFromEdgeNameConsistency)) {
+  if (plan.node_intersecting_edge_from_edge_name_consistency) {
     bool name_consistency =
         (prev_de == nullptr) ? false : prev_de->name_consistency(local_edge_index);
     intersecting_edge->set_prev_name_consistency(name_consistency);
   }
 
   // Set the current/intersecting edge name consistency if requested
-  if (controller(kNodeIntersectingEdgeToEdgeNameConsistency)) {
+  if (plan.node_intersecting_edge_to_edge_name_consistency) {
     intersecting_edge->set_curr_name_consistency(directededge->name_consistency(local_edge_index));
   }
 
   // Add names to edge if requested
-  if (controller(kEdgeNames)) {
+  if (plan.edge_names) {
 
     auto edgeinfo = graphtile->edgeinfo(intersecting_de);
     auto names_and_types = edgeinfo.GetNamesAndTypes(true);
@@ -904,29 +1046,29 @@ void AddTripIntersectingEdge(const AttributesController& controller,
   }
 
   // Set the use for the intersecting edge if requested
-  if (controller(kNodeIntersectingEdgeUse)) {
+  if (plan.node_intersecting_edge_use) {
     intersecting_edge->set_use(GetTripLegUse(intersecting_de->use()));
   }
 
   // Set the road class for the intersecting edge if requested
-  if (controller(kNodeIntersectingEdgeRoadClass)) {
+  if (plan.node_intersecting_edge_road_class) {
     intersecting_edge->set_road_class(GetRoadClass(intersecting_de->classification()));
   }
 
   // Set the lane count for the intersecting edge if requested
-  if (controller(kNodeIntersectingEdgeLaneCount)) {
+  if (plan.node_intersecting_edge_lane_count) {
     intersecting_edge->set_lane_count(intersecting_de->lanecount());
   }
 
   // Set the sign info for the intersecting edge if requested
-  if (controller(kNodeIntersectingEdgeSignInfo)) {
+  if (plan.node_intersecting_edge_sign_info && plan.edge_signs) {
     if (intersecting_de->sign()) {
       LinguisticMap linguistics;
       std::vector<SignInfo> edge_signs =
           graphtile->GetSigns(intersecting_de - graphtile->directededge(0), linguistics);
       if (!edge_signs.empty()) {
         valhalla::TripSign* sign = intersecting_edge->mutable_sign();
-        AddSignInfo(controller, edge_signs, linguistics, sign);
+        AddSignInfo(plan.controller, edge_signs, linguistics, sign);
       }
     }
   }
@@ -935,7 +1077,7 @@ void AddTripIntersectingEdge(const AttributesController& controller,
 /**
  * Adds the intersecting edges in the graph at the current node. Skips edges which are on the path
  * as well as those which are duplicates due to shortcut edges.
- * @param controller               tells us what info we should add about the intersecting edges
+ * @param plan                     tells us what info we should add about the intersecting edges
  * @param start_tile               the tile which contains the node
  * @param node                     the node at which we are copying intersecting edges
  * @param directededge             the current edge leaving the current node in the path
@@ -945,7 +1087,7 @@ void AddTripIntersectingEdge(const AttributesController& controller,
  * @param trip_node                pbf node in the pbf structure we are building
  * @param blind_instructions       whether instructions for blind users are requested
  */
-void AddIntersectingEdges(const AttributesController& controller,
+void AddIntersectingEdges(const AttributePlan& plan,
                           const graph_tile_ptr& start_tile,
                           const NodeInfo* node,
                           const DirectedEdge* directededge,
@@ -995,7 +1137,7 @@ void AddIntersectingEdges(const AttributesController& controller,
     }
 
     // Add intersecting edges on the same hierarchy level and not on the path
-    AddTripIntersectingEdge(controller, start_tile, directededge, prev_de,
+    AddTripIntersectingEdge(plan, start_tile, directededge, prev_de,
                             intersecting_edge->localedgeidx(), node, trip_node, intersecting_edge,
                             blind_instructions);
   }
@@ -1021,7 +1163,7 @@ void AddIntersectingEdges(const AttributesController& controller,
           continue;
         }
 
-        AddTripIntersectingEdge(controller, endtile, directededge, prev_de,
+        AddTripIntersectingEdge(plan, endtile, directededge, prev_de,
                                 intersecting_edge2->localedgeidx(), nodeinfo2, trip_node,
                                 intersecting_edge2, blind_instructions);
       }
@@ -1061,7 +1203,7 @@ void ProcessTunnelBridgeTaggedValue(valhalla::StreetName* trip_edge_name,
 
 /**
  * Add trip edge. (TODO more comments)
- * @param  controller         Controller to determine which attributes to set.
+ * @param  plan               Which attributes to set.
  * @param  edge               Identifier of an edge within the tiled, hierarchical graph.
  * @param  edge_itr           PathInfo iterator
  * @param  block_id           Transit block Id (0 if not a transit edge)
@@ -1079,7 +1221,7 @@ void ProcessTunnelBridgeTaggedValue(valhalla::StreetName* trip_edge_name,
  * @param  edgeinfo           EdgeInfo of the directed edge
  * @param  levels             level information of the edge
  */
-TripLeg_Edge* AddTripEdge(const AttributesController& controller,
+TripLeg_Edge* AddTripEdge(const AttributePlan& plan,
                           const GraphId& edge,
                           const std::vector<valhalla::thor::PathInfo>::const_iterator& edge_itr,
                           const uint32_t block_id,
@@ -1105,7 +1247,7 @@ TripLeg_Edge* AddTripEdge(const AttributesController& controller,
   // Get the edgeinfo
 
   // Add names to edge if requested
-  if (controller(kEdgeNames)) {
+  if (plan.edge_names) {
     auto names_and_types = edgeinfo.GetNamesAndTypes(true);
     if (blind_instructions)
       FilterUnneededStreetNumbers(names_and_types);
@@ -1137,7 +1279,7 @@ TripLeg_Edge* AddTripEdge(const AttributesController& controller,
   }
 
   // Add tagged names to the edge if requested
-  if (controller(kEdgeTaggedValues)) {
+  if (plan.edge_tagged_values) {
     const auto& tagged_values_and_types = edgeinfo.GetTags();
     trip_edge->mutable_tagged_value()->Reserve(tagged_values_and_types.size());
     for (const auto& tagged_value_and_type : tagged_values_and_types) {
@@ -1153,18 +1295,18 @@ TripLeg_Edge* AddTripEdge(const AttributesController& controller,
 #endif
 
   // Set the signs (if the directed edge has sign information) and if requested
-  if (directededge->sign()) {
+  if (directededge->sign() && plan.edge_signs) {
     // Add the edge signs
     LinguisticMap linguistics;
     std::vector<SignInfo> edge_signs = graphtile->GetSigns(idx, linguistics);
     if (!edge_signs.empty()) {
       valhalla::TripSign* sign = trip_edge->mutable_sign();
-      AddSignInfo(controller, edge_signs, linguistics, sign);
+      AddSignInfo(plan.controller, edge_signs, linguistics, sign);
     }
   }
 
   // Process the named junctions at nodes
-  if (has_junction_name && start_tile) {
+  if (has_junction_name && start_tile && plan.edge_sign_junction_name) {
     // Add the node signs
     LinguisticMap linguistics;
     std::vector<SignInfo> node_signs = start_tile->GetSigns(start_node_idx, linguistics, true);
@@ -1174,10 +1316,8 @@ TripLeg_Edge* AddTripEdge(const AttributesController& controller,
       for (const auto& sign : node_signs) {
         switch (sign.type()) {
           case valhalla::baldr::Sign::Type::kJunctionName: {
-            if (controller(kEdgeSignJunctionName)) {
-              PopulateSignElement(sign_index, sign, linguistics,
-                                  trip_sign->mutable_junction_names()->Add());
-            }
+            PopulateSignElement(sign_index, sign, linguistics,
+                                trip_sign->mutable_junction_names()->Add());
             break;
           }
           default:
@@ -1199,13 +1339,13 @@ TripLeg_Edge* AddTripEdge(const AttributesController& controller,
   }
 
   // Set road class if requested
-  if (controller(kEdgeRoadClass)) {
+  if (plan.edge_road_class) {
     trip_edge->set_road_class(GetRoadClass(directededge->classification()));
   }
 
   // Set speed if requested
   // TODO: what to do about transit edges?
-  if (controller(kEdgeSpeed)) {
+  if (plan.edge_speed) {
     // TODO: could get better precision speed here by calling GraphTile::GetSpeed but we'd need to
     // know whether or not the costing actually cares about the speed of the edge. Perhaps a
     // refactor of costing to have a GetSpeed function which EdgeCost calls internally but which we
@@ -1224,11 +1364,11 @@ TripLeg_Edge* AddTripEdge(const AttributesController& controller,
     trip_edge->set_speed(speed);
   }
 
-  if (controller(kEdgeSpeedType)) {
+  if (plan.edge_speed_type) {
     trip_edge->set_speed_type(GetTripLegSpeedType(directededge->speed_type()));
   }
 
-  if (controller(kEdgeSpeedsFaded) || controller(kEdgeSpeedsNonFaded)) {
+  if (plan.edge_speeds_faded || plan.edge_speeds_non_faded) {
     // helper function to only get the speed from GetSpeed that we are interested in
     auto get_speed = [&](uint8_t flow_mask, bool faded,
                          uint64_t second_of_week) -> std::optional<uint32_t> {
@@ -1288,36 +1428,36 @@ TripLeg_Edge* AddTripEdge(const AttributesController& controller,
       }
     };
 
-    if (time_info.valid && controller(kEdgeSpeedsFaded) &&
+    if (time_info.valid && plan.edge_speeds_faded &&
         graphtile->trafficspeed(directededge).speed_valid()) {
       set_speeds(trip_edge->mutable_speeds_faded(), true);
     }
-    if (controller(kEdgeSpeedsNonFaded)) {
+    if (plan.edge_speeds_non_faded) {
       set_speeds(trip_edge->mutable_speeds_non_faded(), false);
     }
   }
 
   // Set country crossing if requested
-  if (controller(kEdgeCountryCrossing)) {
+  if (plan.edge_country_crossing) {
     trip_edge->set_country_crossing(directededge->ctry_crossing());
   }
 
   // Set forward if requested
-  if (controller(kEdgeForward)) {
+  if (plan.edge_forward) {
     trip_edge->set_forward(directededge->forward());
   }
 
   // Set traffic signal if requested
-  if (controller(kEdgeTrafficSignal)) {
+  if (plan.edge_traffic_signal) {
     trip_edge->set_traffic_signal(directededge->traffic_signal());
   }
 
   // Set hov type if requested
-  if (controller(kEdgeHovType)) {
+  if (plan.edge_hov_type) {
     trip_edge->set_hov_type(GetTripLegHovType(directededge->hov_type()));
   }
 
-  if (controller(kEdgeLevels)) {
+  if (plan.edge_levels) {
     trip_edge->set_level_precision(std::max(static_cast<uint32_t>(1), levels.second));
     for (const auto& level : levels.first) {
       auto proto_level = trip_edge->mutable_levels()->Add();
@@ -1338,7 +1478,7 @@ TripLeg_Edge* AddTripEdge(const AttributesController& controller,
   // Test whether edge is traversed forward or reverse
   if (directededge->forward()) {
     // Set traversability for forward directededge if requested
-    if (controller(kEdgeTraversability)) {
+    if (plan.edge_traversability) {
       if ((directededge->forwardaccess() & kAccess) && (directededge->reverseaccess() & kAccess)) {
         trip_edge->set_traversability(TripLeg_Traversability::TripLeg_Traversability_kBoth);
       } else if ((directededge->forwardaccess() & kAccess) &&
@@ -1353,7 +1493,7 @@ TripLeg_Edge* AddTripEdge(const AttributesController& controller,
     }
   } else {
     // Set traversability for reverse directededge if requested
-    if (controller(kEdgeTraversability)) {
+    if (plan.edge_traversability) {
       if ((directededge->forwardaccess() & kAccess) && (directededge->reverseaccess() & kAccess)) {
         trip_edge->set_traversability(TripLeg_Traversability::TripLeg_Traversability_kBoth);
       } else if (!(directededge->forwardaccess() & kAccess) &&
@@ -1378,61 +1518,61 @@ TripLeg_Edge* AddTripEdge(const AttributesController& controller,
   trip_edge->set_has_time_restrictions(edge_itr->restriction_index != kInvalidRestriction);
 
   // Set the trip path use based on directed edge use if requested
-  if (controller(kEdgeUse)) {
+  if (plan.edge_use) {
     trip_edge->set_use(GetTripLegUse(directededge->use()));
   }
 
   // Set toll flag if requested
-  if (directededge->toll() && controller(kEdgeToll)) {
+  if (directededge->toll() && plan.edge_toll) {
     trip_edge->set_toll(true);
   }
 
   // Set unpaved flag if requested
-  if (directededge->unpaved() && controller(kEdgeUnpaved)) {
+  if (directededge->unpaved() && plan.edge_unpaved) {
     trip_edge->set_unpaved(true);
   }
 
   // Set tunnel flag if requested
-  if (directededge->tunnel() && controller(kEdgeTunnel)) {
+  if (directededge->tunnel() && plan.edge_tunnel) {
     trip_edge->set_tunnel(true);
   }
 
   // Set bridge flag if requested
-  if (directededge->bridge() && controller(kEdgeBridge)) {
+  if (directededge->bridge() && plan.edge_bridge) {
     trip_edge->set_bridge(true);
   }
 
   // Set roundabout flag if requested
-  if (directededge->roundabout() && controller(kEdgeRoundabout)) {
+  if (directededge->roundabout() && plan.edge_roundabout) {
     trip_edge->set_roundabout(true);
   }
 
   // Set internal intersection flag if requested
-  if (directededge->internal() && controller(kEdgeInternalIntersection)) {
+  if (directededge->internal() && plan.edge_internal_intersection) {
     trip_edge->set_internal_intersection(true);
   }
 
   // Set drive_on_right if requested
-  if (controller(kEdgeDriveOnRight)) {
+  if (plan.edge_drive_on_right) {
     trip_edge->set_drive_on_left(!drive_on_right);
   }
 
   // Set surface if requested
-  if (controller(kEdgeSurface)) {
+  if (plan.edge_surface) {
     trip_edge->set_surface(GetTripLegSurface(directededge->surface()));
   }
 
   // Set curvature if requested
-  if (controller(kEdgeCurvature)) {
+  if (plan.edge_curvature) {
     trip_edge->set_curvature(directededge->curvature());
   }
 
-  if (directededge->destonly() && controller(kEdgeDestinationOnly)) {
+  if (directededge->destonly() && plan.edge_destination_only) {
     trip_edge->set_destination_only(directededge->destonly());
   }
 
   // Set indoor flag if requested
-  if (directededge->indoor() && controller(kEdgeIndoor)) {
+  if (directededge->indoor() && plan.edge_indoor) {
     trip_edge->set_indoor(true);
   }
 
@@ -1440,78 +1580,78 @@ TripLeg_Edge* AddTripEdge(const AttributesController& controller,
   if (mode == sif::TravelMode::kBicycle) {
     // Override bicycle mode with pedestrian if dismount flag or steps
     if (directededge->dismount() || directededge->use() == Use::kSteps) {
-      if (controller(kEdgeTravelMode)) {
+      if (plan.edge_travel_mode) {
         trip_edge->set_travel_mode(valhalla::TravelMode::kPedestrian);
       }
-      if (controller(kEdgePedestrianType)) {
+      if (plan.edge_pedestrian_type) {
         trip_edge->set_pedestrian_type(valhalla::PedestrianType::kFoot);
       }
     } else {
-      if (controller(kEdgeTravelMode)) {
+      if (plan.edge_travel_mode) {
         trip_edge->set_travel_mode(valhalla::TravelMode::kBicycle);
       }
-      if (controller(kEdgeBicycleType)) {
+      if (plan.edge_bicycle_type) {
         trip_edge->set_bicycle_type(GetTripLegBicycleType(travel_type));
       }
     }
   } else if (mode == sif::TravelMode::kDrive) {
-    if (controller(kEdgeTravelMode)) {
+    if (plan.edge_travel_mode) {
       trip_edge->set_travel_mode(valhalla::TravelMode::kDrive);
     }
-    if (controller(kEdgeVehicleType)) {
+    if (plan.edge_vehicle_type) {
       trip_edge->set_vehicle_type(GetTripLegVehicleType(travel_type));
     }
   } else if (mode == sif::TravelMode::kPedestrian) {
-    if (controller(kEdgeTravelMode)) {
+    if (plan.edge_travel_mode) {
       trip_edge->set_travel_mode(valhalla::TravelMode::kPedestrian);
     }
-    if (controller(kEdgePedestrianType)) {
+    if (plan.edge_pedestrian_type) {
       trip_edge->set_pedestrian_type(GetTripLegPedestrianType(travel_type));
     }
   } else if (mode == sif::TravelMode::kPublicTransit) {
-    if (controller(kEdgeTravelMode)) {
+    if (plan.edge_travel_mode) {
       trip_edge->set_travel_mode(valhalla::TravelMode::kTransit);
     }
   }
 
   // Set edge id (graphid value) if requested
-  if (controller(kEdgeId)) {
+  if (plan.edge_id) {
     trip_edge->set_id(edge.value);
   }
 
   // Set way id (base data id) if requested
-  if (controller(kEdgeWayId)) {
+  if (plan.edge_way_id) {
     trip_edge->set_way_id(edgeinfo.wayid());
   }
 
-  if ((controller(kEdgeBeginOsmNodeId) || controller(kEdgeEndOsmNodeId)) &&
+  if ((plan.edge_begin_osm_node_id || plan.edge_end_osm_node_id) &&
       !edgeinfo.osm_node_ids().empty()) {
     const auto& osm_ids = edgeinfo.osm_node_ids();
     const bool forward = directededge->forward();
 
-    if (controller(kEdgeBeginOsmNodeId)) {
+    if (plan.edge_begin_osm_node_id) {
       trip_edge->set_begin_osm_node_id(forward ? osm_ids.front() : osm_ids.back());
     }
 
-    if (controller(kEdgeEndOsmNodeId)) {
+    if (plan.edge_end_osm_node_id) {
       trip_edge->set_end_osm_node_id(forward ? osm_ids.back() : osm_ids.front());
     }
   }
 
   // Set weighted grade if requested
-  if (controller(kEdgeWeightedGrade)) {
+  if (plan.edge_weighted_grade) {
     trip_edge->set_weighted_grade((directededge->weighted_grade() - 6.f) / 0.6f);
   }
 
   // Set maximum upward and downward grade if requested (set to kNoElevationData if unavailable)
-  if (controller(kEdgeMaxUpwardGrade)) {
+  if (plan.edge_max_upward_grade) {
     if (graphtile->header()->has_elevation()) {
       trip_edge->set_max_upward_grade(directededge->max_up_slope());
     } else {
       trip_edge->set_max_upward_grade(kNoElevationData);
     }
   }
-  if (controller(kEdgeMaxDownwardGrade)) {
+  if (plan.edge_max_downward_grade) {
     if (graphtile->header()->has_elevation()) {
       trip_edge->set_max_downward_grade(directededge->max_down_slope());
     } else {
@@ -1520,15 +1660,15 @@ TripLeg_Edge* AddTripEdge(const AttributesController& controller,
   }
 
   // Set mean elevation if requested (will be kNoElevationData if unavailable)
-  if (controller(kEdgeMeanElevation)) {
+  if (plan.edge_mean_elevation) {
     trip_edge->set_mean_elevation(edgeinfo.mean_elevation());
   }
 
-  if (controller(kEdgeLaneCount)) {
+  if (plan.edge_lane_count) {
     trip_edge->set_lane_count(directededge->lanecount());
   }
 
-  if (directededge->laneconnectivity() && controller(kEdgeLaneConnectivity)) {
+  if (directededge->laneconnectivity() && plan.edge_lane_connectivity) {
     auto laneconnectivity = graphtile->GetLaneConnectivity(idx);
     trip_edge->mutable_lane_connectivity()->Reserve(laneconnectivity.size());
     for (const auto& l : laneconnectivity) {
@@ -1539,23 +1679,23 @@ TripLeg_Edge* AddTripEdge(const AttributesController& controller,
     }
   }
 
-  if (directededge->cyclelane() != CycleLane::kNone && controller(kEdgeCycleLane)) {
+  if (directededge->cyclelane() != CycleLane::kNone && plan.edge_cycle_lane) {
     trip_edge->set_cycle_lane(GetTripLegCycleLane(directededge->cyclelane()));
   }
 
-  if (controller(kEdgeBicycleNetwork)) {
+  if (plan.edge_bicycle_network) {
     trip_edge->set_bicycle_network(directededge->bike_network());
   }
 
-  if (controller(kEdgeSacScale)) {
+  if (plan.edge_sac_scale) {
     trip_edge->set_sac_scale(GetTripLegSacScale(directededge->sac_scale()));
   }
 
-  if (controller(kEdgeShoulder)) {
+  if (plan.edge_shoulder) {
     trip_edge->set_shoulder(directededge->shoulder());
   }
 
-  if (controller(kEdgeSidewalk)) {
+  if (plan.edge_sidewalk) {
     if (directededge->sidewalk_left() && directededge->sidewalk_right()) {
       trip_edge->set_sidewalk(TripLeg_Sidewalk::TripLeg_Sidewalk_kBothSides);
     } else if (directededge->sidewalk_left()) {
@@ -1565,20 +1705,20 @@ TripLeg_Edge* AddTripEdge(const AttributesController& controller,
     }
   }
 
-  if (controller(kEdgeDensity)) {
+  if (plan.edge_density) {
     trip_edge->set_density(directededge->density());
   }
 
-  if (controller(kEdgeIsUrban)) {
+  if (plan.edge_is_urban) {
     bool is_urban = (directededge->density() > 8) ? true : false;
     trip_edge->set_is_urban(is_urban);
   }
 
-  if (controller(kEdgeSpeedLimit)) {
+  if (plan.edge_speed_limit) {
     trip_edge->set_speed_limit(edgeinfo.speed_limit());
   }
 
-  if (controller(kEdgeConditionalSpeedLimits)) {
+  if (plan.edge_conditional_speed_limits) {
     auto conditional_limits = edgeinfo.conditional_speed_limits();
     trip_edge->mutable_conditional_speed_limits()->Reserve(conditional_limits.size());
     for (const auto& limit : conditional_limits) {
@@ -1610,15 +1750,15 @@ TripLeg_Edge* AddTripEdge(const AttributesController& controller,
     }
   }
 
-  if (controller(kEdgeDefaultSpeed)) {
+  if (plan.edge_default_speed) {
     trip_edge->set_default_speed(directededge->speed());
   }
 
-  if (controller(kEdgeTruckSpeed)) {
+  if (plan.edge_truck_speed) {
     trip_edge->set_truck_speed(directededge->truck_speed());
   }
 
-  if (directededge->truck_route() && controller(kEdgeTruckRoute)) {
+  if (directededge->truck_route() && plan.edge_truck_route) {
     trip_edge->set_truck_route(true);
   }
 
@@ -1627,6 +1767,7 @@ TripLeg_Edge* AddTripEdge(const AttributesController& controller,
   if (edge_itr->trip_id && (directededge->use() == Use::kRail || directededge->use() == Use::kBus)) {
 
     TransitRouteInfo* transit_route_info = trip_edge->mutable_transit_route_info();
+    const auto& controller = plan.controller;
 
     // Set block_id if requested
     if (controller(kEdgeTransitRouteInfoBlockId)) {
@@ -1823,6 +1964,9 @@ void TripLegBuilder::Build(
     (*interrupt_callback)();
   }
 
+  // Look up the requested attributes once for the whole leg
+  const AttributePlan plan(controller);
+
   // Remember what algorithms were used to create this leg
   *trip_path.mutable_algorithms() = {algorithms.begin(), algorithms.end()};
 
@@ -1972,7 +2116,7 @@ void TripLegBuilder::Build(
     }
     const NodeInfo* node = start_tile->node(startnode);
 
-    if (osmchangeset == 0 && controller(kOsmChangeset)) {
+    if (osmchangeset == 0 && plan.osm_changeset) {
       osmchangeset = start_tile->header()->dataset_id();
     }
 
@@ -1985,22 +2129,22 @@ void TripLegBuilder::Build(
     // Add a node to the trip path and set its attributes.
     TripLeg_Node* trip_node = trip_path.add_node();
 
-    if (controller(kNodeType)) {
+    if (plan.node_type) {
       trip_node->set_type(GetTripLegNodeType(node->type()));
     }
 
-    if (controller(kNodeTrafficSignal) && node->traffic_signal()) {
+    if (plan.node_traffic_signal && node->traffic_signal()) {
       trip_node->set_traffic_signal(true);
     }
 
     if (node->intersection() == IntersectionType::kFork) {
-      if (controller(kNodeFork)) {
+      if (plan.node_fork) {
         trip_node->set_fork(true);
       }
     }
 
     // Assign the elapsed time from the start of the leg
-    if (controller(kNodeElapsedTime)) {
+    if (plan.node_elapsed_time) {
       if (edge_itr == path_begin) {
         trip_node->mutable_cost()->mutable_elapsed_cost()->set_seconds(0);
         trip_node->mutable_cost()->mutable_elapsed_cost()->set_cost(0);
@@ -2013,19 +2157,19 @@ void TripLegBuilder::Build(
     }
 
     // Assign the admin index
-    if (controller(kNodeAdminIndex)) {
+    if (plan.node_admin_index) {
       trip_node->set_admin_index(
           GetAdminIndex(start_tile->admininfo(node->admin_index()), admin_info_map, admin_info_list));
     }
 
-    if (controller(kNodeTimeZone)) {
+    if (plan.node_time_zone) {
       auto tz = DateTime::get_tz_db().from_index(node->timezone());
       if (tz) {
         trip_node->set_time_zone(tz->name());
       }
     }
 
-    if (controller(kNodeTransitionTime)) {
+    if (plan.node_transition_time) {
       trip_node->mutable_cost()->mutable_transition_cost()->set_seconds(
           edge_itr->transition_cost.secs);
       trip_node->mutable_cost()->mutable_transition_cost()->set_cost(edge_itr->transition_cost.cost);
@@ -2042,8 +2186,8 @@ void TripLegBuilder::Build(
     std::pair<std::vector<std::pair<float, float>>, uint32_t> levels = edgeinfo.levels();
     // Add edge to the trip node and set its attributes
     TripLeg_Edge* trip_edge =
-        AddTripEdge(controller, edge, edge_itr, multimodal_builder.block_id, mode, travel_type,
-                    costing, directededge, node->drive_on_right(), trip_node, graphtile, time_info,
+        AddTripEdge(plan, edge, edge_itr, multimodal_builder.block_id, mode, travel_type, costing,
+                    directededge, node->drive_on_right(), trip_node, graphtile, time_info,
                     startnode.id(), node->named_intersection(), start_tile,
                     travel_type == PedestrianType::kBlind && mode == sif::TravelMode::kPedestrian,
                     edgeinfo, levels);
@@ -2198,7 +2342,7 @@ void TripLegBuilder::Build(
     }
 
     // Set length if requested. Convert to km
-    if (controller(kEdgeLength)) {
+    if (plan.edge_length) {
       float km =
           std::max(directededge->length() * kKmPerMeter * (trim_end_pct - trim_start_pct), 0.0f);
       trip_edge->set_length_km(km);
@@ -2210,42 +2354,45 @@ void TripLegBuilder::Build(
       edge_seconds -= std::prev(edge_itr)->elapsed_cost.secs;
 
     // Set shape attributes, sending incidents enables them in the pbf
-    auto incidents = controller(kIncidents) ? graphreader.GetIncidents(edge_itr->edgeid, graphtile)
-                                            : valhalla::baldr::IncidentResult{};
+    auto incidents = plan.incidents ? graphreader.GetIncidents(edge_itr->edgeid, graphtile)
+                                    : valhalla::baldr::IncidentResult{};
 
+    // The end node's tile is only needed for the country of the incidents
     graph_tile_ptr end_node_tile = graphtile;
-    graphreader.GetGraphTile(directededge->endnode(), end_node_tile);
-    SetShapeAttributes(controller, graphtile, end_node_tile, directededge, trip_shape, begin_index,
+    if (incidents.start_index != incidents.end_index) {
+      graphreader.GetGraphTile(directededge->endnode(), end_node_tile);
+    }
+    SetShapeAttributes(plan, graphtile, end_node_tile, directededge, trip_shape, begin_index,
                        trip_path, trim_start_pct, trim_end_pct, edge_seconds,
                        costing->flow_mask() & kCurrentFlowMask, incidents);
 
     // Set begin shape index if requested
-    if (controller(kEdgeBeginShapeIndex)) {
+    if (plan.edge_begin_shape_index) {
       trip_edge->set_begin_shape_index(begin_index);
     }
 
     // Set end shape index if requested
-    if (controller(kEdgeEndShapeIndex)) {
+    if (plan.edge_end_shape_index) {
       trip_edge->set_end_shape_index(trip_shape.size() - 1);
     }
 
     // Set begin and end heading if requested. Uses trip_shape so
     // must be done after the edge's shape has been added.
-    SetHeadings(trip_edge, controller, directededge, trip_shape, begin_index);
+    SetHeadings(trip_edge, plan, directededge, trip_shape, begin_index);
 
     // Add elevation along the edge if requested
-    if (controller(kEdgeElevation)) {
+    if (plan.edge_elevation) {
       SetElevation(trip_edge, trim_start_pct, trim_end_pct, node, directededge, graphtile,
                    graphreader);
     }
 
     // Add landmarks in the directededge to the trip leg
-    AddLandmarks(edgeinfo, trip_edge, controller, directededge, trip_shape, begin_index);
+    AddLandmarks(edgeinfo, trip_edge, plan, directededge, trip_shape, begin_index);
 
     // Add the intersecting edges at the node. Skip it if the node was an inner node (excluding start
     // node and end node) of a shortcut that was recovered.
-    if (startnode.is_valid() && !edge_itr->start_node_is_recovered) {
-      AddIntersectingEdges(controller, start_tile, node, directededge, prev_de, prior_opp_local_index,
+    if (plan.intersecting_edges && startnode.is_valid() && !edge_itr->start_node_is_recovered) {
+      AddIntersectingEdges(plan, start_tile, node, directededge, prev_de, prior_opp_local_index,
                            graphreader, trip_node,
                            travel_type == PedestrianType::kBlind &&
                                mode == sif::TravelMode::kPedestrian);
@@ -2273,7 +2420,7 @@ void TripLegBuilder::Build(
 
   // Add the last node
   auto* node = trip_path.add_node();
-  if (controller(kNodeAdminIndex)) {
+  if (plan.node_admin_index) {
     auto last_tile = graphreader.GetGraphTile(startnode);
     if (last_tile == nullptr) {
       throw tile_gone_error_t("TripLegBuilder::Build failed", startnode);
@@ -2282,17 +2429,17 @@ void TripLegBuilder::Build(
         GetAdminIndex(last_tile->admininfo(last_tile->node(startnode)->admin_index()), admin_info_map,
                       admin_info_list));
   }
-  if (controller(kNodeElapsedTime)) {
+  if (plan.node_elapsed_time) {
     node->mutable_cost()->mutable_elapsed_cost()->set_seconds(std::prev(path_end)->elapsed_cost.secs);
     node->mutable_cost()->mutable_elapsed_cost()->set_cost(std::prev(path_end)->elapsed_cost.cost);
   }
 
-  if (controller(kNodeTransitionTime)) {
+  if (plan.node_transition_time) {
     node->mutable_cost()->mutable_transition_cost()->set_seconds(0);
     node->mutable_cost()->mutable_transition_cost()->set_cost(0);
   }
 
-  if (controller(kShapeAttributesClosure)) {
+  if (plan.shape_attributes_closure) {
     // Set the end shape index if we're ending on a closure as the last index is
     // not processed in SetShapeAttributes above
     valhalla::TripLeg_Closure* closure = fetch_last_closure_annotation(trip_path);
@@ -2308,11 +2455,11 @@ void TripLegBuilder::Build(
   SetBoundingBox(trip_path, trip_shape);
 
   // Set shape if requested
-  if (controller(kShape)) {
+  if (plan.shape) {
     trip_path.set_shape(encode<std::vector<PointLL>>(trip_shape));
   }
 
-  if (osmchangeset != 0 && controller(kOsmChangeset)) {
+  if (osmchangeset != 0 && plan.osm_changeset) {
     trip_path.set_osm_changeset(osmchangeset);
   }
 
@@ -79,6 +79,10 @@ bool UnidirectionalAStar<expansion_direction, FORWARD>::Expand(GraphReader& grap
       FORWARD ? time_info.forward(pred.cost().secs, static_cast<int>(nodeinfo->timezone()))
               : time_info.reverse(pred.cost().secs, static_cast<int>(nodeinfo->timezone()));
 
+  // Compute the heuristics of the end nodes of all the edges at once
+  heuristic_batch_.Gather(node, tile, nodeinfo);
+  heuristic_batch_.Compute(astarheuristic_);
+
   if (!costing_->Allowed(nodeinfo)) {
     const DirectedEdge* opp_edge = nullptr;
     const GraphId opp_edge_id = graphreader.GetOpposingEdgeId(pred.edgeid(), opp_edge, tile);
@@ -220,8 +224,6 @@ inline bool UnidirectionalAStar<expansion_direction, FORWARD>::ExpandInner(
                                                 0 != (flow_sources & kDefaultFlowMask),
                                                 pred.internal_turn());
 
-  auto endpoint = endtile->get_node_ll(meta.edge->endnode());
-
   auto add_label = [&](const valhalla::PathEdge* dest_path_edge) {
     /*
      * NOTE:
@@ -257,9 +259,14 @@ inline bool UnidirectionalAStar<expansion_direction, FORWARD>::ExpandInner(
     auto cost = pred.cost() + transition_cost + edge_cost * percent_traversed;
     cost.cost += dest_path_edge ? dest_path_edge->distance() : 0.0f;
 
+    // Expand has computed the distances of the end nodes of the node's edges in its tile
     auto dist = 0.0f;
-    auto sortcost =
-        cost.cost + (dest_path_edge ? astarheuristic_.Get(0) : astarheuristic_.Get(endpoint, dist));
+    if (!dest_path_edge) {
+      dist = heuristic_batch_.Has(meta.edge_id, meta.edge)
+                 ? heuristic_batch_.Distance(meta.edge_id)
+                 : astarheuristic_.GetDistance(endtile->get_node_ll(meta.edge->endnode()));
+    }
+    auto sortcost = cost.cost + astarheuristic_.Get(dist);
 
     auto path_distance =
         static_cast<uint32_t>(pred.path_distance() + meta.edge->length() * percent_traversed + .5f);
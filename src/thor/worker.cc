@@ -4,6 +4,7 @@
 
 #include <boost/property_tree/ptree.hpp>
 
+#include <algorithm>
 #include <functional>
 #include <stdexcept>
 #include <string>
@@ -62,12 +63,19 @@ thor_worker_t::thor_worker_t(const boost::property_tree::ptree& config,
     : service_worker_t(config), mode(valhalla::sif::TravelMode::kPedestrian),
       bidir_astar(config.get_child("thor")), multimodal_astar(config.get_child("thor")),
       multi_modal_transit(config.get_child("thor")), timedep_forward(config.get_child("thor")),
-      timedep_reverse(config.get_child("thor")), costmatrix_(config.get_child("thor")),
-      time_distance_matrix_(config.get_child("thor")),
+      timedep_reverse(config.get_child("thor")), route_cache_(config.get_child("thor")),
+      costmatrix_(config.get_child("thor")), time_distance_matrix_(config.get_child("thor")),
       time_distance_bss_matrix_(config.get_child("thor")), isochrone_gen(config.get_child("thor")),
+      isochrone_contour_concurrency(
+          std::max(config.get<uint32_t>("thor.isochrone.contour_concurrency", 1), 1u)),
+      accessibility_gen(config.get_child("thor")),
+      optimizer_(config.get_child("thor")),
+      optimizer_annealing_(config.get<std::string>("thor.optimizer.engine", "local_search") ==
+                           "annealing"),
       reader(graph_reader ? graph_reader
                           : std::make_shared<baldr::GraphReader>(config.get_child("mjolnir"))),
-      matcher_factory(config, reader), controller{},
+      matcher_factory(config, reader), tileset_generation_(reader->TileSetGeneration()),
+      controller{},
       allow_hierarchy_limits_modifications(
           config.get<bool>("service_limits.hierarchy_limits.allow_modification", false)),
       min_linear_cost_factor(config.get<double>("service_limits.min_linear_cost_factor", 1.0)),
@@ -102,6 +110,12 @@ thor_worker_t::thor_worker_t(const boost::property_tree::ptree& config,
 
   costmatrix_allow_second_pass = config.get<bool>("thor.costmatrix.allow_second_pass", false);
 
+  auto batch_concurrency =
+      std::max(config.get<uint32_t>("thor.isochrone.batch_concurrency", 1), 1u);
+  for (uint32_t i = 1; i < batch_concurrency; ++i) {
+    isochrone_workers_.emplace_back(std::make_unique<Isochrone>(config.get_child("thor")));
+  }
+
   max_timedep_distance =
       config.get<float>("service_limits.max_timedep_distance", kDefaultMaxTimeDependentDistance);
 
@@ -140,8 +154,11 @@ thor_worker_t::work(const std::list<zmq::message_t>& job,
 
     // Set the interrupt function
     service_worker_t::set_interrupt(&interrupt_function);
+    refresh_tileset();
 
-    // do request specific processing
+    // do request specific processing. matrix and isochrone responses are not streamed here, a
+    // prime_server worker hands its result to the server only once it returns so chunking the
+    // body would neither get the first bytes out sooner nor keep the memory flat
     switch (options.action()) {
       case Options::sources_to_targets:
         result = to_response(matrix(request), info, request);
@@ -154,6 +171,9 @@ thor_worker_t::work(const std::list<zmq::message_t>& job,
       case Options::isochrone:
         result = to_response(isochrones(request), info, request);
         break;
+      case Options::accessibility:
+        result = to_response(accessibility(request), info, request);
+        break;
       case Options::route: {
         route(request);
         result.messages.emplace_back(serialize_to_pbf(request));
@@ -362,6 +382,10 @@ void thor_worker_t::cleanup() {
   time_distance_matrix_.Clear();
   time_distance_bss_matrix_.Clear();
   isochrone_gen.Clear();
+  for (auto& isochrone : isochrone_workers_) {
+    isochrone->Clear();
+  }
+  accessibility_gen.Clear();
   centroid_gen.Clear();
   matcher_factory.ClearFullCache();
   if (reader->OverCommitted()) {
@@ -373,5 +397,14 @@ void thor_worker_t::set_interrupt(const std::function<void()>* interrupt_functio
   interrupt = interrupt_function;
   reader->SetInterrupt(interrupt);
 }
+
+void thor_worker_t::refresh_tileset() {
+  reader->ReloadIfRequested();
+  // the reader may be shared with another worker which already reloaded it
+  if (tileset_generation_ != reader->TileSetGeneration()) {
+    tileset_generation_ = reader->TileSetGeneration();
+    matcher_factory.ClearFullCache();
+  }
+}
 } // namespace thor
 } // namespace valhalla
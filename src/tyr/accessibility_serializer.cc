@@ -0,0 +1,82 @@
+#include "baldr/graphconstants.h"
+#include "baldr/rapidjson_utils.h"
+#include "midgard/constants.h"
+#include "proto_conversions.h"
+#include "tyr/serializers.h"
+
+#include <cstdint>
+
+using namespace valhalla;
+using namespace valhalla::midgard;
+using namespace valhalla::baldr;
+
+namespace {
+
+void serialize_score(const Accessibility::Score& score,
+                     const double distance_scale,
+                     rapidjson::writer_wrapper_t& writer) {
+  writer.start_object();
+  writer.set_precision(2);
+  writer(score.metric() == Accessibility::time ? "time" : "distance", score.metric_value());
+  writer.set_precision(tyr::kDefaultPrecision);
+  writer("length", score.length() * distance_scale);
+  writer("edges", static_cast<uint64_t>(score.edges()));
+  writer.start_object("road_classes");
+  for (int i = 0; i < score.road_class_edges_size(); ++i) {
+    writer(to_string(static_cast<RoadClass>(i)), static_cast<uint64_t>(score.road_class_edges(i)));
+  }
+  writer.end_object();
+  writer("targets", static_cast<uint64_t>(score.targets()));
+  writer.end_object();
+}
+
+std::string serializeAccessibilityJson(const Api& request) {
+  const auto& options = request.options();
+  double distance_scale = (options.units() == Options::miles) ? kMilePerMeter : kKmPerMeter;
+
+  rapidjson::writer_wrapper_t writer(4096);
+  writer.start_object();
+  writer.start_array("accessibility");
+  for (int i = 0; i < request.accessibility().origins_size(); ++i) {
+    const auto& location = options.locations(i);
+    writer.start_object();
+    writer.set_precision(tyr::kCoordinatePrecision);
+    writer("lat", location.ll().lat());
+    writer("lon", location.ll().lng());
+    writer.start_array("contours");
+    for (const auto& score : request.accessibility().origins(i).scores()) {
+      serialize_score(score, distance_scale, writer);
+    }
+    writer.end_array();
+    writer.end_object();
+  }
+  writer.end_array();
+
+  writer("units", Options_Units_Enum_Name(options.units()));
+  if (options.has_id_case()) {
+    writer("id", options.id());
+  }
+
+  // add warnings to json response
+  if (request.info().warnings_size() >= 1) {
+    tyr::serializeWarnings(request, writer);
+  }
+
+  writer.end_object();
+  return writer.get_buffer();
+}
+
+} // namespace
+
+namespace valhalla {
+namespace tyr {
+
+std::string serializeAccessibility(Api& request) {
+  if (request.options().format() == Options_Format_pbf) {
+    return serializePbf(request);
+  }
+  return serializeAccessibilityJson(request);
+}
+
+} // namespace tyr
+} // namespace valhalla
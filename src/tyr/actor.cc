@@ -32,6 +32,9 @@ struct actor_t::pimpl_t {
     loki_worker.set_interrupt(interrupt_function);
     thor_worker.set_interrupt(interrupt_function);
     odin_worker.set_interrupt(interrupt_function);
+    // every request starts here so its a good time to pick up new tiles
+    loki_worker.refresh_tileset();
+    thor_worker.refresh_tileset();
   }
   void cleanup() {
     loki_worker.cleanup();
@@ -57,7 +60,9 @@ void actor_t::cleanup() {
   pimpl->cleanup();
 }
 
-std::string actor_t::act(Api& api, const std::function<void()>* interrupt) {
+std::string actor_t::act(Api& api,
+                         const std::function<void()>* interrupt,
+                         const std::function<void(const char*, size_t)>* sink) {
   if (api.options().action() == Options::no_action)
     throw valhalla_exception_t{106};
 
@@ -67,11 +72,11 @@ std::string actor_t::act(Api& api, const std::function<void()>* interrupt) {
     case Options::locate:
       return locate("", interrupt, &api);
     case Options::sources_to_targets:
-      return matrix("", interrupt, &api);
+      return matrix("", interrupt, &api, sink);
     case Options::optimized_route:
       return optimized_route("", interrupt, &api);
     case Options::isochrone:
-      return isochrone("", interrupt, &api);
+      return isochrone("", interrupt, &api, sink);
     case Options::trace_route:
       return trace_route("", interrupt, &api);
     case Options::trace_attributes:
@@ -88,6 +93,8 @@ std::string actor_t::act(Api& api, const std::function<void()>* interrupt) {
       return status("", interrupt, &api);
     case Options::tile:
       return tile("", interrupt, &api);
+    case Options::accessibility:
+      return accessibility("", interrupt, &api);
     default:
       throw valhalla_exception_t{106};
   }
@@ -137,8 +144,10 @@ actor_t::locate(const std::string& request_str, const std::function<void()>* int
   return json;
 }
 
-std::string
-actor_t::matrix(const std::string& request_str, const std::function<void()>* interrupt, Api* api) {
+std::string actor_t::matrix(const std::string& request_str,
+                            const std::function<void()>* interrupt,
+                            Api* api,
+                            const std::function<void(const char*, size_t)>* sink) {
   auto scoped_cleaner = make_finally([this]() {
     if (auto_cleanup)
       cleanup();
@@ -155,7 +164,7 @@ actor_t::matrix(const std::string& request_str, const std::function<void()>* int
   // check the request and locate the locations in the graph
   pimpl->loki_worker.matrix(*api);
   // compute the matrix
-  auto bytes = pimpl->thor_worker.matrix(*api);
+  auto bytes = pimpl->thor_worker.matrix(*api, sink);
   return bytes;
 }
 
@@ -184,8 +193,10 @@ std::string actor_t::optimized_route(const std::string& request_str,
   return bytes;
 }
 
-std::string
-actor_t::isochrone(const std::string& request_str, const std::function<void()>* interrupt, Api* api) {
+std::string actor_t::isochrone(const std::string& request_str,
+                               const std::function<void()>* interrupt,
+                               Api* api,
+                               const std::function<void(const char*, size_t)>* sink) {
   auto scoped_cleaner = make_finally([this]() {
     if (auto_cleanup)
       cleanup();
@@ -202,7 +213,7 @@ actor_t::isochrone(const std::string& request_str, const std::function<void()>*
   // check the request and locate the locations in the graph
   pimpl->loki_worker.isochrones(*api);
   // compute the isochrones
-  auto json = pimpl->thor_worker.isochrones(*api);
+  auto json = pimpl->thor_worker.isochrones(*api, sink);
   return json;
 }
 
@@ -392,5 +403,28 @@ actor_t::tile(const std::string& request_str, const std::function<void()>* inter
   return bytes;
 }
 
+std::string actor_t::accessibility(const std::string& request_str,
+                                   const std::function<void()>* interrupt,
+                                   Api* api) {
+  auto scoped_cleaner = make_finally([this]() {
+    if (auto_cleanup)
+      cleanup();
+  });
+  // set the interrupts
+  pimpl->set_interrupts(interrupt);
+  // if the caller doesn't want a copy we'll use this dummy
+  Api dummy;
+  if (!api) {
+    api = &dummy;
+  }
+  // parse the request
+  ParseApi(request_str, Options::accessibility, *api);
+  // check the request and locate the locations and targets in the graph
+  pimpl->loki_worker.accessibility(*api);
+  // score what is reachable from each location
+  auto json = pimpl->thor_worker.accessibility(*api);
+  return json;
+}
+
 } // namespace tyr
 } // namespace valhalla
@@ -13,6 +13,7 @@
 
 #include <cmath>
 #include <cstring>
+#include <functional>
 #include <limits>
 #include <ranges>
 #include <sstream>
@@ -388,8 +389,10 @@ std::string serializeIsochroneJson(Api& request,
                                    std::vector<contour_interval_t>& intervals,
                                    contours_t& contours,
                                    bool show_locations,
-                                   bool polygons) {
-  rapidjson::writer_wrapper_t writer(4096);
+                                   bool polygons,
+                                   const std::function<void(const char*, size_t)>* sink) {
+  auto writer = sink ? rapidjson::writer_wrapper_t(*sink, tyr::kStreamChunkSize)
+                     : rapidjson::writer_wrapper_t(4096);
   writer.start_object(); // feature_collection
   writer.start_array("features");
   // for each contour interval
@@ -448,6 +451,7 @@ std::string serializeIsochroneJson(Api& request,
 
       writer("type", "Feature");
       writer.end_object(); // feature
+      writer.flush();
     }
   }
 
@@ -467,6 +471,8 @@ std::string serializeIsochroneJson(Api& request,
   }
 
   writer.end_object(); // feature_collection
+  // when streaming this hands off the rest and leaves the buffer empty
+  writer.flush(true);
   return writer.get_buffer();
 }
 
@@ -517,10 +523,13 @@ namespace tyr {
 
 std::string serializeIsochrones(Api& request,
                                 std::vector<midgard::GriddedData<2>::contour_interval_t>& intervals,
-                                const std::shared_ptr<const midgard::GriddedData<2>>& isogrid) {
+                                const std::shared_ptr<const midgard::GriddedData<2>>& isogrid,
+                                const std::function<void(const char*, size_t)>* sink,
+                                uint32_t concurrency) {
 
   // only generate if json or pbf output is requested
   contours_t contours;
+  std::string bytes;
 
   switch (request.options().format()) {
     case Options_Format_pbf:
@@ -528,21 +537,31 @@ std::string serializeIsochrones(Api& request,
       // we have parallel vectors of contour properties and the actual geojson features
       // this method sorts the contour specifications by metric (time or distance) and then by value
       // with the largest values coming first. eg (60min, 30min, 10min, 40km, 10km)
-      contours =
-          isogrid->GenerateContours(intervals, request.options().polygons(),
-                                    request.options().denoise(), request.options().generalize());
-      return request.options().format() == Options_Format_json
-                 ? serializeIsochroneJson(request, intervals, contours,
-                                          request.options().show_locations(),
-                                          request.options().polygons())
-                 : serializeIsochronePbf(request, intervals, contours);
+      contours = isogrid->GenerateContours(intervals, request.options().polygons(),
+                                           request.options().denoise(),
+                                           request.options().generalize(), concurrency);
+      if (request.options().format() == Options_Format_json) {
+        return serializeIsochroneJson(request, intervals, contours,
+                                      request.options().show_locations(),
+                                      request.options().polygons(), sink);
+      }
+      bytes = serializeIsochronePbf(request, intervals, contours);
+      break;
 #ifdef ENABLE_GEOTIFF
     case Options_Format_geotiff:
-      return serializeGeoTIFF(request, isogrid);
+      bytes = serializeGeoTIFF(request, isogrid);
+      break;
 #endif
     default:
       throw;
   }
+
+  // the binary formats cant be written incrementally so the sink just gets them all at once
+  if (sink) {
+    (*sink)(bytes.data(), bytes.size());
+    bytes.clear();
+  }
+  return bytes;
 }
 } // namespace tyr
 } // namespace valhalla
@@ -3,7 +3,15 @@
 #include "thor/matrixalgorithm.h"
 #include "tyr/serializers.h"
 
+#include <zlib.h>
+
+#include <bit>
 #include <cstdint>
+#include <cstring>
+#include <functional>
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
 
 using namespace valhalla;
 using namespace valhalla::midgard;
@@ -72,8 +80,9 @@ void serialize_shape(const valhalla::Matrix& matrix,
 namespace osrm_serializers {
 
 // Serialize route response in OSRM compatible format.
-std::string serialize(const Api& request) {
-  rapidjson::writer_wrapper_t writer(4096);
+std::string serialize(const Api& request, const std::function<void(const char*, size_t)>* sink) {
+  auto writer = sink ? rapidjson::writer_wrapper_t(*sink, tyr::kStreamChunkSize)
+                     : rapidjson::writer_wrapper_t(4096);
   writer.start_object();
   const auto& options = request.options();
 
@@ -92,6 +101,7 @@ std::string serialize(const Api& request) {
     writer.start_array();
     serialize_duration(request.matrix(), writer, first_td, options.targets_size());
     writer.end_array();
+    writer.flush();
   }
   writer.end_array();
 
@@ -101,11 +111,14 @@ std::string serialize(const Api& request) {
     writer.start_array();
     serialize_distance(request.matrix(), writer, first_td, options.targets_size(), 1.0);
     writer.end_array();
+    writer.flush();
   }
   writer.end_array();
   writer("algorithm", MatrixAlgoToString(request.matrix().algorithm()));
 
   writer.end_object();
+  // when streaming this hands off the rest and leaves the buffer empty
+  writer.flush(true);
   return writer.get_buffer();
 }
 } // namespace osrm_serializers
@@ -218,18 +231,42 @@ void serialize_row(const valhalla::Matrix& matrix,
   writer.end_array();
 }
 
-std::string serialize(const Api& request, double distance_scale) {
-  rapidjson::writer_wrapper_t writer(4096);
+std::string serialize(const Api& request,
+                      double distance_scale,
+                      const std::function<void(const char*, size_t)>* sink) {
+  auto writer = sink ? rapidjson::writer_wrapper_t(*sink, tyr::kStreamChunkSize)
+                     : rapidjson::writer_wrapper_t(4096);
   writer.set_precision(tyr::kDefaultPrecision);
   writer.start_object();
   const auto& options = request.options();
 
+  // a date_time range has a matrix per date_time one after the other, which nests the rows one
+  // level deeper
+  const auto& matrix = request.matrix();
+  const bool range = matrix.date_times_size() > 0;
+  const int matrices = range ? matrix.date_times_size() : 1;
+  const size_t matrix_size = options.sources_size() * options.targets_size();
+  auto rows = [&](const std::function<void(size_t, int)>& row) {
+    for (int m = 0; m < matrices; ++m) {
+      if (range) {
+        writer.start_array();
+      }
+      for (int source_index = 0; source_index < options.sources_size(); ++source_index) {
+        row(m * matrix_size + source_index * options.targets_size(), source_index);
+        writer.flush();
+      }
+      if (range) {
+        writer.end_array();
+      }
+    }
+  };
+
   if (options.verbose()) {
     writer.start_array("sources_to_targets");
-    for (int source_index = 0; source_index < options.sources_size(); ++source_index) {
-      serialize_row(request.matrix(), writer, source_index * options.targets_size(),
-                    options.targets_size(), source_index, 0, distance_scale, options.shape_format());
-    }
+    rows([&](size_t first_td, int source_index) {
+      serialize_row(matrix, writer, first_td, options.targets_size(), source_index, 0,
+                    distance_scale, options.shape_format());
+    });
     writer.end_array(); // sources_to_targets
 
     writer.start_array("sources");
@@ -243,38 +280,40 @@ std::string serialize(const Api& request, double distance_scale) {
     writer.start_object("sources_to_targets");
 
     writer.start_array("durations");
-    for (int source_index = 0; source_index < options.sources_size(); ++source_index) {
-      const auto first_td = source_index * options.targets_size();
+    rows([&](size_t first_td, int) {
       writer.start_array();
-      serialize_duration(request.matrix(), writer, first_td, options.targets_size());
+      serialize_duration(matrix, writer, first_td, options.targets_size());
       writer.end_array();
-    }
+    });
     writer.end_array();
 
     writer.start_array("distances");
-    for (int source_index = 0; source_index < options.sources_size(); ++source_index) {
-      const auto first_td = source_index * options.targets_size();
+    rows([&](size_t first_td, int) {
       writer.start_array();
-      serialize_distance(request.matrix(), writer, first_td, options.targets_size(), distance_scale);
+      serialize_distance(matrix, writer, first_td, options.targets_size(), distance_scale);
       writer.end_array();
-    }
+    });
     writer.end_array();
 
-    if (!(options.shape_format() == no_shape ||
-          (request.matrix().algorithm() != Matrix::CostMatrix))) {
+    if (!(options.shape_format() == no_shape || (matrix.algorithm() != Matrix::CostMatrix))) {
       writer.start_array("shapes");
-      for (int source_index = 0; source_index < options.sources_size(); ++source_index) {
-        const auto first_td = source_index * options.targets_size();
+      rows([&](size_t first_td, int) {
         writer.start_array();
-        serialize_shape(request.matrix(), writer, first_td, options.targets_size(),
-                        options.shape_format());
+        serialize_shape(matrix, writer, first_td, options.targets_size(), options.shape_format());
         writer.end_array();
-      }
+      });
       writer.end_array();
     }
 
     writer.end_object(); // sources_to_targets
   }
+  if (range) {
+    writer.start_array("date_times");
+    for (const auto& date_time : matrix.date_times()) {
+      writer(date_time);
+    }
+    writer.end_array();
+  }
   writer("units", Options_Units_Enum_Name(options.units()));
   writer("algorithm", MatrixAlgoToString(request.matrix().algorithm()));
 
@@ -288,14 +327,82 @@ std::string serialize(const Api& request, double distance_scale) {
   }
 
   writer.end_object();
+  // when streaming this hands off the rest and leaves the buffer empty
+  writer.flush(true);
   return writer.get_buffer();
 }
 } // namespace valhalla_serializers
 
+namespace binary_serializers {
+
+// layout of the fixed size header which precedes the arrays, all fields are little-endian
+constexpr char kMagic[4] = {'V', 'M', 'T', 'X'};
+constexpr uint16_t kVersion = 1;
+constexpr uint8_t kCompressed = 1;
+constexpr size_t kHeaderSize = 32;
+
+// compilers turn this into a plain store on little-endian machines
+template <typename T> void write_le(char* out, T value) {
+  static_assert(std::is_unsigned_v<T>, "Only unsigned integers can be written");
+  for (size_t i = 0; i < sizeof(T); ++i) {
+    out[i] = static_cast<char>(value >> (8 * i));
+  }
+}
+
+// Serialize the times and distances as contiguous arrays so a client can just memcpy them
+std::string serialize(const Api& request) {
+  const auto& options = request.options();
+  const auto& matrix = request.matrix();
+  const size_t count = matrix.times_size();
+
+  // the times as float32 seconds then the distances as uint32 meters, both row-major. unfound
+  // connections get +inf for time and the max uint32 for distance
+  std::string payload(count * (sizeof(float) + sizeof(uint32_t)), '\0');
+  auto* times = payload.data();
+  auto* distances = times + count * sizeof(float);
+  for (size_t i = 0; i < count; ++i) {
+    const auto time = matrix.times(i);
+    const bool found = time != kMaxCost;
+    write_le(times + i * sizeof(float),
+             std::bit_cast<uint32_t>(found ? time : std::numeric_limits<float>::infinity()));
+    write_le(distances + i * sizeof(uint32_t),
+             found ? matrix.distances(i) : std::numeric_limits<uint32_t>::max());
+  }
+
+  // optionally deflate the arrays with zlib
+  uint8_t flags = 0;
+  if (options.compress()) {
+    uLongf compressed_size = compressBound(payload.size());
+    std::string compressed(compressed_size, '\0');
+    if (compress2(reinterpret_cast<Bytef*>(compressed.data()), &compressed_size,
+                  reinterpret_cast<const Bytef*>(payload.data()), payload.size(),
+                  Z_DEFAULT_COMPRESSION) != Z_OK) {
+      throw std::runtime_error("Failed to compress binary matrix");
+    }
+    compressed.resize(compressed_size);
+    payload.swap(compressed);
+    flags |= kCompressed;
+  }
+
+  // the header tells the client the shape of the arrays and how to decode them
+  std::string bytes(kHeaderSize, '\0');
+  std::memcpy(bytes.data(), kMagic, sizeof(kMagic));
+  write_le(bytes.data() + 4, kVersion);
+  bytes[6] = static_cast<char>(flags);
+  bytes[7] = static_cast<char>(matrix.algorithm());
+  write_le(bytes.data() + 8, static_cast<uint32_t>(options.sources_size()));
+  write_le(bytes.data() + 12, static_cast<uint32_t>(options.targets_size()));
+  write_le(bytes.data() + 16, static_cast<uint64_t>(count * (sizeof(float) + sizeof(uint32_t))));
+  write_le(bytes.data() + 24, static_cast<uint64_t>(payload.size()));
+  bytes.append(payload);
+  return bytes;
+}
+} // namespace binary_serializers
+
 namespace valhalla {
 namespace tyr {
 
-std::string serializeMatrix(Api& request) {
+std::string serializeMatrix(Api& request, const std::function<void(const char*, size_t)>* sink) {
   double distance_scale = (request.options().units() == Options::miles) ? kMilePerMeter : kKmPerMeter;
 
   // dont bother serializing in case of /expansion request
@@ -305,11 +412,21 @@ std::string serializeMatrix(Api& request) {
 
   switch (request.options().format()) {
     case Options_Format_osrm:
-      return osrm_serializers::serialize(request);
+      return osrm_serializers::serialize(request, sink);
     case Options_Format_json:
-      return valhalla_serializers::serialize(request, distance_scale);
+      return valhalla_serializers::serialize(request, distance_scale, sink);
     case Options_Format_pbf:
-      return serializePbf(request);
+    case Options_Format_binary: {
+      // these cant be written incrementally so the sink just gets it all at once
+      auto bytes = request.options().format() == Options_Format_pbf
+                       ? serializePbf(request)
+                       : binary_serializers::serialize(request);
+      if (sink) {
+        (*sink)(bytes.data(), bytes.size());
+        bytes.clear();
+      }
+      return bytes;
+    }
     default:
       throw;
   }
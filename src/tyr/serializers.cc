@@ -121,6 +121,23 @@ std::string serializeStatus(Api& request) {
     status_doc.AddMember("osm_changeset",
                          rapidjson::Value().SetUint64(request.status().osm_changeset()), alloc);
 
+  if (request.status().has_tileset_warm_up_case())
+    status_doc.AddMember("tileset_warm_up",
+                         rapidjson::Value().SetFloat(request.status().tileset_warm_up()), alloc);
+  if (request.status().has_tileset_generation_case())
+    status_doc.AddMember("tileset_generation",
+                         rapidjson::Value().SetUint64(request.status().tileset_generation()),
+                         alloc);
+  if (request.status().has_route_cache()) {
+    const auto& cache = request.status().route_cache();
+    rapidjson::Value cache_doc(rapidjson::kObjectType);
+    cache_doc.AddMember("hits", rapidjson::Value().SetUint64(cache.hits()), alloc);
+    cache_doc.AddMember("misses", rapidjson::Value().SetUint64(cache.misses()), alloc);
+    cache_doc.AddMember("entries", rapidjson::Value().SetUint64(cache.entries()), alloc);
+    cache_doc.AddMember("evictions", rapidjson::Value().SetUint64(cache.evictions()), alloc);
+    status_doc.AddMember("route_cache", cache_doc, alloc);
+  }
+
   rapidjson::Document bbox_doc;
   if (request.status().has_bbox_case()) {
     bbox_doc.Parse(request.status().bbox());
@@ -211,6 +228,9 @@ std::string serializePbf(Api& request) {
       case Options::expansion:
         selection.set_expansion(true);
         break;
+      case Options::accessibility:
+        selection.set_accessibility(true);
+        break;
       // should never get here, actions which dont have pbf yet return json
       default:
         throw std::logic_error("Requested action is not yet serializable as pbf");
@@ -240,6 +260,8 @@ std::string serializePbf(Api& request) {
     request.clear_isochrone();
   if (!selection.expansion())
     request.clear_expansion();
+  if (!selection.accessibility())
+    request.clear_accessibility();
 
   // serialize the bytes
   auto bytes = request.SerializeAsString();
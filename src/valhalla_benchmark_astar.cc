@@ -0,0 +1,154 @@
+#include "baldr/graphreader.h"
+#include "baldr/rapidjson_utils.h"
+#include "benchmark_utils.h"
+#include "loki/worker.h"
+#include "midgard/logging.h"
+#include "sif/costfactory.h"
+#include "thor/bidirectional_astar.h"
+#include "thor/unidirectional_astar.h"
+#include "worker.h"
+
+#include <boost/property_tree/ptree.hpp>
+#include <cxxopts.hpp>
+
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace valhalla;
+
+namespace {
+
+std::string make_request(const std::pair<double, double>& a,
+                         const std::pair<double, double>& b,
+                         const std::string& costing) {
+  rapidjson::writer_wrapper_t writer(512);
+  writer.start_object();
+  writer.start_array("locations");
+  for (const auto& ll : {a, b}) {
+    writer.start_object();
+    writer.set_precision(6);
+    writer("lon", ll.first);
+    writer("lat", ll.second);
+    writer.end_object();
+  }
+  writer.end_array();
+  writer("costing", costing);
+  writer.end_object();
+  return writer.get_buffer();
+}
+
+// a pair of correlated locations, ready to find the path between them again and again
+struct route_t {
+  Api request;
+  sif::mode_costing_t mode_costing;
+  sif::TravelMode mode;
+};
+
+} // namespace
+
+int main(int argc, char** argv) {
+  const auto program = std::filesystem::path(__FILE__).stem().string();
+  // args
+  boost::property_tree::ptree config;
+  std::vector<double> bbox;
+  uint32_t count, seed, repeats;
+  std::string costing;
+
+  // clang-format off
+  cxxopts::Options options(
+    program,
+    program + " " + VALHALLA_PRINT_VERSION + "\n\n"
+    "valhalla_benchmark_astar correlates random pairs of points in a bounding box and then\n"
+    "times finding the paths between them with the bidirectional and the unidirectional A*.\n"
+    "It reports the throughput in edges expanded per second, that is the edges the searches\n"
+    "reached and put on their adjacency lists.\n");
+
+  add_benchmark_options(options, true);
+  options.add_options()
+    ("b,bbox", "Bounding box of the points: min lon,min lat,max lon,max lat.", cxxopts::value<std::vector<double>>(bbox))
+    ("n,count", "How many pairs of points to route between.", cxxopts::value<uint32_t>(count)->default_value("1000"))
+    ("r,repeats", "How many times to find the paths of all the pairs.", cxxopts::value<uint32_t>(repeats)->default_value("3"))
+    ("costing", "The costing of the routes.", cxxopts::value<std::string>(costing)->default_value("auto"))
+    ("s,seed", "Seed of the random points.", cxxopts::value<uint32_t>(seed)->default_value("0"));
+  // clang-format on
+
+  if (auto exit_code = parse_benchmark_args(program, options, argc, argv, &config, &bbox))
+    return *exit_code;
+
+  auto reader = std::make_shared<baldr::GraphReader>(config.get_child("mjolnir"));
+  loki::loki_worker_t loki_worker(config, reader);
+  sif::CostFactory factory;
+
+  std::mt19937 generator(seed);
+  std::uniform_real_distribution<double> lon(bbox[0], bbox[2]), lat(bbox[1], bbox[3]);
+
+  // correlate the points up front, pairs of points that don't snap are left out
+  std::vector<route_t> routes;
+  routes.reserve(count);
+  for (uint32_t i = 0; i < count; ++i) {
+    route_t route;
+    auto request =
+        make_request({lon(generator), lat(generator)}, {lon(generator), lat(generator)}, costing);
+    try {
+      ParseApi(request, Options::route, route.request);
+      loki_worker.route(route.request);
+      route.mode_costing = factory.CreateModeCosting(*route.request.mutable_options(), route.mode);
+      routes.emplace_back(std::move(route));
+    } catch (const std::exception& e) {
+      LOG_DEBUG(std::string("Skipping route: ") + e.what());
+    }
+    loki_worker.cleanup();
+  }
+  if (routes.empty()) {
+    std::cerr << "None of the points could be correlated" << std::endl;
+    return EXIT_FAILURE;
+  }
+  std::cout << "Correlated " << routes.size() << " of " << count << " pairs of points\n";
+
+  // every edge the searches put on their adjacency lists is reported as reached
+  size_t edges = 0;
+  const auto count_edges = [&edges](baldr::GraphReader&, const baldr::GraphId, const baldr::GraphId,
+                                    const char*, const Expansion_EdgeStatus status, float, uint32_t,
+                                    float, const Expansion_ExpansionType, const uint8_t,
+                                    const TravelMode) {
+    edges += status == Expansion_EdgeStatus_reached;
+  };
+
+  thor::BidirectionalAStar bidirectional(config.get_child("thor"));
+  thor::TimeDepForward unidirectional(config.get_child("thor"));
+  const table_t table(
+      {{"algorithm", 16}, {"paths", 10}, {"edges", 14}, {"seconds", 12}, {"edges/s", 14}});
+  table.header();
+  for (thor::PathAlgorithm* algorithm :
+       std::vector<thor::PathAlgorithm*>{&bidirectional, &unidirectional}) {
+    algorithm->set_track_expansion(count_edges);
+    size_t paths = 0;
+    edges = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (uint32_t r = 0; r < repeats; ++r) {
+      for (const auto& route : routes) {
+        // the searches write to the locations, so each one gets its own copy
+        auto origin = route.request.options().locations(0);
+        auto destination = route.request.options().locations(1);
+        try {
+          auto found = algorithm->GetBestPath(origin, destination, *reader, route.mode_costing,
+                                              route.mode, route.request.options());
+          paths += !found.empty() && !found.front().empty();
+        } catch (const std::exception& e) {
+          LOG_DEBUG(std::string("Skipping route: ") + e.what());
+        }
+        algorithm->Clear();
+      }
+    }
+    double secs = seconds_since(start);
+    table.row(algorithm->name(), paths, edges, secs, edges / secs);
+  }
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,136 @@
+#include "baldr/rapidjson_utils.h"
+#include "benchmark_utils.h"
+#include "midgard/logging.h"
+#include "tyr/actor.h"
+
+#include <boost/property_tree/ptree.hpp>
+#include <cxxopts.hpp>
+
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace valhalla;
+
+namespace {
+
+// the request for the isochrones around the given origins, as a batch or around all of them
+std::string make_request(const std::vector<std::pair<double, double>>& origins,
+                         const std::string& costing,
+                         const float minutes,
+                         const bool batch) {
+  rapidjson::writer_wrapper_t writer(4096);
+  writer.start_object();
+  writer.start_array("locations");
+  for (const auto& origin : origins) {
+    writer.start_object();
+    writer.set_precision(6);
+    writer("lon", origin.first);
+    writer("lat", origin.second);
+    writer.end_object();
+  }
+  writer.end_array();
+  writer("costing", costing);
+  writer.start_array("contours");
+  writer.start_object();
+  writer.set_precision(2);
+  writer("time", minutes);
+  writer.end_object();
+  writer.end_array();
+  writer("batch", batch);
+  writer.end_object();
+  return writer.get_buffer();
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  const auto program = std::filesystem::path(__FILE__).stem().string();
+  // args
+  boost::property_tree::ptree config;
+  std::vector<double> bbox;
+  std::vector<uint32_t> concurrencies;
+  uint32_t count, seed;
+  float minutes;
+  std::string costing;
+
+  // clang-format off
+  cxxopts::Options options(
+    program,
+    program + " " + VALHALLA_PRINT_VERSION + "\n\n"
+    "valhalla_benchmark_isochrones makes isochrones around random origins in a bounding box,\n"
+    "first with a request per origin and then with batch requests using different numbers of\n"
+    "threads, and reports the throughput in isochrones per second. Origins that don't snap to\n"
+    "the graph are left out of the batches.\n");
+
+  add_benchmark_options(options, true);
+  options.add_options()
+    ("b,bbox", "Bounding box of the origins: min lon,min lat,max lon,max lat.", cxxopts::value<std::vector<double>>(bbox))
+    ("n,count", "How many origins to make isochrones for.", cxxopts::value<uint32_t>(count)->default_value("100"))
+    ("t,time", "The contour time in minutes.", cxxopts::value<float>(minutes)->default_value("15"))
+    ("costing", "The costing of the isochrones.", cxxopts::value<std::string>(costing)->default_value("auto"))
+    ("j,concurrency", "Comma separated numbers of threads of the batch requests.", cxxopts::value<std::vector<uint32_t>>(concurrencies)->default_value("1,2,4"))
+    ("s,seed", "Seed of the random origins.", cxxopts::value<uint32_t>(seed)->default_value("0"));
+  // clang-format on
+
+  if (auto exit_code = parse_benchmark_args(program, options, argc, argv, &config, &bbox))
+    return *exit_code;
+
+  // the batches hold all the origins
+  config.put("service_limits.isochrone.max_batch_locations", count);
+
+  std::mt19937 generator(seed);
+  std::uniform_real_distribution<double> lon(bbox[0], bbox[2]), lat(bbox[1], bbox[3]);
+  std::vector<std::pair<double, double>> origins;
+  for (uint32_t i = 0; i < count; ++i) {
+    origins.emplace_back(lon(generator), lat(generator));
+  }
+
+  // a request per origin, which also finds the origins a batch can use
+  std::vector<std::pair<double, double>> snapped;
+  tyr::actor_t actor(config, true);
+  auto start = std::chrono::steady_clock::now();
+  for (const auto& origin : origins) {
+    try {
+      actor.isochrone(make_request({origin}, costing, minutes, false));
+      snapped.push_back(origin);
+    } catch (const std::exception& e) { LOG_DEBUG(std::string("Skipping origin: ") + e.what()); }
+  }
+  double secs = seconds_since(start);
+  if (snapped.empty()) {
+    std::cerr << "None of the origins snapped to the graph" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  const table_t table({{"mode", 12},
+                       {"threads", 10},
+                       {"isochrones", 12},
+                       {"seconds", 12},
+                       {"isochrones/s", 16}});
+  table.header();
+  auto report = [&table](const std::string& mode, uint32_t threads, size_t isochrones,
+                         double secs) {
+    table.row(mode, threads, isochrones, secs, isochrones / secs);
+  };
+  report("single", 1, snapped.size(), secs);
+
+  auto batch = make_request(snapped, costing, minutes, true);
+  for (auto concurrency : concurrencies) {
+    config.put("thor.isochrone.batch_concurrency", std::max(concurrency, 1u));
+    tyr::actor_t batch_actor(config, true);
+    start = std::chrono::steady_clock::now();
+    try {
+      batch_actor.isochrone(batch);
+    } catch (const std::exception& e) {
+      std::cerr << "Batch request failed: " << e.what() << std::endl;
+      return EXIT_FAILURE;
+    }
+    report("batch", std::max(concurrency, 1u), snapped.size(), seconds_since(start));
+  }
+
+  return EXIT_SUCCESS;
+}
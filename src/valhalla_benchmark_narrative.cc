@@ -0,0 +1,176 @@
+#include "benchmark_utils.h"
+#include "odin/narrative_dictionary.h"
+#include "odin/phrase_template.h"
+#include "odin/util.h"
+
+#include <boost/algorithm/string/replace.hpp>
+#include <cxxopts.hpp>
+
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace valhalla;
+using namespace valhalla::odin;
+
+namespace {
+
+// every tag of the phrases with a value of a typical length
+const std::vector<std::pair<std::string, std::string>> kTagValues = {
+    {kCardinalDirectionTag, "north"},
+    {kRelativeDirectionTag, "left"},
+    {kOrdinalValueTag, "1st"},
+    {kStreetNamesTag, "Main Street"},
+    {kPreviousStreetNamesTag, "Old Road"},
+    {kBeginStreetNamesTag, "First Avenue"},
+    {kCrossStreetNamesTag, "Cross Way"},
+    {kRoundaboutExitStreetNamesTag, "Exit Street"},
+    {kRoundaboutExitBeginStreetNamesTag, "Exit Begin Street"},
+    {kRampExitNumbersVisualTag, "67B"},
+    {kObjectLabelTag, "gate"},
+    {kLengthTag, "1.5 kilometers"},
+    {kDestinationTag, "Home"},
+    {kCurrentVerbalCueTag, "Turn right."},
+    {kNextVerbalCueTag, "Turn left."},
+    {kNumberSignTag, "42"},
+    {kBranchSignTag, "I 95 North"},
+    {kTowardSignTag, "Baltimore"},
+    {kNameSignTag, "Gettysburg Pike"},
+    {kJunctionNameTag, "Big Junction"},
+    {kFerryLabelTag, "Ferry"},
+    {kTransitPlatformTag, "8 St - NYU"},
+    {kStationLabelTag, "Station"},
+    {kTimeTag, "8:06 AM"},
+    {kTransitNameTag, "R"},
+    {kTransitHeadSignTag, "Forest Hills"},
+    {kTransitPlatformCountTag, "7"},
+    {kTransitPlatformCountLabelTag, "stops"},
+    {kLevelTag, "2"},
+};
+
+} // namespace
+
+int main(int argc, char** argv) {
+  const auto program = std::filesystem::path(__FILE__).stem().string();
+  // args
+  std::vector<std::string> locales;
+  uint32_t repeats;
+
+  // clang-format off
+  cxxopts::Options options(
+    program,
+    program + " " + VALHALLA_PRINT_VERSION + "\n\n"
+    "valhalla_benchmark_narrative renders every phrase of the locales, once by copying the\n"
+    "phrase and replacing each tag with boost::replace_all and once from the templates the\n"
+    "phrases are compiled into when a locale is loaded. It reports the throughput in phrases\n"
+    "per second of both per locale.\n");
+
+  add_benchmark_options(options, false);
+  options.add_options()
+    ("l,locales", "Comma separated locales to render, all of them if not given.", cxxopts::value<std::vector<std::string>>(locales))
+    ("r,repeats", "How many times to render the phrases of a locale.", cxxopts::value<uint32_t>(repeats)->default_value("1000"));
+  // clang-format on
+
+  if (auto exit_code = parse_benchmark_args(program, options, argc, argv, nullptr))
+    return *exit_code;
+
+  if (locales.empty()) {
+    for (const auto& locale : get_locales()) {
+      locales.push_back(locale.first);
+    }
+  }
+  const std::vector<PhraseTemplate::TagValue> tag_values(kTagValues.begin(), kTagValues.end());
+
+  const table_t table({{"locale", 10},
+                       {"phrases", 10},
+                       {"replace_all/s", 16},
+                       {"templates/s", 16},
+                       {"speedup", 10}},
+                      2);
+  table.header();
+  for (const auto& name : locales) {
+    auto locale = get_locales().find(name);
+    if (locale == get_locales().end()) {
+      std::cerr << "Unknown locale " << name << std::endl;
+      return EXIT_FAILURE;
+    }
+    const auto& dictionary = *locale->second;
+    const std::vector<const PhraseSet*> phrase_sets = {
+        &dictionary.start_subset, &dictionary.start_verbal_subset, &dictionary.destination_subset,
+        &dictionary.destination_verbal_alert_subset, &dictionary.destination_verbal_subset,
+        &dictionary.becomes_subset, &dictionary.becomes_verbal_subset, &dictionary.continue_subset,
+        &dictionary.continue_verbal_alert_subset, &dictionary.continue_verbal_subset,
+        &dictionary.bear_subset, &dictionary.bear_verbal_subset, &dictionary.turn_subset,
+        &dictionary.turn_verbal_subset, &dictionary.sharp_subset, &dictionary.sharp_verbal_subset,
+        &dictionary.uturn_subset, &dictionary.uturn_verbal_subset, &dictionary.ramp_straight_subset,
+        &dictionary.ramp_straight_verbal_subset, &dictionary.ramp_subset,
+        &dictionary.ramp_verbal_subset, &dictionary.exit_subset, &dictionary.exit_verbal_subset,
+        &dictionary.exit_visual_subset, &dictionary.keep_subset, &dictionary.keep_verbal_subset,
+        &dictionary.keep_to_stay_on_subset, &dictionary.keep_to_stay_on_verbal_subset,
+        &dictionary.merge_subset, &dictionary.merge_verbal_subset,
+        &dictionary.enter_roundabout_subset, &dictionary.enter_roundabout_verbal_subset,
+        &dictionary.exit_roundabout_subset, &dictionary.exit_roundabout_verbal_subset,
+        &dictionary.enter_ferry_subset, &dictionary.enter_ferry_verbal_subset,
+        &dictionary.transit_connection_start_subset,
+        &dictionary.transit_connection_start_verbal_subset,
+        &dictionary.transit_connection_transfer_subset,
+        &dictionary.transit_connection_transfer_verbal_subset,
+        &dictionary.transit_connection_destination_subset,
+        &dictionary.transit_connection_destination_verbal_subset, &dictionary.depart_subset,
+        &dictionary.depart_verbal_subset, &dictionary.arrive_subset, &dictionary.arrive_verbal_subset,
+        &dictionary.transit_subset, &dictionary.transit_verbal_subset,
+        &dictionary.transit_remain_on_subset, &dictionary.transit_remain_on_verbal_subset,
+        &dictionary.transit_transfer_subset, &dictionary.transit_transfer_verbal_subset,
+        &dictionary.post_transition_verbal_subset, &dictionary.post_transition_transit_verbal_subset,
+        &dictionary.verbal_multi_cue_subset, &dictionary.approach_verbal_alert_subset,
+        &dictionary.pass_subset, &dictionary.elevator_subset, &dictionary.steps_subset,
+        &dictionary.escalator_subset, &dictionary.level_change_subset,
+        &dictionary.enter_building_subset, &dictionary.exit_building_subset,
+        &dictionary.park_vehicle_subset};
+
+    // copy each phrase and search and replace every tag in it
+    size_t phrases = 0, bytes = 0;
+    std::string instruction;
+    auto start = std::chrono::steady_clock::now();
+    for (uint32_t r = 0; r < repeats; ++r) {
+      for (const auto* phrase_set : phrase_sets) {
+        for (const auto& phrase : phrase_set->phrases) {
+          instruction = phrase.second;
+          for (const auto& tag_value : kTagValues) {
+            boost::replace_all(instruction, tag_value.first, tag_value.second);
+          }
+          bytes += instruction.size();
+          ++phrases;
+        }
+      }
+    }
+    const double replace_secs = seconds_since(start);
+
+    // render each phrase from its template into a reused buffer
+    start = std::chrono::steady_clock::now();
+    for (uint32_t r = 0; r < repeats; ++r) {
+      for (const auto* phrase_set : phrase_sets) {
+        for (const auto& phrase_template : phrase_set->templates) {
+          phrase_template.second.Render(instruction, tag_values);
+          bytes -= instruction.size();
+        }
+      }
+    }
+    const double template_secs = seconds_since(start);
+
+    // both ways render the same text, so what was added is taken away again
+    if (bytes != 0) {
+      std::cerr << "The templates of " << name << " rendered other text than replace_all"
+                << std::endl;
+      return EXIT_FAILURE;
+    }
+    table.row(name, phrases / repeats, phrases / replace_secs, phrases / template_secs,
+              replace_secs / template_secs);
+  }
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,171 @@
+#include "benchmark_utils.h"
+#include "thor/localsearch_optimizer.h"
+#include "thor/optimizer.h"
+
+#include <boost/property_tree/ptree.hpp>
+#include <cxxopts.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace valhalla::thor;
+
+namespace {
+
+struct result_t {
+  double cost = 0;
+  double secs = 0;
+};
+
+// asymmetric costs between points scattered uniformly, the one way penalty mimics turn restrictions
+// and one way streets
+std::vector<float> uniform_costs(const uint32_t count, std::mt19937& generator) {
+  std::uniform_real_distribution<float> coordinate(0.f, 10000.f);
+  std::vector<std::pair<float, float>> points(count);
+  for (auto& p : points) {
+    p = {coordinate(generator), coordinate(generator)};
+  }
+  std::uniform_real_distribution<float> penalty(1.f, 1.3f);
+  std::vector<float> costs(count * count);
+  for (uint32_t i = 0; i < count; ++i) {
+    for (uint32_t j = 0; j < count; ++j) {
+      float d = std::hypot(points[i].first - points[j].first, points[i].second - points[j].second);
+      costs[i * count + j] = i == j ? 0.f : d * penalty(generator);
+    }
+  }
+  return costs;
+}
+
+// asymmetric costs between points gathered around a few towns, like a day of deliveries
+std::vector<float> clustered_costs(const uint32_t count, std::mt19937& generator) {
+  std::uniform_real_distribution<float> coordinate(0.f, 10000.f), spread(-300.f, 300.f);
+  std::vector<std::pair<float, float>> towns(std::max<uint32_t>(count / 10, 2)), points(count);
+  for (auto& t : towns) {
+    t = {coordinate(generator), coordinate(generator)};
+  }
+  std::uniform_int_distribution<size_t> town(0, towns.size() - 1);
+  for (auto& p : points) {
+    const auto& t = towns[town(generator)];
+    p = {t.first + spread(generator), t.second + spread(generator)};
+  }
+  std::uniform_real_distribution<float> penalty(1.f, 1.3f);
+  std::vector<float> costs(count * count);
+  for (uint32_t i = 0; i < count; ++i) {
+    for (uint32_t j = 0; j < count; ++j) {
+      float d = std::hypot(points[i].first - points[j].first, points[i].second - points[j].second);
+      costs[i * count + j] = i == j ? 0.f : d * penalty(generator);
+    }
+  }
+  return costs;
+}
+
+double tour_cost(const uint32_t count,
+                 const std::vector<float>& costs,
+                 const std::vector<uint32_t>& tour) {
+  double cost = 0;
+  for (size_t i = 0; i + 1 < tour.size(); ++i) {
+    cost += costs[tour[i] * count + tour[i + 1]];
+  }
+  return cost;
+}
+
+result_t run(const uint32_t count,
+             const std::vector<float>& costs,
+             const std::function<std::vector<uint32_t>()>& solve) {
+  auto start = std::chrono::steady_clock::now();
+  auto tour = solve();
+  result_t result;
+  result.secs = seconds_since(start);
+  result.cost = tour_cost(count, costs, tour);
+  return result;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  const auto program = std::filesystem::path(__FILE__).stem().string();
+  // args
+  std::vector<uint32_t> counts;
+  uint32_t matrices, starts, concurrency, max_time;
+
+  // clang-format off
+  cxxopts::Options options(
+    program,
+    program + " " + VALHALLA_PRINT_VERSION + "\n\n"
+    "valhalla_benchmark_optimizer compares the tours and run times of the simulated annealing\n"
+    "and the local search engines of optimized_route on random cost matrices. The costs are\n"
+    "reported relative to the annealer, lower is better.\n");
+
+  add_benchmark_options(options, false);
+  options.add_options()
+    ("l,locations", "Comma separated numbers of locations to benchmark.", cxxopts::value<std::vector<uint32_t>>(counts)->default_value("10,25,50,100,200"))
+    ("m,matrices", "How many random matrices of each kind and size to solve.", cxxopts::value<uint32_t>(matrices)->default_value("10"))
+    ("s,starts", "Starting tours of the local search.", cxxopts::value<uint32_t>(starts)->default_value(std::to_string(kDefaultOptimizerStarts)))
+    ("j,concurrency", "Threads of the local search.", cxxopts::value<uint32_t>(concurrency)->default_value("1"))
+    ("t,max-time", "Time budget of the local search in milliseconds.", cxxopts::value<uint32_t>(max_time)->default_value(std::to_string(kDefaultOptimizerMaxTime)));
+  // clang-format on
+
+  if (auto exit_code = parse_benchmark_args(program, options, argc, argv, nullptr))
+    return *exit_code;
+  matrices = std::max(matrices, 1u);
+
+  // the single start run shows what the extra starts are worth
+  auto make_config = [&](uint32_t s) {
+    boost::property_tree::ptree config;
+    config.put("optimizer.starts", s);
+    config.put("optimizer.concurrency", concurrency);
+    config.put("optimizer.max_time", max_time);
+    return config;
+  };
+  LocalSearchOptimizer single(make_config(1)), multi(make_config(starts));
+
+  using matrix_t = std::function<std::vector<float>(uint32_t, std::mt19937&)>;
+  const std::vector<std::pair<std::string, matrix_t>> kinds{{"uniform", uniform_costs},
+                                                             {"clustered", clustered_costs}};
+
+  const auto multi_label = "ls-" + std::to_string(starts);
+  const table_t table({{"matrix", 10},
+                       {"locations", 10},
+                       {"anneal ms", 12},
+                       {"ls-1 ms", 12},
+                       {"ls-1 cost", 12},
+                       {multi_label + " ms", 12},
+                       {multi_label + " cost", 12}});
+  table.header();
+  for (const auto& kind : kinds) {
+    for (auto count : counts) {
+      if (count < 2) {
+        continue;
+      }
+      std::mt19937 generator(count);
+      result_t anneal_total, single_total, multi_total;
+      for (uint32_t m = 0; m < matrices; ++m) {
+        auto costs = kind.second(count, generator);
+        Optimizer annealer;
+        annealer.Seed(m);
+        auto anneal = run(count, costs, [&]() { return annealer.Solve(count, costs); });
+        auto ls1 = run(count, costs, [&]() { return single.Solve(count, costs); });
+        auto lsn = run(count, costs, [&]() { return multi.Solve(count, costs); });
+        // average the costs relative to the annealer so large and small matrices weigh the same
+        anneal_total.secs += anneal.secs;
+        single_total.secs += ls1.secs;
+        single_total.cost += ls1.cost / std::max(anneal.cost, 1.0);
+        multi_total.secs += lsn.secs;
+        multi_total.cost += lsn.cost / std::max(anneal.cost, 1.0);
+      }
+      table.row(kind.first, count, 1000 * anneal_total.secs / matrices,
+                1000 * single_total.secs / matrices, single_total.cost / matrices,
+                1000 * multi_total.secs / matrices, multi_total.cost / matrices);
+    }
+  }
+
+  return EXIT_SUCCESS;
+}
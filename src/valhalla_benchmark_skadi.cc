@@ -0,0 +1,123 @@
+#include "benchmark_utils.h"
+#include "midgard/pointll.h"
+#include "skadi/sample.h"
+
+#include <boost/property_tree/ptree.hpp>
+#include <cxxopts.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <filesystem>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace valhalla;
+
+namespace {
+
+// A random walk through the bounding box with a step of about the resampling distance of a route
+// shape, so consecutive points mostly fall into the same hgt tile like those of a real polyline
+std::vector<midgard::PointLL>
+make_polyline(const std::vector<double>& bbox, const uint32_t count, const uint32_t seed) {
+  constexpr double kStep = 0.0003;
+  std::mt19937 generator(seed);
+  std::uniform_real_distribution<double> lon(bbox[0], bbox[2]), lat(bbox[1], bbox[3]);
+  std::uniform_real_distribution<double> turn(-0.5, 0.5);
+
+  std::vector<midgard::PointLL> polyline;
+  polyline.reserve(count);
+  midgard::PointLL point(lon(generator), lat(generator));
+  double heading = turn(generator) * 2 * M_PI;
+  for (uint32_t i = 0; i < count; ++i) {
+    polyline.push_back(point);
+    heading += turn(generator);
+    auto x = point.lng() + kStep * std::cos(heading);
+    auto y = point.lat() + kStep * std::sin(heading);
+    // turn around at the edges of the bounding box
+    if (x < bbox[0] || x > bbox[2] || y < bbox[1] || y > bbox[3]) {
+      heading += M_PI;
+      x = std::clamp(x, bbox[0], bbox[2]);
+      y = std::clamp(y, bbox[1], bbox[3]);
+    }
+    point = midgard::PointLL(x, y);
+  }
+  return polyline;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  const auto program = std::filesystem::path(__FILE__).stem().string();
+  // args
+  boost::property_tree::ptree config;
+  std::vector<double> bbox;
+  uint32_t count, seed, repeats;
+
+  // clang-format off
+  cxxopts::Options options(
+    program,
+    program + " " + VALHALLA_PRINT_VERSION + "\n\n"
+    "valhalla_benchmark_skadi samples the elevation along a random polyline in a bounding box,\n"
+    "once with a sample::get per point and once with a single sample::get_all, and reports\n"
+    "the throughput in points per second and the largest difference between the two. The\n"
+    "elevation tiles are read from additional_data.elevation of the config.\n");
+
+  add_benchmark_options(options, true);
+  options.add_options()
+    ("b,bbox", "Bounding box of the polyline: min lon,min lat,max lon,max lat.", cxxopts::value<std::vector<double>>(bbox))
+    ("n,count", "How many points the polyline has.", cxxopts::value<uint32_t>(count)->default_value("100000"))
+    ("r,repeats", "How many times to sample the polyline.", cxxopts::value<uint32_t>(repeats)->default_value("10"))
+    ("s,seed", "Seed of the random polyline.", cxxopts::value<uint32_t>(seed)->default_value("0"));
+  // clang-format on
+
+  if (auto exit_code = parse_benchmark_args(program, options, argc, argv, &config, &bbox))
+    return *exit_code;
+
+  skadi::sample sample(config);
+  const auto polyline = make_polyline(bbox, count, seed);
+
+  // sample point by point once up front, which loads the tiles before anything is timed
+  std::vector<double> expected;
+  expected.reserve(polyline.size());
+  for (const auto& point : polyline) {
+    expected.push_back(sample.get(point));
+  }
+
+  const table_t table({{"method", 12}, {"points", 12}, {"seconds", 12}, {"points/s", 16},
+                       {"max diff", 14}});
+  table.header();
+  const size_t points = size_t(repeats) * polyline.size();
+
+  // a sample::get per point
+  std::vector<double> heights(polyline.size());
+  auto start = std::chrono::steady_clock::now();
+  for (uint32_t r = 0; r < repeats; ++r) {
+    for (size_t i = 0; i < polyline.size(); ++i) {
+      heights[i] = sample.get(polyline[i]);
+    }
+  }
+  double secs = seconds_since(start);
+  double diff = 0;
+  for (size_t i = 0; i < polyline.size(); ++i) {
+    diff = std::max(diff, std::abs(heights[i] - expected[i]));
+  }
+  table.row("get", points, secs, points / secs, diff);
+
+  // all of them at once
+  start = std::chrono::steady_clock::now();
+  for (uint32_t r = 0; r < repeats; ++r) {
+    heights = sample.get_all(polyline);
+  }
+  secs = seconds_since(start);
+  diff = 0;
+  for (size_t i = 0; i < polyline.size(); ++i) {
+    diff = std::max(diff, std::abs(heights[i] - expected[i]));
+  }
+  table.row("get_all", points, secs, points / secs, diff);
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,163 @@
+#include "baldr/attributes_controller.h"
+#include "baldr/graphreader.h"
+#include "baldr/rapidjson_utils.h"
+#include "benchmark_utils.h"
+#include "loki/worker.h"
+#include "midgard/logging.h"
+#include "sif/costfactory.h"
+#include "thor/bidirectional_astar.h"
+#include "thor/triplegbuilder.h"
+#include "worker.h"
+
+#include <boost/property_tree/ptree.hpp>
+#include <cxxopts.hpp>
+
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace valhalla;
+
+namespace {
+
+std::string make_request(const std::pair<double, double>& a,
+                         const std::pair<double, double>& b,
+                         const std::string& costing) {
+  rapidjson::writer_wrapper_t writer(512);
+  writer.start_object();
+  writer.start_array("locations");
+  for (const auto& ll : {a, b}) {
+    writer.start_object();
+    writer.set_precision(6);
+    writer("lon", ll.first);
+    writer("lat", ll.second);
+    writer.end_object();
+  }
+  writer.end_array();
+  writer("costing", costing);
+  writer.end_object();
+  return writer.get_buffer();
+}
+
+// a route whose path has been found, ready to be built into a trip leg again and again
+struct route_t {
+  Api request;
+  sif::mode_costing_t mode_costing;
+  std::vector<thor::PathInfo> path;
+};
+
+} // namespace
+
+int main(int argc, char** argv) {
+  const auto program = std::filesystem::path(__FILE__).stem().string();
+  // args
+  boost::property_tree::ptree config;
+  std::vector<double> bbox;
+  std::vector<std::string> minimal_attributes;
+  uint32_t count, seed, repeats;
+  std::string costing;
+
+  // clang-format off
+  cxxopts::Options options(
+    program,
+    program + " " + VALHALLA_PRINT_VERSION + "\n\n"
+    "valhalla_benchmark_triplegs finds routes between random pairs of points in a bounding box\n"
+    "and then times building the trip legs of those routes, once with every attribute the\n"
+    "route action includes by default and once with only a minimal set of attributes, as an\n"
+    "OSRM style response needs. It reports the throughput in legs per second.\n");
+
+  add_benchmark_options(options, true);
+  options.add_options()
+    ("b,bbox", "Bounding box of the points: min lon,min lat,max lon,max lat.", cxxopts::value<std::vector<double>>(bbox))
+    ("n,count", "How many routes to find.", cxxopts::value<uint32_t>(count)->default_value("1000"))
+    ("r,repeats", "How many times to build the legs of all the routes.", cxxopts::value<uint32_t>(repeats)->default_value("3"))
+    ("costing", "The costing of the routes.", cxxopts::value<std::string>(costing)->default_value("auto"))
+    ("a,attributes", "Comma separated attributes of the minimal legs.", cxxopts::value<std::vector<std::string>>(minimal_attributes)->default_value("shape,edge.length,edge.speed,node.elapsed_time"))
+    ("s,seed", "Seed of the random points.", cxxopts::value<uint32_t>(seed)->default_value("0"));
+  // clang-format on
+
+  if (auto exit_code = parse_benchmark_args(program, options, argc, argv, &config, &bbox))
+    return *exit_code;
+
+  auto reader = std::make_shared<baldr::GraphReader>(config.get_child("mjolnir"));
+  loki::loki_worker_t loki_worker(config, reader);
+  thor::BidirectionalAStar astar(config.get_child("thor"));
+  sif::CostFactory factory;
+
+  std::mt19937 generator(seed);
+  std::uniform_real_distribution<double> lon(bbox[0], bbox[2]), lat(bbox[1], bbox[3]);
+
+  // find the paths up front, pairs of points that don't snap or connect are left out
+  std::vector<route_t> routes;
+  routes.reserve(count);
+  auto start = std::chrono::steady_clock::now();
+  for (uint32_t i = 0; i < count; ++i) {
+    route_t route;
+    auto request =
+        make_request({lon(generator), lat(generator)}, {lon(generator), lat(generator)}, costing);
+    try {
+      ParseApi(request, Options::route, route.request);
+      loki_worker.route(route.request);
+      auto& options = *route.request.mutable_options();
+      sif::TravelMode mode;
+      route.mode_costing = factory.CreateModeCosting(options, mode);
+      auto paths = astar.GetBestPath(*options.mutable_locations(0), *options.mutable_locations(1),
+                                     *reader, route.mode_costing, mode, options);
+      astar.Clear();
+      if (paths.empty() || paths.front().empty())
+        continue;
+      route.path = std::move(paths.front());
+      routes.emplace_back(std::move(route));
+    } catch (const std::exception& e) {
+      astar.Clear();
+      LOG_DEBUG(std::string("Skipping route: ") + e.what());
+    }
+    loki_worker.cleanup();
+  }
+  if (routes.empty()) {
+    std::cerr << "None of the routes could be found" << std::endl;
+    return EXIT_FAILURE;
+  }
+  std::cout << "Found " << routes.size() << " of " << count << " routes in " << std::fixed
+            << std::setprecision(3) << seconds_since(start) << " seconds\n";
+
+  // the attributes of a route by default and those of a minimal, strictly filtered one
+  Options minimal_options;
+  minimal_options.set_filter_action(FilterAction::include);
+  for (const auto& attribute : minimal_attributes)
+    minimal_options.add_filter_attributes(attribute);
+  const baldr::AttributesController full, minimal(minimal_options, true);
+
+  const table_t table({{"attributes", 12},
+                       {"legs", 12},
+                       {"seconds", 12},
+                       {"legs/s", 12},
+                       {"bytes/leg", 14}});
+  table.header();
+  for (const auto* controller : {&full, &minimal}) {
+    size_t legs = 0, bytes = 0;
+    start = std::chrono::steady_clock::now();
+    for (uint32_t r = 0; r < repeats; ++r) {
+      for (auto& route : routes) {
+        auto& options = *route.request.mutable_options();
+        TripLeg leg;
+        thor::TripLegBuilder::Build(options, *controller, *reader, route.mode_costing,
+                                    route.path.begin(), route.path.end(),
+                                    *options.mutable_locations(0), *options.mutable_locations(1),
+                                    leg, {"bidirectional_a*"});
+        bytes += leg.ByteSizeLong();
+        ++legs;
+      }
+    }
+    double secs = seconds_since(start);
+    table.row(controller == &full ? "full" : "minimal", legs, secs, legs / secs, bytes / legs);
+  }
+
+  return EXIT_SUCCESS;
+}
@@ -1,7 +1,9 @@
 #include <cxxopts.hpp>
 
+#include <csignal>
 #include <filesystem>
 #include <fstream>
+#include <functional>
 #include <iostream>
 #include <iterator>
 #include <list>
@@ -14,6 +16,7 @@ using namespace prime_server;
 #endif
 
 #include "argparse_utils.h"
+#include "baldr/graphreader.h"
 #include "config.h"
 #include "loki/worker.h"
 #include "midgard/logging.h"
@@ -107,6 +110,11 @@ int main(int argc, char** argv) {
       return 1;
     }
 
+    // large matrices and isochrones are streamed straight to stdout as they are serialized
+    const std::function<void(const char*, size_t)> to_stdout = [](const char* bytes, size_t size) {
+      std::cout.write(bytes, size);
+    };
+
     // do the right action
     valhalla::Api request;
     try {
@@ -118,13 +126,13 @@ int main(int argc, char** argv) {
           std::cout << actor.locate(request_str, nullptr, &request) << std::endl;
           break;
         case valhalla::Options::sources_to_targets:
-          std::cout << actor.matrix(request_str, nullptr, &request) << std::endl;
+          std::cout << actor.matrix(request_str, nullptr, &request, &to_stdout) << std::endl;
           break;
         case valhalla::Options::optimized_route:
           std::cout << actor.optimized_route(request_str, nullptr, &request) << std::endl;
           break;
         case valhalla::Options::isochrone:
-          std::cout << actor.isochrone(request_str, nullptr, &request) << std::endl;
+          std::cout << actor.isochrone(request_str, nullptr, &request, &to_stdout) << std::endl;
           break;
         case valhalla::Options::trace_route:
           std::cout << actor.trace_route(request_str, nullptr, &request) << std::endl;
@@ -147,6 +155,9 @@ int main(int argc, char** argv) {
         case valhalla::Options::tile:
           std::cout << actor.tile(request_str, nullptr, &request) << std::endl;
           break;
+        case valhalla::Options::accessibility:
+          std::cout << actor.accessibility(request_str, nullptr, &request) << std::endl;
+          break;
         default:
           std::cerr << "Unknown action" << std::endl;
           return 1;
@@ -175,6 +186,9 @@ int main(int argc, char** argv) {
   prime_server::quiesce(config.get<unsigned int>("httpd.service.drain_seconds", 28),
                         config.get<unsigned int>("httpd.service.shutdown_seconds", 1));
 
+  // pick up new tile and traffic extracts when asked via SIGHUP
+  std::signal(SIGHUP, [](int) { valhalla::baldr::GraphReader::RequestReload(); });
+
   // grab the endpoints
   std::string listen = config.get<std::string>("httpd.service.listen");
   std::string loopback = config.get<std::string>("httpd.service.loopback");
@@ -1,8 +1,10 @@
+#include "baldr/graphreader.h"
 #include "baldr/rapidjson_utils.h"
 #include "thor/worker.h"
 
 #include <boost/property_tree/ptree.hpp>
 
+#include <csignal>
 #include <iostream>
 
 int main(int argc, char** argv) {
@@ -17,6 +19,9 @@ int main(int argc, char** argv) {
   boost::property_tree::ptree config;
   rapidjson::read_json(config_file, config);
 
+  // pick up new tile and traffic extracts when asked via SIGHUP
+  std::signal(SIGHUP, [](int) { valhalla::baldr::GraphReader::RequestReload(); });
+
   // run the service worker
   valhalla::thor::run_service(config);
 
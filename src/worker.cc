@@ -23,6 +23,8 @@ using namespace valhalla;
 #ifdef ENABLE_SERVICES
 using namespace prime_server;
 
+static const worker::content_type BINARY_MIME{"Content-type", "application/octet-stream"};
+
 // returns the correct MIME type for a given format
 static const worker::content_type& fmt_to_mime(const Options::Format& fmt) noexcept {
   switch (fmt) {
@@ -34,6 +36,8 @@ static const worker::content_type& fmt_to_mime(const Options::Format& fmt) noexc
       return worker::TIFF_MIME;
     case Options::mvt:
       return worker::MVT_MIME;
+    case Options::binary:
+      return BINARY_MIME;
     default:
       return worker::JSON_MIME;
   }
@@ -42,6 +46,9 @@ static const worker::content_type& fmt_to_mime(const Options::Format& fmt) noexc
 
 namespace {
 
+// minutes between the date_times of a matrix date_time range if not specified
+constexpr uint32_t kDefaultDateTimeStep = 15;
+
 // Parses exclude_layers from JSON and adds them to the request's tile options
 void parse_exclude_layers(const boost::optional<rapidjson::Value&>& exclude_layers, Api& request) {
   static const std::unordered_set<std::string_view> kSupportedLayers =
@@ -75,7 +82,8 @@ bool is_format_supported(Options::Action action, Options::Format format) {
       // pbf
       (1 << Options::route) | (1 << Options::optimized_route) | (1 << Options::trace_route) |
           (1 << Options::centroid) | (1 << Options::trace_attributes) | (1 << Options::status) |
-          (1 << Options::sources_to_targets) | (1 << Options::isochrone) | (1 << Options::expansion),
+          (1 << Options::sources_to_targets) | (1 << Options::isochrone) |
+          (1 << Options::expansion) | (1 << Options::accessibility),
   // geotiff
 #ifdef ENABLE_GEOTIFF
       (1 << Options::isochrone),
@@ -84,6 +92,8 @@ bool is_format_supported(Options::Action action, Options::Format format) {
 #endif
       // mvt
       (1 << Options::tile),
+      // binary
+      (1 << Options::sources_to_targets),
   };
   static_assert(std::size(kFormatActionSupport) == Options::Format_ARRAYSIZE,
                 "Please update format_action array to match Options::Action_ARRAYSIZE");
@@ -653,6 +663,11 @@ void from_json(rapidjson::Document& doc, Options::Action action, Api& api) {
     options.set_verbose(rapidjson::get(doc, "/verbose", options.verbose()));
   }
 
+  // status can ask for the tile extracts to be reloaded
+  if (options.action() == Options::status) {
+    options.set_reload_tiles(rapidjson::get(doc, "/reload_tiles", options.reload_tiles()));
+  }
+
   // if specified, get the filter_action value in there
   auto filter_action_str = rapidjson::get_optional<std::string>(doc, "/filters/action");
   FilterAction filter_action;
@@ -724,11 +739,14 @@ void from_json(rapidjson::Document& doc, Options::Action action, Api& api) {
     options.set_format(Options::json);
     add_warning(api, 211);
   }
-  if (options.format() == Options::pbf) {
+  if (options.format() == Options::pbf || options.format() == Options::binary) {
     // jsonp wont work because javascript doesnt support byte arrays
     options.clear_jsonp();
   }
 
+  // whether or not binary output should be compressed
+  options.set_compress(rapidjson::get<bool>(doc, "/compress", options.compress()));
+
   auto units = rapidjson::get_optional<std::string>(doc, "/units");
   if (units && ((*units == "miles") || (*units == "mi"))) {
     options.set_units(Options::miles);
@@ -853,6 +871,29 @@ void from_json(rapidjson::Document& doc, Options::Action action, Api& api) {
     if (date_time_value != "current" && !baldr::DateTime::is_iso_valid(date_time_value))
       throw valhalla_exception_t{162};
     options.set_date_time(date_time_value);
+
+    // a range of date_times asks for a matrix per date_time, each computed on its own
+    auto date_time_end =
+        rapidjson::get<std::string>(doc, "/date_time/end", options.date_time_end());
+    if (!date_time_end.empty()) {
+      if (action != Options::sources_to_targets ||
+          (v != Options::depart_at && v != Options::arrive_by))
+        throw valhalla_exception_t{169, "only sources_to_targets with a date_time type of 1 or 2"};
+      if (options.format() == Options::osrm || options.format() == Options::binary)
+        throw valhalla_exception_t{169, "not available in the osrm or binary format"};
+      if (!baldr::DateTime::is_iso_valid(date_time_end))
+        throw valhalla_exception_t{162};
+      auto step = rapidjson::get<unsigned int>(doc, "/date_time/step",
+                                               options.date_time_step() ? options.date_time_step()
+                                                                        : kDefaultDateTimeStep);
+      if (step == 0)
+        throw valhalla_exception_t{169, "step must be positive"};
+      if (baldr::DateTime::get_formatted_date(date_time_end) <
+          baldr::DateTime::get_formatted_date(date_time_value))
+        throw valhalla_exception_t{169, "end is before value"};
+      options.set_date_time_end(date_time_end);
+      options.set_date_time_step(step);
+    }
   } // not specified but you want transit, then we default to current
   else if (options.costing_type() == Costing::multimodal ||
            options.costing_type() == Costing::transit) {
@@ -866,7 +907,7 @@ void from_json(rapidjson::Document& doc, Options::Action action, Api& api) {
         options.date_time_type() == Options::invariant) {
       if (options.costing_type() == Costing::multimodal || options.costing_type() == Costing::transit)
         throw valhalla_exception_t{141};
-      if (options.action() == Options::isochrone)
+      if (options.action() == Options::isochrone || options.action() == Options::accessibility)
         throw valhalla_exception_t{142};
     }
   }
@@ -1239,6 +1280,13 @@ void from_json(rapidjson::Document& doc, Options::Action action, Api& api) {
   // if specified, get the show_locations boolean in there
   options.set_show_locations(rapidjson::get<bool>(doc, "/show_locations", options.show_locations()));
 
+  // if specified, make an isochrone per location, which is only written as json
+  if (action == Options::isochrone) {
+    options.set_batch(rapidjson::get<bool>(doc, "/batch", options.batch()));
+    if (options.batch() && options.format() != Options::json)
+      throw valhalla_exception_t{145};
+  }
+
   // if specified, get the shape_match in there
   auto shape_match_str = rapidjson::get_optional<std::string>(doc, "/shape_match");
   ShapeMatch shape_match;
@@ -189,6 +189,7 @@ TEST(Actor, SupportedFormats) {
       {Options::centroid, &tyr::actor_t::centroid, options},
       {Options::status, &tyr::actor_t::status, options},
       {Options::tile, &tyr::actor_t::tile, tile_options},
+      {Options::accessibility, &tyr::actor_t::accessibility, isochrone_options},
   };
   ASSERT_EQ(std::size(tests), Options::Action_ARRAYSIZE - 1) // -1 for `Options::no_action`
       << "Please add missing action to this test";
@@ -2,6 +2,7 @@
 #include "loki/worker.h"
 #include "odin/worker.h"
 #include "test.h"
+#include "thor/alternates.h"
 #include "thor/worker.h"
 
 #include <string>
@@ -79,3 +80,41 @@ TEST(Alternates, test_one_alternate) {
 TEST(Alternates, test_two_alternates) {
   test_alternates(2);
 }
+
+namespace {
+
+std::vector<PathInfo> make_path(const std::vector<std::pair<uint32_t, float>>& edges) {
+  std::vector<PathInfo> path;
+  float distance = 0.f;
+  for (const auto& edge : edges) {
+    distance += edge.second;
+    path.emplace_back(sif::TravelMode::kDrive, sif::Cost{}, GraphId(edge.first, 2, 0), 0, distance);
+  }
+  return path;
+}
+
+} // namespace
+
+TEST(Alternates, test_sharing) {
+  // the optimal path and an accepted alternate
+  std::vector<std::vector<PathInfo>> paths{
+      make_path({{7, 100.f}, {3, 100.f}, {5, 100.f}, {9, 100.f}}),
+      make_path({{7, 100.f}, {4, 150.f}, {6, 150.f}, {9, 100.f}}),
+  };
+  SharedEdges shared_edges;
+
+  // shares 200m of the 400m optimal path and 350m of the 500m alternate
+  auto distinct = make_path({{7, 100.f}, {8, 200.f}, {6, 150.f}, {9, 100.f}});
+  EXPECT_TRUE(validate_alternate_by_sharing(shared_edges, paths, distinct, 0.71f));
+  EXPECT_FALSE(validate_alternate_by_sharing(shared_edges, paths, distinct, 0.69f));
+
+  // a candidate with the same edge twice counts it both times, 300m of the optimal 400m
+  auto loop = make_path({{7, 100.f}, {1, 50.f}, {2, 50.f}, {7, 100.f}, {9, 100.f}});
+  EXPECT_TRUE(validate_alternate_by_sharing(shared_edges, paths, loop, 0.76f));
+  EXPECT_FALSE(validate_alternate_by_sharing(shared_edges, paths, loop, 0.74f));
+
+  // the cached edges of the accepted paths don't depend on which candidates came before
+  SharedEdges fresh;
+  EXPECT_FALSE(validate_alternate_by_sharing(fresh, paths, loop, 0.74f));
+  EXPECT_TRUE(validate_alternate_by_sharing(fresh, paths, distinct, 0.71f));
+}
@@ -641,6 +641,19 @@ TEST(DateTime, TestDayOfWeek) {
   EXPECT_EQ(dow, 3) << "DateTime::day_of_week failed: 3 expected";
 }
 
+TEST(DateTime, DateTimeRange) {
+  // crosses midnight and the end of the month, the end is only included if it falls on a step
+  auto date_times = DateTime::date_time_range("2018-07-31T23:20", "2018-08-01T00:30", 25);
+  std::vector<std::string> expected = {"2018-07-31T23:20", "2018-07-31T23:45", "2018-08-01T00:10"};
+  EXPECT_EQ(date_times, expected);
+
+  date_times = DateTime::date_time_range("2018-07-31T23:20", "2018-07-31T23:20", 15);
+  EXPECT_EQ(date_times, std::vector<std::string>{"2018-07-31T23:20"});
+
+  EXPECT_TRUE(DateTime::date_time_range("2018-07-31T23:20", "2018-07-31T23:00", 15).empty());
+  EXPECT_TRUE(DateTime::date_time_range("2018-07-31T23:20", "2018-07-31T23:50", 0).empty());
+}
+
 TEST(DateTime, TimezoneAliases) {
   const auto& dt_db = DateTime::get_tz_db();
   // map of alias and target names
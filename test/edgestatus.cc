@@ -64,6 +64,35 @@ TEST(EdgeStatus, TestStatus) {
   TryGet(edgestatus, GraphId(555, 3, 1), EdgeSet::kUnreachedOrReset);
 }
 
+TEST(EdgeStatus, TestReset) {
+  EdgeStatus edgestatus;
+
+  GraphTileHeader header;
+  header.set_directededgecount(1000);
+  test_tile* tt = new test_tile;
+  tt->header_ = &header;
+  graph_tile_ptr tile{tt};
+
+  // reset keeps the arrays but every edge is unreached again
+  edgestatus.Set(GraphId(555, 1, 10), EdgeSet::kPermanent, 1, tile);
+  edgestatus.Set(GraphId(555, 1, 20), EdgeSet::kTemporary, 2, tile);
+  edgestatus.reset(1000);
+  TryGet(edgestatus, GraphId(555, 1, 10), EdgeSet::kUnreachedOrReset);
+  TryGet(edgestatus, GraphId(555, 1, 20), EdgeSet::kUnreachedOrReset);
+
+  // the kept arrays can be updated without being set first
+  edgestatus.GetPtr(GraphId(555, 1, 30), tile)->set_ = static_cast<uint32_t>(EdgeSet::kTemporary);
+  edgestatus.Update(GraphId(555, 1, 30), EdgeSet::kPermanent);
+  TryGet(edgestatus, GraphId(555, 1, 30), EdgeSet::kPermanent);
+
+  // with more edges than allowed the arrays are let go
+  edgestatus.Set(GraphId(555, 2, 10), EdgeSet::kPermanent, 3, tile);
+  edgestatus.reset(1000);
+  TryGet(edgestatus, GraphId(555, 1, 30), EdgeSet::kUnreachedOrReset);
+  TryGet(edgestatus, GraphId(555, 2, 10), EdgeSet::kUnreachedOrReset);
+  EXPECT_THROW(edgestatus.Update(GraphId(555, 1, 30), EdgeSet::kPermanent), std::runtime_error);
+}
+
 } // namespace
 
 int main(int argc, char* argv[]) {
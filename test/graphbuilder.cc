@@ -241,6 +241,52 @@ TEST(Graphbuilder, AdminBbox) {
             "BE/WAL");
 }
 
+TEST(Graphbuilder, PolygonIndex) {
+  auto admin_db = AdminDB::open(VALHALLA_SOURCE_DIR "test/data/language_admin.sqlite");
+  ASSERT_TRUE(admin_db);
+  auto tz_db = AdminDB::open(VALHALLA_BUILD_DIR "test/data/tz.sqlite");
+  ASSERT_TRUE(tz_db);
+
+  const auto& tiling = TileHierarchy::levels().back().tiles;
+
+  // a tile on the border of Flanders and Wallonia
+  const GraphId id(811462);
+  GraphTileBuilder graphtile(tile_dir, id, false);
+  std::unordered_map<uint32_t, bool> drive_on_right;
+  std::unordered_map<uint32_t, bool> allow_intersection_names;
+  language_poly_index language_polys;
+
+  const AABB2<PointLL> bbox = tiling.TileBounds(id);
+  auto admin_polys = GetAdminInfo(*admin_db, drive_on_right, allow_intersection_names, language_polys,
+                                  bbox, graphtile);
+  auto tz_polys = GetTimeZones(*tz_db, {-106.450948, 31.669746, -106.386046, 31.724371});
+  const AABB2<PointLL> tz_bbox(-106.450948, 31.669746, -106.386046, 31.724371);
+
+  PolygonIndex admin_lookup(admin_polys, bbox);
+  PolygonIndex language_lookup(language_polys, bbox);
+  PolygonIndex tz_lookup(tz_polys, tz_bbox);
+
+  // the index has to give the same answers as testing every polygon, including on the tile edges,
+  // the cell edges and just off the tile
+  const int steps = 64;
+  for (int x = -1; x <= steps + 1; ++x) {
+    for (int y = -1; y <= steps + 1; ++y) {
+      PointLL ll(bbox.minx() + bbox.Width() * x / steps, bbox.miny() + bbox.Height() * y / steps);
+      EXPECT_EQ(GetMultiPolyId(admin_lookup, ll, graphtile),
+                GetMultiPolyId(admin_polys, ll, graphtile))
+          << ll.lng() << "," << ll.lat();
+      EXPECT_EQ(GetMultiPolyIndexes(language_polys, language_lookup, ll),
+                GetMultiPolyIndexes(language_polys, ll))
+          << ll.lng() << "," << ll.lat();
+
+      PointLL tz_ll(tz_bbox.minx() + tz_bbox.Width() * x / steps,
+                    tz_bbox.miny() + tz_bbox.Height() * y / steps);
+      EXPECT_EQ(GetMultiPolyId(tz_lookup, tz_ll), GetMultiPolyId(tz_polys, tz_ll))
+          << tz_ll.lng() << "," << tz_ll.lat();
+    }
+  }
+}
+
 class HarrisburgTestSuiteEnv : public ::testing::Environment {
 public:
   void SetUp() override {
@@ -4,6 +4,7 @@
 #include <gtest/gtest.h>
 
 #include <limits>
+#include <random>
 // #include <iostream>
 
 using namespace valhalla::midgard;
@@ -79,6 +80,38 @@ TEST(GriddedData, Basic) {
   */
 }
 
+TEST(GriddedData, Concurrency) {
+  // a ragged field with holes so the contours break up into lots of lines and rings
+  AABB2<PointLL> bounds{-0.2, -0.15, 0.2, 0.15};
+  GriddedData<2> g(bounds, 0.002f, {NODATA_VALUE, NODATA_VALUE});
+  Tiles<PointLL> t(bounds, 0.002f);
+  std::mt19937 generator(7);
+  std::uniform_real_distribution<float> noise(0.8f, 1.3f);
+  for (int row = 0; row < t.nrows(); ++row) {
+    for (int col = 0; col < t.ncolumns(); ++col) {
+      float d = PointLL(0, 0).Distance(t.Base(t.TileId(col, row)));
+      if (noise(generator) > 1.25f) {
+        continue;
+      }
+      g.SetIfLessThan(t.TileId(col, row), {d / 12.f * noise(generator), d * noise(generator)});
+    }
+  }
+
+  for (bool rings_only : {false, true}) {
+    std::vector<GriddedData<2>::contour_interval_t> intervals{
+        {0, 300, "time", ""},      {0, 600, "time", ""},       {0, 900, "time", ""},
+        {1, 5000, "distance", ""}, {1, 10000, "distance", ""},
+    };
+    auto serial = g.GenerateContours(intervals, rings_only, 0.f, 0.f);
+    ASSERT_EQ(serial.size(), intervals.size());
+    // the bands and intervals are traced in parallel but the lines come out exactly the same
+    for (uint32_t concurrency : {2, 3, 8}) {
+      auto parallel = g.GenerateContours(intervals, rings_only, 0.f, 0.f, concurrency);
+      EXPECT_EQ(parallel, serial) << "concurrency " << concurrency;
+    }
+  }
+}
+
 } // namespace
 
 int main(int argc, char* argv[]) {
@@ -688,6 +688,9 @@ valhalla::Api do_action(const valhalla::Options::Action& action,
     case valhalla::Options::tile:
       json_str = actor.tile(request_json, nullptr, &api);
       break;
+    case valhalla::Options::accessibility:
+      json_str = actor.accessibility(request_json, nullptr, &api);
+      break;
     default:
       throw std::logic_error("Unsupported action");
       break;
@@ -0,0 +1,144 @@
+#include "baldr/graphconstants.h"
+#include "baldr/rapidjson_utils.h"
+#include "gurka.h"
+#include "test.h"
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+using namespace valhalla;
+using valhalla::baldr::RoadClass;
+
+namespace {
+
+//   x
+// A-----B-----C
+//       |     y
+//       D
+//
+// AB is 600m of residential, BC 600m of primary and BD 200m of service road. The target x is
+// halfway along AB and y is at C
+class Accessibility : public ::testing::Test {
+protected:
+  static gurka::map map;
+
+  static void SetUpTestSuite() {
+    constexpr double gridsize = 100;
+
+    const std::string ascii_map = R"(
+         x
+      A-----B-----C
+            |     y
+            D
+    )";
+
+    const gurka::ways ways = {
+        {"AB", {{"highway", "residential"}}},
+        {"BC", {{"highway", "primary"}}},
+        {"BD", {{"highway", "service"}}},
+    };
+
+    const auto layout = gurka::detail::map_to_coordinates(ascii_map, gridsize);
+    map = gurka::buildtiles(layout, ways, {}, {}, "test/data/gurka_accessibility");
+  }
+
+  std::string points(const std::vector<std::string>& names) {
+    std::string json;
+    for (const auto& name : names) {
+      const auto& ll = map.nodes.at(name);
+      json += (json.empty() ? "" : ",") + std::string(R"({"lat":)") + std::to_string(ll.lat()) +
+              R"(,"lon":)" + std::to_string(ll.lng()) + "}";
+    }
+    return "[" + json + "]";
+  }
+
+  Api accessibility(const std::vector<std::string>& locations,
+                    const std::string& contours,
+                    const std::string& format = "json",
+                    std::string* response = nullptr) {
+    std::string request = R"({"locations":)" + points(locations) +
+                          R"(,"targets":)" + points({"x", "y"}) +
+                          R"(,"costing":"auto","contours":)" + contours + R"(,"format":")" +
+                          format + R"("})";
+    return gurka::do_action(Options::accessibility, map, request, {}, response);
+  }
+};
+
+gurka::map Accessibility::map = {};
+
+TEST_F(Accessibility, Distances) {
+  std::string response;
+  auto api = accessibility({"A", "C"}, R"([{"distance":0.4},{"distance":0.8},{"distance":2}])",
+                           "json", &response);
+
+  // a score per contour for each of the locations
+  ASSERT_EQ(api.accessibility().origins_size(), 2);
+  for (const auto& origin : api.accessibility().origins()) {
+    ASSERT_EQ(origin.scores_size(), 3);
+
+    // within 400m only part of the first edge is reached
+    const auto& near = origin.scores(0);
+    EXPECT_EQ(near.metric(), valhalla::Accessibility::distance);
+    EXPECT_NEAR(near.length(), 400, 1);
+    EXPECT_EQ(near.edges(), 1);
+    EXPECT_EQ(near.targets(), 1);
+
+    // within 800m the first edge is reached in full and the other two in part
+    const auto& mid = origin.scores(1);
+    EXPECT_NEAR(mid.length(), 1000, 5);
+    EXPECT_EQ(mid.edges(), 3);
+    EXPECT_EQ(mid.targets(), 1);
+    ASSERT_EQ(mid.road_class_edges_size(), static_cast<int>(RoadClass::kInvalid));
+    EXPECT_EQ(mid.road_class_edges(static_cast<int>(RoadClass::kPrimary)), 1);
+    EXPECT_EQ(mid.road_class_edges(static_cast<int>(RoadClass::kResidential)), 1);
+    EXPECT_EQ(mid.road_class_edges(static_cast<int>(RoadClass::kServiceOther)), 1);
+    EXPECT_EQ(mid.road_class_edges(static_cast<int>(RoadClass::kMotorway)), 0);
+
+    // and within 2km everything is, each two way edge only counts once
+    const auto& far = origin.scores(2);
+    EXPECT_NEAR(far.length(), 1400, 5);
+    EXPECT_EQ(far.edges(), 3);
+    EXPECT_EQ(far.targets(), 2);
+  }
+
+  // the json has the same in kilometers
+  rapidjson::Document doc;
+  doc.Parse(response.c_str());
+  ASSERT_FALSE(doc.HasParseError());
+  const auto& scores = doc["accessibility"][1]["contours"];
+  ASSERT_EQ(scores.Size(), 3);
+  EXPECT_NEAR(scores[2]["distance"].GetDouble(), 2, 0.01);
+  EXPECT_NEAR(scores[2]["length"].GetDouble(), 1.4, 0.005);
+  EXPECT_EQ(scores[2]["edges"].GetUint(), 3);
+  EXPECT_EQ(scores[2]["road_classes"]["primary"].GetUint(), 1);
+  EXPECT_EQ(scores[2]["targets"].GetUint(), 2);
+  EXPECT_STREQ(doc["units"].GetString(), "kilometers");
+}
+
+TEST_F(Accessibility, Time) {
+  // an hour is enough to reach everything, a second isn't enough to reach anything but the target
+  // right at C
+  auto api = accessibility({"C"}, R"([{"time":60},{"time":0.01}])", "pbf");
+  ASSERT_EQ(api.accessibility().origins_size(), 1);
+  const auto& scores = api.accessibility().origins(0).scores();
+  ASSERT_EQ(scores.size(), 2);
+  EXPECT_EQ(scores.Get(0).metric(), valhalla::Accessibility::time);
+  EXPECT_NEAR(scores.Get(0).length(), 1400, 5);
+  EXPECT_EQ(scores.Get(0).edges(), 3);
+  EXPECT_EQ(scores.Get(0).targets(), 2);
+  EXPECT_LT(scores.Get(1).length(), 50);
+  EXPECT_EQ(scores.Get(1).targets(), 1);
+}
+
+TEST_F(Accessibility, TooManyTargets) {
+  map.config.put("service_limits.isochrone.max_accessibility_targets", 1);
+  try {
+    accessibility({"A"}, R"([{"time":10}])");
+    FAIL() << "Expected too many targets";
+  } catch (const valhalla_exception_t& e) { EXPECT_EQ(e.code, 176); }
+  map.config.put("service_limits.isochrone.max_accessibility_targets", 10000);
+}
+
+} // namespace
@@ -105,3 +105,41 @@ TEST(Alternates, test_too_long_detour) {
 
   ASSERT_EQ(paths.size(), 1) << "Got alternative with too long detour";
 }
+
+TEST(Alternates, test_concurrent_directions) {
+  const std::string ascii_map = R"(
+               E---------F
+               |         |
+       A-------B---------C-------D
+               |         |
+               |         |
+               G---------H
+    )";
+
+  const gurka::ways ways = {
+      {"AB", {{"highway", "primary"}, {"maxspeed", "60"}, {"name", "Alpha"}}},
+      {"BC", {{"highway", "primary"}, {"maxspeed", "60"}, {"name", "Bravo"}}},
+      {"CD", {{"highway", "primary"}, {"maxspeed", "60"}, {"name", "Charlie"}}},
+
+      {"BGHC", {{"highway", "primary"}, {"maxspeed", "60"}, {"name", "Golf"}}},
+      {"BEFC", {{"highway", "primary"}, {"maxspeed", "60"}, {"name", "Echo"}}},
+  };
+
+  const auto layout = gurka::detail::map_to_coordinates(ascii_map, 1000);
+  auto map = gurka::buildtiles(layout, ways, {}, {}, "test/data/alternates_concurrent");
+
+  // build the directions of the route and its alternates serially
+  std::string serial;
+  map.config.put("odin.concurrency", 1);
+  auto result = gurka::do_action(valhalla::Options::route, map, {"A", "D"}, "auto",
+                                 {{"/alternates", "2"}}, {}, &serial);
+  ASSERT_EQ(result.directions().routes_size(), 3);
+
+  // and then with more threads than there are legs to build, the output should be identical
+  std::string concurrent;
+  map.config.put("odin.concurrency", 8);
+  result = gurka::do_action(valhalla::Options::route, map, {"A", "D"}, "auto",
+                            {{"/alternates", "2"}}, {}, &concurrent);
+  ASSERT_EQ(result.directions().routes_size(), 3);
+  EXPECT_EQ(serial, concurrent);
+}
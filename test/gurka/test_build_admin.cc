@@ -6,6 +6,8 @@
 #include <sqlite3.h>
 
 #include <filesystem>
+#include <string>
+#include <vector>
 
 using namespace valhalla;
 using namespace valhalla::baldr;
@@ -288,6 +290,33 @@ void GetAdminData(const std::string& dbname,
   }
 }
 
+// Every row of the admin tables as text, including the rowids the parent admins refer to
+std::vector<std::string> DumpAdminTables(const std::string& dbname) {
+  sqlite3* db_handle = nullptr;
+  EXPECT_EQ(sqlite3_open_v2(dbname.c_str(), &db_handle, SQLITE_OPEN_READONLY, nullptr), SQLITE_OK);
+
+  std::vector<std::string> rows;
+  for (const std::string sql :
+       {"SELECT rowid, admin_level, iso_code, parent_admin, name, name_en, drive_on_right, "
+        "allow_intersection_names, default_language, supported_languages, hex(geom) FROM admins "
+        "ORDER BY rowid;",
+        "SELECT rowid, * FROM admin_access ORDER BY rowid;"}) {
+    sqlite3_stmt* stmt = nullptr;
+    EXPECT_EQ(sqlite3_prepare_v2(db_handle, sql.c_str(), -1, &stmt, nullptr), SQLITE_OK);
+    while (sqlite3_step(stmt) == SQLITE_ROW) {
+      std::string row;
+      for (int i = 0; i < sqlite3_column_count(stmt); ++i) {
+        const auto* text = sqlite3_column_text(stmt, i);
+        row += (text ? reinterpret_cast<const char*>(text) : "NULL") + std::string("|");
+      }
+      rows.push_back(std::move(row));
+    }
+    sqlite3_finalize(stmt);
+  }
+  sqlite3_close(db_handle);
+  return rows;
+}
+
 } // anonymous namespace
 
 TEST(AdminTest, TestBuildAdminFromPBF) {
@@ -470,3 +499,21 @@ TEST(AdminTest, TestBuildAdminFromPBF) {
     EXPECT_EQ(one_admin.country_text(), "None");
   }
 }
+
+TEST(AdminTest, SameForAnyConcurrency) {
+  // the polygons are built on several threads but the rows have to be inserted in the same order
+  std::vector<std::vector<std::string>> tables;
+  for (const unsigned int concurrency : {1u, 4u}) {
+    const std::string workdir = "test/data/admin_concurrency_" + std::to_string(concurrency);
+    std::filesystem::create_directories(workdir);
+    valhalla::gurka::map admin_map = BuildPBF(workdir);
+
+    boost::property_tree::ptree& pt = admin_map.config;
+    pt.put("mjolnir.concurrency", concurrency);
+    pt.put("mjolnir.admin", workdir + "/admin.sqlite");
+    ASSERT_TRUE(BuildAdminFromPBF(pt.get_child("mjolnir"), {workdir + "/map.pbf"}));
+    tables.push_back(DumpAdminTables(workdir + "/admin.sqlite"));
+  }
+  ASSERT_FALSE(tables[0].empty());
+  EXPECT_EQ(tables[0], tables[1]);
+}
@@ -0,0 +1,170 @@
+#include "baldr/graphreader.h"
+#include "baldr/tilehierarchy.h"
+#include "baldr/traffictile.h"
+#include "gurka.h"
+#include "midgard/sequence.h"
+#include "mjolnir/extractbuilder.h"
+
+#include <boost/property_tree/ptree.hpp>
+#include <gtest/gtest.h>
+
+#include <cstdlib>
+#include <filesystem>
+#include <unordered_map>
+
+using namespace valhalla;
+
+namespace {
+
+struct index_entry_t {
+  uint64_t offset;
+  uint32_t tile_id;
+  uint32_t size;
+};
+
+const std::string workdir = "test/data/gurka_build_extract";
+
+gurka::map build_map() {
+  // ways spanning a few tiles on two levels
+  const std::string ascii_map = R"(
+    A------------------B------------------C
+    |                                     |
+    D------------------E------------------F
+  )";
+  const gurka::ways ways = {
+      {"ABC", {{"highway", "motorway"}}},
+      {"DEF", {{"highway", "residential"}}},
+      {"AD", {{"highway", "primary"}}},
+      {"CF", {{"highway", "residential"}}},
+  };
+  const auto layout = gurka::detail::map_to_coordinates(ascii_map, 100, {-.01, -.01});
+  return gurka::buildtiles(layout, ways, {}, {}, workdir, {{"mjolnir.concurrency", "2"}});
+}
+
+// visits every regular file in the tar, returns them by name
+std::unordered_map<std::string, std::pair<const char*, size_t>> entries(midgard::tar& archive) {
+  std::unordered_map<std::string, std::pair<const char*, size_t>> files;
+  EXPECT_EQ(archive.for_each([&files](const std::string& name, const char* data, size_t size) {
+    files.emplace(name, std::make_pair(data, size));
+    return true;
+  }),
+            0);
+  return files;
+}
+
+} // namespace
+
+TEST(BuildExtract, LayoutAndIndex) {
+  auto map = build_map();
+  auto extract = workdir + "/tiles.tar";
+  auto count =
+      mjolnir::ExtractBuilder::Build(map.config.get_child("mjolnir"), extract, true, std::nullopt);
+
+  baldr::GraphReader dir_reader(map.config.get_child("mjolnir"));
+  auto tile_ids = dir_reader.GetTileSet();
+  ASSERT_EQ(count, tile_ids.size());
+  ASSERT_GT(count, 1);
+
+  // index.bin is first and every tile is page aligned at the offset it claims
+  midgard::tar archive(extract);
+  const auto* first = reinterpret_cast<const midgard::tar::header_t*>(archive.mm.get());
+  ASSERT_EQ(std::string(first->name), "index.bin");
+  auto files = entries(archive);
+  ASSERT_EQ(files.size(), count + 1);
+  const auto& index = files["index.bin"];
+  ASSERT_EQ(index.second, count * sizeof(index_entry_t));
+  const auto* entry = reinterpret_cast<const index_entry_t*>(index.first);
+  for (size_t i = 0; i < count; ++i, ++entry) {
+    EXPECT_EQ(entry->offset % mjolnir::kExtractPageSize, 0);
+    const auto* header =
+        reinterpret_cast<const midgard::tar::header_t*>(archive.mm.get() + entry->offset) - 1;
+    EXPECT_EQ(baldr::GraphTile::GetTileId(header->name).value, entry->tile_id);
+    EXPECT_EQ(header->get_file_size(), entry->size);
+    EXPECT_EQ(files[header->name].first, archive.mm.get() + entry->offset);
+  }
+
+  // the tiles in the extract are the same as the ones on disk
+  auto config = map.config;
+  config.put("mjolnir.tile_extract", extract);
+  config.put("mjolnir.tile_dir", workdir + "/nonexistent");
+  baldr::GraphReader tar_reader(config.get_child("mjolnir"));
+  ASSERT_EQ(tar_reader.GetTileSet().size(), count);
+  for (const auto& tile_id : tile_ids) {
+    auto dir_tile = dir_reader.GetGraphTile(tile_id);
+    auto tar_tile = tar_reader.GetGraphTile(tile_id);
+    ASSERT_TRUE(tar_tile);
+    ASSERT_EQ(memcmp(dir_tile->header(), tar_tile->header(), sizeof(baldr::GraphTileHeader)), 0);
+  }
+
+  // and the traffic tiles have a speed for each edge of their graph tile
+  midgard::tar traffic(workdir + "/traffic.tar");
+  auto traffic_files = entries(traffic);
+  ASSERT_EQ(traffic_files.size(), count + 1);
+  for (const auto& tile_id : tile_ids) {
+    auto dir_tile = dir_reader.GetGraphTile(tile_id);
+    auto found = traffic_files.find(baldr::GraphTile::FileSuffix(tile_id));
+    ASSERT_NE(found, traffic_files.end());
+    const auto* header = reinterpret_cast<const baldr::TrafficTileHeader*>(found->second.first);
+    EXPECT_EQ(header->tile_id, tile_id.value);
+    EXPECT_EQ(header->directed_edge_count, dir_tile->header()->directededgecount());
+    EXPECT_EQ(header->traffic_tile_version, baldr::TRAFFIC_TILE_VERSION);
+    EXPECT_EQ(found->second.second, sizeof(baldr::TrafficTileHeader) +
+                                        header->directed_edge_count * sizeof(baldr::TrafficSpeed));
+  }
+
+  // the traffic extract is usable alongside the tile extract
+  config.put("mjolnir.traffic_extract", workdir + "/traffic.tar");
+  baldr::GraphReader traffic_reader(config.get_child("mjolnir"));
+  for (const auto& tile_id : tile_ids) {
+    auto tile = traffic_reader.GetGraphTile(tile_id);
+    ASSERT_TRUE(tile);
+    EXPECT_EQ(tile->trafficspeed(tile->directededge(0)).speed_valid(), false);
+  }
+}
+
+TEST(BuildExtract, BoundingBox) {
+  auto map = build_map();
+  auto extract = workdir + "/bbox.tar";
+  baldr::GraphReader reader(map.config.get_child("mjolnir"));
+  auto all = reader.GetTileSet();
+
+  // just the tiles west of the prime meridian
+  midgard::AABB2<midgard::PointLL> bbox(-0.02, -0.02, -0.001, 0.02);
+  auto count = mjolnir::ExtractBuilder::Build(map.config.get_child("mjolnir"), extract, false, bbox);
+  size_t expected = 0;
+  for (const auto& tile_id : all) {
+    expected += baldr::TileHierarchy::get_tiling(tile_id.level())
+                    .TileBounds(tile_id.tileid())
+                    .Intersects(bbox);
+  }
+  EXPECT_GT(count, 0);
+  EXPECT_LT(count, all.size());
+  EXPECT_EQ(count, expected);
+}
+
+TEST(BuildExtract, HilbertOrder) {
+  // a 16x16 block of level 2 tiles in the corner of the tiling and a few other levels
+  const auto& tiles = baldr::TileHierarchy::get_tiling(2);
+  std::vector<baldr::GraphId> tile_ids;
+  for (uint32_t row = 0; row < 16; ++row) {
+    for (uint32_t col = 0; col < 16; ++col) {
+      tile_ids.emplace_back(row * tiles.ncolumns() + col, 2, 0);
+    }
+  }
+  tile_ids.emplace_back(5, 1, 0);
+  tile_ids.emplace_back(3, 0, 0);
+  mjolnir::ExtractBuilder::SortTiles(tile_ids);
+
+  // levels are grouped in ascending order
+  ASSERT_EQ(tile_ids[0], baldr::GraphId(3, 0, 0));
+  ASSERT_EQ(tile_ids[1], baldr::GraphId(5, 1, 0));
+
+  // and each tile in the block is a neighbour of the one before it
+  for (size_t i = 3; i < tile_ids.size(); ++i) {
+    int x0 = tile_ids[i - 1].tileid() % tiles.ncolumns();
+    int y0 = tile_ids[i - 1].tileid() / tiles.ncolumns();
+    int x1 = tile_ids[i].tileid() % tiles.ncolumns();
+    int y1 = tile_ids[i].tileid() / tiles.ncolumns();
+    EXPECT_EQ(std::abs(x1 - x0) + std::abs(y1 - y0), 1) << "at " << i;
+  }
+}
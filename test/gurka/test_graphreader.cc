@@ -1,7 +1,13 @@
 #include "gurka.h"
+#include "mjolnir/extractbuilder.h"
 
+#include <boost/property_tree/ptree.hpp>
 #include <gtest/gtest.h>
 
+#include <filesystem>
+#include <fstream>
+#include <thread>
+
 using namespace valhalla;
 
 TEST(GraphReader, ModifyTilePointerByReference) {
@@ -168,3 +174,118 @@ TEST(GraphReader, ModifyTilePointerByReference) {
     std::swap(l, r);
   }
 }
+
+namespace {
+
+// builds tiles for the given ways in their own directory and packs them into extract
+gurka::map
+build_extract(const gurka::ways& ways, const std::string& name, const std::string& extract) {
+  const std::string ascii_map = R"(
+    A-----B-----C
+          |
+          D
+  )";
+  const auto layout = gurka::detail::map_to_coordinates(ascii_map, 100);
+  auto map = gurka::buildtiles(layout, ways, {}, {}, "test/data/graphreader_reload/" + name,
+                              {{"mjolnir.shortcuts", "true"}});
+  // move it into place like a deployment would
+  mjolnir::ExtractBuilder::Build(map.config.get_child("mjolnir"), extract + ".new");
+  std::filesystem::rename(extract + ".new", extract);
+  return map;
+}
+
+// the number of edges leaving B
+uint32_t edge_count(baldr::GraphReader& reader, const gurka::map& map) {
+  auto node = gurka::findNode(reader, map.nodes, "B");
+  auto tile = reader.GetGraphTile(node);
+  return tile ? tile->node(node)->edge_count() : 0;
+}
+
+} // namespace
+
+TEST(GraphReader, ReloadExtract) {
+  const std::string extract = "test/data/graphreader_reload/tiles.tar";
+  const gurka::ways ways = {{"AB", {{"highway", "motorway"}, {"name", "M1"}}},
+                            {"BC", {{"highway", "motorway"}, {"name", "M1"}}}};
+  auto before = build_extract(ways, "before", extract);
+
+  auto config = before.config;
+  config.put("mjolnir.tile_extract", extract);
+  config.put("mjolnir.shortcut_caching", true);
+  // the second reader shares its cache with the first but won't be reloaded
+  config.put("mjolnir.global_synchronized_cache", true);
+  baldr::GraphReader reader(config.get_child("mjolnir"));
+  baldr::GraphReader stale_reader(config.get_child("mjolnir"));
+  auto old_tile = reader.GetGraphTile(gurka::findNode(reader, before.nodes, "B"));
+  ASSERT_TRUE(old_tile);
+  auto old_tile_edge_count = old_tile->header()->directededgecount();
+  auto old_edge_count = edge_count(reader, before);
+
+  // the shortcut over B is in the recovery cache
+  auto shortcut = std::get<0>(gurka::findEdgeByNodes(reader, before.nodes, "A", "C"));
+  ASSERT_TRUE(reader.GetGraphTile(shortcut)->directededge(shortcut)->is_shortcut());
+  ASSERT_EQ(reader.RecoverShortcut(shortcut).size(), 2);
+
+  // nothing happens until a reload is requested
+  auto after_ways = ways;
+  after_ways["BD"] = {{"highway", "motorway"}, {"name", "M1"}};
+  auto after = build_extract(after_ways, "after", extract);
+  EXPECT_FALSE(reader.ReloadIfRequested());
+  EXPECT_EQ(edge_count(reader, before), old_edge_count);
+
+  auto generation = reader.TileSetGeneration();
+  baldr::GraphReader::RequestReload();
+  EXPECT_TRUE(reader.ReloadIfRequested());
+  EXPECT_GT(reader.TileSetGeneration(), generation);
+  EXPECT_FALSE(reader.ReloadIfRequested());
+
+  // new tiles come from the new extract while the one we held on to is still intact
+  EXPECT_EQ(edge_count(reader, after), old_edge_count + 1);
+  EXPECT_EQ(old_tile->header()->directededgecount(), old_tile_edge_count);
+
+  // the shared cache never hands a reader the tiles of another extract
+  EXPECT_EQ(edge_count(stale_reader, before), old_edge_count);
+  EXPECT_EQ(edge_count(reader, after), old_edge_count + 1);
+
+  // B can't be contracted anymore so there are no shortcuts left to recover, whatever the id of
+  // the old one is now. the reader that wasn't reloaded still recovers the old shortcut
+  ASSERT_FALSE(reader.GetGraphTile(shortcut)->directededge(shortcut)->is_shortcut());
+  EXPECT_EQ(reader.RecoverShortcut(shortcut), std::vector<baldr::GraphId>{shortcut});
+  EXPECT_EQ(stale_reader.RecoverShortcut(shortcut).size(), 2);
+
+  // a broken extract is not swapped in
+  { std::ofstream(extract + ".new") << "not a tar"; }
+  std::filesystem::rename(extract + ".new", extract);
+  baldr::GraphReader::RequestReload();
+  EXPECT_TRUE(reader.ReloadIfRequested());
+  EXPECT_EQ(edge_count(reader, after), old_edge_count + 1);
+  EXPECT_FALSE(reader.Reload());
+}
+
+TEST(GraphReader, WarmUpExtract) {
+  const std::string extract = "test/data/graphreader_reload/warm_up.tar";
+  auto map = build_extract({{"ABC", {{"highway", "primary"}}}, {"BD", {{"highway", "motorway"}}}},
+                           "warm_up", extract);
+  baldr::GraphReader dir_reader(map.config.get_child("mjolnir"));
+  auto tile_id = gurka::findNode(dir_reader, map.nodes, "B").tile_base();
+
+  // fault in the tile B is in
+  const std::string hot_tiles = "test/data/graphreader_reload/hot_tiles.txt";
+  {
+    std::ofstream file(hot_tiles);
+    file << baldr::GraphTile::FileSuffix(tile_id) << "\n" << "not a tile\n";
+  }
+  auto config = map.config;
+  config.put("mjolnir.tile_extract", extract);
+  config.put("mjolnir.warm_up.policy", "hot_tiles");
+  config.put("mjolnir.warm_up.hot_tiles", hot_tiles);
+  config.put("mjolnir.warm_up.ready_fraction", 1.f);
+  baldr::GraphReader reader(config.get_child("mjolnir"));
+
+  for (size_t i = 0; i < 100 && !baldr::GraphReader::WarmedUp(); ++i) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  }
+  EXPECT_TRUE(baldr::GraphReader::WarmedUp());
+  EXPECT_FLOAT_EQ(baldr::GraphReader::WarmUpProgress(), 1.f);
+  EXPECT_TRUE(reader.GetGraphTile(tile_id));
+}
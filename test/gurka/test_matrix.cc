@@ -1,14 +1,23 @@
 #include "baldr/rapidjson_utils.h"
 #include "gurka.h"
 #include "loki/worker.h"
+#include "midgard/constants.h"
 #include "midgard/encoded.h"
 #include "proto/api.pb.h"
 #include "test.h"
 #include "thor/worker.h"
+#include "tyr/actor.h"
+#include "tyr/serializers.h"
 #include "valhalla/proto_conversions.h"
 #include "valhalla/worker.h"
 
 #include <gtest/gtest.h>
+#include <zlib.h>
+
+#include <cmath>
+#include <cstring>
+#include <functional>
+#include <limits>
 
 using namespace valhalla;
 using namespace valhalla::thor;
@@ -841,6 +850,103 @@ TEST_F(DateTimeTest, NoTimeZone) {
   }
 }
 
+TEST_F(DateTimeTest, DateTimeRange) {
+  const std::vector<std::string> date_times = {"2020-10-30T09:00", "2020-10-30T09:30",
+                                               "2020-10-30T10:00"};
+  std::string res;
+  auto api = gurka::do_action(valhalla::Options::sources_to_targets, map_tz, {"A", "G"}, {"A", "G"},
+                              "bicycle",
+                              {{"/date_time/type", "1"},
+                               {"/date_time/value", date_times.front()},
+                               {"/date_time/end", "2020-10-30T10:10"},
+                               {"/date_time/step", "30"}},
+                              nullptr, &res);
+  ASSERT_EQ(api.matrix().algorithm(), Matrix::TimeDistanceMatrix);
+  const int count = date_times.size();
+  ASSERT_EQ(api.matrix().date_times_size(), count);
+  ASSERT_EQ(api.matrix().times_size(), count * 4);
+
+  // every matrix of the range is the same as the one of a single request for its date_time
+  for (int i = 0; i < count; ++i) {
+    EXPECT_EQ(api.matrix().date_times(i), date_times[i]);
+    auto single = gurka::do_action(valhalla::Options::sources_to_targets, map_tz, {"A", "G"},
+                                   {"A", "G"}, "bicycle",
+                                   {{"/date_time/type", "1"}, {"/date_time/value", date_times[i]}});
+    for (int j = 0; j < single.matrix().times_size(); ++j) {
+      EXPECT_EQ(api.matrix().times(i * 4 + j), single.matrix().times(j));
+      EXPECT_EQ(api.matrix().distances(i * 4 + j), single.matrix().distances(j));
+      EXPECT_EQ(api.matrix().date_times(i * 4 + j), single.matrix().date_times(j));
+    }
+  }
+
+  // the json nests a matrix per date_time
+  rapidjson::Document res_doc;
+  res_doc.Parse(res.c_str());
+  ASSERT_EQ(res_doc["date_times"].GetArray().Size(), count);
+  EXPECT_EQ(res_doc["date_times"][2].GetString(), date_times[2]);
+  ASSERT_EQ(res_doc["sources_to_targets"].GetArray().Size(), count);
+  EXPECT_EQ(res_doc["sources_to_targets"][2][1][0]["from_index"].GetInt(), 1);
+  EXPECT_EQ(res_doc["sources_to_targets"][2][1][0]["date_time"].GetString(),
+            api.matrix().date_times(2 * 4 + 2));
+
+  // invalid ranges
+  for (const auto& options : std::vector<std::unordered_map<std::string, std::string>>{
+           {{"/date_time/type", "1"},
+            {"/date_time/value", "2020-10-30T09:00"},
+            {"/date_time/end", "2020-10-30T08:00"}},
+           {{"/date_time/type", "1"},
+            {"/date_time/value", "2020-10-30T09:00"},
+            {"/date_time/end", "2020-10-30T10:00"},
+            {"/date_time/step", "0"}},
+           {{"/date_time/type", "0"}, {"/date_time/end", "2020-10-30T10:00"}},
+           {{"/date_time/type", "1"},
+            {"/date_time/value", "2020-10-30T09:00"},
+            {"/date_time/end", "2020-11-30T09:00"},
+            {"/date_time/step", "1"}},
+           {{"/date_time/type", "1"},
+            {"/date_time/value", "2020-10-30T09:00"},
+            {"/date_time/end", "2020-10-30T10:00"},
+            {"/format", "binary"}},
+       }) {
+    try {
+      gurka::do_action(valhalla::Options::sources_to_targets, map_tz, {"A"}, {"G"}, "bicycle",
+                       options);
+      FAIL() << "Expected valhalla_exception_t.";
+    } catch (const valhalla_exception_t& err) { EXPECT_EQ(err.code, 169); } catch (...) {
+      FAIL() << "Expected valhalla_exception_t.";
+    }
+  }
+
+  // protobuf requests don't go through the json parsing, loki checks their ranges
+  const auto request_json = gurka::detail::build_valhalla_request(
+      {"sources", "targets"}, {{map_tz.nodes.at("A")}, {map_tz.nodes.at("G")}}, "bicycle",
+      {{"/date_time/type", "1"},
+       {"/date_time/value", "2020-10-30T09:00"},
+       {"/date_time/end", "2020-10-30T10:00"}});
+  Api clean;
+  ParseApi(request_json, Options::sources_to_targets, clean);
+  // every date_time is a matrix, 5 of them fit into 10 location pairs but 13 don't
+  auto limited = map_tz;
+  limited.config.put("service_limits.bicycle.max_matrix_location_pairs", "10");
+  const auto range_error = [&](const std::function<void(Options&)>& modify) {
+    Api request;
+    request.mutable_options()->CopyFrom(clean.options());
+    request.mutable_options()->clear_costings();
+    request.mutable_options()->set_date_time_step(15);
+    modify(*request.mutable_options());
+    try {
+      gurka::do_action(limited, request);
+    } catch (const valhalla_exception_t& err) { return err.code; }
+    return 0u;
+  };
+  EXPECT_EQ(range_error([](Options&) {}), 0u);
+  EXPECT_EQ(range_error([](Options& options) { options.set_date_time_step(5); }), 150u);
+  EXPECT_EQ(range_error([](Options& options) { options.set_date_time_step(0); }), 169u);
+  EXPECT_EQ(range_error([](Options& options) { options.set_date_time_end("2020-10-30T08:00"); }),
+            169u);
+  EXPECT_EQ(range_error([](Options& options) { options.set_format(Options::binary); }), 169u);
+}
+
 // Parameterize check_reverse_connection
 class TestConnectionCheck : public ::testing::TestWithParam<std::string> {};
 
@@ -1417,3 +1523,138 @@ TEST(StandAlone, MaxDistanceCutoff) {
     EXPECT_TRUE(row[2]["distance"].IsNull()) << "A->D should NOT be reachable with max_distance=4500";
   }
 }
+
+TEST(StandAlone, StreamedMatrixMatchesBuffered) {
+  const std::string ascii_map = R"(
+    A---B---C---D
+    |   |   |   |
+    E---F---G---H
+    |   |   |   |
+    I---J---K---L
+  )";
+  const gurka::ways ways = {
+      {"ABCD", {{"highway", "residential"}}}, {"EFGH", {{"highway", "residential"}}},
+      {"IJKL", {{"highway", "residential"}}}, {"AEI", {{"highway", "residential"}}},
+      {"BFJ", {{"highway", "residential"}}},  {"CGK", {{"highway", "residential"}}},
+      {"DHL", {{"highway", "residential"}}},
+  };
+  const auto layout = gurka::detail::map_to_coordinates(ascii_map, 100);
+  auto map =
+      gurka::buildtiles(layout, ways, {}, {}, VALHALLA_BUILD_DIR "test/data/matrix_streamed");
+
+  // enough locations that the verbose response spans several chunks
+  std::vector<PointLL> lls;
+  for (size_t i = 0; i < 4; ++i) {
+    for (const auto& name : {"A", "B", "C", "D", "E", "F", "G", "H", "I", "J", "K", "L"}) {
+      lls.push_back(layout.at(name));
+    }
+  }
+
+  for (const auto& verbose : {"1", "0"}) {
+    for (const auto& format : {"json", "osrm"}) {
+      const auto request =
+          gurka::detail::build_valhalla_request({"sources", "targets"}, {lls, lls}, "auto",
+                                                {{"/verbose", verbose}, {"/format", format}});
+      tyr::actor_t actor(map.config, true);
+      const auto buffered = actor.matrix(request);
+
+      std::string streamed;
+      size_t chunks = 0;
+      const std::function<void(const char*, size_t)> sink = [&](const char* bytes, size_t size) {
+        EXPECT_GT(size, 0);
+        streamed.append(bytes, size);
+        ++chunks;
+      };
+      EXPECT_TRUE(actor.matrix(request, nullptr, nullptr, &sink).empty());
+      EXPECT_EQ(streamed, buffered) << "verbose=" << verbose << " format=" << format;
+      EXPECT_GE(chunks, 1);
+      // rows are small so a big response must have been handed off in more than one go
+      if (buffered.size() > 2 * tyr::kStreamChunkSize) {
+        EXPECT_GT(chunks, 1);
+      }
+    }
+  }
+}
+
+TEST(StandAlone, BinaryMatrixFormat) {
+  const std::string ascii_map = R"(
+    A---B---C
+    |       |
+    D---E   F
+
+    G---H
+  )";
+  const gurka::ways ways = {
+      {"ABC", {{"highway", "residential"}}}, {"AD", {{"highway", "residential"}}},
+      {"DE", {{"highway", "residential"}}},  {"CF", {{"highway", "residential"}}},
+      {"GH", {{"highway", "residential"}}},
+  };
+  const auto layout = gurka::detail::map_to_coordinates(ascii_map, 100);
+  auto map = gurka::buildtiles(layout, ways, {}, {}, VALHALLA_BUILD_DIR "test/data/matrix_binary");
+
+  // the json response is what we compare against, GH is an island so we get some nulls too
+  const std::vector<std::string> sources{"A", "E", "G"}, targets{"B", "C", "F", "G", "H"};
+  std::string json;
+  gurka::do_action(valhalla::Options::sources_to_targets, map, sources, targets, "auto",
+                   {{"/verbose", "0"}}, nullptr, &json);
+  rapidjson::Document doc;
+  doc.Parse(json.c_str());
+  const auto& durations = doc["sources_to_targets"]["durations"];
+  const auto& distances = doc["sources_to_targets"]["distances"];
+
+  for (const auto& compress : {"0", "1"}) {
+    std::string bytes;
+    gurka::do_action(valhalla::Options::sources_to_targets, map, sources, targets, "auto",
+                     {{"/format", "binary"}, {"/compress", compress}}, nullptr, &bytes);
+
+    // check the header
+    ASSERT_GE(bytes.size(), 32);
+    EXPECT_EQ(bytes.substr(0, 4), "VMTX");
+    uint16_t version;
+    uint32_t source_count, target_count;
+    uint64_t array_size, payload_size;
+    std::memcpy(&version, bytes.data() + 4, sizeof(version));
+    std::memcpy(&source_count, bytes.data() + 8, sizeof(source_count));
+    std::memcpy(&target_count, bytes.data() + 12, sizeof(target_count));
+    std::memcpy(&array_size, bytes.data() + 16, sizeof(array_size));
+    std::memcpy(&payload_size, bytes.data() + 24, sizeof(payload_size));
+    EXPECT_EQ(version, 1);
+    EXPECT_EQ(bytes[6], std::string(compress) == "1" ? 1 : 0);
+    EXPECT_EQ(bytes[7], static_cast<char>(Matrix::CostMatrix));
+    ASSERT_EQ(source_count, sources.size());
+    ASSERT_EQ(target_count, targets.size());
+    ASSERT_EQ(array_size, sources.size() * targets.size() * 8);
+    ASSERT_EQ(payload_size, bytes.size() - 32);
+
+    // get the arrays out
+    std::string arrays(array_size, '\0');
+    if (bytes[6]) {
+      uLongf size = array_size;
+      ASSERT_EQ(uncompress(reinterpret_cast<Bytef*>(arrays.data()), &size,
+                           reinterpret_cast<const Bytef*>(bytes.data() + 32), payload_size),
+                Z_OK);
+      ASSERT_EQ(size, array_size);
+    } else {
+      arrays = bytes.substr(32);
+    }
+    std::vector<float> times(source_count * target_count);
+    std::vector<uint32_t> meters(source_count * target_count);
+    std::memcpy(times.data(), arrays.data(), times.size() * sizeof(float));
+    std::memcpy(meters.data(), arrays.data() + times.size() * sizeof(float),
+                meters.size() * sizeof(uint32_t));
+
+    // and make sure they agree with the json
+    for (size_t i = 0; i < source_count; ++i) {
+      for (size_t j = 0; j < target_count; ++j) {
+        const auto k = i * target_count + j;
+        if (durations[i][j].IsNull()) {
+          EXPECT_TRUE(std::isinf(times[k]));
+          EXPECT_EQ(meters[k], std::numeric_limits<uint32_t>::max());
+        } else {
+          EXPECT_EQ(static_cast<uint64_t>(times[k]), durations[i][j].GetUint64());
+          EXPECT_NEAR(meters[k] * kKmPerMeter, distances[i][j].GetDouble(), 0.001);
+        }
+      }
+    }
+  }
+}
@@ -4,6 +4,8 @@
 #include <openssl/evp.h>
 
 #include <fstream>
+#include <string>
+#include <unordered_map>
 
 #if !defined(VALHALLA_SOURCE_DIR)
 #define VALHALLA_SOURCE_DIR
@@ -113,18 +115,25 @@ uint64_t get_pbf_md5(std::string pbf_path) {
   return checksum;
 }
 
-// 1. build tiles with the same input twice
+// 1. build tiles with the same input twice, optionally with different config options
 // 2. check that the same tile sets are generated
 struct ReproducibleBuild : ::testing::Test {
-  void BuildTiles(const std::string& ascii_map, const gurka::ways& ways, const double gridsize) {
-    const auto build_tiles = [&](const std::string& dir) -> std::pair<gurka::map, std::string> {
+  void BuildTiles(const std::string& ascii_map,
+                  const gurka::ways& ways,
+                  const double gridsize,
+                  const std::unordered_map<std::string, std::string>& first_options = {},
+                  const std::unordered_map<std::string, std::string>& second_options = {}) {
+    const std::string test_name = ::testing::UnitTest::GetInstance()->current_test_info()->name();
+    const auto build_tiles = [&](const std::string& dir,
+                                 const std::unordered_map<std::string, std::string>& options)
+        -> std::pair<gurka::map, std::string> {
       const gurka::nodelayout layout = gurka::detail::map_to_coordinates(ascii_map, gridsize);
-      const std::string workdir = "test/data/gurka_reproduce_tile_build/" + dir;
-      return std::make_pair(gurka::buildtiles(layout, ways, {}, {}, workdir, {}),
+      const std::string workdir = "test/data/gurka_reproduce_tile_build/" + test_name + "/" + dir;
+      return std::make_pair(gurka::buildtiles(layout, ways, {}, {}, workdir, options),
                             workdir + "/map.pbf");
     };
-    const auto [first_map, first_pbf] = build_tiles("1");
-    const auto [second_map, second_pbf] = build_tiles("2");
+    const auto [first_map, first_pbf] = build_tiles("1", first_options);
+    const auto [second_map, second_pbf] = build_tiles("2", second_options);
     // the checksums will differ when the PBFs weren't produced in the same second due to OSM header
     const auto first_pbf_md5 = get_pbf_md5(first_pbf);
     const auto second_pbf_md5 = get_pbf_md5(second_pbf);
@@ -193,3 +202,48 @@ TEST_F(ReproducibleBuild, BigGridSize) {
                             {"EH", {{"highway", "path"}}}};
   BuildTiles(ascii_map, ways, 100000);
 }
+
+TEST_F(ReproducibleBuild, SameForAnyConcurrency) {
+  // several tiles on every level, and chains of nodes on the upper levels to form shortcuts from
+  const std::string ascii_map = R"(
+    A----B----C----D----E
+    |         |         |
+    F----G----H----I----J
+    |         |         |
+    K----L----M----N----O)";
+
+  const gurka::ways ways = {{"ABCDE", {{"highway", "motorway"}}},
+                            {"FGHIJ", {{"highway", "trunk"}}},
+                            {"KLMNO", {{"highway", "primary"}}},
+                            {"AFK", {{"highway", "secondary"}}},
+                            {"CHM", {{"highway", "tertiary"}}},
+                            {"EJO", {{"highway", "residential"}}}};
+  BuildTiles(ascii_map, ways, 20000, {{"mjolnir.concurrency", "1"}},
+             {{"mjolnir.concurrency", "4"}});
+}
+
+TEST_F(ReproducibleBuild, FilteredSameForAnyConcurrency) {
+  // filtering out the paths leaves E with DE and EF only, so they are aggregated into one edge
+  const std::string ascii_map = R"(
+    A----B----C
+    |    .
+    D----E----F
+    |    . \
+    G----H----I)";
+
+  const gurka::ways ways = {{"AB", {{"highway", "primary"}}},
+                            {"BC", {{"highway", "primary"}}},
+                            {"DEF", {{"highway", "primary"}}},
+                            {"GHI", {{"highway", "primary"}}},
+                            {"ADG", {{"highway", "motorway"}}},
+                            {"BE", {{"highway", "path"}}},
+                            {"EI", {{"highway", "path"}, {"bicycle", "no"}}},
+                            {"EH", {{"highway", "path"}}}};
+  BuildTiles(ascii_map, ways, 100000,
+             {{"mjolnir.concurrency", "1"},
+              {"mjolnir.include_bicycle", "false"},
+              {"mjolnir.include_pedestrian", "false"}},
+             {{"mjolnir.concurrency", "4"},
+              {"mjolnir.include_bicycle", "false"},
+              {"mjolnir.include_pedestrian", "false"}});
+}
@@ -0,0 +1,102 @@
+#include "baldr/rapidjson_utils.h"
+#include "gurka.h"
+#include "test.h"
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+using namespace valhalla;
+
+namespace {
+
+// the hits, misses, entries and evictions of the route cache as /status reports them
+std::vector<uint64_t> cache_status(tyr::actor_t& actor) {
+  rapidjson::Document doc;
+  doc.Parse(actor.status("").c_str());
+  EXPECT_FALSE(doc.HasParseError());
+  const auto& cache = doc["route_cache"];
+  return {cache["hits"].GetUint64(), cache["misses"].GetUint64(), cache["entries"].GetUint64(),
+          cache["evictions"].GetUint64()};
+}
+
+TEST(RouteCache, HitsMissesAndInvalidation) {
+  const std::string ascii_map = R"(
+    A----B----C
+         |    |
+         D----E
+  )";
+
+  const gurka::ways ways = {{"ABC", {{"highway", "primary"}}},
+                            {"BDE", {{"highway", "residential"}}},
+                            {"CE", {{"highway", "residential"}}}};
+
+  const auto layout = gurka::detail::map_to_coordinates(ascii_map, 100);
+  auto map = gurka::buildtiles(layout, ways, {}, {}, "test/data/gurka_route_cache",
+                               {{"thor.route_cache.max_entries", "2"},
+                                {"thor.route_cache.traffic_check_interval", "0"}});
+  map.config.put("mjolnir.traffic_extract", "test/data/gurka_route_cache/traffic.tar");
+  test::build_live_traffic_data(map.config);
+
+  // one actor for all of the requests so that its thor worker keeps the cache
+  auto reader = test::make_clean_graphreader(map.config.get_child("mjolnir"));
+  tyr::actor_t actor(map.config, *reader);
+  auto route = [&](const std::string& from, const std::string& to,
+                   const std::unordered_map<std::string, std::string>& options = {}) {
+    auto request = gurka::detail::build_valhalla_request({"locations"},
+                                                         {{map.nodes.at(from), map.nodes.at(to)}},
+                                                         "auto", options);
+    Api api;
+    actor.route(request, nullptr, &api);
+    return api;
+  };
+
+  // the second time around the path comes from the cache and the route is the same
+  auto first = route("A", "E");
+  EXPECT_EQ(cache_status(actor), (std::vector<uint64_t>{0, 1, 1, 0}));
+  auto second = route("A", "E");
+  EXPECT_EQ(cache_status(actor), (std::vector<uint64_t>{1, 1, 1, 0}));
+  gurka::assert::raw::expect_path(second, {"ABC", "CE"});
+  EXPECT_EQ(first.trip().routes(0).legs(0).shape(), second.trip().routes(0).legs(0).shape());
+
+  // other costing options are another path
+  const std::unordered_map<std::string, std::string> slow = {
+      {"/costing_options/auto/top_speed", "30"}};
+  route("A", "E", slow);
+  EXPECT_EQ(cache_status(actor), (std::vector<uint64_t>{1, 2, 2, 0}));
+
+  // so is the other direction, the least recently used path makes room for it
+  route("E", "A");
+  EXPECT_EQ(cache_status(actor), (std::vector<uint64_t>{1, 3, 2, 1}));
+  route("A", "E");
+  EXPECT_EQ(cache_status(actor), (std::vector<uint64_t>{1, 4, 2, 2}));
+
+  // an update of the live traffic drops everything
+  test::customize_live_traffic_data(map.config, [](baldr::GraphReader&, baldr::TrafficTile&,
+                                                   uint32_t, baldr::TrafficSpeed*) {});
+  route("A", "E");
+  EXPECT_EQ(cache_status(actor), (std::vector<uint64_t>{1, 5, 1, 2}));
+  route("A", "E");
+  EXPECT_EQ(cache_status(actor), (std::vector<uint64_t>{2, 5, 1, 2}));
+
+  // the traffic tiles aren't looked at again until the interval has passed
+  map.config.put("thor.route_cache.traffic_check_interval", 3600);
+  tyr::actor_t lazy_actor(map.config, *reader);
+  auto lazy_route = [&](const std::string& from, const std::string& to) {
+    auto request = gurka::detail::build_valhalla_request({"locations"},
+                                                         {{map.nodes.at(from), map.nodes.at(to)}},
+                                                         "auto");
+    lazy_actor.route(request);
+  };
+  lazy_route("A", "E");
+  lazy_route("A", "E");
+  EXPECT_EQ(cache_status(lazy_actor), (std::vector<uint64_t>{1, 1, 1, 0}));
+  test::customize_live_traffic_data(map.config, [](baldr::GraphReader&, baldr::TrafficTile&,
+                                                   uint32_t, baldr::TrafficSpeed*) {});
+  lazy_route("A", "E");
+  EXPECT_EQ(cache_status(lazy_actor), (std::vector<uint64_t>{2, 1, 1, 0}));
+}
+
+} // namespace
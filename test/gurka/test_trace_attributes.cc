@@ -513,3 +513,44 @@ TEST(Standalone, PbfOut) {
     EXPECT_NEAR(it->distance_from_trace_point(), 10., 0.5);
   }
 }
+
+TEST(Standalone, SkipUnrequestedParts) {
+  const std::string ascii_map = R"(
+      1    2   3
+    A------B------C
+           |
+           D
+  )";
+
+  const gurka::ways ways = {{"AB", {{"highway", "primary"}, {"name", "Main"}}},
+                            {"BC", {{"highway", "primary"}, {"name", "Main"}}},
+                            {"BD", {{"highway", "residential"}, {"name", "Side"}}}};
+
+  const double gridsize = 10;
+  const auto layout = gurka::detail::map_to_coordinates(ascii_map, gridsize);
+  auto map = gurka::buildtiles(layout, ways, {}, {}, "test/data/trace_attributes_skip");
+
+  // by default the intersecting side street is on the node at B
+  auto full = gurka::do_action(valhalla::Options::trace_attributes, map, {"1", "2", "3"}, "auto");
+  const auto& full_leg = full.trip().routes(0).legs(0);
+  ASSERT_EQ(full_leg.node_size(), 3);
+  ASSERT_EQ(full_leg.node(1).intersecting_edge_size(), 1);
+  EXPECT_EQ(full_leg.node(1).intersecting_edge(0).road_class(), valhalla::RoadClass::kResidential);
+
+  // without any intersecting edge attributes they aren't added at all, the rest is the same
+  auto minimal =
+      gurka::do_action(valhalla::Options::trace_attributes, map, {"1", "2", "3"}, "auto",
+                       {{"/filters/action", "include"},
+                        {"/filters/attributes/0", "edge.length"},
+                        {"/filters/attributes/1", "node.type"}});
+  const auto& minimal_leg = minimal.trip().routes(0).legs(0);
+  ASSERT_EQ(minimal_leg.node_size(), full_leg.node_size());
+  for (int i = 0; i < minimal_leg.node_size(); ++i) {
+    EXPECT_EQ(minimal_leg.node(i).intersecting_edge_size(), 0);
+    EXPECT_EQ(minimal_leg.node(i).type(), full_leg.node(i).type());
+    if (i + 1 < minimal_leg.node_size()) {
+      EXPECT_EQ(minimal_leg.node(i).edge().length_km(), full_leg.node(i).edge().length_km());
+      EXPECT_EQ(minimal_leg.node(i).edge().name_size(), 0);
+    }
+  }
+}
@@ -389,6 +389,69 @@ TEST(Isochrones, test_max_reserved_labels_count) {
   isochrone.Clear();
 }
 
+std::string batch_isochrones(const boost::property_tree::ptree& config,
+                             const std::string& request_json,
+                             const std::function<void(const char*, size_t)>* sink = nullptr) {
+  loki_worker_t loki_worker(config);
+  thor_worker_t thor_worker(config);
+  Api request;
+  ParseApi(request_json, Options::isochrone, request);
+  loki_worker.isochrones(request);
+  return thor_worker.isochrones(request, sink);
+}
+
+TEST(Isochrones, Batch) {
+  // more locations than service_limits.isochrone.max_locations allows in one request
+  const std::vector<std::string> locations = {R"({"lat":52.078937,"lon":5.115321})",
+                                              R"({"lat":52.075911,"lon":5.086633})",
+                                              R"({"lat":52.109455,"lon":5.128852})",
+                                              R"({"lat":52.093199,"lon":5.042799})"};
+  const std::string options = R"("costing":"auto","contours":[{"time":3},{"time":6}],)"
+                              R"("polygons":true,"show_locations":true)";
+
+  // the batch answers like a request per location would
+  std::string expected = "[";
+  std::string batch = R"({"batch":true,)" + options + R"(,"locations":[)";
+  for (size_t i = 0; i < locations.size(); ++i) {
+    expected += (i == 0 ? "" : ",") +
+                batch_isochrones(cfg, R"({)" + options + R"(,"locations":[)" + locations[i] + "]}");
+    batch += (i == 0 ? "" : ",") + locations[i];
+  }
+  expected += "]";
+  batch += "]}";
+
+  for (uint32_t concurrency : {1, 2, 3, 8}) {
+    SCOPED_TRACE("batch_concurrency " + std::to_string(concurrency));
+    auto config = cfg;
+    config.put("thor.isochrone.batch_concurrency", concurrency);
+    EXPECT_EQ(batch_isochrones(config, batch), expected);
+
+    std::string streamed;
+    std::function<void(const char*, size_t)> sink = [&streamed](const char* data, size_t size) {
+      streamed.append(data, size);
+    };
+    EXPECT_EQ(batch_isochrones(config, batch, &sink), "");
+    EXPECT_EQ(streamed, expected);
+  }
+
+  // only json can be written as a batch
+  try {
+    batch_isochrones(cfg, R"({"format":"pbf",)" + batch.substr(1));
+    FAIL() << "Expected to throw";
+  } catch (const valhalla_exception_t& e) { EXPECT_EQ(e.code, 145); }
+
+  // a batch has a limit of its own
+  auto config = cfg;
+  config.put("service_limits.isochrone.max_batch_locations", 3);
+  try {
+    batch_isochrones(config, batch);
+    FAIL() << "Expected to throw";
+  } catch (const valhalla_exception_t& e) {
+    EXPECT_EQ(e.code, 150);
+    EXPECT_EQ(e.message, "Exceeded max locations: 3");
+  }
+}
+
 #ifdef ENABLE_GEOTIFF
 
 void check_raster_edges(size_t x, size_t y, uint16_t* data) {
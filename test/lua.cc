@@ -1,11 +1,18 @@
 #include "mjolnir/graph_lua_proc.h"
 #include "mjolnir/luatagtransform.h"
+#include "mjolnir/nativetagtransform.h"
 #include "mjolnir/osmdata.h"
 
 #include <gtest/gtest.h>
 #include <osmium/builder/osm_object_builder.hpp>
+#include <osmium/io/pbf_input.hpp>
 
 #include <string>
+#include <vector>
+
+#if !defined(VALHALLA_SOURCE_DIR)
+#define VALHALLA_SOURCE_DIR
+#endif
 
 using namespace valhalla;
 
@@ -151,6 +158,100 @@ TEST(Lua, TestForwardBackward) {
   ASSERT_TRUE(results.count("maxweight_forward") == 1);
   ASSERT_TRUE(results.count("maxweight_backward") == 1);
 }
+
+mjolnir::OSMType to_type(osmium::item_type type) {
+  switch (type) {
+    case osmium::item_type::node:
+      return mjolnir::OSMType::kNode;
+    case osmium::item_type::way:
+      return mjolnir::OSMType::kWay;
+    default:
+      return mjolnir::OSMType::kRelation;
+  }
+}
+
+TEST(Lua, NativeMatchesLuaOnExtracts) {
+  mjolnir::LuaTagTransform lua(std::string(lua_graph_lua, lua_graph_lua + lua_graph_lua_len));
+  mjolnir::NativeTagTransform native;
+
+  size_t transformed = 0;
+  for (const auto* pbf : {"amsterdam.osm.pbf", "baltimore.osm.pbf", "bike.osm.pbf", "bus.osm.pbf",
+                          "melborne.osm.pbf", "ny-access-restriction.osm.pbf", "paris_bss.osm.pbf",
+                          "rome.osm.pbf", "whitelion_bristol_uk.osm.pbf"}) {
+    osmium::io::Reader reader(std::string(VALHALLA_SOURCE_DIR "test/data/") + pbf,
+                              osmium::osm_entity_bits::nwr);
+    while (osmium::memory::Buffer buffer = reader.read()) {
+      for (const auto& object : buffer.select<osmium::OSMObject>()) {
+        auto type = to_type(object.type());
+        auto expected = lua.Transform(type, object.id(), object.tags());
+        auto actual = native.Transform(type, object.id(), object.tags());
+        ASSERT_EQ(expected, actual) << pbf << " " << object.type() << " " << object.id();
+        transformed += !expected.empty();
+      }
+    }
+    reader.close();
+  }
+  EXPECT_GT(transformed, 0);
+}
+
+TEST(Lua, NativeMatchesLuaOnEdgeCases) {
+  mjolnir::LuaTagTransform lua(std::string(lua_graph_lua, lua_graph_lua + lua_graph_lua_len));
+  mjolnir::NativeTagTransform native;
+
+  const std::vector<std::pair<mjolnir::OSMType, std::vector<std::pair<std::string, std::string>>>>
+      cases = {
+          {mjolnir::OSMType::kWay, {}},
+          {mjolnir::OSMType::kNode, {}},
+          {mjolnir::OSMType::kRelation, {}},
+          {mjolnir::OSMType::kWay, {{"highway", "primary"}, {"maxweight", "3.5 t"}}},
+          {mjolnir::OSMType::kWay, {{"highway", "primary"}, {"maxweight", ".t"}}},
+          {mjolnir::OSMType::kWay, {{"highway", "primary"}, {"maxweight", "7000 lbs"}}},
+          {mjolnir::OSMType::kWay, {{"highway", "tertiary"}, {"maxheight", "12'6\""}}},
+          {mjolnir::OSMType::kWay, {{"highway", "tertiary"}, {"maxheight", "3..35"}}},
+          {mjolnir::OSMType::kWay, {{"highway", "residential"}, {"maxspeed", "20 mph"}}},
+          {mjolnir::OSMType::kWay, {{"highway", "residential"}, {"maxspeed", "walk"}}},
+          {mjolnir::OSMType::kWay,
+           {{"highway", "unclassified"},
+            {"oneway", "-1"},
+            {"oneway:bicycle", "no"},
+            {"cycleway", "opposite_lane"},
+            {"cycleway:right", "lane"}}},
+          {mjolnir::OSMType::kWay,
+           {{"highway", "motorway"},
+            {"hov:lanes:forward", "designated|yes"},
+            {"hov:minimum", "3"},
+            {"toll", "yes"},
+            {"payment:cash", "yes"},
+            {"payment:notes", "no"}}},
+          {mjolnir::OSMType::kWay,
+           {{"highway", "secondary"},
+            {"motor_vehicle:conditional", "no @ (Mo-Fr 07:00-09:00)"},
+            {"hgv:backward:conditional", "no@(22:00-06:00)"},
+            {"access", "destination"}}},
+          {mjolnir::OSMType::kWay,
+           {{"highway", "footway"}, {"footway", "sidewalk"}, {"bicycle", "dismount"}}},
+          {mjolnir::OSMType::kWay, {{"route", "ferry"}, {"duration", "00:30"}, {"ref", "A;B"}}},
+          {mjolnir::OSMType::kNode, {{"barrier", "gate"}, {"access", "private"}, {"foot", "yes"}}},
+          {mjolnir::OSMType::kNode, {{"barrier", "toll_booth"}, {"payment:coins", "yes"}}},
+          {mjolnir::OSMType::kNode, {{"amenity", "bicycle_rental"}, {"capacity", "10"}}},
+          {mjolnir::OSMType::kRelation,
+           {{"type", "restriction"},
+            {"restriction:conditional", "no_right_turn @ (Mo-Fr 07:00-09:00)"},
+            {"except", "bicycle;psv"}}},
+          {mjolnir::OSMType::kRelation,
+           {{"type", "route"}, {"route", "bicycle"}, {"network", "lcn"}, {"ref", "12"}}},
+      };
+
+  for (const auto& c : cases) {
+    TagsBuilder tags;
+    for (const auto& tag : c.second) {
+      tags.insert(tag);
+    }
+    ASSERT_EQ(lua.Transform(c.first, 1, tags.get()), native.Transform(c.first, 1, tags.get()))
+        << (c.second.empty() ? std::string() : c.second.front().second);
+  }
+}
+
 } // namespace
 
 // TODO: sweet jesus add more tests of this class!
@@ -389,6 +389,69 @@ TEST(Matrix, test_timedistancematrix_reverse) {
   }
 }
 
+TEST(Matrix, test_timedistancematrix_concurrent) {
+  // more sources than targets runs the expansions in reverse
+  const auto test_request_reverse = R"({
+    "sources":[
+      {"lat":52.106337,"lon":5.101728},
+      {"lat":52.111276,"lon":5.089717},
+      {"lat":52.103105,"lon":5.081005},
+      {"lat":52.103948,"lon":5.06813}
+    ],
+    "targets":[
+      {"lat":52.106126,"lon":5.101497},
+      {"lat":52.100469,"lon":5.087099},
+      {"lat":52.103105,"lon":5.081005}
+    ],
+    "costing":"auto"
+  })";
+
+  loki_worker_t loki_worker(cfg);
+  GraphReader reader(cfg.get_child("mjolnir"));
+
+  boost::property_tree::ptree concurrent_cfg;
+  concurrent_cfg.put("timedistancematrix.concurrency", 4);
+  TimeDistanceMatrix serial_matrix, concurrent_matrix(concurrent_cfg);
+
+  for (const auto* json : {test_request, test_request_reverse}) {
+    Api serial_request, concurrent_request;
+    for (auto* request : {&serial_request, &concurrent_request}) {
+      ParseApi(json, Options::sources_to_targets, *request);
+      loki_worker.matrix(*request);
+      thor_worker_t::adjust_locations(*request);
+    }
+
+    sif::mode_costing_t mode_costing;
+    mode_costing[0] = CreateSimpleCost(
+        serial_request.options().costings().find(serial_request.options().costing_type())->second);
+    set_hierarchy_limits(mode_costing[0]);
+
+    serial_matrix.SourceToTarget(serial_request, reader, mode_costing, sif::TravelMode::kDrive,
+                                 400000.0);
+    serial_matrix.Clear();
+    // twice to make sure the worker state is reset between requests
+    for (int run = 0; run < 2; ++run) {
+      concurrent_request.clear_matrix();
+      concurrent_matrix.SourceToTarget(concurrent_request, reader, mode_costing,
+                                       sif::TravelMode::kDrive, 400000.0);
+      concurrent_matrix.Clear();
+
+      const auto& expected = serial_request.matrix();
+      const auto& matrix = concurrent_request.matrix();
+      ASSERT_EQ(matrix.times().size(), expected.times().size());
+      for (int i = 0; i < matrix.times().size(); ++i) {
+        EXPECT_EQ(matrix.from_indices()[i], expected.from_indices()[i]);
+        EXPECT_EQ(matrix.to_indices()[i], expected.to_indices()[i]);
+        EXPECT_EQ(matrix.distances()[i], expected.distances()[i])
+            << "result " + std::to_string(i) + "'s distance differs from the serial TDMatrix";
+        EXPECT_EQ(matrix.times()[i], expected.times()[i])
+            << "result " + std::to_string(i) + "'s time differs from the serial TDMatrix";
+        EXPECT_EQ(matrix.date_times(i), expected.date_times(i));
+      }
+    }
+  }
+}
+
 TEST(Matrix, test_matrix_osrm) {
   loki_worker_t loki_worker(cfg);
 
@@ -2,6 +2,7 @@
 #include "midgard/logging.h"
 #include "odin/util.h"
 
+#include <boost/algorithm/string/replace.hpp>
 #include <gtest/gtest.h>
 
 #include <map>
@@ -1339,6 +1340,72 @@ TEST(NarrativeDictionary, test_en_US_approach_verbal_alert) {
   validate(us_customary_lengths, kExpectedUsCustomaryLengths);
 }
 
+TEST(NarrativeDictionary, test_phrase_templates_match_replace_all) {
+  // every tag we know of mapped to a value that is unique and cannot itself form a tag
+  const std::vector<std::pair<std::string, std::string>> values = {
+      {kCardinalDirectionTag, "north"},
+      {kRelativeDirectionTag, "left"},
+      {kOrdinalValueTag, "1st"},
+      {kStreetNamesTag, "Main Street"},
+      {kPreviousStreetNamesTag, "Old Road"},
+      {kBeginStreetNamesTag, "First Avenue"},
+      {kCrossStreetNamesTag, "Cross Way"},
+      {kRoundaboutExitStreetNamesTag, "Exit Street"},
+      {kRoundaboutExitBeginStreetNamesTag, "Exit Begin Street"},
+      {kRampExitNumbersVisualTag, "67B"},
+      {kObjectLabelTag, "gate"},
+      {kLengthTag, "1.5 kilometers"},
+      {kDestinationTag, "Home"},
+      {kCurrentVerbalCueTag, "Turn right."},
+      {kNextVerbalCueTag, "Turn left."},
+      {kNumberSignTag, "42"},
+      {kBranchSignTag, "I 95 North"},
+      {kTowardSignTag, "Baltimore"},
+      {kNameSignTag, "Gettysburg Pike"},
+      {kJunctionNameTag, "Big Junction"},
+      {kFerryLabelTag, "Ferry"},
+      {kTransitPlatformTag, "8 St - NYU"},
+      {kStationLabelTag, "Station"},
+      {kTimeTag, "8:06 AM"},
+      {kTransitNameTag, "R"},
+      {kTransitHeadSignTag, "Forest Hills"},
+      {kTransitPlatformCountTag, "7"},
+      {kTransitPlatformCountLabelTag, "stops"},
+      {kLevelTag, "2"},
+  };
+
+  std::vector<PhraseTemplate::TagValue> tag_values(values.begin(), values.end());
+
+  for (const auto& locale : get_locales()) {
+    const auto& dictionary = *locale.second;
+    for (const PhraseSet* phrase_set :
+         {static_cast<const PhraseSet*>(&dictionary.start_subset), &dictionary.start_verbal_subset,
+          &dictionary.destination_subset, &dictionary.continue_verbal_subset,
+          &dictionary.turn_subset, &dictionary.uturn_verbal_subset, &dictionary.exit_subset,
+          &dictionary.keep_to_stay_on_subset, &dictionary.enter_roundabout_subset,
+          &dictionary.transit_connection_start_subset, &dictionary.transit_subset,
+          &dictionary.post_transition_verbal_subset, &dictionary.verbal_multi_cue_subset,
+          &dictionary.level_change_subset}) {
+      ASSERT_EQ(phrase_set->phrases.size(), phrase_set->templates.size());
+      for (const auto& phrase : phrase_set->phrases) {
+        std::string expected = phrase.second;
+        for (const auto& value : values) {
+          boost::replace_all(expected, value.first, value.second);
+        }
+
+        std::string rendered;
+        const auto& phrase_template = phrase_set->templates.at(phrase.first);
+        phrase_template.Render(rendered, tag_values);
+        EXPECT_EQ(rendered, expected) << locale.first << " phrase " << phrase.first;
+
+        // tags without a value are left in place
+        phrase_template.Render(rendered, {});
+        EXPECT_EQ(rendered, phrase.second) << locale.first << " phrase " << phrase.first;
+      }
+    }
+  }
+}
+
 } // namespace
 
 int main(int argc, char* argv[]) {
@@ -1,8 +1,13 @@
+#include "thor/localsearch_optimizer.h"
 #include "thor/optimizer.h"
 
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <cmath>
 #include <cstdint>
+#include <numeric>
+#include <random>
 #include <vector>
 
 using namespace std;
@@ -19,20 +24,104 @@ void TryOptimizer(const uint32_t nlocs,
   EXPECT_EQ(order, expected_order);
 }
 
+const std::vector<float> kBasicCosts = {
+    0,    3036, 707,  956,  318,  1934, 355,  1170, 1286, 3171, 2133,
+    2978, 0,    2664, 3613, 3102, 2011, 3139, 3846, 1764, 2050, 1143,
+    638,  2638, 0,    1295, 763,  1536, 800,  1528, 888,  2773, 1735,
+    940,  3457, 1281, 0,    582,  2450, 630,  655,  1796, 3681, 2643,
+    357,  3037, 708,  637,  0,    1935, 47,   851,  1286, 3171, 2133,
+    1839, 2004, 1525, 2480, 1963, 0,    2000, 2713, 690,  2578, 1100,
+    387,  3066, 737,  715,  77,   1964, 0,    928,  1316, 3201, 2163,
+    1129, 3803, 1537, 682,  769,  2707, 819,  0,    2052, 3230, 2899,
+    1214, 1750, 900,  1849, 1338, 634,  1375, 2082, 0,    1907, 846,
+    3128, 2036, 2814, 3763, 3252, 2549, 3290, 3228, 1914, 0,    2010,
+    2068, 1133, 1754, 2704, 2193, 1102, 2230, 2937, 854,  2000, 0};
+
 TEST(Optimizer, Basic) {
-  std::vector<float> costs = {0,    3036, 707,  956,  318,  1934, 355,  1170, 1286, 3171, 2133,
-                              2978, 0,    2664, 3613, 3102, 2011, 3139, 3846, 1764, 2050, 1143,
-                              638,  2638, 0,    1295, 763,  1536, 800,  1528, 888,  2773, 1735,
-                              940,  3457, 1281, 0,    582,  2450, 630,  655,  1796, 3681, 2643,
-                              357,  3037, 708,  637,  0,    1935, 47,   851,  1286, 3171, 2133,
-                              1839, 2004, 1525, 2480, 1963, 0,    2000, 2713, 690,  2578, 1100,
-                              387,  3066, 737,  715,  77,   1964, 0,    928,  1316, 3201, 2163,
-                              1129, 3803, 1537, 682,  769,  2707, 819,  0,    2052, 3230, 2899,
-                              1214, 1750, 900,  1849, 1338, 634,  1375, 2082, 0,    1907, 846,
-                              3128, 2036, 2814, 3763, 3252, 2549, 3290, 3228, 1914, 0,    2010,
-                              2068, 1133, 1754, 2704, 2193, 1102, 2230, 2937, 854,  2000, 0};
   std::vector<uint32_t> expected_order = {0, 3, 7, 4, 6, 2, 8, 5, 9, 1, 10};
-  TryOptimizer(11, costs, expected_order);
+  TryOptimizer(11, kBasicCosts, expected_order);
+}
+
+LocalSearchOptimizer MakeLocalSearchOptimizer(uint32_t concurrency, uint32_t starts = 8) {
+  boost::property_tree::ptree config;
+  config.put("optimizer.concurrency", concurrency);
+  config.put("optimizer.starts", starts);
+  // big enough to never run out on the ci machines, the results only depend on the starts
+  config.put("optimizer.max_time", 60000);
+  return LocalSearchOptimizer(config);
+}
+
+// asymmetric costs of locations in a few clusters, like a day of deliveries around some towns
+std::vector<float> ClusteredCosts(const uint32_t count) {
+  std::mt19937 generator(42);
+  std::uniform_real_distribution<float> spread(-50.f, 50.f), town(0.f, 2000.f);
+  std::vector<std::pair<float, float>> towns(4), points(count);
+  for (auto& t : towns) {
+    t = {town(generator), town(generator)};
+  }
+  for (uint32_t i = 0; i < count; ++i) {
+    const auto& t = towns[i % towns.size()];
+    points[i] = {t.first + spread(generator), t.second + spread(generator)};
+  }
+  std::vector<float> costs(count * count);
+  for (uint32_t i = 0; i < count; ++i) {
+    for (uint32_t j = 0; j < count; ++j) {
+      float d = std::hypot(points[i].first - points[j].first, points[i].second - points[j].second);
+      costs[i * count + j] = i < j ? d : d * 1.2f;
+    }
+  }
+  return costs;
+}
+
+float TourCost(const uint32_t count,
+               const std::vector<float>& costs,
+               const std::vector<uint32_t>& tour) {
+  float cost = 0.f;
+  for (size_t i = 0; i + 1 < tour.size(); ++i) {
+    cost += costs[tour[i] * count + tour[i + 1]];
+  }
+  return cost;
+}
+
+TEST(LocalSearchOptimizer, Basic) {
+  std::vector<uint32_t> expected_order = {0, 3, 7, 4, 6, 2, 8, 5, 9, 1, 10};
+  for (uint32_t concurrency : {1, 4}) {
+    EXPECT_EQ(MakeLocalSearchOptimizer(concurrency).Solve(11, kBasicCosts), expected_order);
+  }
+}
+
+TEST(LocalSearchOptimizer, Trivial) {
+  LocalSearchOptimizer optimizer;
+  EXPECT_EQ(optimizer.Solve(2, {0, 1, 1, 0}), (std::vector<uint32_t>{0, 1}));
+  std::vector<float> costs = {0, 9, 1, 9, 9, 0, 9, 1, 9, 1, 0, 9, 9, 9, 9, 0};
+  EXPECT_EQ(optimizer.Solve(4, costs), (std::vector<uint32_t>{0, 2, 1, 3}));
+}
+
+TEST(LocalSearchOptimizer, Clustered) {
+  const uint32_t count = 60;
+  auto costs = ClusteredCosts(count);
+  auto serial = MakeLocalSearchOptimizer(1).Solve(count, costs);
+
+  // the ends stay put and every location is visited once
+  ASSERT_EQ(serial.size(), count);
+  EXPECT_EQ(serial.front(), 0);
+  EXPECT_EQ(serial.back(), count - 1);
+  auto sorted = serial;
+  std::sort(sorted.begin(), sorted.end());
+  std::vector<uint32_t> all(count);
+  std::iota(all.begin(), all.end(), 0);
+  EXPECT_EQ(sorted, all);
+
+  // the threads don't change the outcome
+  EXPECT_EQ(MakeLocalSearchOptimizer(4).Solve(count, costs), serial);
+
+  // more starts can only help and no start should do worse than the annealer by much
+  auto single = MakeLocalSearchOptimizer(1, 1).Solve(count, costs);
+  EXPECT_LE(TourCost(count, costs, serial), TourCost(count, costs, single));
+  Optimizer annealer;
+  annealer.Seed(111111);
+  auto annealed = annealer.Solve(count, costs);
+  EXPECT_LE(TourCost(count, costs, serial), TourCost(count, costs, annealed) * 1.05f);
 }
 
 } // namespace
@@ -0,0 +1,108 @@
+#include "mjolnir/packed_file.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+
+using namespace valhalla::mjolnir;
+
+namespace {
+
+struct osm_node {
+  uint64_t id;
+  float lng;
+  float lat;
+  uint32_t attributes;
+};
+
+const std::string file_name = "nodes.bin";
+const std::string packed_name = file_name + kPackedSuffix;
+
+std::string read_file() {
+  std::ifstream in(file_name, std::ios_base::binary);
+  return std::string((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+}
+
+// ids repeat like they do in the build, returns what was written
+std::string write_nodes(uint64_t count) {
+  {
+    std::ofstream file(file_name, std::ios_base::binary | std::ios_base::trunc);
+    for (uint64_t i = 0; i < count; ++i) {
+      osm_node node{i / 3 * 2, static_cast<float>(i), 0.f, static_cast<uint32_t>(i % 7)};
+      file.write(reinterpret_cast<const char*>(&node), sizeof(node));
+    }
+  }
+  return read_file();
+}
+
+class PackedFile : public testing::TestWithParam<Compression> {};
+
+TEST_P(PackedFile, RoundTrip) {
+  // spans several blocks with a partial one at the end
+  auto raw = write_nodes(3 * 1024 * 1024 / sizeof(osm_node) + 1234);
+
+  auto packed_size = pack(file_name, GetParam(), sizeof(osm_node));
+  EXPECT_FALSE(std::filesystem::exists(file_name)) << "The raw file should be replaced";
+  EXPECT_EQ(packed_size, std::filesystem::file_size(packed_name));
+  if (GetParam() != Compression::kNone) {
+    EXPECT_LT(packed_size, raw.size()) << "Repetitive records should compress";
+  }
+
+  unpack(file_name);
+  EXPECT_FALSE(std::filesystem::exists(packed_name)) << "The packed copy should be replaced";
+  EXPECT_TRUE(read_file() == raw) << "Unpacking didn't give back the original file";
+
+  // an empty file packs too
+  write_nodes(0);
+  pack(file_name, GetParam(), sizeof(osm_node));
+  unpack(file_name);
+  EXPECT_EQ(std::filesystem::file_size(file_name), 0);
+
+  std::remove(file_name.c_str());
+}
+
+TEST_P(PackedFile, Failures) {
+  // a partial record can't be packed and the file is left alone
+  auto raw = write_nodes(17);
+  {
+    std::ofstream partial(file_name, std::ios_base::binary | std::ios_base::app);
+    partial.put(0);
+  }
+  EXPECT_THROW(pack(file_name, GetParam(), sizeof(osm_node)), std::runtime_error);
+  EXPECT_EQ(std::filesystem::file_size(file_name), raw.size() + 1);
+  EXPECT_FALSE(std::filesystem::exists(packed_name));
+
+  // nothing to unpack
+  EXPECT_THROW(unpack(file_name), std::runtime_error);
+
+  // a truncated packed copy isn't unpacked and is left alone
+  write_nodes(1024);
+  auto packed_size = pack(file_name, GetParam(), sizeof(osm_node));
+  std::filesystem::resize_file(packed_name, packed_size - 1);
+  EXPECT_THROW(unpack(file_name), std::runtime_error);
+  EXPECT_FALSE(std::filesystem::exists(file_name));
+  EXPECT_EQ(std::filesystem::file_size(packed_name), packed_size - 1);
+
+  // something which isn't a packed file
+  { std::ofstream(packed_name, std::ios_base::binary | std::ios_base::trunc) << "not packed"; }
+  EXPECT_THROW(unpack(file_name), std::runtime_error);
+
+  for (const auto& name : {file_name, packed_name})
+    std::remove(name.c_str());
+}
+
+INSTANTIATE_TEST_SUITE_P(Compressions,
+                         PackedFile,
+                         testing::Values(Compression::kNone, Compression::kLz4, Compression::kZlib));
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
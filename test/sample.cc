@@ -165,6 +165,29 @@ TEST(Sample, edges) {
   EXPECT_EQ(v, skadi::get_no_data_value()) << "Wrong value at location";
 }
 
+TEST(Sample, get_all_matches_get) {
+  skadi::sample s("test/data/sample");
+
+  // a line that wanders in and out of the tile we have and into one we dont, more points than the
+  // batch width and not a multiple of it either so we exercise the partial batches as well
+  std::vector<std::pair<double, double>> postings;
+  for (size_t i = 0; i < 101; ++i) {
+    postings.emplace_back(-76.99 + i * .003, 40.1 + (i % 3 == 0 ? 1 : 0) + i * .007);
+  }
+  postings.emplace_back(-76.5, 40.0);
+  postings.emplace_back(-76.5, 40.999999);
+
+  auto heights = s.get_all(postings);
+  ASSERT_EQ(heights.size(), postings.size());
+  size_t no_data = 0;
+  for (size_t i = 0; i < postings.size(); ++i) {
+    EXPECT_NEAR(heights[i], s.get(postings[i]), 1e-9) << "Mismatch at posting " << i;
+    no_data += heights[i] == skadi::get_no_data_value();
+  }
+  EXPECT_GT(no_data, 0) << "Some postings should be outside of the tile we have";
+  EXPECT_LT(no_data, postings.size()) << "Some postings should be inside of the tile we have";
+}
+
 TEST(Sample, lazy_load) {
   // make sure there is no data there
   { std::ofstream file("test/data/sample/N00/N00E000.hgt", std::ios::binary | std::ios::trunc); }
@@ -55,6 +55,28 @@ TEST(Sequence, ReadWrite) {
   read_nodes(file_name, count);
 }
 
+TEST(Sequence, ExternalSort) {
+  // a budget of a few megabytes makes for many runs and several merge passes
+  const size_t count = 1024 * 1024;
+  for (size_t concurrency : {1, 3}) {
+    {
+      sequence<osm_node> sequence("external.nd", true);
+      for (uint64_t i = 0; i < count; ++i)
+        sequence.push_back({(i * 7919) % count, 0.f, 0.f, static_cast<uint32_t>(i)});
+    }
+    sequence<osm_node> sequence("external.nd", false);
+    sequence.external_sort([](const osm_node& a, const osm_node& b) { return a.id < b.id; },
+                           4 * 1024 * 1024, concurrency);
+    ASSERT_EQ(sequence.size(), count);
+    for (uint64_t i = 0; i < count; ++i) {
+      osm_node node = *sequence[i];
+      ASSERT_EQ(node.id, i) << "Found wrong node at: " + std::to_string(i);
+      // 315407 is the inverse of 7919 modulo count
+      ASSERT_EQ(node.attributes, (i * 315407) % count) << "Node " + std::to_string(i) + " changed";
+    }
+  }
+}
+
 TEST(Sequence, Iterator) {
   sequence<osm_node> sequence("nodes.nd", false, 512);
   auto i = sequence.begin();
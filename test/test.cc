@@ -11,7 +11,9 @@
 #include <boost/algorithm/string.hpp>
 #include <boost/property_tree/ptree.hpp>
 
+#include <algorithm>
 #include <cmath>
+#include <ctime>
 #include <filesystem>
 #include <fstream>
 #include <sstream>
@@ -652,6 +654,9 @@ void customize_live_traffic_data(const boost::property_tree::ptree& config,
             const_cast<valhalla::baldr::TrafficSpeed*>(tile.speeds + index);
         setter_cb(reader, tile, index, current);
       }
+      // like a real update does, so that whatever depends on the speeds notices
+      tile.header->last_update =
+          std::max<uint64_t>(tile.header->last_update + 1, std::time(nullptr));
       mtar_next(&tar);
     }
   }
@@ -190,6 +190,17 @@ uint32_t day_of_week_mask(const std::string& date_time);
 std::string
 get_duration(const std::string& date_time, const uint32_t seconds, const date::time_zone* tz);
 
+/**
+ * Get the local date_times from begin to end every step minutes. End is only included if it
+ * falls on a step.
+ * @param   begin   first date_time in the format of 2015-05-06T08:00
+ * @param   end     last date_time in the format of 2015-05-06T08:00
+ * @param   step    minutes between the date_times, must be positive
+ * @return  Returns the ISO formatted date_times
+ */
+std::vector<std::string>
+date_time_range(const std::string& begin, const std::string& end, const uint32_t step);
+
 /**
  * Checks if a date is restricted within a begin and end range.
  * @param   type          type of restriction kYMD or kNthDow
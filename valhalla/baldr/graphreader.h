@@ -361,10 +361,10 @@ class SynchronizedTileCache : public TileCache {
 public:
   /**
    * Constructor.
-   * @param cache reference to an external cache
+   * @param cache an external cache, kept alive as long as this wrapper is
    * @param mutex reference to an external mutex
    */
-  SynchronizedTileCache(TileCache& cache, std::mutex& mutex);
+  SynchronizedTileCache(std::shared_ptr<TileCache> cache, std::mutex& mutex);
   /**
    * Reserves enough cache to hold (max_cache_size / tile_size) items.
    * @param tile_size appeoximate size of one tile
@@ -411,7 +411,7 @@ public:
   void Trim() override;
 
 private:
-  TileCache& cache_;
+  std::shared_ptr<TileCache> cache_;
   std::mutex& mutex_ref_;
 };
 
@@ -424,9 +424,11 @@ class TileCacheFactory final {
 public:
   /**
    * Constructs tile cache.
-   * @param pt  Property tree listing the configuration for the cache configuration
+   * @param pt          Property tree listing the configuration for the cache configuration
+   * @param generation  The tileset generation the tiles come from. A global synchronized cache is
+   *                    only shared by the readers of the same generation
    */
-  static TileCache* createTileCache(const boost::property_tree::ptree& pt);
+  static TileCache* createTileCache(const boost::property_tree::ptree& pt, uint64_t generation = 0);
 };
 
 /**
@@ -468,6 +470,14 @@ public:
     return !tile_extract_->traffic_tiles.empty();
   }
 
+  /**
+   * Returns the most recent last_update of the live traffic tiles, 0 without live traffic. Things
+   * derived from the live speeds can compare this to find out they changed. It looks at the header
+   * of every traffic tile, which on a large extract are many scattered page reads, so it is meant
+   * to be called every so often rather than per request.
+   */
+  uint64_t TrafficVersion() const;
+
   /**
    * Get a pointer to a graph tile object given a GraphId.
    * @param graphid  the graphid of the tile
@@ -523,6 +533,51 @@ public:
     cache_->Trim();
   }
 
+  /**
+   * Asks every GraphReader in this process to map its tile and traffic extracts again. The readers
+   * pick this up in ReloadIfRequested. This only increments an atomic counter so it can be called
+   * from a signal handler.
+   */
+  static void RequestReload();
+
+  /**
+   * Reloads the tile and traffic extracts if a reload was requested since they were last loaded.
+   * Tiles handed out before the reload keep the previous mapping alive until they are released,
+   * so requests in flight keep using the old data. Call this between requests. It must not run
+   * while another thread is using this reader.
+   * @return true if a reload was requested, whether or not the new extracts could be used
+   */
+  bool ReloadIfRequested();
+
+  /**
+   * Maps the configured tile and traffic extracts again and moves on to a tile cache, shortcut
+   * recovery cache and incident tile set for them. Unless a reload was requested, this requests one
+   * so the other readers pick up the new extracts too. If an extract that is loaded now can't be
+   * loaded again, nothing changes and the current extracts are kept.
+   * @return true if the newly mapped extracts are in use
+   */
+  virtual bool Reload();
+
+  /**
+   * Returns the fraction of the tile extract's pages which the warm up configured in
+   * mjolnir.warm_up has brought into memory so far, 1 if there is nothing to warm up.
+   */
+  static float WarmUpProgress();
+
+  /**
+   * Returns whether mjolnir.warm_up.ready_fraction of the pages being warmed up are in memory,
+   * or whether the warm up has done all it can.
+   */
+  static bool WarmedUp();
+
+  /**
+   * Returns which reload request the current extracts were loaded for, 0 if none was requested.
+   * Things derived from the tiles can compare this to find out they need to be rebuilt.
+   */
+  uint64_t TileSetGeneration() const {
+    return tileset_generation_;
+  }
+
   /**
    * Returns the maximum number of threads that can
    * use the reader concurrently without blocking
@@ -1007,6 +1062,14 @@ protected:
   std::unique_ptr<TileCache> cache_;
 
   bool enable_incidents_;
+  bool shortcut_caching_;
+
+  // what we need to load the extracts and their cache again on Reload
+  const std::shared_ptr<const boost::property_tree::ptree> extract_config_;
+  const bool traffic_readonly_;
+  // the reload request the extracts were loaded for and the last one we acted on
+  uint64_t tileset_generation_;
+  uint64_t reload_checked_;
 
   /**
    * Loads the tile_dir/id.txt URL & MD5 hash and validates whether the URLs match
@@ -1034,5 +1097,29 @@ public:
 protected:
   GraphReader& reader_;
 };
+
+/**
+ * A reader for one of several threads working on the same request. It gets its tiles from a reader
+ * shared by all of them, guarded by a mutex, and keeps them in a cache of its own so that it rarely
+ * has to take the lock. Tiles are immutable so they can be used by all threads at once.
+ */
+class ConcurrentGraphReader : public GraphReader {
+public:
+  /**
+   * @param reader  the reader shared by the threads
+   * @param mutex   the mutex all the threads lock to use the shared reader
+   */
+  ConcurrentGraphReader(GraphReader& reader, std::mutex& mutex);
+
+  bool DoesTileExist(const GraphId& graphid) const override;
+
+  graph_tile_ptr GetGraphTile(const GraphId& graphid) override;
+
+  using GraphReader::GetGraphTile;
+
+protected:
+  GraphReader& reader_;
+  std::mutex& mutex_;
+};
 } // namespace baldr
 } // namespace valhalla
@@ -17,11 +17,13 @@
 #include <rapidjson/writer.h>
 
 #include <fstream>
+#include <functional>
 #include <istream>
 #include <locale>
 #include <stdexcept>
 #include <string>
 #include <type_traits>
+#include <utility>
 
 namespace {
 
@@ -276,18 +278,53 @@ inline Document read_json(const std::string& filename, const std::locale& loc =
  *
  * Rapidjson's write is pretty complete but its quite verbose for common operations like
  * adding a key value pair. Because of that we have a small wrapper here to make it less verbose
+ *
+ * For very large documents the writer can also be given a sink, in which case the serialized bytes
+ * are handed off to the sink in chunks whenever flush is called rather than accumulating the whole
+ * document in memory
  */
 class writer_wrapper_t {
+public:
+  using sink_t = std::function<void(const char*, size_t)>;
+
 protected:
   rapidjson::StringBuffer buffer;
   rapidjson::Writer<decltype(buffer)> writer;
+  sink_t sink;
+  size_t chunk_size;
 
 public:
-  writer_wrapper_t(size_t reservation = 0) : buffer(), writer(buffer) {
+  writer_wrapper_t(size_t reservation = 0) : buffer(), writer(buffer), chunk_size(0) {
     if (reservation != 0)
       buffer.Reserve(reservation);
   }
 
+  /**
+   * Constructs a writer which streams its output to the sink rather than keeping all of it
+   * @param sink        receives each chunk of serialized json in the order it was written
+   * @param chunk_size  how many bytes to accumulate before a call to flush hands them to the sink
+   */
+  writer_wrapper_t(sink_t sink, size_t chunk_size)
+      : buffer(), writer(buffer), sink(std::move(sink)), chunk_size(chunk_size) {
+    buffer.Reserve(chunk_size);
+  }
+
+  /**
+   * Hands the bytes written so far to the sink once there are at least chunk_size of them. This
+   * is a no-op without a sink so serializers can call it between rows either way
+   * @param force  hand off the bytes regardless of how many there are, ie at the end of a document
+   */
+  inline void flush(bool force = false) {
+    if (sink && buffer.GetSize() > 0 && (force || buffer.GetSize() >= chunk_size)) {
+      sink(buffer.GetString(), buffer.GetSize());
+      buffer.Clear();
+    }
+  }
+
+  inline bool streaming() const {
+    return static_cast<bool>(sink);
+  }
+
   inline void start_object() {
     writer.StartObject();
   }
@@ -38,6 +38,7 @@ public:
   void route(Api& request);
   void matrix(Api& request);
   void isochrones(Api& request);
+  void accessibility(Api& request);
   void trace(Api& request);
   std::string height(Api& request);
   std::string transit_available(Api& request);
@@ -45,6 +46,8 @@ public:
   std::string render_tile(Api& request);
 
   void set_interrupt(const std::function<void()>* interrupt) override;
+  // reloads the tile extracts if that was requested since the last request
+  void refresh_tileset();
 
   using ZoomConfig = std::array<uint32_t, static_cast<size_t>(baldr::RoadClass::kInvalid)>;
 
@@ -82,6 +85,9 @@ protected:
   std::unordered_map<std::string, float> max_matrix_distance;
   std::vector<std::pair<std::string, std::string>> mvt_headers;
   size_t max_timedep_dist_matrix;
+  size_t max_matrix_date_times;
+  size_t max_batch_isochrone_locations;
+  size_t max_accessibility_targets;
   std::unordered_map<std::string, float> max_matrix_locations;
   size_t max_exclude_locations;
   float max_exclude_polygons_length;
@@ -111,6 +117,8 @@ protected:
   float min_resample;
   unsigned int max_alternates;
   bool allow_verbose;
+  bool allow_reload;
+  uint64_t tileset_generation_;
   bool allow_hard_exclusions;
   float max_distance_disable_hierarchy_culling;
 
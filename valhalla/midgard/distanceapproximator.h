@@ -5,6 +5,7 @@
 #include <valhalla/midgard/constants.h>
 
 #include <cmath>
+#include <cstddef>
 
 namespace valhalla {
 namespace midgard {
@@ -78,6 +79,26 @@ public:
            sqr((ll.lng() - centerlng_) * m_per_lng_degree_);
   }
 
+  /**
+   * Approximates the squared arc distances of a batch of positions to the test point, the same
+   * as DistanceSquared does for each of them. The latitudes and longitudes are passed as separate
+   * arrays so that the loop vectorizes.
+   * @param   lats     Latitudes of the points (degrees)
+   * @param   lngs     Longitudes of the points (degrees)
+   * @param   count    Number of points
+   * @param   squares  Where the squared distance (in meters) of each point goes
+   */
+  template <typename T>
+  void DistanceSquared(const typename PointT::first_type* lats,
+                       const typename PointT::first_type* lngs,
+                       const size_t count,
+                       T* squares) const {
+    for (size_t i = 0; i < count; ++i) {
+      squares[i] = static_cast<T>(sqr((lats[i] - centerlat_) * kMetersPerDegreeLat) +
+                                  sqr((lngs[i] - centerlng_) * m_per_lng_degree_));
+    }
+  }
+
   /**
    * Approximates arc distance between 2 lat,lng positions using meters per
    * latitude and longitude degree.  Uses the mid latitude of the 2 positions
@@ -1,10 +1,12 @@
 #pragma once
 
 #include <algorithm>
+#include <atomic>
 #include <cerrno>
 #include <cmath>
 #include <cstdint>
 #include <cstring>
+#include <exception>
 #include <filesystem>
 #include <fstream>
 #include <functional>
@@ -13,6 +15,8 @@
 #include <queue>
 #include <stdexcept>
 #include <string>
+#include <thread>
+#include <type_traits>
 #include <utility>
 #include <vector>
 
@@ -386,6 +390,119 @@ public:
     return;
   }
 
+  // sort the file based on the predicate like sort() does, but within a memory budget and without
+  // random access through the memory map, which thrashes the page cache once the file is larger
+  // than the available memory. A budget of 0 falls back to sort().
+  //
+  // Strategy is to first sort runs of the file in place, reading and writing each run in one go,
+  // on concurrency threads which share the budget. Then the runs are merged via priority queue,
+  // as many at a time as the budget allows large sequential reads for, back and forth between
+  // this file and a temporary one until only a single run is left.
+  void external_sort(const std::function<bool(const T&, const T&)>& predicate,
+                     size_t memory_budget,
+                     size_t concurrency = 1) {
+    flush();
+    if (memory_budget == 0) {
+      sort(predicate);
+      return;
+    }
+    // if no elements we are done
+    const size_t count = memmap.size();
+    if (count == 0) {
+      return;
+    }
+
+    // everything below is counted in elements, we read at least a megabyte per run at a time
+    const size_t min_buffer = std::max(static_cast<size_t>(1), 1024 * 1024 / sizeof(T));
+    const size_t budget = std::max(memory_budget / sizeof(T), 4 * min_buffer);
+    concurrency = std::max(static_cast<size_t>(1), concurrency);
+    const size_t run_size = std::max(static_cast<size_t>(1), budget / concurrency);
+
+    // we read and write the file directly from here on
+    file.reset();
+    memmap.unmap();
+
+    // sort the runs in place, each thread takes the next unsorted run
+    std::atomic<size_t> next_run(0);
+    std::vector<std::exception_ptr> errors(concurrency);
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < concurrency; ++i) {
+      threads.emplace_back([&, i]() {
+        try {
+          std::fstream io(file_name,
+                          std::ios_base::binary | std::ios_base::in | std::ios_base::out);
+          buffer_t run(std::min(run_size, count));
+          for (size_t begin; (begin = next_run.fetch_add(run_size)) < count;) {
+            const size_t size = std::min(run_size, count - begin);
+            read(io, begin, data(run), size);
+            std::sort(data(run), data(run) + size, predicate);
+            io.seekp(begin * sizeof(T));
+            io.write(reinterpret_cast<const char*>(data(run)), size * sizeof(T));
+          }
+          io.flush();
+          if (!io) {
+            throw std::runtime_error("sequence: " + file_name + ": failed to write sorted runs");
+          }
+        } catch (...) {
+          errors[i] = std::current_exception();
+        }
+      });
+    }
+    for (auto& thread : threads) {
+      thread.join();
+    }
+    for (const auto& error : errors) {
+      if (error) {
+        std::rethrow_exception(error);
+      }
+    }
+
+    // where each run begins, plus the end of the last one
+    std::vector<size_t> bounds;
+    for (size_t begin = 0; begin < count; begin += run_size) {
+      bounds.push_back(begin);
+    }
+    bounds.push_back(count);
+
+    // merge groups of runs into longer runs, until only one is left
+    const size_t fan_in = std::max(static_cast<size_t>(2), budget / min_buffer - 1);
+    auto tmp_path = std::filesystem::path(file_name).replace_filename(
+        std::filesystem::path(file_name).filename().string() + ".tmp");
+    std::string src = file_name, dst = tmp_path.string();
+    while (bounds.size() > 2) {
+      std::vector<size_t> merged;
+      {
+        std::ifstream in(src, std::ios_base::binary);
+        std::ofstream out(dst, std::ios_base::binary | std::ios_base::trunc);
+        for (size_t first = 0; first + 1 < bounds.size(); first += fan_in) {
+          const size_t last = std::min(first + fan_in, bounds.size() - 1);
+          merge(in, out, bounds, first, last, budget, predicate);
+          merged.push_back(bounds[first]);
+        }
+        out.flush();
+        if (!in || !out) {
+          throw std::runtime_error("sequence: " + file_name + ": failed to merge sorted runs");
+        }
+      }
+      merged.push_back(count);
+      bounds = std::move(merged);
+      std::swap(src, dst);
+    }
+
+    // Move the sorted result back into place
+    if (src != file_name) {
+      std::filesystem::remove(file_name);
+      std::filesystem::rename(src, file_name);
+    } else {
+      std::filesystem::remove(tmp_path);
+    }
+
+    // Reload the sequence
+    sequence<T> reloaded(file_name, false);
+    std::swap(file, reloaded.file);
+    std::swap(memmap, reloaded.memmap);
+  }
+
   // perform an volatile operation on all the items of this sequence
   void transform(const std::function<void(T&)>& predicate) {
     flush();
@@ -582,6 +699,80 @@ public:
 protected:
   std::shared_ptr<std::fstream> file;
   std::string file_name;
+  // uninitialized storage for the external sort, T needn't be default constructible
+  using buffer_t = std::vector<typename std::aligned_storage<sizeof(T), alignof(T)>::type>;
+  static T* data(buffer_t& buffer) {
+    return reinterpret_cast<T*>(buffer.data());
+  }
+
+  // reads count elements starting at element offset from the stream
+  static void read(std::istream& in, size_t offset, T* elements, size_t count) {
+    in.seekg(offset * sizeof(T));
+    in.read(reinterpret_cast<char*>(elements), count * sizeof(T));
+  }
+
+  // merges the sorted runs [first, last) of in into a single sorted run in out at the same place
+  static void merge(std::istream& in,
+                    std::ostream& out,
+                    const std::vector<size_t>& bounds,
+                    size_t first,
+                    size_t last,
+                    size_t budget,
+                    const std::function<bool(const T&, const T&)>& predicate) {
+    // one buffer per run and one for the output share the budget
+    const size_t buffer_size = std::max(static_cast<size_t>(1), budget / (last - first + 1));
+    struct run_t {
+      buffer_t buffer;
+      size_t next; // the next element of the run to read from the file
+      size_t end;  // the end of the run in the file
+      size_t pos;  // the current element in the buffer
+      size_t size; // the number of elements in the buffer
+    };
+    std::vector<run_t> runs;
+    runs.reserve(last - first);
+    for (size_t i = first; i < last; ++i) {
+      runs.push_back({buffer_t(std::min(buffer_size, bounds[i + 1] - bounds[i])), bounds[i],
+                      bounds[i + 1], 0, 0});
+    }
+    auto refill = [&in](run_t& run) {
+      run.pos = 0;
+      run.size = std::min(run.buffer.size(), run.end - run.next);
+      read(in, run.next, data(run.buffer), run.size);
+      run.next += run.size;
+      return run.size != 0;
+    };
+
+    // Comparator needs to be inverted for pq to provide constant time *smallest* lookup
+    auto cmp = [&runs, &predicate](size_t a, size_t b) {
+      return predicate(data(runs[b].buffer)[runs[b].pos], data(runs[a].buffer)[runs[a].pos]);
+    };
+    std::priority_queue<size_t, std::vector<size_t>, decltype(cmp)> pq(cmp);
+    for (size_t i = 0; i < runs.size(); ++i) {
+      if (refill(runs[i])) {
+        pq.push(i);
+      }
+    }
+
+    // Perform the merge
+    out.seekp(bounds[first] * sizeof(T));
+    buffer_t output(buffer_size);
+    size_t written = 0;
+    while (!pq.empty()) {
+      auto i = pq.top();
+      pq.pop();
+      auto& run = runs[i];
+      data(output)[written++] = data(run.buffer)[run.pos++];
+      if (written == output.size()) {
+        out.write(reinterpret_cast<const char*>(data(output)), written * sizeof(T));
+        written = 0;
+      }
+      if (run.pos < run.size || refill(run)) {
+        pq.push(i);
+      }
+    }
+    out.write(reinterpret_cast<const char*>(data(output)), written * sizeof(T));
+  }
+
   std::vector<T> write_buffer;
   mem_map<T> memmap;
 };
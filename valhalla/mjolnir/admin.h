@@ -8,6 +8,7 @@
 
 #include <cstdint>
 #include <unordered_map>
+#include <vector>
 
 struct GEOSContextHandle_HS;
 struct GEOSGeom_t;
@@ -54,6 +55,58 @@ struct Geometry {
 
 typedef std::vector<std::tuple<Geometry, std::vector<std::string>, bool>> language_poly_index;
 
+/**
+ * Answers which of a tile's polygons intersect a point without testing every polygon. It is a
+ * quadtree over the tile which remembers, per cell, which polygons cover the whole cell and which
+ * only cross it. Points are then only tested against the polygons crossing their cell, so nodes in
+ * parts of the tile that are entirely inside or outside of every polygon need no point in polygon
+ * test at all. Cells are refined lazily, once enough points fell into them, so that tiles with few
+ * nodes don't pay for classifying the polygons against cells no node is in.
+ */
+class PolygonIndex {
+public:
+  /**
+   * Indexes polygons keyed by admin or timezone index
+   * @param  polys  the polygons, which must outlive the index
+   * @param  bbox   the bounds of the tile
+   */
+  PolygonIndex(const std::multimap<uint32_t, Geometry>& polys,
+               const midgard::AABB2<midgard::PointLL>& bbox);
+
+  /**
+   * Indexes language polygons keyed by their position
+   * @param  polys  the polygons, which must outlive the index
+   * @param  bbox   the bounds of the tile
+   */
+  PolygonIndex(const language_poly_index& polys, const midgard::AABB2<midgard::PointLL>& bbox);
+
+  /**
+   * Get the keys of the polygons which intersect the point, in the order the polygons were given.
+   * The returned vector is only valid until the next call.
+   * @param  ll  point that needs to be checked.
+   */
+  const std::vector<uint32_t>& intersecting(const midgard::PointLL& ll);
+
+private:
+  struct cell_t {
+    midgard::AABB2<midgard::PointLL> bbox;
+    std::vector<uint32_t> covering; // positions of the polygons covering the whole cell
+    std::vector<uint32_t> crossing; // positions of the polygons crossing the cell
+    uint32_t children;              // index of the first of the 4 sub cells, 0 for a leaf
+    uint32_t depth;
+    uint32_t lookups;
+  };
+
+  void init(const midgard::AABB2<midgard::PointLL>& bbox);
+  void split(uint32_t cell);
+
+  std::vector<std::pair<uint32_t, const Geometry*>> polys_;
+  std::vector<midgard::AABB2<midgard::PointLL>> envelopes_;
+  std::vector<cell_t> cells_;
+  std::vector<uint32_t> positions_;
+  std::vector<uint32_t> keys_;
+};
+
 class AdminDB {
   Sqlite3 db;
   geos_context_type geos_context;
@@ -115,6 +168,23 @@ uint32_t GetMultiPolyId(const std::multimap<uint32_t, Geometry>& polys,
  */
 uint32_t GetMultiPolyId(const std::multimap<uint32_t, Geometry>& polys, const midgard::PointLL& ll);
 
+/**
+ * Get the polygon index like above, but only test the polygons which the index can't rule in or out
+ * for the pointLL.
+ * @param  index      index over the admin polys of the tile.
+ * @param  ll         point that needs to be checked.
+ * @param  graphtile  graphtilebuilder that is used to determine if we are a country poly or not.
+ */
+uint32_t GetMultiPolyId(PolygonIndex& index, const midgard::PointLL& ll, GraphTileBuilder& graphtile);
+
+/**
+ * Get the polygon index like above, but only test the polygons which the index can't rule in or out
+ * for the pointLL.
+ * @param  index      index over the tz polys of the tile.
+ * @param  ll         point that needs to be checked.
+ */
+uint32_t GetMultiPolyId(PolygonIndex& index, const midgard::PointLL& ll);
+
 /**
  * Get the vector of languages for this LL.  Used by admin areas.  Checks if the pointLL is covered_by
  * the poly.
@@ -125,6 +195,18 @@ uint32_t GetMultiPolyId(const std::multimap<uint32_t, Geometry>& polys, const mi
 std::vector<std::pair<std::string, bool>>
 GetMultiPolyIndexes(const language_poly_index& language_ploys, const midgard::PointLL& ll);
 
+/**
+ * Get the vector of languages for this LL like above, but only test the polygons which the index
+ * can't rule in or out for the pointLL.
+ * @param  language_polys  tuple that contains a language, poly, is_default_language.
+ * @param  index           index over the language_polys.
+ * @param  ll              point that needs to be checked.
+ * @return  Returns the vector of pairs {language, is_default_language}
+ */
+std::vector<std::pair<std::string, bool>> GetMultiPolyIndexes(const language_poly_index& language_polys,
+                                                              PolygonIndex& index,
+                                                              const midgard::PointLL& ll);
+
 /**
  * Get the timezone polys from the db
  * @param  db           sqlite3 db handle
@@ -0,0 +1,56 @@
+#ifndef VALHALLA_MJOLNIR_EXTRACTBUILDER_H
+#define VALHALLA_MJOLNIR_EXTRACTBUILDER_H
+
+#include <valhalla/baldr/graphid.h>
+#include <valhalla/midgard/aabb2.h>
+#include <valhalla/midgard/pointll.h>
+
+#include <boost/property_tree/ptree_fwd.hpp>
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace valhalla {
+namespace mjolnir {
+
+// Tile data in the extracts built here starts on a multiple of this many bytes
+constexpr uint32_t kExtractPageSize = 4096;
+
+/**
+ * Class used to pack the graph tiles of a tile directory into a tar extract that the GraphReader
+ * can memory map. The extract starts with an index.bin so that loading it doesn't have to scan
+ * the archive. The tiles of each level follow the Hilbert curve through the level's tiling, so
+ * tiles which are close together on the map are close together in the file. Each tile's data is
+ * also aligned to a page, which helps readahead and the page cache.
+ */
+class ExtractBuilder {
+public:
+  /**
+   * Packs the tiles in mjolnir.tile_dir into the tar at mjolnir.tile_extract. The tiles are
+   * copied into the extract on mjolnir.concurrency threads.
+   * @param pt            the mjolnir configuration
+   * @param extract       where to write the tile extract, defaults to mjolnir.tile_extract
+   * @param with_traffic  whether to also write an empty traffic extract next to it, at
+   *                      mjolnir.traffic_extract or traffic.tar in the same directory
+   * @param bbox          optionally only pack the tiles intersecting this bounding box
+   * @return the number of tiles that were packed
+   */
+  static size_t Build(const boost::property_tree::ptree& pt,
+                      const std::string& extract = "",
+                      bool with_traffic = false,
+                      const std::optional<midgard::AABB2<midgard::PointLL>>& bbox = {});
+
+  /**
+   * Sorts tile ids into the order they are written to an extract. Levels are kept together in
+   * ascending order and the tiles of each level are ordered along a Hilbert curve.
+   * @param tile_ids  the tile ids to sort
+   */
+  static void SortTiles(std::vector<baldr::GraphId>& tile_ids);
+};
+
+} // namespace mjolnir
+} // namespace valhalla
+
+#endif // VALHALLA_MJOLNIR_EXTRACTBUILDER_H
@@ -2,8 +2,8 @@
 #define VALHALLA_MJOLNIR_LUA_H
 
 #include <valhalla/mjolnir/osmdata.h>
+#include <valhalla/mjolnir/tagtransform.h>
 
-#include <ankerl/unordered_dense.h>
 #include <osmium/osm/tag.hpp>
 
 #include <string>
@@ -13,11 +13,9 @@ struct lua_State;
 namespace valhalla {
 namespace mjolnir {
 
-using Tags = ankerl::unordered_dense::map<std::string, std::string>;
-
 /**
  */
-class LuaTagTransform {
+class LuaTagTransform : public TagTransform {
 public:
   /**
    * Constructor
@@ -30,9 +28,9 @@ public:
   LuaTagTransform(LuaTagTransform&&) = delete;
   LuaTagTransform& operator=(LuaTagTransform&&) = delete;
 
-  ~LuaTagTransform();
+  ~LuaTagTransform() override;
 
-  Tags Transform(OSMType type, uint64_t osmid, const osmium::TagList& tags);
+  Tags Transform(OSMType type, uint64_t osmid, const osmium::TagList& tags) override;
 
 protected:
   lua_State* state_;
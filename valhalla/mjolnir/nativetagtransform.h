@@ -0,0 +1,27 @@
+#ifndef VALHALLA_MJOLNIR_NATIVETAGTRANSFORM_H
+#define VALHALLA_MJOLNIR_NATIVETAGTRANSFORM_H
+
+#include <valhalla/mjolnir/osmdata.h>
+#include <valhalla/mjolnir/tagtransform.h>
+
+#include <osmium/osm/tag.hpp>
+
+#include <cstdint>
+
+namespace valhalla {
+namespace mjolnir {
+
+/**
+ * A C++ implementation of the stock lua/graph.lua. It produces the same tags as running the script
+ * through LuaTagTransform, without the cost of marshalling every tag in and out of lua. Any change
+ * to lua/graph.lua has to be made here as well.
+ */
+class NativeTagTransform : public TagTransform {
+public:
+  Tags Transform(OSMType type, uint64_t osmid, const osmium::TagList& tags) override;
+};
+
+} // namespace mjolnir
+} // namespace valhalla
+
+#endif // VALHALLA_MJOLNIR_NATIVETAGTRANSFORM_H
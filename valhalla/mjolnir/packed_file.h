@@ -0,0 +1,47 @@
+#ifndef VALHALLA_MJOLNIR_PACKED_FILE_H_
+#define VALHALLA_MJOLNIR_PACKED_FILE_H_
+
+#include <cstdint>
+#include <string>
+
+namespace valhalla {
+namespace mjolnir {
+
+// How the blocks of a packed file are compressed
+enum class Compression : uint8_t { kNone = 0, kLz4 = 1, kZlib = 2 };
+
+// Suffix of the packed copies of the intermediate files
+constexpr char kPackedSuffix[] = ".packed";
+
+/**
+ * Parses the name of a compression: none, lz4 or zlib. Falls back to zlib if lz4 support isn't
+ * compiled in.
+ * @param  name  the name of the compression
+ * @return the compression
+ * @throws std::runtime_error if the name is unknown
+ */
+Compression compression_from_string(const std::string& name);
+
+/**
+ * Replaces an intermediate file of the graph build, while no stage needs it, by a compressed copy
+ * named with kPackedSuffix. The copy is written in independently compressed blocks of whole
+ * records, each block is kept raw if compressing doesn't make it smaller.
+ * @param  file_name    the file to pack
+ * @param  compression  how to compress it
+ * @param  record_size  the size of the records in the file, its size has to be a multiple of it
+ * @return the size of the packed copy
+ * @throws std::runtime_error if the file can't be read or the packed copy can't be written
+ */
+uint64_t pack(const std::string& file_name, Compression compression, uint32_t record_size = 1);
+
+/**
+ * Replaces the packed copy of an intermediate file by the file itself, before a stage reads it
+ * @param  file_name  the file to unpack, not the packed copy
+ * @throws std::runtime_error if the packed copy is missing, truncated or corrupt
+ */
+void unpack(const std::string& file_name);
+
+} // namespace mjolnir
+} // namespace valhalla
+
+#endif // VALHALLA_MJOLNIR_PACKED_FILE_H_
@@ -0,0 +1,48 @@
+#ifndef VALHALLA_MJOLNIR_TAGTRANSFORM_H
+#define VALHALLA_MJOLNIR_TAGTRANSFORM_H
+
+#include <valhalla/mjolnir/osmdata.h>
+
+#include <ankerl/unordered_dense.h>
+#include <osmium/osm/tag.hpp>
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+namespace valhalla {
+namespace mjolnir {
+
+using Tags = ankerl::unordered_dense::map<std::string, std::string>;
+
+/**
+ * Turns the tags of an OSM object into the normalized tags the graph parser understands. An empty
+ * result means the object is of no interest for routing. Implementations are not thread safe, use
+ * one per thread.
+ */
+class TagTransform {
+public:
+  virtual ~TagTransform() = default;
+
+  /**
+   * Transforms the tags of an OSM object
+   * @param type   whether its a node, a way or a relation
+   * @param osmid  the id of the object, only used for logging
+   * @param tags   the tags of the object
+   * @return the transformed tags, empty if the object should be filtered
+   */
+  virtual Tags Transform(OSMType type, uint64_t osmid, const osmium::TagList& tags) = 0;
+
+  /**
+   * Creates the transform for the graph parser. When no lua script is given the built in rules of
+   * lua/graph.lua are applied natively, otherwise the script is run in lua.
+   * @param lua  the lua script or empty to use the native transform
+   * @return the transform
+   */
+  static std::unique_ptr<TagTransform> Create(const std::string& lua);
+};
+
+} // namespace mjolnir
+} // namespace valhalla
+
+#endif // VALHALLA_MJOLNIR_TAGTRANSFORM_H
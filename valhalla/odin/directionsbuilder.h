@@ -24,12 +24,33 @@ public:
    * calls PopulateDirectionsLeg to transform the maneuver list into the
    * trip directions.
    *
-   * @param api   the protobuf object containing the request, the path and a place
-   *              to store the resulting directions
+   * The legs of all routes are independent of one another so they can be built
+   * concurrently. The resulting directions are always in the same order as the
+   * trip legs regardless of the number of threads used.
+   *
+   * @param api              the protobuf object containing the request, the path and a
+   *                         place to store the resulting directions
+   * @param markup_formatter the formatter used for phoneme markup in the narrative
+   * @param concurrency      the maximum number of threads (including the calling one)
+   *                         to use to build the directions of the legs
    */
-  static void Build(Api& api, const MarkupFormatter& markup_formatter);
+  static void
+  Build(Api& api, const MarkupFormatter& markup_formatter, unsigned int concurrency = 1);
 
 protected:
+  /**
+   * Builds the maneuvers, narrative and directions for a single trip leg.
+   *
+   * @param options          the request options
+   * @param markup_formatter the formatter used for phoneme markup in the narrative
+   * @param trip_path        the trip leg to build directions for
+   * @param trip_directions  the directions leg to populate
+   */
+  static void BuildLeg(const Options& options,
+                       const MarkupFormatter& markup_formatter,
+                       TripLeg& trip_path,
+                       DirectionsLeg& trip_directions);
+
   /**
    * Update the heading of ~0 length edges.
    *
@@ -1,6 +1,8 @@
 #ifndef VALHALLA_ODIN_NARRATIVE_DICTIONARY_H_
 #define VALHALLA_ODIN_NARRATIVE_DICTIONARY_H_
 
+#include <valhalla/odin/phrase_template.h>
+
 #include <boost/property_tree/ptree_fwd.hpp>
 
 #include <locale>
@@ -178,6 +180,8 @@ namespace odin {
 
 struct PhraseSet {
   std::unordered_map<std::string, std::string> phrases;
+  // the same phrases compiled once per locale for rendering instructions
+  std::unordered_map<std::string, PhraseTemplate> templates;
 };
 
 struct StartSubset : PhraseSet {
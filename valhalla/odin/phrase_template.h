@@ -0,0 +1,78 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace valhalla {
+namespace odin {
+
+/**
+ * A narrative phrase parsed once into a list of literal text and tag tokens so that forming an
+ * instruction is a single pass over the phrase rather than one search and replace per tag.
+ *
+ * For example "Turn <RELATIVE_DIRECTION> onto <STREET_NAMES>." is compiled into the tokens
+ * "Turn ", <RELATIVE_DIRECTION>, " onto ", <STREET_NAMES> and ".".
+ */
+class PhraseTemplate {
+public:
+  using TagValue = std::pair<std::string_view, std::string_view>;
+
+  PhraseTemplate() = default;
+
+  /**
+   * Constructor.
+   * @param  phrase  the localized phrase containing tags such as <STREET_NAMES>.
+   */
+  explicit PhraseTemplate(std::string phrase);
+
+  /**
+   * Renders the phrase into the supplied output string, replacing each tag with its value. Any
+   * tag without a value is copied through verbatim, which is what a search and replace would do.
+   * The output is cleared first but keeps its capacity so the caller can reuse the buffer.
+   *
+   * @param  output  the string to render the phrase into.
+   * @param  values  the tags (including their angle brackets) and the values that replace them.
+   */
+  void Render(std::string& output, std::initializer_list<TagValue> values) const {
+    Render(output, values.begin(), values.end());
+  }
+
+  /**
+   * Renders the phrase into the supplied output string, replacing each tag with its value.
+   * @param  output  the string to render the phrase into.
+   * @param  values  the tags (including their angle brackets) and the values that replace them.
+   */
+  void Render(std::string& output, const std::vector<TagValue>& values) const {
+    Render(output, values.data(), values.data() + values.size());
+  }
+
+  /**
+   * Returns the phrase this template was compiled from.
+   * @return the phrase this template was compiled from.
+   */
+  const std::string& phrase() const {
+    return phrase_;
+  }
+
+protected:
+  void Render(std::string& output, const TagValue* values_begin, const TagValue* values_end) const;
+
+  struct Token {
+    // offset and length of the token within phrase_
+    uint32_t offset;
+    uint32_t length;
+    // whether the token is a tag or literal text
+    bool tag;
+  };
+
+  std::string phrase_;
+  std::vector<Token> tokens_;
+};
+
+} // namespace odin
+} // namespace valhalla
@@ -33,6 +33,8 @@ public:
 
 protected:
   MarkupFormatter markup_formatter_;
+  // how many threads may be used to build the directions of a single request
+  unsigned int concurrency_;
 
 private:
   std::string service_name() const override {
@@ -0,0 +1,108 @@
+#ifndef VALHALLA_THOR_ACCESSIBILITY_H_
+#define VALHALLA_THOR_ACCESSIBILITY_H_
+
+#include <valhalla/baldr/graphreader.h>
+#include <valhalla/proto/api.pb.h>
+#include <valhalla/sif/dynamiccost.h>
+#include <valhalla/sif/edgelabel.h>
+#include <valhalla/thor/dijkstras.h>
+
+#include <cstdint>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace valhalla {
+namespace thor {
+
+/**
+ * Algorithm to score what can be reached from a location within each contour: how long and how
+ * many the edges are, how many of them there are per road class and how many of a set of target
+ * points lie on them. It expands the same tree as an isochrone but only sums up the edges as they
+ * are settled, there is no grid to mark or contours to trace.
+ */
+class Accessibility : public Dijkstras {
+public:
+  /**
+   * Constructor.
+   * @param config A config object of key, value pairs
+   */
+  explicit Accessibility(const boost::property_tree::ptree& config = {});
+
+  /**
+   * Destructor
+   */
+  virtual ~Accessibility() {
+  }
+
+  /**
+   * Sets the points which are counted when they are reached. They stay set for every expansion
+   * until they are set again.
+   *
+   * @param targets  the targets correlated to the graph
+   */
+  void SetTargets(const google::protobuf::RepeatedPtrField<valhalla::Location>& targets);
+
+  /**
+   * Scores what can be reached from the locations of the request within each of its contours.
+   * Multiple locations are the origins of a single expansion, as for an isochrone.
+   *
+   * @param expansion_type  Which type of expansion to do, forward/reverse/mulitmodal
+   * @param api             The request containing the locations to seed the expansion
+   * @param reader          Graph reader to provide access to graph primitives
+   * @param costings        Per mode costing objects
+   * @param mode            The mode specifying which costing to use
+   * @param origin          The scores of the time and distance of each contour of the request
+   */
+  void Expand(const ExpansionType& expansion_type,
+              valhalla::Api& api,
+              baldr::GraphReader& reader,
+              const sif::mode_costing_t& costings,
+              const sif::TravelMode mode,
+              valhalla::Accessibility::Origin& origin);
+
+protected:
+  // when we expand up to a node we add the edge that ends at the node to the scores
+  virtual void ExpandingNode(baldr::GraphReader& graphreader,
+                             baldr::graph_tile_ptr tile,
+                             const baldr::NodeInfo* node,
+                             const sif::EdgeLabel& current,
+                             const sif::EdgeLabel* previous) override;
+
+  // when the main loop is looking to continue expanding we tell it to terminate here
+  virtual ExpansionRecommendation ShouldExpand(baldr::GraphReader& graphreader,
+                                               const sif::EdgeLabel& pred,
+                                               const ExpansionType route_type) override;
+
+  // tell the expansion how many labels to expect and how many buckets to use
+  virtual void GetExpansionHints(uint32_t& bucket_count,
+                                 uint32_t& edge_label_reservation) const override;
+
+  // a contour is a limit in either seconds or meters
+  struct contour_t {
+    bool time;
+    float limit;
+  };
+
+  // what has been reached within a contour so far
+  struct score_t {
+    double length;
+    uint32_t edges;
+    std::vector<uint32_t> road_class_edges;
+    uint32_t targets;
+  };
+
+  float max_seconds_;
+  float max_meters_;
+  std::vector<contour_t> contours_;
+  std::vector<score_t> scores_;
+  // the targets on each directed edge as the index of the target and its percent along the edge
+  std::unordered_multimap<uint64_t, std::pair<uint32_t, float>> target_edges_;
+  // the fewest seconds and meters it took to reach each target
+  std::vector<std::pair<float, float>> target_reached_;
+};
+
+} // namespace thor
+} // namespace valhalla
+
+#endif // VALHALLA_THOR_ACCESSIBILITY_H_
@@ -2,6 +2,8 @@
 
 #include <valhalla/thor/bidirectional_astar.h>
 
+#include <cstdint>
+#include <utility>
 #include <vector>
 
 namespace valhalla {
@@ -13,7 +15,16 @@ void filter_alternates_by_stretch(std::vector<CandidateConnection>& connections)
 bool validate_alternate_by_stretch(const std::vector<PathInfo>& optimal_path,
                                    const std::vector<PathInfo>& candidate_path);
 
-bool validate_alternate_by_sharing(std::vector<std::unordered_set<baldr::GraphId>>& shared_edgeids,
+// Scratch space for validate_alternate_by_sharing that lives as long as the paths of one request.
+// The edges of each accepted path are kept sorted and free of duplicates so that a candidate is
+// compared against them by a single merge instead of hashing each of its edges once per path
+struct SharedEdges {
+  std::vector<std::vector<baldr::GraphId>> paths;
+  std::vector<std::pair<baldr::GraphId, uint32_t>> candidate;
+  std::vector<bool> hits;
+};
+
+bool validate_alternate_by_sharing(SharedEdges& shared_edges,
                                    const std::vector<std::vector<PathInfo>>& paths,
                                    const std::vector<PathInfo>& candidate_path,
                                    float at_most_shared);
@@ -1,9 +1,14 @@
 #ifndef VALHALLA_THOR_ASTARHEURISTIC_H_
 #define VALHALLA_THOR_ASTARHEURISTIC_H_
 
+#include <valhalla/baldr/graphtile.h>
 #include <valhalla/midgard/distanceapproximator.h>
 #include <valhalla/midgard/pointll.h>
 
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
 namespace valhalla {
 namespace thor {
 
@@ -76,12 +81,101 @@ public:
     return dist * costfactor_;
   }
 
+  /**
+   * Get the distances of a batch of positions to the destination, the same as GetDistance does
+   * for each of them but in loops that vectorize.
+   * @param  lats       Latitudes of the positions.
+   * @param  lngs       Longitudes of the positions.
+   * @param  count      Number of positions.
+   * @param  distances  Where the distance (meters) of each position goes.
+   */
+  void GetDistances(const double* lats,
+                    const double* lngs,
+                    const size_t count,
+                    float* distances) const {
+    distapprox_.DistanceSquared(lats, lngs, count, distances);
+    // a loop of its own, sqrtf only vectorizes without math errno but the squares always do
+    for (size_t i = 0; i < count; ++i) {
+      distances[i] = sqrtf(distances[i]);
+    }
+  }
+
 private:
   midgard::DistanceApproximator<midgard::PointLL> distapprox_; // Distance approximation
   float costfactor_; // Cost factor - ensures the cost estimate
                      // underestimates the true cost.
 };
 
+/**
+ * The distances of the end nodes of a node's outbound edges to the destinations of the A*
+ * heuristics. They are gathered before the edges are expanded so that the distances of all of
+ * them are computed in one go instead of one edge at a time in between costing the edges. Only the
+ * end nodes in the node's own tile are gathered, the others are left to AStarHeuristic::Get.
+ */
+class HeuristicBatch {
+public:
+  HeuristicBatch() : first_edge_(0), count_(0), lats_{}, lngs_{}, distances_{} {
+  }
+
+  /**
+   * Gathers the positions of the end nodes of a node's outbound edges
+   * @param  node      the node
+   * @param  tile      the tile of the node
+   * @param  nodeinfo  the node's info
+   */
+  void Gather(const baldr::GraphId& node,
+              const baldr::graph_tile_ptr& tile,
+              const baldr::NodeInfo* nodeinfo) {
+    tile_ = node.tile_base();
+    first_edge_ = nodeinfo->edge_index();
+    count_ = nodeinfo->edge_count();
+    const auto* edge = tile->directededge(first_edge_);
+    for (uint32_t i = 0; i < count_; ++i, ++edge) {
+      if (!edge->leaves_tile()) {
+        const auto ll = tile->get_node_ll(edge->endnode());
+        lats_[i] = ll.lat();
+        lngs_[i] = ll.lng();
+      }
+    }
+  }
+
+  /**
+   * Computes the distances of the gathered end nodes to the destination of a heuristic
+   * @param  heuristic  the heuristic
+   * @param  set        which set of distances to fill out, 0 or 1
+   */
+  void Compute(const AStarHeuristic& heuristic, const uint32_t set = 0) {
+    heuristic.GetDistances(lats_.data(), lngs_.data(), count_, distances_[set].data());
+  }
+
+  /**
+   * Returns whether the distance of the end node of an edge was gathered
+   * @param  edge_id  the id of the edge
+   * @param  edge     the edge
+   */
+  bool Has(const baldr::GraphId& edge_id, const baldr::DirectedEdge* edge) const {
+    return edge_id.tile_base() == tile_ && edge_id.id() - first_edge_ < count_ &&
+           !edge->leaves_tile();
+  }
+
+  /**
+   * Returns the distance of the end node of an edge, Has must be true for it
+   * @param  edge_id  the id of the edge
+   * @param  set      which set of distances, 0 or 1
+   */
+  float Distance(const baldr::GraphId& edge_id, const uint32_t set = 0) const {
+    return distances_[set][edge_id.id() - first_edge_];
+  }
+
+protected:
+  baldr::GraphId tile_;
+  uint32_t first_edge_;
+  uint32_t count_;
+  std::array<double, baldr::kMaxEdgesPerNode> lats_;
+  std::array<double, baldr::kMaxEdgesPerNode> lngs_;
+  std::array<std::array<float, baldr::kMaxEdgesPerNode>, 2> distances_;
+};
+
 } // namespace thor
 } // namespace valhalla
 
@@ -49,6 +49,12 @@ public:
    */
   virtual void Clear();
 
+  /**
+   * Clear the temporary memory like Clear but keep the edgestatus arrays, which makes the next
+   * expansion cheaper when it runs over mostly the same tiles
+   */
+  void Reset();
+
   /**
    * Compute the best first graph traversal from a list locations
    * @param expansion_type  What type of expansion should be run
@@ -113,6 +119,9 @@ protected:
                     const sif::TravelMode mode,
                     const valhalla::Options& options);
 
+  // Clears the edge labels and adjacency lists for Clear and Reset
+  void ClearLabels();
+
   // A child-class must implement this to learn about what nodes were expanded
   virtual void ExpandingNode(baldr::GraphReader&,
                              baldr::graph_tile_ptr,
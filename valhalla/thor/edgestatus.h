@@ -3,6 +3,7 @@
 #include <valhalla/baldr/graphid.h>
 #include <valhalla/baldr/graphtile.h>
 
+#include <algorithm>
 #include <unordered_map>
 
 // handy macro for shifting the 7bit path index value so that it can be or'd with the tile/level id
@@ -79,9 +80,26 @@ public:
   void clear() {
     // Delete any allocated arrays for tiles within the map.
     for (auto& iter : edgestatus_) {
-      delete[] iter.second;
+      delete[] iter.second.first;
     }
     edgestatus_.clear();
+    edge_count_ = 0;
+  }
+
+  /**
+   * Mark all edges unreached but keep the EdgeStatusInfo arrays, so that another search over
+   * mostly the same tiles doesn't have to allocate them again. If the arrays hold more than
+   * max_edges statuses they are deleted like clear() does instead.
+   * @param  max_edges  the most edge statuses to keep allocated
+   */
+  void reset(const size_t max_edges) {
+    if (edge_count_ > max_edges) {
+      clear();
+      return;
+    }
+    for (auto& iter : edgestatus_) {
+      std::fill_n(iter.second.first, iter.second.second, EdgeStatusInfo());
+    }
   }
 
   /**
@@ -101,13 +119,11 @@ public:
     assert(path_id <= baldr::kMaxMultiPathId);
     auto p = edgestatus_.find(edgeid.tile_value() | SHIFT_path_id(path_id));
     if (p != edgestatus_.end()) {
-      p->second[edgeid.id()] = {set, index};
+      p->second.first[edgeid.id()] = {set, index};
     } else {
       // Tile is not in the map. Add an array of EdgeStatusInfo, sized to
       // the number of directed edges in the specified tile.
-      auto inserted = edgestatus_.emplace(edgeid.tile_value() | SHIFT_path_id(path_id),
-                                          new EdgeStatusInfo[tile->header()->directededgecount()]);
-      inserted.first->second[edgeid.id()] = {set, index};
+      add(edgeid.tile_value() | SHIFT_path_id(path_id), tile)[edgeid.id()] = {set, index};
     }
   }
 
@@ -123,7 +139,7 @@ public:
     assert(path_id <= baldr::kMaxMultiPathId);
     const auto p = edgestatus_.find(edgeid.tile_value() | SHIFT_path_id(path_id));
     if (p != edgestatus_.end()) {
-      p->second[edgeid.id()].set_ = static_cast<uint32_t>(set);
+      p->second.first[edgeid.id()].set_ = static_cast<uint32_t>(set);
     } else {
       throw std::runtime_error("EdgeStatus Update on edge not previously set");
     }
@@ -139,7 +155,7 @@ public:
   EdgeStatusInfo Get(const baldr::GraphId& edgeid, const uint8_t path_id = 0) const {
     assert(path_id <= baldr::kMaxMultiPathId);
     const auto p = edgestatus_.find(edgeid.tile_value() | SHIFT_path_id(path_id));
-    return (p == edgestatus_.end()) ? EdgeStatusInfo() : p->second[edgeid.id()];
+    return (p == edgestatus_.end()) ? EdgeStatusInfo() : p->second.first[edgeid.id()];
   }
 
   /**
@@ -157,21 +173,29 @@ public:
     assert(path_id <= baldr::kMaxMultiPathId);
     const auto p = edgestatus_.find(edgeid.tile_value() | SHIFT_path_id(path_id));
     if (p != edgestatus_.end()) {
-      return &p->second[edgeid.id()];
+      return &p->second.first[edgeid.id()];
     } else {
       // Tile is not in the map. Add an array of EdgeStatusInfo, sized to
       // the number of directed edges in the specified tile.
-      auto inserted = edgestatus_.emplace(edgeid.tile_value() | SHIFT_path_id(path_id),
-                                          new EdgeStatusInfo[tile->header()->directededgecount()]);
-      return &(inserted.first->second)[edgeid.id()];
+      return &add(edgeid.tile_value() | SHIFT_path_id(path_id), tile)[edgeid.id()];
     }
   }
 
 private:
+  // Adds the array of EdgeStatusInfo for a tile and path to the map
+  EdgeStatusInfo* add(const uint32_t key, const baldr::graph_tile_ptr& tile) {
+    const uint32_t count = tile->header()->directededgecount();
+    edge_count_ += count;
+    return edgestatus_.emplace(key, std::make_pair(new EdgeStatusInfo[count], count))
+        .first->second.first;
+  }
+
   // Edge status - keys are the tile Ids (level and tile Id) and the
   // values are dynamically allocated arrays of EdgeStatusInfo (sized
-  // based on the directed edge count within the tile).
-  std::unordered_map<uint32_t, EdgeStatusInfo*> edgestatus_;
+  // based on the directed edge count within the tile) and their sizes.
+  std::unordered_map<uint32_t, std::pair<EdgeStatusInfo*, uint32_t>> edgestatus_;
+  // Number of EdgeStatusInfo in all the arrays
+  size_t edge_count_ = 0;
 };
 
 } // namespace thor
@@ -0,0 +1,67 @@
+#ifndef VALHALLA_THOR_LOCALSEARCH_OPTIMIZER_H_
+#define VALHALLA_THOR_LOCALSEARCH_OPTIMIZER_H_
+
+#include <boost/property_tree/ptree.hpp>
+
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+namespace valhalla {
+namespace thor {
+
+// Default number of starting tours, each of them is improved by a local search
+constexpr uint32_t kDefaultOptimizerStarts = 8;
+
+// Default time budget for all the local searches of one Solve
+constexpr uint32_t kDefaultOptimizerMaxTime = 1000; // milliseconds
+
+/**
+ * Optimizes the order of locations like Optimizer, keeping the first location (origin) and last
+ * location (destination) fixed. Instead of annealing it runs a local search of 2-opt, Or-opt and
+ * 3-opt segment exchange moves with don't-look bits until no move improves the tour. All moves
+ * are evaluated in constant time, also for asymmetric costs, so it is cheap enough to be run from
+ * several starting tours, in parallel if allowed. The best of the resulting tours is returned.
+ *
+ * Every start has its own generator seeded from the start's index, so the result is the same no
+ * matter how many threads are used, unless the time budget runs out first.
+ */
+class LocalSearchOptimizer {
+public:
+  /**
+   * Constructor
+   * @param  config  the thor config, optimizer.starts, optimizer.concurrency and
+   *                 optimizer.max_time (milliseconds) are read from it
+   */
+  LocalSearchOptimizer(const boost::property_tree::ptree& config = {});
+
+  /**
+   * Optimize the tour through a set of locations given the cost matrix
+   * among all locations. The first location (origin) and last location
+   * (destination) remain fixed in the tour.
+   * @param  count  Number of locations.
+   * @param  costs  2-D cost matrix.
+   * @return Returns the tour as an updated order of locations visited to
+   *         complete the tour.
+   */
+  std::vector<uint32_t> Solve(const uint32_t count, const std::vector<float>& costs) const;
+
+  /**
+   * Seed the random number generators of the starts.
+   * @param  seed  Seed from which the seed of every start is derived.
+   */
+  void Seed(const uint32_t seed) {
+    seed_ = seed;
+  }
+
+protected:
+  uint32_t starts_;                    // # of starting tours
+  uint32_t concurrency_;               // # of threads running the starts
+  std::chrono::milliseconds max_time_; // time budget per Solve
+  uint32_t seed_;                      // seed of the random starting tours
+};
+
+} // namespace thor
+} // namespace valhalla
+
+#endif // VALHALLA_THOR_LOCALSEARCH_OPTIMIZER_H_
@@ -1,6 +1,7 @@
 #ifndef VALHALLA_THOR_OPTIMIZER_H_
 #define VALHALLA_THOR_OPTIMIZER_H_
 
+#include <algorithm>
 #include <cstdint>
 #include <random>
 #include <vector>
@@ -126,7 +127,8 @@ protected:
    * @return  Returns the index of a random location.
    */
   uint32_t get_random_location() {
-    return static_cast<uint32_t>(r01() * (count_ - 2) + 1);
+    // r01 close to 1 can round up to the last location in float math
+    return std::min(static_cast<uint32_t>(r01() * (count_ - 2) + 1), count_ - 2);
   }
 
   /**
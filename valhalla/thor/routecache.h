@@ -0,0 +1,125 @@
+#ifndef VALHALLA_THOR_ROUTECACHE_H_
+#define VALHALLA_THOR_ROUTECACHE_H_
+
+#include <valhalla/proto/api.pb.h>
+#include <valhalla/thor/pathinfo.h>
+
+#include <boost/property_tree/ptree_fwd.hpp>
+
+#include <chrono>
+#include <cstdint>
+#include <list>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace valhalla {
+namespace baldr {
+class GraphReader;
+} // namespace baldr
+
+namespace thor {
+
+/**
+ * A bounded, least recently used cache of the paths found between two correlated locations so
+ * that requests repeating an origin and destination don't search for the path again. The paths
+ * are keyed by everything that goes into finding them: the algorithm, a hash of the costing
+ * options, the edges the locations were correlated to and their date_time, which is a bucket of
+ * a minute already. Since the costs come from the tiles and the live traffic, everything cached
+ * is dropped whenever the tileset is reloaded or a traffic tile is updated. Incidents are not part
+ * of the key, they don't go into the costs and are only attached to the trip leg, which is built
+ * anew for every request, cached path or not.
+ *
+ * Every thor worker keeps its own cache, so it is not synchronized.
+ */
+class RouteCache {
+public:
+  struct entry_t {
+    std::vector<std::vector<PathInfo>> paths;
+    // whether the paths were found on the second pass with relaxed limits and filtered edges
+    bool relaxed;
+    // the date_time the search left on the locations, it resolves "current"
+    std::string origin_date_time;
+    std::string destination_date_time;
+  };
+
+  /**
+   * Constructor
+   * @param  config  the thor config, route_cache.max_entries is read from it, 0 disables it, and
+   *                 route_cache.traffic_check_interval, the seconds between looks at the traffic
+   */
+  RouteCache(const boost::property_tree::ptree& config);
+
+  bool enabled() const {
+    return max_entries_ > 0;
+  }
+
+  /**
+   * Drops every entry if the tileset or the live traffic changed since they were cached. Reading
+   * the traffic version touches the header of every traffic tile, so it is only done once every
+   * traffic check interval or when the tileset changed
+   * @param  reader  the reader the paths are found with
+   */
+  void Validate(const baldr::GraphReader& reader);
+
+  /**
+   * Makes the key of the paths between two locations
+   * @param  options      the request's options, with the costing already parsed
+   * @param  algorithm    the name of the path algorithm finding the paths
+   * @param  origin       the correlated origin
+   * @param  destination  the correlated destination
+   * @return the key
+   */
+  static std::string Key(const Options& options,
+                         const std::string& algorithm,
+                         const valhalla::Location& origin,
+                         const valhalla::Location& destination);
+
+  /**
+   * Looks up the paths of a key and counts the hit or miss
+   * @param  key  the key made by Key
+   * @return the cached paths or nullptr if there are none
+   */
+  const entry_t* Find(const std::string& key);
+
+  /**
+   * Caches the paths of a key, evicting the least recently used entry if the cache is full
+   * @param  key    the key made by Key
+   * @param  entry  the paths to cache
+   */
+  void Insert(std::string key, entry_t entry);
+
+  /**
+   * Drops every entry, the counters are kept
+   */
+  void Clear();
+
+  /**
+   * Fills out the hits, misses, entries and evictions
+   * @param  status  the status of a status request
+   */
+  void Report(Status::RouteCache& status) const;
+
+protected:
+  using lru_t = std::list<std::pair<std::string, entry_t>>;
+
+  size_t max_entries_;
+  uint64_t tileset_generation_;
+  uint64_t traffic_version_;
+  std::chrono::steady_clock::duration traffic_check_interval_;
+  std::chrono::steady_clock::time_point traffic_checked_;
+
+  // most recently used first, indexed by key
+  lru_t entries_;
+  std::unordered_map<std::string, lru_t::iterator> index_;
+
+  uint64_t hits_;
+  uint64_t misses_;
+  uint64_t evictions_;
+};
+
+} // namespace thor
+} // namespace valhalla
+
+#endif // VALHALLA_THOR_ROUTECACHE_H_
@@ -13,6 +13,7 @@
 #include <valhalla/thor/pathalgorithm.h>
 
 #include <cstdint>
+#include <memory>
 #include <unordered_map>
 #include <vector>
 
@@ -76,6 +77,9 @@ public:
     reset();
     destinations_.clear();
     dest_edges_.clear();
+    for (auto& worker : workers_) {
+      worker->Clear();
+    }
   };
 
   /**
@@ -120,6 +124,12 @@ protected:
   // when doing timezone differencing a timezone cache speeds up the computation
   baldr::DateTime::tz_sys_info_cache_t tz_cache_;
 
+  // How many threads run the expansions from the origins, this one included
+  uint32_t concurrency_;
+
+  // The state of the other threads, kept between requests to reuse their reserved labels
+  std::vector<std::unique_ptr<TimeDistanceMatrix>> workers_;
+
   /**
    * Reset all origin-specific information
    */
@@ -147,6 +157,26 @@ protected:
             const bool FORWARD = expansion_direction == ExpansionType::forward>
   bool ComputeMatrix(Api& request, baldr::GraphReader& graphreader, const float max_matrix_distance);
 
+  /**
+   * Runs the one to many expansion from a single origin and writes its row (or column when in
+   * reverse) of the matrix. Only touches the state of this object and the matrix elements of the
+   * origin, so several objects can work on the origins of the same request at once.
+   * @param  request               the full request
+   * @param  matrix                the matrix to fill in, its arrays already have their full size
+   * @param  graphreader           Graph reader for accessing routing graph.
+   * @param  origin_index          Index of the origin among the sources (targets in reverse).
+   * @param  time_info             Time info of the origin.
+   * @param  max_matrix_distance   Maximum arc-length distance for current mode.
+   */
+  template <const ExpansionType expansion_direction,
+            const bool FORWARD = expansion_direction == ExpansionType::forward>
+  void ComputeOrigin(const Api& request,
+                     valhalla::Matrix& matrix,
+                     baldr::GraphReader& graphreader,
+                     const int origin_index,
+                     const baldr::TimeInfo& time_info,
+                     const float max_matrix_distance);
+
   /**
    * Expand from the node along the forward search path. Immediately expands
    * from the end node of any transition edge (so no transition edges are added
@@ -260,13 +290,15 @@ protected:
   /**
    * Form a time/distance matrix from the results.
    *
-   * @param request   The full request object
-   * @param reader    GraphReader instance
-   * @param origin_dt The origin's date_time string
-   * @param origin_tz The origin's timezone index
-   * @param pred_id   The destination edge's GraphId
+   * @param matrix       The matrix to write to
+   * @param target_count The number of targets in the request
+   * @param reader       GraphReader instance
+   * @param origin_dt    The origin's date_time string
+   * @param origin_tz    The origin's timezone index
+   * @param pred_id      The destination edge's GraphId
    */
-  void FormTimeDistanceMatrix(Api& request,
+  void FormTimeDistanceMatrix(valhalla::Matrix& matrix,
+                              const int target_count,
                               baldr::GraphReader& reader,
                               const bool forward,
                               const uint32_t origin_index,
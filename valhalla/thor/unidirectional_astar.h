@@ -164,6 +164,7 @@ protected:
 
   // A* heuristic
   AStarHeuristic astarheuristic_;
+  HeuristicBatch heuristic_batch_;
 
   // Current costing mode
   sif::cost_ptr_t costing_;
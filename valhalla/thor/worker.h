@@ -9,12 +9,15 @@
 #include <valhalla/proto/options.pb.h>
 #include <valhalla/proto/trip.pb.h>
 #include <valhalla/sif/costfactory.h>
+#include <valhalla/thor/accessibility.h>
 #include <valhalla/thor/bidirectional_astar.h>
 #include <valhalla/thor/centroid.h>
 #include <valhalla/thor/costmatrix.h>
 #include <valhalla/thor/isochrone.h>
+#include <valhalla/thor/localsearch_optimizer.h>
 #include <valhalla/thor/multimodal_astar.h>
 #include <valhalla/thor/multimodal_transit.h>
+#include <valhalla/thor/routecache.h>
 #include <valhalla/thor/timedistancebssmatrix.h>
 #include <valhalla/thor/timedistancematrix.h>
 #include <valhalla/thor/unidirectional_astar.h>
@@ -22,6 +25,7 @@
 
 #include <boost/property_tree/ptree_fwd.hpp>
 
+#include <memory>
 #include <tuple>
 #include <vector>
 
@@ -52,16 +56,21 @@ public:
   static void adjust_locations(valhalla::Api& options);
 
   void route(Api& request);
-  std::string matrix(Api& request);
+  // when a sink is given the serialized response is streamed to it and an empty string returned
+  std::string matrix(Api& request, const std::function<void(const char*, size_t)>* sink = nullptr);
   void optimized_route(Api& request);
-  std::string isochrones(Api& request);
+  std::string isochrones(Api& request,
+                         const std::function<void(const char*, size_t)>* sink = nullptr);
   void trace_route(Api& request);
   std::string trace_attributes(Api& request);
   std::string expansion(Api& request);
+  std::string accessibility(Api& request);
   void centroid(Api& request);
   void status(Api& request) const;
 
   void set_interrupt(const std::function<void()>* interrupt) override;
+  // reloads the tile extracts if that was requested since the last request
+  void refresh_tileset();
 
 protected:
   std::vector<std::vector<thor::PathInfo>> get_path(PathAlgorithm* path_algorithm,
@@ -76,6 +85,28 @@ protected:
                                           Api& request);
   thor::MatrixAlgorithm*
   get_matrix_algorithm(Api& request, const bool has_time, const std::string& costing);
+  /**
+   * Fills out the request's matrix with the algorithm, including a second pass for CostMatrix
+   * @param request   the request with its sources and targets correlated
+   * @param algo      the algorithm picked for the request
+   * @param costing   the name of the costing
+   * @return whether a second pass was needed, the caller warns about it
+   */
+  bool compute_matrix(Api& request, thor::MatrixAlgorithm* algo, const std::string& costing);
+  /**
+   * Computes an isochrone per location of a batch request, several at a time if configured. The
+   * feature collections are written in the order of the locations as a json array
+   * @param request         the request with its locations correlated
+   * @param intervals       the contours of every isochrone
+   * @param expansion_type  the direction of the expansions
+   * @param sink            when given the feature collections are streamed to it as they finish
+   * @return the json array unless it was streamed to the sink
+   */
+  std::string
+  batch_isochrones(Api& request,
+                   const std::vector<midgard::GriddedData<2>::contour_interval_t>& intervals,
+                   const ExpansionType expansion_type,
+                   const std::function<void(const char*, size_t)>* sink);
   void route_match(Api& request);
   /**
    * Returns the results of the map match where the first float is the normalized
@@ -116,6 +147,8 @@ protected:
   MultiModalPathAlgorithm multi_modal_transit;
   TimeDepForward timedep_forward;
   TimeDepReverse timedep_reverse;
+  // Paths found by the above for previous requests, if enabled
+  RouteCache route_cache_;
 
   // Time distance matrix
   CostMatrix costmatrix_;
@@ -123,6 +156,13 @@ protected:
   TimeDistanceBSSMatrix time_distance_bss_matrix_;
 
   Isochrone isochrone_gen;
+  uint32_t isochrone_contour_concurrency;
+  // the threads of a batch isochrone request each reuse one of these, the first one isochrone_gen
+  std::vector<std::unique_ptr<Isochrone>> isochrone_workers_;
+  Accessibility accessibility_gen;
+  // Orders the locations of optimized_route unless the annealer is configured instead
+  LocalSearchOptimizer optimizer_;
+  bool optimizer_annealing_;
   std::shared_ptr<meili::MapMatcher> matcher;
   float max_timedep_distance;
   std::unordered_map<std::string, float> max_matrix_distance;
@@ -130,6 +170,7 @@ protected:
   bool costmatrix_allow_second_pass;
   std::shared_ptr<baldr::GraphReader> reader;
   meili::MapMatcherFactory matcher_factory;
+  uint64_t tileset_generation_;
   baldr::AttributesController controller;
   Centroid centroid_gen;
 
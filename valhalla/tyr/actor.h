@@ -6,6 +6,7 @@
 
 #include <boost/property_tree/ptree_fwd.hpp>
 
+#include <functional>
 #include <memory>
 
 namespace valhalla {
@@ -41,9 +42,13 @@ public:
    * output was requested
    * @param api        object containing the request options and result after the call
    * @param interrupt  allows the underlying computation to be aborted via the functor throwing
+   * @param sink       optional sink to which matrix and isochrone responses are streamed in chunks
+   *                   as they are serialized, in which case an empty string is returned for them
    * @return json or pbf bytes depending on what was specified in the options object
    */
-  std::string act(Api& api, const std::function<void()>* interrupt = nullptr);
+  std::string act(Api& api,
+                  const std::function<void()>* interrupt = nullptr,
+                  const std::function<void(const char*, size_t)>* sink = nullptr);
 
   /**
    * Perform the route action and return json or protobuf depending on which was requested. The
@@ -81,11 +86,15 @@ public:
    * @param interrupt    allows the underlying computation to be aborted via the functor throwing
    * @param api          protobuffer object which can contain the input request via the options object
    *                     and will be filled out as the request is processed
+   * @param sink         optional sink to which the response is streamed in chunks as it is
+   *                     serialized, so that it need not be held in memory all at once. When given
+   *                     the returned string is empty
    * @return json or pbf bytes depending on what was specified in the options object
    */
   std::string matrix(const std::string& request_str,
                      const std::function<void()>* interrupt = nullptr,
-                     Api* api = nullptr);
+                     Api* api = nullptr,
+                     const std::function<void(const char*, size_t)>* sink = nullptr);
 
   /**
    * Perform the optimized_route action and return json or protobuf depending on which was requested.
@@ -109,11 +118,15 @@ public:
    * @param interrupt    allows the underlying computation to be aborted via the functor throwing
    * @param api          protobuffer object which can contain the input request via the options object
    *                     and will be filled out as the request is processed
+   * @param sink         optional sink to which the response is streamed in chunks as it is
+   *                     serialized, so that it need not be held in memory all at once. When given
+   *                     the returned string is empty
    * @return json or pbf bytes depending on what was specified in the options object
    */
   std::string isochrone(const std::string& request_str,
                         const std::function<void()>* interrupt = nullptr,
-                        Api* api = nullptr);
+                        Api* api = nullptr,
+                        const std::function<void(const char*, size_t)>* sink = nullptr);
 
   /**
    * Perform the trace_route action and return json or protobuf depending on which was requested. The
@@ -222,6 +235,20 @@ public:
                    const std::function<void()>* interrupt = nullptr,
                    Api* api = nullptr);
 
+  /**
+   * Perform the accessibility action and return json. The request may either be in the form of a
+   * json string provided by the request_str parameter or contained in the api parameter as a
+   * deserialized protobuf object
+   * @param request_str  json string if json input is being used empty otherwise
+   * @param interrupt    allows the underlying computation to be aborted via the functor throwing
+   * @param api          protobuffer object which can contain the input request via the options object
+   *                     and will be filled out as the request is processed
+   * @return json with the reachable edges and targets of every location
+   */
+  std::string accessibility(const std::string& request_str,
+                            const std::function<void()>* interrupt = nullptr,
+                            Api* api = nullptr);
+
 protected:
   struct pimpl_t;
   std::shared_ptr<pimpl_t> pimpl;
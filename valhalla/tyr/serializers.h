@@ -10,6 +10,7 @@
 #include <valhalla/midgard/pointll.h>
 #include <valhalla/proto/api.pb.h>
 
+#include <functional>
 #include <string>
 #include <unordered_map>
 #include <vector>
@@ -24,6 +25,10 @@ namespace tyr {
 
 constexpr unsigned int kDefaultPrecision = 3;
 constexpr unsigned int kCoordinatePrecision = 6;
+// how many bytes of a streamed response to accumulate before handing them off to the sink. only
+// library callers (actor_t) and valhalla_service's one shot mode stream, the http service doesn't
+// since prime_server only sends a worker's result once the worker has returned it in full
+constexpr size_t kStreamChunkSize = 64 * 1024;
 
 /**
  * Turn path and directions into a route that one can follow
@@ -32,18 +37,36 @@ std::string serializeDirections(Api& request);
 
 /**
  * Turn a time distance matrix into json that one can look up location pair results from
+ *
+ * @param request  the request containing the computed matrix
+ * @param sink     optional sink which receives the response in chunks, row by row, as it is
+ *                 serialized so that large matrices need not be held in memory all at once. When
+ *                 a sink is provided the returned string is empty
  */
-std::string serializeMatrix(Api& request);
+std::string serializeMatrix(Api& request,
+                            const std::function<void(const char*, size_t)>* sink = nullptr);
 
 /**
  * Turn grid data contours into geojson
  *
  * @param grid_contours    the contours generated from the grid
  * @param colors           the #ABC123 hex string color used in geojson fill color
+ * @param sink             optional sink which receives the response in chunks, feature by feature,
+ *                         as it is serialized. When a sink is provided the returned string is empty
+ * @param concurrency      how many threads may generate the contours
  */
 std::string serializeIsochrones(Api& request,
                                 std::vector<midgard::GriddedData<2>::contour_interval_t>& intervals,
-                                const std::shared_ptr<const midgard::GriddedData<2>>& isogrid);
+                                const std::shared_ptr<const midgard::GriddedData<2>>& isogrid,
+                                const std::function<void(const char*, size_t)>* sink = nullptr,
+                                uint32_t concurrency = 1);
+/**
+ * Turn the accessibility scores of each location into json or pbf
+ *
+ * @param request  the request with its accessibility filled out
+ */
+std::string serializeAccessibility(Api& request);
+
 /**
  * Write GeoJSON from expansion pbf
  */